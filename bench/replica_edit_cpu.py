@@ -0,0 +1,119 @@
+#!/usr/bin/env python3
+"""
+Replica CPU under an edit-heavy workload.
+
+Runs a stream of FS.REPLACE / FS.INSERT / FS.DELETELINES against one large
+file on the primary and reports how much CPU the replica burned applying
+them, alongside the replication stream size. With effect replication the
+replica applies each edit as an FS.SPLICE and its CPU should stay a small
+fraction of the primary's; with verbatim replication the two are roughly
+equal because the replica repeats every scan.
+
+Usage:
+    # Primary and replica, both with the module loaded:
+    #   redis-server --port 6379 --loadmodule ./module/fs.so
+    #   redis-server --port 6380 --loadmodule ./module/fs.so --replicaof 127.0.0.1 6379
+    #
+    python3 bench/replica_edit_cpu.py [--primary 6379] [--replica 6380]
+        [--size-mb 8] [--ops 200]
+"""
+
+import argparse
+import random
+import time
+
+import redis
+
+
+def cpu_seconds(r):
+    info = r.info("cpu")
+    return float(info["used_cpu_user"]) + float(info["used_cpu_sys"])
+
+
+def repl_offset(r):
+    return int(r.info("replication")["master_repl_offset"])
+
+
+def wait_for_replica(primary, replica, timeout=60):
+    """Block until the replica has applied everything the primary sent."""
+    target = repl_offset(primary)
+    deadline = time.time() + timeout
+    while time.time() < deadline:
+        info = replica.info("replication")
+        if int(info.get("slave_repl_offset", info.get("master_repl_offset", 0))) >= target:
+            return
+        time.sleep(0.01)
+    raise RuntimeError("replica did not catch up")
+
+
+def build_file(size_mb, seed):
+    rnd = random.Random(seed)
+    words = ["alpha", "beta", "gamma", "delta", "needle", "kappa", "omega"]
+    lines = []
+    total = 0
+    while total < size_mb * 1024 * 1024:
+        line = " ".join(rnd.choice(words) for _ in range(12))
+        lines.append(line)
+        total += len(line) + 1
+    return "\n".join(lines) + "\n", len(lines)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n")[1])
+    ap.add_argument("--host", default="127.0.0.1")
+    ap.add_argument("--primary", type=int, default=6379)
+    ap.add_argument("--replica", type=int, default=6380)
+    ap.add_argument("--key", default="bench:edit")
+    ap.add_argument("--size-mb", type=int, default=8)
+    ap.add_argument("--ops", type=int, default=200)
+    ap.add_argument("--seed", type=int, default=1)
+    args = ap.parse_args()
+
+    primary = redis.Redis(host=args.host, port=args.primary)
+    replica = redis.Redis(host=args.host, port=args.replica)
+
+    content, nlines = build_file(args.size_mb, args.seed)
+    primary.delete(args.key)
+    primary.execute_command("FS.ECHO", args.key, "/big.txt", content)
+    wait_for_replica(primary, replica)
+
+    rnd = random.Random(args.seed)
+    p_cpu, r_cpu, off = cpu_seconds(primary), cpu_seconds(replica), repl_offset(primary)
+    start = time.time()
+    for i in range(args.ops):
+        op = i % 4
+        if op == 0:
+            # Touches every occurrence: the worst case for verbatim replay.
+            # Flip the case back and forth so every round has matches.
+            old, new = ("needle", "NEEDLE") if (i // 4) % 2 == 0 else ("NEEDLE", "needle")
+            primary.execute_command("FS.REPLACE", args.key, "/big.txt", old, new, "ALL")
+        elif op == 1:
+            line = rnd.randint(1, nlines)
+            primary.execute_command("FS.INSERT", args.key, "/big.txt", line,
+                                    f"inserted line {i}")
+            nlines += 1
+        elif op == 2:
+            line = rnd.randint(1, nlines)
+            primary.execute_command("FS.DELETELINES", args.key, "/big.txt", line, line)
+            nlines -= 1
+        else:
+            line = rnd.randint(1, nlines)
+            primary.execute_command("FS.REPLACE", args.key, "/big.txt",
+                                    "gamma", "GAMMA", "LINE", line, line)
+    wait_for_replica(primary, replica)
+    elapsed = time.time() - start
+
+    p_used = cpu_seconds(primary) - p_cpu
+    r_used = cpu_seconds(replica) - r_cpu
+    sent = repl_offset(primary) - off
+
+    print(f"file:            {args.size_mb} MB, {args.ops} edits in {elapsed:.2f}s")
+    print(f"primary CPU:     {p_used:.3f}s")
+    print(f"replica CPU:     {r_used:.3f}s ({100 * r_used / max(p_used, 1e-9):.1f}% of primary)")
+    print(f"repl stream:     {sent / 1024:.1f} KB ({sent / args.ops:.0f} B/edit)")
+
+    primary.delete(args.key)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,88 @@
+#!/usr/bin/env python3
+"""
+Directory traversal throughput on a large tree.
+
+Builds a tree of FANOUT^3 files under /t (a million with the default
+fanout of 100) and times the commands that walk directories: FS.TREE over
+the whole tree, nested and FLAT, FS.LS LONG on every leaf directory, and
+a recursive FS.CP followed by a recursive FS.RM of the copy. Each line
+reports inodes visited per second, so runs at different fanouts compare
+directly.
+
+Usage:
+    # redis-server --port 6379 --loadmodule ./module/fs.so
+    python3 bench/tree_traversal.py [--port 6379] [--fanout 100] [--rounds 3]
+"""
+
+import argparse
+import time
+
+import redis
+
+
+def build_tree(r, key, fanout, batch=10000):
+    pipe = r.pipeline(transaction=False)
+    queued = 0
+    for a in range(fanout):
+        for b in range(fanout):
+            for c in range(fanout):
+                pipe.execute_command("FS.ECHO", key, f"/t/d{a}/d{b}/f{c}", "x")
+                queued += 1
+                if queued == batch:
+                    pipe.execute()
+                    queued = 0
+    if queued:
+        pipe.execute()
+
+
+def timed(label, inodes, rounds, fn):
+    best = float("inf")
+    for _ in range(rounds):
+        start = time.perf_counter()
+        fn()
+        best = min(best, time.perf_counter() - start)
+    print(f"{label:<18} {best * 1000:9.1f} ms  {inodes / best / 1e6:6.2f} M inodes/s")
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n")[1])
+    ap.add_argument("--host", default="127.0.0.1")
+    ap.add_argument("--port", type=int, default=6379)
+    ap.add_argument("--key", default="bench:tree")
+    ap.add_argument("--fanout", type=int, default=100)
+    ap.add_argument("--rounds", type=int, default=3)
+    args = ap.parse_args()
+
+    r = redis.Redis(host=args.host, port=args.port)
+    n = args.fanout
+    files = n ** 3
+    inodes = files + n * n + n + 1
+
+    r.delete(args.key)
+    start = time.perf_counter()
+    build_tree(r, args.key, n)
+    print(f"tree:              {inodes} inodes built in {time.perf_counter() - start:.1f}s")
+
+    timed("FS.TREE", inodes, args.rounds,
+          lambda: r.execute_command("FS.TREE", args.key, "/t"))
+    timed("FS.TREE FLAT", inodes, args.rounds,
+          lambda: r.execute_command("FS.TREE", args.key, "/t", "FLAT"))
+
+    def ls_leaves():
+        pipe = r.pipeline(transaction=False)
+        for a in range(n):
+            for b in range(n):
+                pipe.execute_command("FS.LS", args.key, f"/t/d{a}/d{b}", "LONG")
+        pipe.execute()
+    timed("FS.LS LONG", files, args.rounds, ls_leaves)
+
+    def cp_rm():
+        r.execute_command("FS.CP", args.key, "/t", "/copy", "RECURSIVE")
+        r.execute_command("FS.RM", args.key, "/copy", "RECURSIVE")
+    timed("FS.CP + FS.RM", 2 * inodes, args.rounds, cp_rm)
+
+    r.delete(args.key)
+
+
+if __name__ == "__main__":
+    main()
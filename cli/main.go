@@ -777,6 +777,11 @@ func importDirectory(ctx context.Context, rdb *redis.Client, key, source string,
 				return fmt.Errorf("FS.MKDIR %s: %w", redisPath, err)
 			}
 			dirs++
+		case info.Size() > uploadChunkSize:
+			if err := uploadFile(ctx, rdb, key, redisPath, path); err != nil {
+				return err
+			}
+			files++
 		default:
 			data, err := os.ReadFile(path)
 			if err != nil {
@@ -799,6 +804,56 @@ func importDirectory(ctx context.Context, rdb *redis.Client, key, source string,
 	return files, dirs, symlinks, err
 }
 
+// uploadChunkSize is the largest payload sent in one command. Bigger files
+// are streamed with FS.OPEN / FS.WRITECHUNK / FS.COMMIT, so neither side
+// holds a whole multi-GB file in one bulk string.
+const uploadChunkSize = 4 << 20
+
+// uploadFile streams a local file into redisPath in chunks. The file only
+// appears in Redis once every chunk is in; on failure the partial upload
+// is aborted.
+func uploadFile(ctx context.Context, rdb *redis.Client, key, redisPath, source string) error {
+	f, err := os.Open(source)
+	if err != nil {
+		return err
+	}
+	defer f.Close()
+
+	handle, err := rdb.Do(ctx, "FS.OPEN", key, redisPath).Int64()
+	if err != nil {
+		return fmt.Errorf("FS.OPEN %s: %w", redisPath, err)
+	}
+	committed := false
+	defer func() {
+		if !committed {
+			rdb.Do(context.Background(), "FS.ABORT", key, handle)
+		}
+	}()
+
+	buf := make([]byte, uploadChunkSize)
+	var offset int64
+	for {
+		n, err := io.ReadFull(f, buf)
+		if n > 0 {
+			if err := rdb.Do(ctx, "FS.WRITECHUNK", key, handle, buf[:n], "OFFSET", offset).Err(); err != nil {
+				return fmt.Errorf("FS.WRITECHUNK %s: %w", redisPath, err)
+			}
+			offset += int64(n)
+		}
+		if err == io.EOF || err == io.ErrUnexpectedEOF {
+			break
+		}
+		if err != nil {
+			return err
+		}
+	}
+	if err := rdb.Do(ctx, "FS.COMMIT", key, handle).Err(); err != nil {
+		return fmt.Errorf("FS.COMMIT %s: %w", redisPath, err)
+	}
+	committed = true
+	return nil
+}
+
 func applyMetadata(ctx context.Context, rdb *redis.Client, key, path string, info os.FileInfo) error {
 	modeStr := fmt.Sprintf("%04o", info.Mode().Perm())
 	if err := rdb.Do(ctx, "FS.CHMOD", key, path, modeStr).Err(); err != nil {
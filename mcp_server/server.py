@@ -2,29 +2,53 @@
 
 import os
 import asyncio
-from typing import Any
+from typing import Any, Optional
 
 from mcp.server import Server
 from mcp.server.stdio import stdio_server
 from mcp.types import Tool, TextContent
-import redis
+from redis.asyncio import Redis
 
-from redis_fs import RedisFS
+from redis_fs import AsyncRedisFS
 
 # Default port for HTTP transport
 DEFAULT_HTTP_PORT = 8089
 
+# Default page size for fs_tree, fs_find and fs_grep; each returns a cursor
+# for the rest, so a large volume can't flood the caller's context.
+DEFAULT_RESULT_LIMIT = 200
 
-def get_redis() -> redis.Redis:
-    """Get Redis client from environment."""
+
+def get_redis() -> Redis:
+    """Get a pooled asyncio Redis client from environment.
+
+    REDIS_MAX_CONNECTIONS bounds the pool shared by all tool calls.
+    """
+    max_connections = int(os.environ.get("REDIS_MAX_CONNECTIONS", "64"))
     url = os.environ.get("REDIS_URL")
     if url:
-        return redis.from_url(url)
+        return Redis.from_url(url, max_connections=max_connections)
     
     host = os.environ.get("REDIS_HOST", "localhost")
     port = int(os.environ.get("REDIS_PORT", "6379"))
     db = int(os.environ.get("REDIS_DB", "0"))
-    return redis.Redis(host=host, port=port, db=db)
+    return Redis(host=host, port=port, db=db, max_connections=max_connections)
+
+
+def format_tree(nodes: list[tuple[int, str, str]]) -> list[str]:
+    """Render FS.TREE FLAT (depth, type, name) tuples as indented lines."""
+    suffix = {"dir": "/", "symlink": "@"}
+    return [
+        "  " * depth + name + ("" if name == "/" else suffix.get(type_, ""))
+        for depth, type_, name in nodes
+    ]
+
+
+def with_cursor(text: str, cursor: Optional[str]) -> str:
+    """Append a continuation note when a paged result has more to come."""
+    if cursor is None:
+        return text
+    return f'{text}\n\n[more results: call again with cursor="{cursor}"]'
 
 
 def create_server() -> Server:
@@ -32,8 +56,8 @@ def create_server() -> Server:
     server = Server("redis-fs")
     r = get_redis()
 
-    def get_fs(key: str) -> RedisFS:
-        return RedisFS(r, key)
+    def get_fs(key: str) -> AsyncRedisFS:
+        return AsyncRedisFS(r, key)
 
     @server.list_tools()
     async def list_tools() -> list[Tool]:
@@ -51,6 +75,18 @@ def create_server() -> Server:
                     "required": ["key", "path"],
                 },
             ),
+            Tool(
+                name="fs_read_many",
+                description="Read several files from Redis-FS in one round trip",
+                inputSchema={
+                    "type": "object",
+                    "properties": {
+                        "key": {"type": "string", "description": "Filesystem volume key"},
+                        "paths": {"type": "array", "items": {"type": "string"}, "description": "Absolute file paths"},
+                    },
+                    "required": ["key", "paths"],
+                },
+            ),
             Tool(
                 name="fs_write",
                 description="Write content to file in Redis-FS (creates parents)",
@@ -64,6 +100,22 @@ def create_server() -> Server:
                     "required": ["key", "path", "content"],
                 },
             ),
+            Tool(
+                name="fs_write_many",
+                description="Write several files to Redis-FS in one round trip (creates parents)",
+                inputSchema={
+                    "type": "object",
+                    "properties": {
+                        "key": {"type": "string", "description": "Filesystem volume key"},
+                        "files": {
+                            "type": "object",
+                            "additionalProperties": {"type": "string"},
+                            "description": "Map of absolute file path to content",
+                        },
+                    },
+                    "required": ["key", "files"],
+                },
+            ),
             Tool(
                 name="fs_append",
                 description="Append content to file in Redis-FS",
@@ -148,9 +200,24 @@ def create_server() -> Server:
                     "required": ["key"],
                 },
             ),
+            Tool(
+                name="fs_tree",
+                description="Show the directory tree, a page at a time",
+                inputSchema={
+                    "type": "object",
+                    "properties": {
+                        "key": {"type": "string", "description": "Filesystem volume key"},
+                        "path": {"type": "string", "description": "Directory path", "default": "/"},
+                        "depth": {"type": "integer", "description": "Max depth"},
+                        "limit": {"type": "integer", "description": "Max results per call", "default": DEFAULT_RESULT_LIMIT},
+                        "cursor": {"type": "string", "description": "Cursor from the previous call, to continue"},
+                    },
+                    "required": ["key"],
+                },
+            ),
             Tool(
                 name="fs_find",
-                description="Find files matching glob pattern",
+                description="Find files matching glob pattern, a page at a time",
                 inputSchema={
                     "type": "object",
                     "properties": {
@@ -158,13 +225,15 @@ def create_server() -> Server:
                         "path": {"type": "string", "description": "Starting path"},
                         "pattern": {"type": "string", "description": "Glob pattern (e.g., *.md)"},
                         "type": {"type": "string", "enum": ["file", "dir", "link"], "description": "Filter by type"},
+                        "limit": {"type": "integer", "description": "Max results per call", "default": DEFAULT_RESULT_LIMIT},
+                        "cursor": {"type": "string", "description": "Cursor from the previous call, to continue"},
                     },
                     "required": ["key", "path", "pattern"],
                 },
             ),
             Tool(
                 name="fs_grep",
-                description="Search file contents with glob pattern",
+                description="Search file contents with glob pattern, a page at a time",
                 inputSchema={
                     "type": "object",
                     "properties": {
@@ -172,10 +241,27 @@ def create_server() -> Server:
                         "path": {"type": "string", "description": "Search path"},
                         "pattern": {"type": "string", "description": "Glob pattern (e.g., *TODO*)"},
                         "nocase": {"type": "boolean", "description": "Case-insensitive", "default": False},
+                        "limit": {"type": "integer", "description": "Max results per call", "default": DEFAULT_RESULT_LIMIT},
+                        "cursor": {"type": "string", "description": "Cursor from the previous call, to continue"},
                     },
                     "required": ["key", "path", "pattern"],
                 },
             ),
+            Tool(
+                name="fs_search",
+                description="Rank files by relevance to a free-text query (BM25), with the best-matching line of each",
+                inputSchema={
+                    "type": "object",
+                    "properties": {
+                        "key": {"type": "string", "description": "Filesystem volume key"},
+                        "path": {"type": "string", "description": "Search path"},
+                        "query": {"type": "string", "description": "Words to search for"},
+                        "limit": {"type": "integer", "description": "Max files", "default": 10},
+                        "include": {"type": "string", "description": "Only files whose name matches this glob"},
+                    },
+                    "required": ["key", "path", "query"],
+                },
+            ),
             Tool(
                 name="fs_mkdir",
                 description="Create directory",
@@ -223,24 +309,46 @@ def create_server() -> Server:
 
         try:
             if name == "fs_read":
-                result = fs.read(arguments["path"])
+                result = await fs.read(arguments["path"])
                 return [TextContent(type="text", text=result or "")]
 
+            elif name == "fs_read_many":
+                batch = fs.batch()
+                reads = [(p, batch.read(p)) for p in arguments["paths"]]
+                try:
+                    await batch.execute()
+                except Exception:
+                    pass  # reported per file below
+                parts = []
+                for p, r in reads:
+                    try:
+                        content = r.value
+                    except Exception as e:
+                        content = f"Error: {e}"
+                    parts.append(f"==> {p} <==\n{content if content is not None else '(no such file)'}")
+                return [TextContent(type="text", text="\n\n".join(parts))]
+
             elif name == "fs_write":
-                fs.write(arguments["path"], arguments["content"])
+                await fs.write(arguments["path"], arguments["content"])
                 return [TextContent(type="text", text="OK")]
 
+            elif name == "fs_write_many":
+                async with fs.batch() as b:
+                    for path, content in arguments["files"].items():
+                        b.write(path, content)
+                return [TextContent(type="text", text=f"{len(arguments['files'])} file(s) written")]
+
             elif name == "fs_append":
-                fs.append(arguments["path"], arguments["content"])
+                await fs.append(arguments["path"], arguments["content"])
                 return [TextContent(type="text", text="OK")]
 
             elif name == "fs_lines":
                 end = arguments.get("end", -1)
-                result = fs.lines(arguments["path"], arguments["start"], end)
+                result = await fs.lines(arguments["path"], arguments["start"], end)
                 return [TextContent(type="text", text=result or "")]
 
             elif name == "fs_replace":
-                count = fs.replace(
+                count = await fs.replace(
                     arguments["path"],
                     arguments["old"],
                     arguments["new"],
@@ -251,44 +359,72 @@ def create_server() -> Server:
                 return [TextContent(type="text", text=f"{count} replacement(s)")]
 
             elif name == "fs_insert":
-                fs.insert(arguments["path"], arguments["line"], arguments["content"])
+                await fs.insert(arguments["path"], arguments["line"], arguments["content"])
                 return [TextContent(type="text", text="OK")]
 
             elif name == "fs_delete_lines":
-                count = fs.delete_lines(arguments["path"], arguments["start"], arguments["end"])
+                count = await fs.delete_lines(arguments["path"], arguments["start"], arguments["end"])
                 return [TextContent(type="text", text=f"{count} line(s) deleted")]
 
             elif name == "fs_ls":
                 path = arguments.get("path", "/")
-                entries = fs.ls(path)
+                entries = await fs.ls(path)
                 return [TextContent(type="text", text="\n".join(entries))]
 
+            elif name == "fs_tree":
+                tree, cursor = await fs.tree_page(
+                    arguments.get("path", "/"),
+                    depth=arguments.get("depth"),
+                    limit=arguments.get("limit", DEFAULT_RESULT_LIMIT),
+                    cursor=arguments.get("cursor"),
+                    flat=True,
+                )
+                text = "\n".join(format_tree(tree))
+                return [TextContent(type="text", text=with_cursor(text, cursor))]
+
             elif name == "fs_find":
-                results = fs.find(
+                results, cursor = await fs.find_page(
                     arguments["path"],
                     arguments["pattern"],
                     type=arguments.get("type"),
+                    limit=arguments.get("limit", DEFAULT_RESULT_LIMIT),
+                    cursor=arguments.get("cursor"),
                 )
-                return [TextContent(type="text", text="\n".join(results))]
+                return [TextContent(type="text", text=with_cursor("\n".join(results), cursor))]
 
             elif name == "fs_grep":
-                results = fs.grep(
+                results, cursor = await fs.grep_page(
                     arguments["path"],
                     arguments["pattern"],
                     nocase=arguments.get("nocase", False),
+                    limit=arguments.get("limit", DEFAULT_RESULT_LIMIT),
+                    cursor=arguments.get("cursor"),
+                )
+                text = "\n".join(str(r) for r in results)
+                return [TextContent(type="text", text=with_cursor(text, cursor))]
+
+            elif name == "fs_search":
+                hits = await fs.search(
+                    arguments["path"],
+                    arguments["query"],
+                    limit=arguments.get("limit", 10),
+                    include=arguments.get("include"),
+                )
+                text = "\n".join(
+                    f"{h['path']}:{h['line']} ({h['score']:.2f}) {h['text']}" for h in hits
                 )
-                return [TextContent(type="text", text="\n".join(str(r) for r in results))]
+                return [TextContent(type="text", text=text)]
 
             elif name == "fs_mkdir":
-                fs.mkdir(arguments["path"], parents=arguments.get("parents", False))
+                await fs.mkdir(arguments["path"], parents=arguments.get("parents", False))
                 return [TextContent(type="text", text="OK")]
 
             elif name == "fs_rm":
-                fs.rm(arguments["path"], recursive=arguments.get("recursive", False))
+                await fs.rm(arguments["path"], recursive=arguments.get("recursive", False))
                 return [TextContent(type="text", text="OK")]
 
             elif name == "fs_info":
-                info = fs.info()
+                info = await fs.info()
                 text = "\n".join(f"{k}: {v}" for k, v in info.items())
                 return [TextContent(type="text", text=text)]
 
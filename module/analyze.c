@@ -0,0 +1,300 @@
+/*
+ * analyze.c - Data-shape statistics for FS.ANALYZE.
+ */
+
+#include "analyze.h"
+#include "log.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct fsAnalyzeExtension {
+    char ext[FS_ANALYZE_MAX_EXTENSION];
+    size_t len;
+    uint64_t files;
+    uint64_t bytes;
+} fsAnalyzeExtension;
+
+void fsAnalysisInit(fsAnalysis *a) {
+    memset(a, 0, sizeof(*a));
+    a->extensions = RedisModule_CreateDict(NULL);
+}
+
+void fsAnalysisFree(fsAnalysis *a) {
+    RedisModuleDictIter *iter = RedisModule_DictIteratorStartC(a->extensions, "^", NULL, 0);
+    fsAnalyzeExtension *ext;
+    while (RedisModule_DictNextC(iter, NULL, (void**)&ext) != NULL) RedisModule_Free(ext);
+    RedisModule_DictIteratorStop(iter);
+    RedisModule_FreeDict(NULL, a->extensions);
+    if (a->samples) RedisModule_Free(a->samples);
+}
+
+/* ===================================================================
+ * Accounting
+ * =================================================================== */
+
+/* Index of the power-of-two bucket holding v (see analyze.h). */
+static int fsAnalyzeBucket(uint64_t v) {
+    if (v <= 1) return (int)v;
+    int b = 64 - __builtin_clzll(v - 1) + 1;
+    return b < FS_ANALYZE_LOG2_BUCKETS ? b : FS_ANALYZE_LOG2_BUCKETS - 1;
+}
+
+static uint64_t fsAnalyzeBucketLabel(int b) {
+    return b == 0 ? 0 : 1ULL << (b - 1);
+}
+
+/* Tenths of a bloom filter's bits that are set, rounded up. */
+static int fsAnalyzeBloomFill(const uint8_t *bloom) {
+    unsigned bits = 0;
+    for (int i = 0; i < FS_BLOOM_BYTES; i++) bits += (unsigned)__builtin_popcount(bloom[i]);
+    return (int)((bits * 10 + FS_BLOOM_BITS - 1) / FS_BLOOM_BITS);
+}
+
+/* FNV-1a, 64-bit, continued from h. */
+static uint64_t fsAnalyzeHash(uint64_t h, const char *p, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        h ^= (uint8_t)p[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+/* Hash up to limit bytes of a file's content, continuing from h. */
+static uint64_t fsAnalyzeHashContent(uint64_t h, const fsInode *inode, size_t limit) {
+    const fsLog *log = inode->payload.file.log;
+    if (!log) {
+        size_t n = inode->payload.file.size < limit ? inode->payload.file.size : limit;
+        return fsAnalyzeHash(h, inode->payload.file.data, n);
+    }
+    for (size_t i = 0; i < log->count && limit > 0; i++) {
+        size_t n = log->segments[i].size < limit ? log->segments[i].size : limit;
+        h = fsAnalyzeHash(h, log->segments[i].data, n);
+        limit -= n;
+    }
+    return h;
+}
+
+/* splitmix64's finalizer: FNV's low bits alone are too regular to pick a
+ * sample with. */
+static uint64_t fsAnalyzeMix(uint64_t h) {
+    h ^= h >> 30;
+    h *= 0xBF58476D1CE4E5B9ULL;
+    h ^= h >> 27;
+    h *= 0x94D049BB133111EBULL;
+    h ^= h >> 31;
+    return h;
+}
+
+static void fsAnalyzeSampleFile(fsAnalysis *a, const fsInode *inode) {
+    uint64_t size = inode->payload.file.size;
+    if (size == 0) return;
+    uint64_t seed = fsAnalyzeHash(14695981039346656037ULL, (const char*)&size, sizeof(size));
+    uint64_t pick = fsAnalyzeHashContent(seed, inode, FS_ANALYZE_SAMPLE_PREFIX);
+    if (fsAnalyzeMix(pick) % FS_ANALYZE_SAMPLE_RATE) return;
+
+    if (a->nsamples == a->samplescap) {
+        a->samplescap = a->samplescap ? a->samplescap * 2 : 64;
+        a->samples = RedisModule_Realloc(a->samples, sizeof(*a->samples) * a->samplescap);
+    }
+    fsAnalyzeSample *s = &a->samples[a->nsamples++];
+    s->hash = fsAnalyzeMix(fsAnalyzeHashContent(seed, inode, SIZE_MAX));
+    s->size = size;
+    a->hashed_bytes += size;
+}
+
+static void fsAnalyzeExtensionAdd(fsAnalysis *a, const char *path, size_t pathlen,
+                                  uint64_t size) {
+    size_t base = pathlen;
+    while (base > 0 && path[base - 1] != '/') base--;
+    size_t dot = pathlen;
+    while (dot > base && path[dot - 1] != '.') dot--;
+    // No dot, a leading dot only (".bashrc"), or a suffix too long to be
+    // an extension: count the file under "".
+    const char *ext = "";
+    size_t extlen = 0;
+    if (dot > base + 1 && pathlen - dot <= FS_ANALYZE_MAX_EXTENSION) {
+        ext = path + dot;
+        extlen = pathlen - dot;
+    }
+
+    int nokey;
+    fsAnalyzeExtension *e = RedisModule_DictGetC(a->extensions, (void*)ext, extlen, &nokey);
+    if (nokey) {
+        e = RedisModule_Calloc(1, sizeof(*e));
+        memcpy(e->ext, ext, extlen);
+        e->len = extlen;
+        RedisModule_DictSetC(a->extensions, (void*)ext, extlen, e);
+    }
+    e->files++;
+    e->bytes += size;
+}
+
+void fsAnalysisAdd(fsAnalysis *a, const char *path, size_t pathlen, const fsInode *inode) {
+    a->inodes++;
+    a->path_bytes += pathlen;
+    a->pathlens[fsAnalyzeBucket(pathlen)]++;
+    size_t depth = 0;
+    if (pathlen > 1)
+        for (size_t i = 0; i < pathlen; i++) depth += path[i] == '/';
+    a->depths[depth <= FS_MAX_PATH_DEPTH ? depth : FS_MAX_PATH_DEPTH]++;
+
+    a->mem_metadata += sizeof(fsInode) + 64;   // As FSMemUsage counts a dict entry
+    a->mem_paths += pathlen + 1;
+
+    switch (inode->type) {
+    case FS_INODE_FILE: {
+        uint64_t size = inode->payload.file.size;
+        const fsLog *log = inode->payload.file.log;
+        a->files++;
+        a->file_bytes += size;
+        a->sizes[fsAnalyzeBucket(size)]++;
+        fsAnalyzeExtensionAdd(a, path, pathlen, size);
+        fsAnalyzeSampleFile(a, inode);
+        if (log) {
+            // A log's blooms are per segment; take their average.
+            int fill = 0;
+            for (size_t i = 0; i < log->count; i++)
+                fill += fsAnalyzeBloomFill(log->segments[i].bloom);
+            a->bloomfill[log->count ? (fill + (int)log->count - 1) / (int)log->count : 0]++;
+            a->mem_metadata += sizeof(fsLog) + log->capacity * sizeof(fsLogSegment);
+            for (size_t i = 0; i < log->count; i++) a->mem_content += log->segments[i].capacity;
+        } else {
+            a->bloomfill[fsAnalyzeBloomFill(inode->payload.file.bloom)]++;
+            a->mem_content += size;
+        }
+        break;
+    }
+    case FS_INODE_DIR:
+        a->dirs++;
+        a->fanout[fsAnalyzeBucket(inode->payload.dir.count)]++;
+        a->mem_metadata += inode->payload.dir.capacity * sizeof(fsDirent);
+        for (size_t i = 0; i < inode->payload.dir.count; i++)
+            a->mem_paths += strlen(inode->payload.dir.children[i].name) + 1;
+        break;
+    case FS_INODE_SYMLINK:
+        a->symlinks++;
+        if (inode->payload.symlink.target)
+            a->mem_paths += strlen(inode->payload.symlink.target) + 1;
+        break;
+    }
+}
+
+/* ===================================================================
+ * Reply
+ * =================================================================== */
+
+/* A histogram: bucket i is named i * step, or by its power of two when
+ * step is 0. */
+static void fsAnalyzeReplyBuckets(RedisModuleCtx *ctx, const uint64_t *counts, int n,
+                                  uint64_t step) {
+    long len = 0;
+    RedisModule_ReplyWithArray(ctx, REDISMODULE_POSTPONED_LEN);
+    for (int i = 0; i < n; i++) {
+        if (!counts[i]) continue;
+        uint64_t label = step ? (uint64_t)i * step : fsAnalyzeBucketLabel(i);
+        RedisModule_ReplyWithLongLong(ctx, (long long)label);
+        RedisModule_ReplyWithLongLong(ctx, (long long)counts[i]);
+        len += 2;
+    }
+    RedisModule_ReplySetArrayLength(ctx, len);
+}
+
+/* Most bytes first. */
+static int fsAnalyzeExtCompare(const void *a, const void *b) {
+    const fsAnalyzeExtension *x = *(fsAnalyzeExtension *const *)a;
+    const fsAnalyzeExtension *y = *(fsAnalyzeExtension *const *)b;
+    if (x->bytes != y->bytes) return x->bytes < y->bytes ? 1 : -1;
+    int c = memcmp(x->ext, y->ext, x->len < y->len ? x->len : y->len);
+    return c ? c : (x->len > y->len) - (x->len < y->len);
+}
+
+static void fsAnalyzeReplyExtensions(RedisModuleCtx *ctx, fsAnalysis *a) {
+    size_t n = RedisModule_DictSize(a->extensions);
+    fsAnalyzeExtension **rows = n ? RedisModule_Alloc(sizeof(*rows) * n) : NULL;
+    RedisModuleDictIter *iter = RedisModule_DictIteratorStartC(a->extensions, "^", NULL, 0);
+    size_t i = 0;
+    fsAnalyzeExtension *e;
+    while (RedisModule_DictNextC(iter, NULL, (void**)&e) != NULL) rows[i++] = e;
+    RedisModule_DictIteratorStop(iter);
+    if (n > 1) qsort(rows, n, sizeof(*rows), fsAnalyzeExtCompare);
+    RedisModule_ReplyWithArray(ctx, n * 3);
+    for (i = 0; i < n; i++) {
+        RedisModule_ReplyWithStringBuffer(ctx, rows[i]->ext, rows[i]->len);
+        RedisModule_ReplyWithLongLong(ctx, (long long)rows[i]->files);
+        RedisModule_ReplyWithLongLong(ctx, (long long)rows[i]->bytes);
+    }
+    if (rows) RedisModule_Free(rows);
+}
+
+static int fsAnalyzeSampleCompare(const void *a, const void *b) {
+    const fsAnalyzeSample *x = a, *y = b;
+    if (x->hash != y->hash) return x->hash < y->hash ? -1 : 1;
+    return (x->size > y->size) - (x->size < y->size);
+}
+
+void fsAnalysisReply(RedisModuleCtx *ctx, fsAnalysis *a, uint64_t indexbytes) {
+    // Every copy of a content after the first is a duplicate.
+    if (a->nsamples > 1) qsort(a->samples, a->nsamples, sizeof(*a->samples), fsAnalyzeSampleCompare);
+    uint64_t dupfiles = 0, dupbytes = 0;
+    for (size_t i = 1; i < a->nsamples; i++) {
+        if (fsAnalyzeSampleCompare(&a->samples[i], &a->samples[i - 1]) == 0) {
+            dupfiles++;
+            dupbytes += a->samples[i].size;
+        }
+    }
+
+    RedisModule_ReplyWithArray(ctx, 34);
+    RedisModule_ReplyWithCString(ctx, "inodes");
+    RedisModule_ReplyWithLongLong(ctx, (long long)a->inodes);
+    RedisModule_ReplyWithCString(ctx, "files");
+    RedisModule_ReplyWithLongLong(ctx, (long long)a->files);
+    RedisModule_ReplyWithCString(ctx, "directories");
+    RedisModule_ReplyWithLongLong(ctx, (long long)a->dirs);
+    RedisModule_ReplyWithCString(ctx, "symlinks");
+    RedisModule_ReplyWithLongLong(ctx, (long long)a->symlinks);
+    RedisModule_ReplyWithCString(ctx, "file_bytes");
+    RedisModule_ReplyWithLongLong(ctx, (long long)a->file_bytes);
+    RedisModule_ReplyWithCString(ctx, "path_bytes");
+    RedisModule_ReplyWithLongLong(ctx, (long long)a->path_bytes);
+
+    RedisModule_ReplyWithCString(ctx, "file_sizes");
+    fsAnalyzeReplyBuckets(ctx, a->sizes, FS_ANALYZE_LOG2_BUCKETS, 0);
+    RedisModule_ReplyWithCString(ctx, "dir_fanout");
+    fsAnalyzeReplyBuckets(ctx, a->fanout, FS_ANALYZE_LOG2_BUCKETS, 0);
+    RedisModule_ReplyWithCString(ctx, "path_lengths");
+    fsAnalyzeReplyBuckets(ctx, a->pathlens, FS_ANALYZE_LOG2_BUCKETS, 0);
+    RedisModule_ReplyWithCString(ctx, "depths");
+    fsAnalyzeReplyBuckets(ctx, a->depths, FS_MAX_PATH_DEPTH + 1, 1);
+    RedisModule_ReplyWithCString(ctx, "bloom_fill");
+    fsAnalyzeReplyBuckets(ctx, a->bloomfill, 11, 10);
+
+    RedisModule_ReplyWithCString(ctx, "extensions");
+    fsAnalyzeReplyExtensions(ctx, a);
+
+    RedisModule_ReplyWithCString(ctx, "sampled_files");
+    RedisModule_ReplyWithLongLong(ctx, (long long)a->nsamples);
+    RedisModule_ReplyWithCString(ctx, "duplicate_files");
+    RedisModule_ReplyWithLongLong(ctx, (long long)(dupfiles * FS_ANALYZE_SAMPLE_RATE));
+    RedisModule_ReplyWithCString(ctx, "duplicate_bytes");
+    RedisModule_ReplyWithLongLong(ctx, (long long)(dupbytes * FS_ANALYZE_SAMPLE_RATE));
+    RedisModule_ReplyWithCString(ctx, "samples");
+    RedisModule_ReplyWithArray(ctx, a->nsamples * 2);
+    for (size_t i = 0; i < a->nsamples; i++) {
+        char hex[17];
+        snprintf(hex, sizeof(hex), "%016llx", (unsigned long long)a->samples[i].hash);
+        RedisModule_ReplyWithStringBuffer(ctx, hex, 16);
+        RedisModule_ReplyWithLongLong(ctx, (long long)a->samples[i].size);
+    }
+
+    RedisModule_ReplyWithCString(ctx, "memory");
+    RedisModule_ReplyWithArray(ctx, 8);
+    RedisModule_ReplyWithCString(ctx, "metadata");
+    RedisModule_ReplyWithLongLong(ctx, (long long)a->mem_metadata);
+    RedisModule_ReplyWithCString(ctx, "paths");
+    RedisModule_ReplyWithLongLong(ctx, (long long)a->mem_paths);
+    RedisModule_ReplyWithCString(ctx, "content");
+    RedisModule_ReplyWithLongLong(ctx, (long long)a->mem_content);
+    RedisModule_ReplyWithCString(ctx, "indexes");
+    RedisModule_ReplyWithLongLong(ctx, (long long)indexbytes);
+}
@@ -0,0 +1,72 @@
+/*
+ * analyze.h - Data-shape statistics for FS.ANALYZE.
+ *
+ * An fsAnalysis accumulates what a walk over part of a key saw: size,
+ * fan-out, path length and depth histograms, how full the files' bloom
+ * filters are, bytes per file extension, content hashes of a sample of
+ * files, and the memory the inodes take. Every figure but the duplicate
+ * estimate is a count or a sum, so the replies for consecutive pages of a
+ * walk merge by adding them up, which is how clients build the picture of
+ * a large key a page at a time. The duplicate estimate only sees copies
+ * within one page; clients recompute it from the pages' samples together.
+ *
+ * Histograms are replied as flat [bucket, count, ...] arrays, empty
+ * buckets left out. Sizes, fan-outs and path lengths go in power-of-two
+ * buckets named by their upper bound: bucket 64 holds values 33..64, and
+ * bucket 0 holds zero. Depths are exact. Bloom fill is in tenths: bucket
+ * 30 holds filters with 21-30% of their bits set.
+ *
+ * Duplicate content is estimated from one file in FS_ANALYZE_SAMPLE_RATE,
+ * picked by a hash of its size and first bytes. Identical files are
+ * always picked together, so the duplicates among the sample, scaled up,
+ * estimate those in the whole key, while only the picked files are hashed
+ * in full.
+ */
+
+#ifndef REDIS_FS_ANALYZE_H
+#define REDIS_FS_ANALYZE_H
+
+#include "fs.h"
+
+#define FS_ANALYZE_SAMPLE_RATE     16
+#define FS_ANALYZE_SAMPLE_PREFIX   64      /* Bytes hashed to pick the sample */
+#define FS_ANALYZE_MAX_EXTENSION   16      /* Longer suffixes count as none */
+#define FS_ANALYZE_DEFAULT_COUNT   10000   /* Inodes per page */
+#define FS_ANALYZE_LOG2_BUCKETS    65
+
+typedef struct fsAnalyzeSample {
+    uint64_t hash;
+    uint64_t size;
+} fsAnalyzeSample;
+
+typedef struct fsAnalysis {
+    uint64_t inodes, files, dirs, symlinks;
+    uint64_t file_bytes, path_bytes;
+    uint64_t sizes[FS_ANALYZE_LOG2_BUCKETS];
+    uint64_t fanout[FS_ANALYZE_LOG2_BUCKETS];
+    uint64_t pathlens[FS_ANALYZE_LOG2_BUCKETS];
+    uint64_t depths[FS_MAX_PATH_DEPTH + 1];
+    uint64_t bloomfill[11];
+    RedisModuleDict *extensions;    /* extension → fsAnalyzeExtension* */
+    fsAnalyzeSample *samples;
+    size_t nsamples, samplescap;
+    uint64_t hashed_bytes;          /* Content read to hash the sample */
+    /* Memory taken by the inodes seen. */
+    uint64_t mem_metadata;          /* Inode structs, dict entries, child arrays */
+    uint64_t mem_paths;             /* Dict keys, child names, symlink targets */
+    uint64_t mem_content;           /* File content */
+} fsAnalysis;
+
+void fsAnalysisInit(fsAnalysis *a);
+void fsAnalysisFree(fsAnalysis *a);
+
+/* Account for the inode at path. */
+void fsAnalysisAdd(fsAnalysis *a, const char *path, size_t pathlen, const fsInode *inode);
+
+/* Reply with the statistics as a flat [name, value, ...] map. indexbytes
+ * is the memory of the key's indexes and side tables, which belong to no
+ * inode; callers pass it for the first page of a walk only, so a merged
+ * walk counts it once. */
+void fsAnalysisReply(RedisModuleCtx *ctx, fsAnalysis *a, uint64_t indexbytes);
+
+#endif /* REDIS_FS_ANALYZE_H */
@@ -0,0 +1,290 @@
+/*
+ * columns.c - Metadata columns for predicate FS.FIND.
+ *
+ * Layout: one array per field, all indexed by slot. Slot 0 is never handed
+ * out, so a zero fsInode.slot means "not in the table" and a zero parent
+ * means "no parent" (the root). Freed slots keep FS_COLUMNS_FREE as their
+ * type, which no query accepts, and go on a free list for reuse; the
+ * arrays never shrink.
+ *
+ * The scan loop is written without branches on the data — each slot's
+ * verdict is computed with & and appended by bumping the output index —
+ * so it runs at memory speed over the arrays it reads, and compilers can
+ * vectorize the comparisons.
+ */
+
+#include "columns.h"
+#include <string.h>
+
+#define FS_COLUMNS_FREE   7         /* type of an unused slot */
+#define FS_COLUMNS_BLOCK  4096      /* Slots scanned per output reservation */
+
+struct fsColumns {
+    /* Columns, cap entries each. */
+    uint8_t *type;
+    uint8_t *stale;
+    uint32_t *uid;
+    uint32_t *parent;
+    uint64_t *size;
+    int64_t *mtime;
+    char **name;
+    fsInode **inode;
+    uint32_t n;                 /* Slots handed out so far, slot 0 included */
+    uint32_t cap;
+
+    uint32_t *free;             /* Slots to reuse */
+    uint32_t nfree, freecap;
+    uint32_t *dirty;            /* Stale slots */
+    uint32_t ndirty, dirtycap;
+    uint64_t count;             /* Slots in use */
+    size_t namebytes;
+};
+
+/* Bytes per slot across all columns. */
+#define FS_COLUMNS_ROW (2 * sizeof(uint8_t) + 2 * sizeof(uint32_t) + \
+                        sizeof(uint64_t) + sizeof(int64_t) + \
+                        sizeof(char*) + sizeof(fsInode*))
+
+void fsColumnsQueryInit(fsColumnsQuery *q) {
+    q->types = (1 << FS_INODE_FILE) | (1 << FS_INODE_DIR) | (1 << FS_INODE_SYMLINK);
+    q->minsize = 0;
+    q->maxsize = UINT64_MAX;
+    q->minmtime = INT64_MIN;
+    q->maxmtime = INT64_MAX;
+    q->uid = -1;
+}
+
+/* ===================================================================
+ * Lifecycle
+ * =================================================================== */
+
+static void fsColumnsGrow(fsColumns *cols) {
+    uint32_t cap = cols->cap ? cols->cap * 2 : 64;
+    cols->type = RedisModule_Realloc(cols->type, cap * sizeof(*cols->type));
+    cols->stale = RedisModule_Realloc(cols->stale, cap * sizeof(*cols->stale));
+    cols->uid = RedisModule_Realloc(cols->uid, cap * sizeof(*cols->uid));
+    cols->parent = RedisModule_Realloc(cols->parent, cap * sizeof(*cols->parent));
+    cols->size = RedisModule_Realloc(cols->size, cap * sizeof(*cols->size));
+    cols->mtime = RedisModule_Realloc(cols->mtime, cap * sizeof(*cols->mtime));
+    cols->name = RedisModule_Realloc(cols->name, cap * sizeof(*cols->name));
+    cols->inode = RedisModule_Realloc(cols->inode, cap * sizeof(*cols->inode));
+    if (cols->cap == 0) {
+        // Slot 0 is a permanently free placeholder.
+        cols->type[0] = FS_COLUMNS_FREE;
+        cols->stale[0] = 0;
+        cols->name[0] = NULL;
+        cols->inode[0] = NULL;
+    }
+    cols->cap = cap;
+}
+
+fsColumns *fsColumnsCreate(void) {
+    fsColumns *cols = RedisModule_Calloc(1, sizeof(*cols));
+    fsColumnsGrow(cols);
+    cols->n = 1;
+    return cols;
+}
+
+void fsColumnsFree(fsColumns *cols) {
+    if (!cols) return;
+    for (uint32_t i = 1; i < cols->n; i++)
+        if (cols->name[i]) RedisModule_Free(cols->name[i]);
+    RedisModule_Free(cols->type);
+    RedisModule_Free(cols->stale);
+    RedisModule_Free(cols->uid);
+    RedisModule_Free(cols->parent);
+    RedisModule_Free(cols->size);
+    RedisModule_Free(cols->mtime);
+    RedisModule_Free(cols->name);
+    RedisModule_Free(cols->inode);
+    RedisModule_Free(cols->free);
+    RedisModule_Free(cols->dirty);
+    RedisModule_Free(cols);
+}
+
+/* ===================================================================
+ * Maintenance
+ * =================================================================== */
+
+static void fsColumnsPush(uint32_t **list, uint32_t *len, uint32_t *cap, uint32_t slot) {
+    if (*len == *cap) {
+        *cap = *cap ? *cap * 2 : 16;
+        *list = RedisModule_Realloc(*list, *cap * sizeof(**list));
+    }
+    (*list)[(*len)++] = slot;
+}
+
+static void fsColumnsSetName(fsColumns *cols, uint32_t slot, const char *name, size_t namelen) {
+    if (cols->name[slot]) cols->namebytes -= strlen(cols->name[slot]) + 1;
+    cols->name[slot] = RedisModule_Realloc(cols->name[slot], namelen + 1);
+    memcpy(cols->name[slot], name, namelen);
+    cols->name[slot][namelen] = '\0';
+    cols->namebytes += namelen + 1;
+}
+
+void fsColumnsTouch(fsColumns *cols, fsInode *inode) {
+    uint32_t slot = inode->slot;
+    if (!slot || cols->stale[slot]) return;
+    cols->stale[slot] = 1;
+    fsColumnsPush(&cols->dirty, &cols->ndirty, &cols->dirtycap, slot);
+}
+
+void fsColumnsAdd(fsColumns *cols, fsInode *inode, const fsInode *parent,
+                  const char *name, size_t namelen) {
+    uint32_t slot = inode->slot;
+    if (slot && cols->inode[slot] == inode) {
+        fsColumnsMove(cols, inode, parent, name, namelen);
+        fsColumnsTouch(cols, inode);
+        return;
+    }
+    if (cols->nfree) {
+        slot = cols->free[--cols->nfree];
+    } else {
+        if (cols->n == cols->cap) fsColumnsGrow(cols);
+        slot = cols->n++;
+        cols->stale[slot] = 0;
+        cols->name[slot] = NULL;
+    }
+    inode->slot = slot;
+    cols->inode[slot] = inode;
+    cols->type[slot] = inode->type;
+    cols->parent[slot] = parent ? parent->slot : 0;
+    cols->uid[slot] = 0;
+    cols->size[slot] = 0;
+    cols->mtime[slot] = 0;
+    fsColumnsSetName(cols, slot, name, namelen);
+    cols->count++;
+    fsColumnsTouch(cols, inode);
+}
+
+void fsColumnsRemove(fsColumns *cols, fsInode *inode) {
+    uint32_t slot = inode->slot;
+    if (!slot || cols->inode[slot] != inode) return;
+    // A stale flag stays set (and the slot on the dirty list) until the
+    // next refresh, which skips free slots.
+    cols->type[slot] = FS_COLUMNS_FREE;
+    cols->inode[slot] = NULL;
+    cols->namebytes -= strlen(cols->name[slot]) + 1;
+    RedisModule_Free(cols->name[slot]);
+    cols->name[slot] = NULL;
+    inode->slot = 0;
+    cols->count--;
+    fsColumnsPush(&cols->free, &cols->nfree, &cols->freecap, slot);
+}
+
+void fsColumnsMove(fsColumns *cols, fsInode *inode, const fsInode *parent,
+                   const char *name, size_t namelen) {
+    uint32_t slot = inode->slot;
+    if (!slot || cols->inode[slot] != inode) return;
+    if (parent) cols->parent[slot] = parent->slot;
+    fsColumnsSetName(cols, slot, name, namelen);
+}
+
+/* Copy every stale slot's fields from its inode. */
+static void fsColumnsRefresh(fsColumns *cols) {
+    for (uint32_t i = 0; i < cols->ndirty; i++) {
+        uint32_t slot = cols->dirty[i];
+        cols->stale[slot] = 0;
+        const fsInode *inode = cols->inode[slot];
+        if (!inode) continue;
+        cols->uid[slot] = inode->uid;
+        cols->mtime[slot] = inode->mtime;
+        switch (inode->type) {
+        case FS_INODE_FILE: cols->size[slot] = inode->payload.file.size; break;
+        case FS_INODE_DIR:  cols->size[slot] = inode->payload.dir.count; break;
+        default:            cols->size[slot] = 0; break;
+        }
+    }
+    cols->ndirty = 0;
+}
+
+/* ===================================================================
+ * Queries
+ * =================================================================== */
+
+size_t fsColumnsScan(fsColumns *cols, const fsColumnsQuery *q, uint32_t within,
+                     uint32_t **slots) {
+    fsColumnsRefresh(cols);
+
+    const uint8_t *type = cols->type;
+    const uint32_t *uid = cols->uid;
+    const uint64_t *size = cols->size;
+    const int64_t *mtime = cols->mtime;
+    const uint64_t minsize = q->minsize, maxsize = q->maxsize;
+    const int64_t minmtime = q->minmtime, maxmtime = q->maxmtime;
+    const uint32_t types = q->types;
+    const int anyuid = q->uid < 0;
+    const uint32_t wantuid = anyuid ? 0 : (uint32_t)q->uid;
+
+    uint32_t *out = NULL;
+    size_t count = 0, cap = 0;
+    for (uint32_t start = 1; start < cols->n; start += FS_COLUMNS_BLOCK) {
+        uint32_t end = start + FS_COLUMNS_BLOCK;
+        if (end > cols->n || end < start) end = cols->n;
+        if (count + (end - start) > cap) {
+            cap = (count + (end - start)) * 2;
+            out = RedisModule_Realloc(out, cap * sizeof(*out));
+        }
+        for (uint32_t i = start; i < end; i++) {
+            int hit = ((types >> type[i]) & 1) &
+                      (size[i] >= minsize) & (size[i] <= maxsize) &
+                      (mtime[i] >= minmtime) & (mtime[i] <= maxmtime) &
+                      (anyuid | (uid[i] == wantuid));
+            out[count] = i;
+            count += hit;
+        }
+    }
+
+    if (within) {
+        // Keep the hits at or below within, walking up the parent column.
+        const uint32_t *parent = cols->parent;
+        size_t kept = 0;
+        for (size_t i = 0; i < count; i++) {
+            uint32_t s = out[i];
+            while (s && s != within) s = parent[s];
+            if (s) out[kept++] = out[i];
+        }
+        count = kept;
+    }
+    *slots = out;
+    return count;
+}
+
+const char *fsColumnsName(const fsColumns *cols, uint32_t slot) {
+    return cols->name[slot];
+}
+
+char *fsColumnsPath(const fsColumns *cols, uint32_t slot, size_t *len) {
+    // Length first, then fill in from the end.
+    size_t total = 0;
+    for (uint32_t s = slot; cols->parent[s]; s = cols->parent[s])
+        total += 1 + strlen(cols->name[s]);
+    if (total == 0) {
+        char *root = RedisModule_Alloc(2);
+        root[0] = '/';
+        root[1] = '\0';
+        *len = 1;
+        return root;
+    }
+    char *path = RedisModule_Alloc(total + 1);
+    path[total] = '\0';
+    size_t pos = total;
+    for (uint32_t s = slot; cols->parent[s]; s = cols->parent[s]) {
+        size_t nlen = strlen(cols->name[s]);
+        pos -= nlen;
+        memcpy(path + pos, cols->name[s], nlen);
+        path[--pos] = '/';
+    }
+    *len = total;
+    return path;
+}
+
+uint64_t fsColumnsCount(const fsColumns *cols) {
+    return cols ? cols->count : 0;
+}
+
+size_t fsColumnsMemUsage(const fsColumns *cols) {
+    if (!cols) return 0;
+    return sizeof(*cols) + (size_t)cols->cap * FS_COLUMNS_ROW + cols->namebytes +
+           ((size_t)cols->freecap + cols->dirtycap) * sizeof(uint32_t);
+}
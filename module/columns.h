@@ -0,0 +1,76 @@
+/*
+ * columns.h - Metadata columns for predicate FS.FIND.
+ *
+ * An optional per-key side table holding the metadata that predicate
+ * scans filter on — type, size, mtime, uid and parent — as one contiguous
+ * array per field, indexed by the inode's slot (fsInode.slot). A scan
+ * such as "files over 1MB modified since T" then reads a few bytes per
+ * inode from dense arrays instead of chasing a pointer to every fsInode.
+ *
+ * It is created by the first predicate FS.FIND on a key and kept up to
+ * date from then on. Like the word index, a write only marks the slot
+ * stale; the next scan copies the stale slots' fields from their inodes
+ * first, so the fs.c helpers don't have to care whether they bump an
+ * inode before or after changing it.
+ */
+
+#ifndef REDIS_FS_COLUMNS_H
+#define REDIS_FS_COLUMNS_H
+
+#include "fs.h"
+
+typedef struct fsColumns fsColumns;
+
+/* A predicate scan. Every field must match; the defaults from
+ * fsColumnsQueryInit match everything. */
+typedef struct fsColumnsQuery {
+    uint8_t types;          /* Bit (1 << FS_INODE_*) per accepted type */
+    uint64_t minsize, maxsize;      /* Inclusive; dir size = entries */
+    int64_t minmtime, maxmtime;     /* Inclusive */
+    int64_t uid;            /* -1 = any */
+} fsColumnsQuery;
+
+void fsColumnsQueryInit(fsColumnsQuery *q);
+
+/* ---- Lifecycle ---- */
+
+fsColumns *fsColumnsCreate(void);
+void fsColumnsFree(fsColumns *cols);
+
+/* ---- Maintenance (called from the fs.c mutation helpers) ---- */
+
+/* Give inode a slot, under parent (NULL for the root). name is its
+ * basename. */
+void fsColumnsAdd(fsColumns *cols, fsInode *inode, const fsInode *parent,
+                  const char *name, size_t namelen);
+
+/* An inode left the filesystem. Its slot is reused. */
+void fsColumnsRemove(fsColumns *cols, fsInode *inode);
+
+/* An inode was renamed to name, under parent if given. A NULL parent
+ * leaves the parent as it was. */
+void fsColumnsMove(fsColumns *cols, fsInode *inode, const fsInode *parent,
+                   const char *name, size_t namelen);
+
+/* An inode may have changed. O(1): the slot is marked stale. */
+void fsColumnsTouch(fsColumns *cols, fsInode *inode);
+
+/* ---- Queries ---- */
+
+/* Slots whose metadata matches q, in slot order, that are within (or
+ * below) the slot within; 0 means the whole key. Returns the count and
+ * sets *slots, which the caller frees. Stale slots are refreshed first. */
+size_t fsColumnsScan(fsColumns *cols, const fsColumnsQuery *q, uint32_t within,
+                     uint32_t **slots);
+
+/* A slot's basename ("/" for the root). */
+const char *fsColumnsName(const fsColumns *cols, uint32_t slot);
+
+/* A slot's full path, rebuilt from its parents. Caller frees. */
+char *fsColumnsPath(const fsColumns *cols, uint32_t slot, size_t *len);
+
+/* Slots in use, and bytes used by the columns. */
+uint64_t fsColumnsCount(const fsColumns *cols);
+size_t fsColumnsMemUsage(const fsColumns *cols);
+
+#endif /* REDIS_FS_COLUMNS_H */
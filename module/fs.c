@@ -15,11 +15,13 @@
  * of nested directory structures. The benefit is O(1) path lookups: reading
  * a file six directories deep is a single dict lookup, not a six-hop
  * directory traversal. The tradeoff is that directory listings require the
- * directory inode to maintain an array of child basenames.
+ * directory inode to keep its own entry list: an array of fsDirent, each
+ * a child's basename plus a pointer to the child inode, so listings and
+ * recursive walks reach children without going back through the dict.
  *
  * Each inode stores its type (file, directory, or symlink), POSIX metadata
  * (mode, uid, gid, ctime/mtime/atime), and a type-specific payload: inline
- * file content for files, a child-name array for directories, or a target
+ * file content for files, the fsDirent array for directories, or a target
  * string for symlinks.
  *
  * ========================== Key lifecycle =================================
@@ -38,23 +40,154 @@
  * bigrams because they have far lower collision rates in typical text,
  * giving a useful false-positive rate even at 256 bytes per file.
  * The bloom is a derived cache — it is rebuilt on write and on RDB load,
- * never persisted.
+ * never persisted. Range edits (FS.SPLICE and the line-editing commands
+ * built on it) only add the trigrams around what changed, so the bloom
+ * may drift towards more false positives until the next full rebuild.
  *
  * ========================== Symlink resolution ============================
  *
  * Symlinks are resolved lazily at read time. The target string is stored
  * as-is (absolute or relative) and resolved by fsResolvePath(), which
- * follows chains up to 40 levels deep. Cycles are detected by the depth
- * limit — we don't track visited nodes, we just cap the iteration count.
- * This is the same approach POSIX uses.
+ * follows symlinks in any component of the path, not just the last, up to
+ * 40 hops in all. Cycles are detected by the hop limit — we don't track
+ * visited nodes, we just cap the iteration count. This is the same
+ * approach POSIX uses.
+ *
+ * A path that exists as it is needs no resolving: every ancestor of a
+ * dict entry is a real directory. Others are resolved a component at a
+ * time, and those that went through a symlink are cached per key. The
+ * result depends only on where the symlinks are and what they point to,
+ * so each cache entry records the key's symlink generation, which
+ * fsInsert, fsRemove and fsRelocate bump whenever a symlink comes, goes
+ * or moves; an entry from an older generation is a miss. The common case
+ * — a build reading the same paths through symlinked directories again
+ * and again — is one dict probe.
+ *
+ * ========================== Replication ==================================
+ *
+ * Commands are replicated verbatim, except the line-editing commands
+ * (FS.REPLACE, FS.INSERT, FS.DELETELINES), whose cost is in finding what
+ * to change. They replicate the resulting byte ranges as one FS.SPLICE on
+ * the resolved path, so replicas and the AOF apply an edit in time
+ * proportional to the change instead of re-running the scan.
+ *
+ * ========================== Mounts =======================================
+ *
+ * A filesystem can be split across keys (and so across cluster shards) by
+ * mounting another key at a directory: FS.MOUNT records "path → key" in
+ * this key's mount table and leaves an empty stub directory in place. Any
+ * command whose path argument falls at or below a mount point fails with
+ *
+ *     FSMOVED <target-key> <mount-point>
+ *
+ * and the client retries against the target key with the mount point
+ * stripped from its paths, much like a cluster MOVED redirect. Commands
+ * never follow mounts themselves: walks such as FS.FIND and FS.GREP stop
+ * at the stub, and clients fan out to the mounted keys (FS.MOUNTS lists
+ * them). Operations that would span keys — moving or copying across a
+ * mount boundary, or deleting a subtree that contains a mount — are
+ * refused rather than half-done. Symlinks resolve within their own key.
+ *
+ * ========================== Versions =====================================
+ *
+ * Every inode carries a version that changes whenever its content,
+ * metadata, or (for directories) its child list changes. Versions are
+ * handed out by a per-key clock, so they increase monotonically across
+ * the whole filesystem and a path that is deleted and recreated never
+ * reuses an old version. Writers pass IFVERSION to make a change
+ * conditional on the version they read, which gives lock-free
+ * read-modify-write at file granularity without WATCHing the whole key.
+ * Version 0 is never assigned and means "the path must not exist".
+ *
+ * ========================== Expiry ========================================
+ *
+ * Any path except the root can be given an absolute expiry time with
+ * FS.EXPIRE; when it passes, the path and its whole subtree are removed.
+ * Each key keeps an ordered index of (expire_at, path) pairs — a rax
+ * keyed by the big-endian timestamp followed by the path — so the next
+ * path to expire is always the first entry. A global registry lists the
+ * keys that have any expiring paths, and a 100ms timer walks it on the
+ * master, reclaiming a bounded number of inodes per tick. Small subtrees
+ * go in one FS.RM RECURSIVE; large ones are taken apart leaves-first over
+ * several ticks. Replicas never reclaim on their own: every deletion is
+ * replicated as an explicit FS.RM, exactly as if a client had issued it.
+ *
+ * ========================== Search index ==================================
+ *
+ * FS.SEARCH ranks files with BM25 over an inverted word index (index.c).
+ * The index is optional per key: the first search builds it, and from
+ * then on the mutation helpers (fsInsert, fsRemove, fsRelocate and
+ * fsInodeBump) keep it in sync. A content change only marks the file
+ * stale; the next search re-tokenizes stale files before scoring. Like
+ * the bloom filter the index is derived data — RDB records only whether
+ * the key had one, and it is rebuilt on load.
+ *
+ * ========================== Metadata columns ==============================
+ *
+ * Predicate FS.FIND (size, mtime, uid) scans a per-key structure-of-arrays
+ * table (columns.c) rather than the inodes: each inode has a slot, and
+ * its type, size, mtime, uid, parent slot and basename sit at that index
+ * in one array per field. Like the search index it is created by the
+ * first query that needs it, kept in sync by the same mutation helpers
+ * (with writes only marking slots stale), and never saved in RDB. Paths
+ * are rebuilt from the parent and name columns for matches only.
+ *
+ * ========================== Hot files =====================================
+ *
+ * Each inode has logarithmic read and write counters with decay, the
+ * scheme Redis uses for LFU eviction (hot.c): 8 bits each, bumped with
+ * falling probability as they grow, so counting costs a random number
+ * and a compare. Content reads and writes of files count; metadata
+ * commands and scans (FS.GREP, FS.FIND) don't. FS.HOT answers from
+ * per-key pools of the hottest candidates, which a file enters only when
+ * its counter goes up, instead of ranking every inode. fsRemove and
+ * fsRelocate keep the pools' paths current. Nothing here is saved in RDB.
+ *
+ * ========================== Chunked uploads ===============================
+ *
+ * Files larger than one bulk string are written through an upload session
+ * (FS.OPEN, FS.WRITECHUNK, FS.COMMIT). Sessions live beside the inode dict,
+ * not in it, so a partial upload is never visible at its path. Idle
+ * sessions are reclaimed by the same timer as expiring paths.
+ *
+ * ========================== Log files =====================================
+ *
+ * FS.LOG turns a file into a log: its content becomes a list of segments
+ * (log.c), each with its own bloom filter and line count, appended to at
+ * the end and dropped whole from the front by retention. Logs are still
+ * files to every reader; commands that need the content in one piece get
+ * a copy (fsFileBytes), while FS.APPEND, FS.TAIL, FS.GREP and
+ * FS.READCHUNK work segment by segment. Edits in the middle of a log are
+ * refused. Size retention replays identically on replicas, since segment
+ * boundaries depend only on the appends; age retention is decided on the
+ * master and replicated as FS.LOG ... DROP n, like expiry.
+ *
+ * ========================== Read views ====================================
+ *
+ * A background scan works on a read view (view.c): the paths of the files
+ * it will read and the content buffers they had when it started, pinned.
+ * Writers never edit, reallocate or free a pinned buffer in place; the
+ * buffer helpers (fsBufferRealloc, fsBufferUnshare, fsBufferFree) move the
+ * file to a private copy instead and leave the old buffer to the view,
+ * which frees it on release. So a scanning thread reads without the module
+ * lock, and a write costs at most one copy of the file it touches, however
+ * long the scan runs. Unpaged FS.GREP over large content uses this.
  */
 
 #include "fs.h"
 #include "path.h"
+#include "index.h"
+#include "log.h"
+#include "watch.h"
+#include "view.h"
+#include "columns.h"
+#include "hot.h"
+#include "analyze.h"
 #include <string.h>
 #include <stdlib.h>
 #include <ctype.h>
 #include <errno.h>
+#include <pthread.h>
 
 // Module type handle.
 RedisModuleType *FSType = NULL;
@@ -63,17 +196,10 @@ RedisModuleType *FSType = NULL;
  * Forward declarations
  * =================================================================== */
 static int fsDeleteRecursive(fsObject *fs, const char *path, size_t pathlen);
-static int fsCopyRecursive(fsObject *fs, const char *src, size_t srclen,
-                           const char *dst, size_t dstlen);
-static void fsTreeReply(RedisModuleCtx *ctx, fsObject *fs,
-                        const char *path, size_t pathlen,
-                        int depth, int maxdepth);
-static void fsFindWalk(fsObject *fs, const char *path, size_t pathlen,
-                       const char *pattern, int typefilter,
-                       RedisModuleCtx *ctx, long *count);
-static void fsGrepWalk(fsObject *fs, const char *path, size_t pathlen,
-                       const char *pattern, int nocase,
-                       RedisModuleCtx *ctx, long *count);
+static fsInode *fsCopyRecursive(fsObject *fs, fsInode *sinode,
+                                const char *dst, size_t dstlen);
+static void fsExpireTrack(int dbid, const char *name, size_t namelen);
+static void fsResolveCacheFree(fsObject *fs);
 
 #define FS_RESOLVE_OK 0
 #define FS_RESOLVE_ERR_SYMLINK_LOOP 1
@@ -112,6 +238,88 @@ static int fsPathHasPrefix(const char *path, size_t pathlen,
     return pathlen == prefixlen || path[prefixlen] == '/';
 }
 
+/* Strip a trailing "IFVERSION <v>" pair from a write command's arguments.
+ * The pair is only recognized when at least minargs arguments remain, so
+ * content that happens to be the literal string "IFVERSION" still works.
+ * Sets *expected to -1 when the option is absent. Returns REDISMODULE_ERR
+ * (reply already sent) if the version is malformed. */
+static int fsParseIfVersion(RedisModuleCtx *ctx, RedisModuleString **argv,
+                            int *argc, int minargs, long long *expected) {
+    *expected = -1;
+    if (*argc - 2 < minargs) return REDISMODULE_OK;
+
+    const char *opt = RedisModule_StringPtrLen(argv[*argc - 2], NULL);
+    if (strcasecmp(opt, "IFVERSION")) return REDISMODULE_OK;
+
+    long long v;
+    if (RedisModule_StringToLongLong(argv[*argc - 1], &v) != REDISMODULE_OK || v < 0) {
+        RedisModule_ReplyWithError(ctx, "ERR IFVERSION must be a non-negative integer");
+        return REDISMODULE_ERR;
+    }
+    *expected = v;
+    *argc -= 2;
+    return REDISMODULE_OK;
+}
+
+/* Check an IFVERSION precondition. inode is NULL when the target does not
+ * exist, which only matches version 0. Returns 0 (reply already sent) on
+ * mismatch. This runs before any mutation, so a failed check is O(1). */
+static int fsCheckVersion(RedisModuleCtx *ctx, const fsInode *inode, long long expected) {
+    if (expected < 0) return 1;
+    uint64_t current = inode ? inode->version : 0;
+    if (current == (uint64_t)expected) return 1;
+    RedisModule_ReplyWithError(ctx, "ERR version mismatch");
+    return 0;
+}
+
+/* Replicate a write command. When an IFVERSION precondition was consumed,
+ * argc no longer includes it and we replicate the stripped command: the
+ * master already checked the precondition, replicas just apply the effect. */
+static void fsReplicateWrite(RedisModuleCtx *ctx, RedisModuleString **argv,
+                             int argc, long long expected) {
+    if (expected < 0) {
+        RedisModule_ReplicateVerbatim(ctx);
+        return;
+    }
+    RedisModule_Replicate(ctx, RedisModule_StringPtrLen(argv[0], NULL), "v",
+                          argv + 1, (size_t)(argc - 1));
+}
+
+/* Replicate an edit by its effect: FS.SPLICE on the resolved path, so
+ * replicas and the AOF apply the byte ranges instead of repeating the
+ * scan. Call after applying the splices: when there are more than
+ * FS_SPLICE_MAX_RANGES of them we send one span from the first edited
+ * byte to the last, copied out of the new content. */
+static void fsReplicateSplices(RedisModuleCtx *ctx, RedisModuleString *keyname,
+                               const char *path, const fsSplice *sp, size_t n,
+                               const fsInode *inode) {
+    if (n == 0) return;
+    fsSplice span;
+    if (n > FS_SPLICE_MAX_RANGES) {
+        long long delta = 0;
+        for (size_t i = 0; i < n; i++)
+            delta += (long long)sp[i].len - (long long)sp[i].del;
+        span.off = sp[0].off;
+        span.del = sp[n-1].off + sp[n-1].del - sp[0].off;
+        span.data = inode->payload.file.data + span.off;
+        span.len = (size_t)((long long)span.del + delta);
+        sp = &span;
+        n = 1;
+    }
+
+    size_t nargs = 2 + 3 * n;
+    RedisModuleString **args = RedisModule_Alloc(sizeof(*args) * nargs);
+    args[0] = keyname;
+    args[1] = RedisModule_CreateString(ctx, path, strlen(path));
+    for (size_t i = 0; i < n; i++) {
+        args[2 + 3*i] = RedisModule_CreateStringFromLongLong(ctx, (long long)sp[i].off);
+        args[3 + 3*i] = RedisModule_CreateStringFromLongLong(ctx, (long long)sp[i].del);
+        args[4 + 3*i] = RedisModule_CreateString(ctx, sp[i].len ? sp[i].data : "", sp[i].len);
+    }
+    RedisModule_Replicate(ctx, "FS.SPLICE", "v", args, nargs);
+    RedisModule_Free(args);
+}
+
 /* ===================================================================
  * Inode lifecycle
  * =================================================================== */
@@ -147,12 +355,12 @@ void fsInodeFree(fsInode *inode) {
     if (!inode) return;
     switch (inode->type) {
     case FS_INODE_FILE:
-        if (inode->payload.file.data)
-            RedisModule_Free(inode->payload.file.data);
+        fsBufferFree(inode->payload.file.data);
+        fsLogFree(inode->payload.file.log);
         break;
     case FS_INODE_DIR:
         for (size_t i = 0; i < inode->payload.dir.count; i++)
-            RedisModule_Free(inode->payload.dir.children[i]);
+            RedisModule_Free(inode->payload.dir.children[i].name);
         if (inode->payload.dir.children)
             RedisModule_Free(inode->payload.dir.children);
         break;
@@ -175,11 +383,33 @@ fsObject *fsObjectCreate(void) {
     fs->dir_count = 0;
     fs->symlink_count = 0;
     fs->total_data_size = 0;
+    fs->version_clock = 0;
+    fs->expires = NULL;
+    fs->mounts = NULL;
+    fs->index = NULL;
+    fs->uploads = NULL;
+    fs->upload_clock = 0;
+    fs->journal = NULL;
+    fs->columns = NULL;
+    fs->resolved = NULL;
+    fs->symlink_gen = 0;
+    fs->hot = NULL;
     return fs;
 }
 
+static void fsUploadFree(fsUpload *up) {
+    RedisModule_Free(up->path);
+    fsInodeFree(up->inode);
+    RedisModule_Free(up);
+}
+
 void fsObjectFree(fsObject *fs) {
     if (!fs) return;
+    fsIndexFree(fs->index);
+    fsJournalFree(fs->journal);
+    fsColumnsFree(fs->columns);
+    fsResolveCacheFree(fs);
+    fsHotFree(fs->hot);
 
     // Iterate and free all inodes.
     RedisModuleDictIter *iter = RedisModule_DictIteratorStartC(fs->inodes, "^", NULL, 0);
@@ -191,6 +421,23 @@ void fsObjectFree(fsObject *fs) {
     }
     RedisModule_DictIteratorStop(iter);
     RedisModule_FreeDict(NULL, fs->inodes);
+    if (fs->expires) RedisModule_FreeDict(NULL, fs->expires);
+    if (fs->mounts) {
+        iter = RedisModule_DictIteratorStartC(fs->mounts, "^", NULL, 0);
+        char *target;
+        while (RedisModule_DictNextC(iter, &keylen, (void**)&target) != NULL)
+            RedisModule_Free(target);
+        RedisModule_DictIteratorStop(iter);
+        RedisModule_FreeDict(NULL, fs->mounts);
+    }
+    if (fs->uploads) {
+        iter = RedisModule_DictIteratorStartC(fs->uploads, "^", NULL, 0);
+        fsUpload *up;
+        while (RedisModule_DictNextC(iter, &keylen, (void**)&up) != NULL)
+            fsUploadFree(up);
+        RedisModule_DictIteratorStop(iter);
+        RedisModule_FreeDict(NULL, fs->uploads);
+    }
     RedisModule_Free(fs);
 }
 
@@ -198,39 +445,45 @@ void fsObjectFree(fsObject *fs) {
  * Directory helpers
  * =================================================================== */
 
-void fsDirAddChild(fsInode *dir, const char *name, size_t namelen) {
+void fsDirAddChild(fsInode *dir, const char *name, size_t namelen, fsInode *child) {
     if (dir->type != FS_INODE_DIR) return;
 
-    // Check for duplicate.
+    // Already present: the name now refers to child.
     for (size_t i = 0; i < dir->payload.dir.count; i++) {
-        if (strlen(dir->payload.dir.children[i]) == namelen &&
-            memcmp(dir->payload.dir.children[i], name, namelen) == 0)
-            return; // Already present.
+        if (strlen(dir->payload.dir.children[i].name) == namelen &&
+            memcmp(dir->payload.dir.children[i].name, name, namelen) == 0) {
+            dir->payload.dir.children[i].inode = child;
+            return;
+        }
     }
 
     // Grow array if needed.
     if (dir->payload.dir.count >= dir->payload.dir.capacity) {
         size_t newcap = dir->payload.dir.capacity ? dir->payload.dir.capacity * 2 : 8;
         dir->payload.dir.children = RedisModule_Realloc(
-            dir->payload.dir.children, sizeof(char*) * newcap);
+            dir->payload.dir.children, sizeof(fsDirent) * newcap);
         dir->payload.dir.capacity = newcap;
     }
 
     char *copy = RedisModule_Alloc(namelen + 1);
     memcpy(copy, name, namelen);
     copy[namelen] = '\0';
-    dir->payload.dir.children[dir->payload.dir.count++] = copy;
+    fsDirent *e = &dir->payload.dir.children[dir->payload.dir.count++];
+    e->name = copy;
+    e->inode = child;
 }
 
+/* Searches from the end, so removing the newest children first costs
+ * O(1) each. */
 int fsDirRemoveChild(fsInode *dir, const char *name, size_t namelen) {
     if (dir->type != FS_INODE_DIR) return 0;
-    for (size_t i = 0; i < dir->payload.dir.count; i++) {
-        if (strlen(dir->payload.dir.children[i]) == namelen &&
-            memcmp(dir->payload.dir.children[i], name, namelen) == 0) {
-            RedisModule_Free(dir->payload.dir.children[i]);
+    for (size_t i = dir->payload.dir.count; i-- > 0;) {
+        if (strlen(dir->payload.dir.children[i].name) == namelen &&
+            memcmp(dir->payload.dir.children[i].name, name, namelen) == 0) {
+            RedisModule_Free(dir->payload.dir.children[i].name);
             // Shift remaining elements.
-            for (size_t j = i; j + 1 < dir->payload.dir.count; j++)
-                dir->payload.dir.children[j] = dir->payload.dir.children[j+1];
+            memmove(&dir->payload.dir.children[i], &dir->payload.dir.children[i + 1],
+                    sizeof(fsDirent) * (dir->payload.dir.count - i - 1));
             dir->payload.dir.count--;
             return 1;
         }
@@ -241,8 +494,8 @@ int fsDirRemoveChild(fsInode *dir, const char *name, size_t namelen) {
 int fsDirHasChild(fsInode *dir, const char *name, size_t namelen) {
     if (dir->type != FS_INODE_DIR) return 0;
     for (size_t i = 0; i < dir->payload.dir.count; i++) {
-        if (strlen(dir->payload.dir.children[i]) == namelen &&
-            memcmp(dir->payload.dir.children[i], name, namelen) == 0)
+        if (strlen(dir->payload.dir.children[i].name) == namelen &&
+            memcmp(dir->payload.dir.children[i].name, name, namelen) == 0)
             return 1;
     }
     return 0;
@@ -254,8 +507,14 @@ int fsDirHasChild(fsInode *dir, const char *name, size_t namelen) {
 
 void fsFileSetData(fsInode *inode, const char *data, size_t len) {
     if (inode->type != FS_INODE_FILE) return;
-    if (inode->payload.file.data)
-        RedisModule_Free(inode->payload.file.data);
+    fsLog *log = inode->payload.file.log;
+    if (log) {
+        fsLogClear(log);
+        fsLogAppend(log, data, len, fsNowMs());
+        inode->payload.file.size = log->size;
+        return;
+    }
+    fsBufferFree(inode->payload.file.data);
     if (len > 0) {
         inode->payload.file.data = RedisModule_Alloc(len);
         memcpy(inode->payload.file.data, data, len);
@@ -268,14 +527,125 @@ void fsFileSetData(fsInode *inode, const char *data, size_t len) {
 
 void fsFileAppendData(fsInode *inode, const char *data, size_t len) {
     if (inode->type != FS_INODE_FILE || len == 0) return;
+    if (inode->payload.file.log) {
+        fsLogAppend(inode->payload.file.log, data, len, fsNowMs());
+        inode->payload.file.size += len;
+        return;
+    }
     size_t oldsize = inode->payload.file.size;
     size_t newsize = oldsize + len;
-    inode->payload.file.data = RedisModule_Realloc(inode->payload.file.data, newsize);
+    inode->payload.file.data = fsBufferRealloc(inode->payload.file.data, oldsize, newsize);
     memcpy(inode->payload.file.data + oldsize, data, len);
     inode->payload.file.size = newsize;
     fsBloomBuild(inode);
 }
 
+void fsFileMoveData(fsInode *dst, fsInode *src) {
+    if (dst->type != FS_INODE_FILE || src->type != FS_INODE_FILE) return;
+    if (dst->payload.file.log) {
+        fsLogAdopt(dst->payload.file.log, src->payload.file.data,
+                   src->payload.file.size, src->payload.file.bloom, fsNowMs());
+        dst->payload.file.size = src->payload.file.size;
+        src->payload.file.data = NULL;
+        src->payload.file.size = 0;
+        memset(src->payload.file.bloom, 0, FS_BLOOM_BYTES);
+        return;
+    }
+    fsBufferFree(dst->payload.file.data);
+    dst->payload.file.data = src->payload.file.data;
+    dst->payload.file.size = src->payload.file.size;
+    memcpy(dst->payload.file.bloom, src->payload.file.bloom, FS_BLOOM_BYTES);
+    src->payload.file.data = NULL;
+    src->payload.file.size = 0;
+    memset(src->payload.file.bloom, 0, FS_BLOOM_BYTES);
+}
+
+const char *fsFileBytes(const fsInode *inode, char **tofree) {
+    *tofree = NULL;
+    const fsLog *log = inode->payload.file.log;
+    if (!log) return inode->payload.file.data;
+    if (log->size == 0) return NULL;
+    *tofree = RedisModule_Alloc(log->size);
+    fsLogRead(log, 0, log->size, *tofree);
+    return *tofree;
+}
+
+void fsFileSplice(fsInode *inode, const fsSplice *sp, size_t n) {
+    if (inode->type != FS_INODE_FILE || n == 0) return;
+    size_t size = inode->payload.file.size;
+
+    // Moving the bytes in place is safe left-to-right if no prefix of the
+    // splices grows the file, and right-to-left if none shrinks it: either
+    // way we never overwrite bytes we have yet to move. Uniform edits
+    // (REPLACE ALL, a single insert or delete) always fit one of the two;
+    // anything else is rebuilt into a fresh buffer.
+    long long delta = 0, prefix_max = 0, prefix_min = 0;
+    for (size_t i = 0; i < n; i++) {
+        delta += (long long)sp[i].len - (long long)sp[i].del;
+        if (delta > prefix_max) prefix_max = delta;
+        if (delta < prefix_min) prefix_min = delta;
+    }
+    size_t newsize = (size_t)((long long)size + delta);
+    char *data = inode->payload.file.data;
+
+    if (prefix_max == 0) {
+        // Shrinking: slide each kept segment left, then trim.
+        data = fsBufferUnshare(data, size);
+        size_t dst = sp[0].off;
+        for (size_t i = 0; i < n; i++) {
+            if (sp[i].len) memcpy(data + dst, sp[i].data, sp[i].len);
+            dst += sp[i].len;
+            size_t from = sp[i].off + sp[i].del;
+            size_t to = (i + 1 < n) ? sp[i+1].off : size;
+            if (to > from && dst != from) memmove(data + dst, data + from, to - from);
+            dst += to - from;
+        }
+        if (newsize == 0) {
+            RedisModule_Free(data);
+            data = NULL;
+        } else if (newsize < size) {
+            data = RedisModule_Realloc(data, newsize);
+        }
+    } else if (prefix_min == 0) {
+        // Growing: make room, then slide each kept segment right.
+        data = fsBufferRealloc(data, size, newsize);
+        size_t dst = newsize;
+        size_t to = size;
+        for (size_t i = n; i-- > 0; ) {
+            size_t from = sp[i].off + sp[i].del;
+            dst -= to - from;
+            if (to > from && dst != from) memmove(data + dst, data + from, to - from);
+            dst -= sp[i].len;
+            if (sp[i].len) memcpy(data + dst, sp[i].data, sp[i].len);
+            to = sp[i].off;
+        }
+    } else {
+        char *buf = RedisModule_Alloc(newsize);
+        size_t dst = 0, from = 0;
+        for (size_t i = 0; i < n; i++) {
+            memcpy(buf + dst, data + from, sp[i].off - from);
+            dst += sp[i].off - from;
+            if (sp[i].len) memcpy(buf + dst, sp[i].data, sp[i].len);
+            dst += sp[i].len;
+            from = sp[i].off + sp[i].del;
+        }
+        memcpy(buf + dst, data + from, size - from);
+        fsBufferFree(data);
+        data = buf;
+    }
+    inode->payload.file.data = data;
+    inode->payload.file.size = newsize;
+
+    // Cover every trigram that overlaps an edited range in the new content.
+    long long shift = 0;
+    for (size_t i = 0; i < n; i++) {
+        size_t at = (size_t)((long long)sp[i].off + shift);
+        size_t start = at >= 2 ? at - 2 : 0;
+        fsBloomAddRange(inode, start, at + sp[i].len);
+        shift += (long long)sp[i].len - (long long)sp[i].del;
+    }
+}
+
 /* ===================================================================
  * Bloom filter — trigram-based content index for accelerating FS.GREP.
  *
@@ -323,17 +693,30 @@ static inline uint8_t fsLowerChar(uint8_t c) {
 /* Build the bloom filter from file content (lowercased trigrams). */
 void fsBloomBuild(fsInode *inode) {
     memset(inode->payload.file.bloom, 0, FS_BLOOM_BYTES);
-    if (!inode->payload.file.data || inode->payload.file.size < 3) return;
+    fsBloomAddRange(inode, 0, inode->payload.file.size);
+}
 
-    const uint8_t *data = (const uint8_t *)inode->payload.file.data;
-    size_t size = inode->payload.file.size;
+/* Bits are only ever added here, so after an edit the bloom may keep
+ * trigrams that no longer occur. That only costs false positives; the
+ * next full rebuild (rewrite or RDB load) tightens it again. */
+void fsBloomAddRange(fsInode *inode, size_t start, size_t end) {
+    if (!inode->payload.file.data) return;
+    fsBloomAddBytes(inode->payload.file.bloom, inode->payload.file.data,
+                    inode->payload.file.size, start, end);
+}
 
-    for (size_t i = 0; i + 2 < size; i++) {
-        uint8_t a = fsLowerChar(data[i]);
-        uint8_t b = fsLowerChar(data[i+1]);
-        uint8_t c = fsLowerChar(data[i+2]);
-        fsBloomSet(inode->payload.file.bloom, fsBloomHash1(a, b, c));
-        fsBloomSet(inode->payload.file.bloom, fsBloomHash2(a, b, c));
+void fsBloomAddBytes(uint8_t *bloom, const char *data, size_t size,
+                     size_t start, size_t end) {
+    if (size < 3) return;
+    const uint8_t *bytes = (const uint8_t *)data;
+    if (end > size) end = size;
+
+    for (size_t i = start; i < end && i + 2 < size; i++) {
+        uint8_t a = fsLowerChar(bytes[i]);
+        uint8_t b = fsLowerChar(bytes[i+1]);
+        uint8_t c = fsLowerChar(bytes[i+2]);
+        fsBloomSet(bloom, fsBloomHash1(a, b, c));
+        fsBloomSet(bloom, fsBloomHash2(a, b, c));
     }
 }
 
@@ -412,7 +795,12 @@ int fsBloomMayMatch(const fsInode *inode, const char *pattern) {
         // is fine since the file is tiny anyway.
         return 1;
     }
+    if (inode->payload.file.log)
+        return fsLogMayMatch(inode->payload.file.log, pattern);
+    return fsBloomMayContain(inode->payload.file.bloom, pattern);
+}
 
+int fsBloomMayContain(const uint8_t *bloom, const char *pattern) {
     const char *litstr;
     size_t litlen = fsBloomExtractLiteral(pattern, &litstr);
     if (litlen < 3) return 1; // No useful literal — must scan.
@@ -422,9 +810,9 @@ int fsBloomMayMatch(const fsInode *inode, const char *pattern) {
         uint8_t a = fsLowerChar(lit[i]);
         uint8_t b = fsLowerChar(lit[i+1]);
         uint8_t c = fsLowerChar(lit[i+2]);
-        if (!fsBloomTest(inode->payload.file.bloom, fsBloomHash1(a, b, c)))
+        if (!fsBloomTest(bloom, fsBloomHash1(a, b, c)))
             return 0; // Definitely not present.
-        if (!fsBloomTest(inode->payload.file.bloom, fsBloomHash2(a, b, c)))
+        if (!fsBloomTest(bloom, fsBloomHash2(a, b, c)))
             return 0;
     }
     return 1; // All trigrams present — maybe a match.
@@ -441,13 +829,122 @@ fsInode *fsLookup(fsObject *fs, const char *path, size_t pathlen) {
     return (fsInode*)val;
 }
 
+void fsInodeBump(fsObject *fs, fsInode *inode) {
+    inode->version = ++fs->version_clock;
+    if (fs->index && inode->type == FS_INODE_FILE) fsIndexTouch(fs->index, inode);
+    if (fs->columns) fsColumnsTouch(fs->columns, inode);
+}
+
+/* Build an expiry index key: 8-byte big-endian expire time, then the path.
+ * Big-endian keeps the rax ordered by time. Caller frees. */
+static char *fsExpireIndexKey(int64_t when, const char *path, size_t pathlen,
+                              size_t *keylen) {
+    char *k = RedisModule_Alloc(8 + pathlen);
+    uint64_t w = (uint64_t)when;
+    for (int i = 7; i >= 0; i--) {
+        k[i] = (char)(w & 0xff);
+        w >>= 8;
+    }
+    memcpy(k + 8, path, pathlen);
+    *keylen = 8 + pathlen;
+    return k;
+}
+
+static void fsExpireIndexAdd(fsObject *fs, const char *path, size_t pathlen,
+                             int64_t when) {
+    if (!fs->expires) fs->expires = RedisModule_CreateDict(NULL);
+    size_t klen;
+    char *k = fsExpireIndexKey(when, path, pathlen, &klen);
+    RedisModule_DictSetC(fs->expires, k, klen, NULL);
+    RedisModule_Free(k);
+}
+
+static void fsExpireIndexDel(fsObject *fs, const char *path, size_t pathlen,
+                             int64_t when) {
+    if (!fs->expires) return;
+    size_t klen;
+    char *k = fsExpireIndexKey(when, path, pathlen, &klen);
+    RedisModule_DictDelC(fs->expires, k, klen, NULL);
+    RedisModule_Free(k);
+}
+
+/* Set (when > 0) or clear (when == 0) the expiry of the inode at path. */
+static void fsSetExpire(fsObject *fs, const char *path, size_t pathlen,
+                        fsInode *inode, int64_t when) {
+    if (inode->expire_at) fsExpireIndexDel(fs, path, pathlen, inode->expire_at);
+    inode->expire_at = when;
+    if (when) fsExpireIndexAdd(fs, path, pathlen, when);
+}
+
+/* Uploads are keyed by their handle, big-endian. */
+static void fsUploadKey(uint64_t handle, char *k) {
+    for (int i = 7; i >= 0; i--) {
+        k[i] = (char)(handle & 0xff);
+        handle >>= 8;
+    }
+}
+
+static size_t fsUploadCount(const fsObject *fs) {
+    return fs->uploads ? RedisModule_DictSize(fs->uploads) : 0;
+}
+
+static fsUpload *fsUploadGet(fsObject *fs, uint64_t handle) {
+    if (!fs->uploads) return NULL;
+    char k[8];
+    fsUploadKey(handle, k);
+    int nokey = 0;
+    fsUpload *up = RedisModule_DictGetC(fs->uploads, k, 8, &nokey);
+    return nokey ? NULL : up;
+}
+
+/* Drop an upload and everything it received. Returns 0 if there is no
+ * such upload. */
+static int fsUploadDiscard(fsObject *fs, uint64_t handle) {
+    if (!fs->uploads) return 0;
+    char k[8];
+    fsUploadKey(handle, k);
+    fsUpload *up;
+    if (RedisModule_DictDelC(fs->uploads, k, 8, &up) != REDISMODULE_OK) return 0;
+    fsUploadFree(up);
+    return 1;
+}
+
+/* The parent inode of path (NULL for the root), for the metadata columns.
+ * Sets *base to the offset of path's basename. */
+static fsInode *fsColumnsParent(fsObject *fs, const char *path, size_t pathlen,
+                                size_t *base) {
+    size_t i = pathlen;
+    while (i > 0 && path[i - 1] != '/') i--;
+    if (pathlen <= 1 || i == 0) {
+        *base = 0;
+        return NULL;
+    }
+    *base = i;
+    return fsLookup(fs, path, i > 1 ? i - 1 : 1);
+}
+
+/* Give inode a row in the metadata columns, under its parent. */
+static void fsColumnsLink(fsObject *fs, const char *path, size_t pathlen, fsInode *inode) {
+    size_t base;
+    fsInode *parent = fsColumnsParent(fs, path, pathlen, &base);
+    fsColumnsAdd(fs->columns, inode, parent, path + base, pathlen - base);
+}
+
 /* Insert an inode into the filesystem dict. Caller has allocated inode. */
 static void fsInsert(fsObject *fs, const char *path, size_t pathlen, fsInode *inode) {
     RedisModule_DictSetC(fs->inodes, (void*)path, pathlen, inode);
+    if (inode->expire_at) fsExpireIndexAdd(fs, path, pathlen, inode->expire_at);
+    if (fs->index && inode->type == FS_INODE_FILE)
+        fsIndexAdd(fs->index, inode, path, pathlen);
+    if (fs->columns) fsColumnsLink(fs, path, pathlen, inode);
+    fsInodeBump(fs, inode);
     switch (inode->type) {
     case FS_INODE_FILE:    fs->file_count++; break;
     case FS_INODE_DIR:     fs->dir_count++; break;
-    case FS_INODE_SYMLINK: fs->symlink_count++; break;
+    case FS_INODE_SYMLINK:
+        fs->symlink_count++;
+        fs->symlink_gen++;
+        break;
     }
 }
 
@@ -457,57 +954,297 @@ static fsInode *fsRemove(fsObject *fs, const char *path, size_t pathlen) {
     fsInode *inode = RedisModule_DictGetC(fs->inodes, (void*)path, pathlen, &nokey);
     if (nokey) return NULL;
     RedisModule_DictDelC(fs->inodes, (void*)path, pathlen, NULL);
+    if (inode->expire_at) fsExpireIndexDel(fs, path, pathlen, inode->expire_at);
+    if (fs->columns) fsColumnsRemove(fs->columns, inode);
+    if (inode->hot) fsHotRemove(fs->hot, inode);
+    if (fs->mounts && inode->type == FS_INODE_DIR) {
+        // A stub going away (e.g. reclaimed by expiry) takes its mount with it.
+        char *target;
+        if (RedisModule_DictDelC(fs->mounts, (void*)path, pathlen, &target) == REDISMODULE_OK)
+            RedisModule_Free(target);
+    }
     switch (inode->type) {
     case FS_INODE_FILE:
         fs->file_count--;
         fs->total_data_size -= inode->payload.file.size;
+        if (fs->index) fsIndexRemove(fs->index, inode);
         break;
     case FS_INODE_DIR:     fs->dir_count--; break;
-    case FS_INODE_SYMLINK: fs->symlink_count--; break;
+    case FS_INODE_SYMLINK:
+        fs->symlink_count--;
+        fs->symlink_gen++;
+        break;
     }
     return inode;
 }
 
+/* Re-key an inode under a new path (used by FS.MV). Counters and version
+ * are untouched; the expiry and word indexes, the metadata columns and
+ * the hot pools follow the inode to its new path, and moving a symlink
+ * invalidates cached resolutions. */
+static void fsRelocate(fsObject *fs, const char *oldpath, size_t oldlen,
+                       const char *newpath, size_t newlen, fsInode *inode) {
+    RedisModule_DictDelC(fs->inodes, (void*)oldpath, oldlen, NULL);
+    RedisModule_DictSetC(fs->inodes, (void*)newpath, newlen, inode);
+    if (inode->type == FS_INODE_SYMLINK) fs->symlink_gen++;
+    if (fs->index && inode->type == FS_INODE_FILE)
+        fsIndexRename(fs->index, inode, newpath, newlen);
+    if (inode->hot) fsHotRename(fs->hot, inode, newpath, newlen);
+    if (inode->expire_at) {
+        fsExpireIndexDel(fs, oldpath, oldlen, inode->expire_at);
+        fsExpireIndexAdd(fs, newpath, newlen, inode->expire_at);
+    }
+    if (fs->columns) {
+        // When a directory moves, its descendants may be relocated before
+        // their new parent path exists. Their parent inode is the same
+        // one either way, and a NULL parent leaves it as it is.
+        size_t base;
+        fsInode *parent = fsColumnsParent(fs, newpath, newlen, &base);
+        fsColumnsMove(fs->columns, inode, parent, newpath + base, newlen - base);
+    }
+}
+
+/* Count a read or write (FS_HOT_*) of a file at path for FS.HOT. Anything
+ * but a file is ignored. */
+static void fsCountAccess(fsObject *fs, fsInode *inode, int which, const char *path) {
+    if (!inode || inode->type != FS_INODE_FILE) return;
+    if (!fsHotCount(inode, which)) return;
+    if (!fs->hot) fs->hot = fsHotCreate();
+    fsHotOffer(fs->hot, which, inode, path, strlen(path));
+}
+
+/* Create the word index for FS.SEARCH and tokenize every file. From then
+ * on fsInsert, fsRemove, fsRelocate and fsInodeBump keep it current. */
+static void fsIndexEnable(fsObject *fs) {
+    if (fs->index) return;
+    fs->index = fsIndexCreate();
+    RedisModuleDictIter *iter = RedisModule_DictIteratorStartC(fs->inodes, "^", NULL, 0);
+    char *path;
+    size_t pathlen;
+    fsInode *inode;
+    while ((path = RedisModule_DictNextC(iter, &pathlen, (void**)&inode)) != NULL) {
+        if (inode->type == FS_INODE_FILE) fsIndexAdd(fs->index, inode, path, pathlen);
+    }
+    RedisModule_DictIteratorStop(iter);
+    fsIndexRefresh(fs->index);
+}
+
+/* Create the metadata columns for predicate FS.FIND. Key order puts every
+ * directory before its descendants, so parents have their slots first.
+ * From then on the mutation helpers keep the columns current. */
+static void fsColumnsEnable(fsObject *fs) {
+    if (fs->columns) return;
+    fs->columns = fsColumnsCreate();
+    RedisModuleDictIter *iter = RedisModule_DictIteratorStartC(fs->inodes, "^", NULL, 0);
+    char *path;
+    size_t pathlen;
+    fsInode *inode;
+    while ((path = RedisModule_DictNextC(iter, &pathlen, (void**)&inode)) != NULL)
+        fsColumnsLink(fs, path, pathlen, inode);
+    RedisModule_DictIteratorStop(iter);
+}
+
+/* Find the mount covering path: the mount point itself or its nearest
+ * mounted ancestor. Returns the mount point's length (a prefix of path)
+ * and sets *target, or returns 0 if path is not under a mount. */
+static size_t fsMountLookup(fsObject *fs, const char *path, size_t pathlen,
+                            const char **target) {
+    if (!fs->mounts || RedisModule_DictSize(fs->mounts) == 0) return 0;
+    for (size_t i = 1; i <= pathlen; i++) {
+        if (i < pathlen && path[i] != '/') continue;
+        int nokey = 0;
+        char *t = RedisModule_DictGetC(fs->mounts, (void*)path, i, &nokey);
+        if (!nokey) {
+            *target = t;
+            return i;
+        }
+    }
+    return 0;
+}
+
+/* Is there a mount point at path or anywhere below it? */
+static int fsMountsUnder(fsObject *fs, const char *path, size_t pathlen) {
+    if (!fs->mounts || RedisModule_DictSize(fs->mounts) == 0) return 0;
+    if (fsIsRoot(path, pathlen)) return 1;
+    int nokey = 0;
+    RedisModule_DictGetC(fs->mounts, (void*)path, pathlen, &nokey);
+    if (!nokey) return 1;
+
+    char *prefix = RedisModule_Alloc(pathlen + 1);
+    memcpy(prefix, path, pathlen);
+    prefix[pathlen] = '/';
+    RedisModuleDictIter *iter = RedisModule_DictIteratorStartC(
+        fs->mounts, ">=", prefix, pathlen + 1);
+    size_t klen;
+    char *k = RedisModule_DictNextC(iter, &klen, NULL);
+    int found = k && klen > pathlen + 1 && memcmp(k, prefix, pathlen + 1) == 0;
+    RedisModule_DictIteratorStop(iter);
+    RedisModule_Free(prefix);
+    return found;
+}
+
+/* Route a command to the key that owns its paths. argv[a] and, if b is
+ * non-zero, argv[b] are path arguments. If they lie under a mount, reply
+ * with an FSMOVED redirect (or a cross-key error when the two paths are
+ * owned by different keys) and return 1; otherwise return 0 and let the
+ * command run here. Costs one extra key lookup when there are no mounts. */
+static int fsRoute(RedisModuleCtx *ctx, RedisModuleString **argv, int argc,
+                   int a, int b) {
+    if (a >= argc) return 0;
+    RedisModuleKey *key = RedisModule_OpenKey(ctx, argv[1],
+        REDISMODULE_READ|REDISMODULE_OPEN_KEY_NOTOUCH|REDISMODULE_OPEN_KEY_NOSTATS);
+    fsObject *fs = NULL;
+    if (RedisModule_ModuleTypeGetType(key) == FSType)
+        fs = RedisModule_ModuleTypeGetValue(key);
+    RedisModule_CloseKey(key);
+    if (!fs || !fs->mounts || RedisModule_DictSize(fs->mounts) == 0) return 0;
+
+    int idx[2] = { a, b };
+    char *paths[2] = { NULL, NULL };
+    size_t mlen[2] = { 0, 0 };
+    const char *target[2] = { NULL, NULL };
+    int n = (b && b < argc) ? 2 : 1;
+    for (int i = 0; i < n; i++) {
+        size_t rawlen;
+        const char *raw = RedisModule_StringPtrLen(argv[idx[i]], &rawlen);
+        paths[i] = fsNormalizePath(raw, rawlen);
+        if (paths[i]) mlen[i] = fsMountLookup(fs, paths[i], strlen(paths[i]), &target[i]);
+    }
+
+    int routed = 0;
+    if (n == 2 && (mlen[0] != mlen[1] ||
+                   (mlen[0] && memcmp(paths[0], paths[1], mlen[0]) != 0))) {
+        RedisModule_ReplyWithError(ctx, "ERR cross-key operation — paths are on different mounts");
+        routed = 1;
+    } else if (mlen[0]) {
+        RedisModuleString *moved = RedisModule_CreateStringPrintf(ctx,
+            "FSMOVED %s %.*s", target[0], (int)mlen[0], paths[0]);
+        RedisModule_ReplyWithError(ctx, RedisModule_StringPtrLen(moved, NULL));
+        RedisModule_FreeString(ctx, moved);
+        routed = 1;
+    }
+    for (int i = 0; i < n; i++)
+        if (paths[i]) RedisModule_Free(paths[i]);
+    return routed;
+}
+
+/* A cached resolution: path resolves to resolved, as of symlink_gen gen. */
+typedef struct fsResolved {
+    uint64_t gen;
+    size_t len;
+    char resolved[];
+} fsResolved;
+
+static void fsResolveCacheFree(fsObject *fs) {
+    if (!fs->resolved) return;
+    RedisModuleDictIter *iter = RedisModule_DictIteratorStartC(fs->resolved, "^", NULL, 0);
+    fsResolved *r;
+    while (RedisModule_DictNextC(iter, NULL, (void**)&r) != NULL) RedisModule_Free(r);
+    RedisModule_DictIteratorStop(iter);
+    RedisModule_FreeDict(NULL, fs->resolved);
+    fs->resolved = NULL;
+}
+
+static char *fsResolveCacheGet(fsObject *fs, const char *path, size_t pathlen) {
+    if (!fs->resolved) return NULL;
+    int nokey;
+    fsResolved *r = RedisModule_DictGetC(fs->resolved, (void*)path, pathlen, &nokey);
+    if (nokey || r->gen != fs->symlink_gen) return NULL;
+    char *copy = RedisModule_Alloc(r->len + 1);
+    memcpy(copy, r->resolved, r->len + 1);
+    return copy;
+}
+
+static void fsResolveCacheSet(fsObject *fs, const char *path, size_t pathlen,
+                              const char *resolved) {
+    if (fs->resolved && RedisModule_DictSize(fs->resolved) >= FS_RESOLVE_CACHE_MAX)
+        fsResolveCacheFree(fs);
+    if (!fs->resolved) fs->resolved = RedisModule_CreateDict(NULL);
+    size_t len = strlen(resolved);
+    fsResolved *r = RedisModule_Alloc(sizeof(*r) + len + 1);
+    r->gen = fs->symlink_gen;
+    r->len = len;
+    memcpy(r->resolved, resolved, len + 1);
+    fsResolved *old;
+    if (RedisModule_DictDelC(fs->resolved, (void*)path, pathlen, &old) == REDISMODULE_OK)
+        RedisModule_Free(old);
+    RedisModule_DictSetC(fs->resolved, (void*)path, pathlen, r);
+}
+
 char *fsResolvePath(fsObject *fs, const char *path, size_t pathlen, int *err) {
     *err = FS_RESOLVE_OK;
     char *current = RedisModule_Alloc(pathlen + 1);
     memcpy(current, path, pathlen);
     current[pathlen] = '\0';
 
-    for (int depth = 0; depth < FS_MAX_SYMLINK_DEPTH; depth++) {
-        size_t clen = strlen(current);
-        fsInode *inode = fsLookup(fs, current, clen);
-        if (!inode) {
-            // Path not found — return as-is (caller decides).
-            return current;
-        }
+    // A path that exists is made of real directories, up to its last
+    // component; only that one can still be a symlink.
+    if (fs->symlink_count == 0) return current;
+    fsInode *inode = fsLookup(fs, current, pathlen);
+    if (inode && inode->type != FS_INODE_SYMLINK) return current;
+    char *cached = fsResolveCacheGet(fs, current, pathlen);
+    if (cached) {
+        RedisModule_Free(current);
+        return cached;
+    }
+
+    // Walk the components from the root. A symlink's target replaces the
+    // prefix ending at it, and the walk starts over on the new path, whose
+    // own components may be symlinks too.
+    size_t clen = pathlen;
+    size_t pos = 1;
+    int hops = 0;
+    while (pos < clen) {
+        size_t end = pos;
+        while (end < clen && current[end] != '/') end++;
+        inode = fsLookup(fs, current, end);
+        if (!inode) break;  // Nothing below it either: return as-is.
         if (inode->type != FS_INODE_SYMLINK) {
-            return current;
+            if (inode->type != FS_INODE_DIR) break;
+            pos = end + 1;
+            continue;
+        }
+        if (++hops >= FS_MAX_SYMLINK_DEPTH) {
+            RedisModule_Free(current);
+            *err = FS_RESOLVE_ERR_SYMLINK_LOOP;
+            return NULL;
         }
-        // Follow symlink.
-        char *target = inode->payload.symlink.target;
+        const char *target = inode->payload.symlink.target;
         size_t tlen = strlen(target);
-        char *resolved;
+        char *prefix;
         if (tlen > 0 && target[0] == '/') {
-            resolved = fsNormalizePath(target, tlen);
+            prefix = fsNormalizePath(target, tlen);
         } else {
-            char *parent = fsParentPath(current, clen);
-            resolved = fsJoinPath(parent, strlen(parent), target, tlen);
+            char *parent = fsParentPath(current, end);
+            prefix = fsJoinPath(parent, strlen(parent), target, tlen);
             RedisModule_Free(parent);
         }
-        if (!resolved) {
+        if (!prefix) {
             RedisModule_Free(current);
             *err = FS_RESOLVE_ERR_PATH_DEPTH;
             return NULL;
         }
+        // prefix + the components after the symlink, normalized again
+        // to enforce the depth limit.
+        size_t plen = strlen(prefix), restlen = clen - end;
+        char *joined = RedisModule_Alloc(plen + restlen + 1);
+        memcpy(joined, prefix, plen);
+        memcpy(joined + plen, current + end, restlen);
+        joined[plen + restlen] = '\0';
+        RedisModule_Free(prefix);
         RedisModule_Free(current);
-        current = resolved;
+        current = fsNormalizePath(joined, plen + restlen);
+        RedisModule_Free(joined);
+        if (!current) {
+            *err = FS_RESOLVE_ERR_PATH_DEPTH;
+            return NULL;
+        }
+        clen = strlen(current);
+        pos = 1;
     }
 
-    // Too many levels of symlinks.
-    RedisModule_Free(current);
-    *err = FS_RESOLVE_ERR_SYMLINK_LOOP;
-    return NULL;
+    if (hops) fsResolveCacheSet(fs, path, pathlen, current);
+    return current;
 }
 
 /* ===================================================================
@@ -551,8 +1288,9 @@ static int fsEnsureParents(fsObject *fs, const char *path, size_t pathlen) {
     fsInode *gpnode = fsLookup(fs, gp, gplen);
     if (gpnode && gpnode->type == FS_INODE_DIR) {
         char *base = fsBaseName(parent, plen);
-        fsDirAddChild(gpnode, base, strlen(base));
+        fsDirAddChild(gpnode, base, strlen(base), dir);
         RedisModule_Free(base);
+        fsInodeBump(fs, gpnode);
     }
     RedisModule_Free(gp);
     RedisModule_Free(parent);
@@ -604,10 +1342,11 @@ static fsObject *fsGetObject(RedisModuleCtx *ctx, RedisModuleString *keyname,
  * This is the counterpart to auto-create in fsGetObject: just as the
  * first write creates the key, removing the last entry deletes it.
  * We keep the semantics symmetric so that DEL is never needed for
- * cleanup — the key naturally disappears when empty. */
+ * cleanup — the key naturally disappears when empty. Open uploads keep
+ * an otherwise empty key alive. */
 static void fsMaybeDeleteKey(RedisModuleKey *key, fsObject *fs) {
     uint64_t total = fs->file_count + fs->dir_count + fs->symlink_count;
-    if (total <= 1) {
+    if (total <= 1 && fsUploadCount(fs) == 0) {
         // Only root "/" left (or somehow empty). Delete the key.
         RedisModule_DeleteKey(key);
     }
@@ -618,8 +1357,9 @@ static void fsMaybeDeleteKey(RedisModuleKey *key, fsObject *fs) {
  * =================================================================== */
 
 /*
- * RDB format (version 0):
+ * RDB format (version 6):
  *   uint64 inode_count
+ *   uint64 version_clock                  (v1+)
  *   For each inode:
  *     string  path
  *     uint8   type
@@ -629,10 +1369,25 @@ static void fsMaybeDeleteKey(RedisModuleKey *key, fsObject *fs) {
  *     int64   ctime
  *     int64   mtime
  *     int64   atime
+ *     uint64  version                      (v1+)
+ *     int64   expire_at                    (v2+, 0 = none)
  *     [type-specific payload]
- *       FILE:    uint64 size + raw data
+ *       FILE:    uint64 size
+ *                uint64 islog          (v6+, 1 = segmented log)
+ *                If islog (v6+):
+ *                  uint64 segment_bytes, uint64 max_size, int64 max_age,
+ *                  uint64 dropped, uint64 segment_count
+ *                  For each segment: int64 mtime, string data
+ *                Else, if size > 0: string data
  *       DIR:     uint64 child_count + strings
  *       SYMLINK: string target
+ *   uint64 mount_count                    (v3+)
+ *   For each mount: string path, string target key
+ *   uint64 indexed                        (v4+, 1 = rebuild the search index)
+ *   uint64 upload_clock                   (v5+)
+ *   uint64 upload_count                   (v5+)
+ *   For each upload: uint64 handle, string path, int64 timeout,
+ *                    int64 deadline, string data
  */
 
 void FSRdbSave(RedisModuleIO *rdb, void *value) {
@@ -641,6 +1396,7 @@ void FSRdbSave(RedisModuleIO *rdb, void *value) {
     // Count total inodes.
     uint64_t count = fs->file_count + fs->dir_count + fs->symlink_count;
     RedisModule_SaveUnsigned(rdb, count);
+    RedisModule_SaveUnsigned(rdb, fs->version_clock);
 
     RedisModuleDictIter *iter = RedisModule_DictIteratorStartC(fs->inodes, "^", NULL, 0);
     char *path;
@@ -655,19 +1411,24 @@ void FSRdbSave(RedisModuleIO *rdb, void *value) {
         RedisModule_SaveSigned(rdb, inode->ctime);
         RedisModule_SaveSigned(rdb, inode->mtime);
         RedisModule_SaveSigned(rdb, inode->atime);
+        RedisModule_SaveUnsigned(rdb, inode->version);
+        RedisModule_SaveSigned(rdb, inode->expire_at);
 
         switch (inode->type) {
         case FS_INODE_FILE:
             RedisModule_SaveUnsigned(rdb, inode->payload.file.size);
-            if (inode->payload.file.size > 0)
+            RedisModule_SaveUnsigned(rdb, inode->payload.file.log != NULL);
+            if (inode->payload.file.log)
+                fsLogSave(rdb, inode->payload.file.log);
+            else if (inode->payload.file.size > 0)
                 RedisModule_SaveStringBuffer(rdb, inode->payload.file.data,
                                               inode->payload.file.size);
             break;
         case FS_INODE_DIR:
             RedisModule_SaveUnsigned(rdb, inode->payload.dir.count);
             for (size_t i = 0; i < inode->payload.dir.count; i++) {
-                size_t clen = strlen(inode->payload.dir.children[i]);
-                RedisModule_SaveStringBuffer(rdb, inode->payload.dir.children[i], clen);
+                size_t clen = strlen(inode->payload.dir.children[i].name);
+                RedisModule_SaveStringBuffer(rdb, inode->payload.dir.children[i].name, clen);
             }
             break;
         case FS_INODE_SYMLINK:
@@ -677,13 +1438,74 @@ void FSRdbSave(RedisModuleIO *rdb, void *value) {
         }
     }
     RedisModule_DictIteratorStop(iter);
+
+    uint64_t nmounts = fs->mounts ? RedisModule_DictSize(fs->mounts) : 0;
+    RedisModule_SaveUnsigned(rdb, nmounts);
+    if (nmounts) {
+        iter = RedisModule_DictIteratorStartC(fs->mounts, "^", NULL, 0);
+        char *target;
+        while ((path = RedisModule_DictNextC(iter, &pathlen, (void**)&target)) != NULL) {
+            RedisModule_SaveStringBuffer(rdb, path, pathlen);
+            RedisModule_SaveStringBuffer(rdb, target, strlen(target));
+        }
+        RedisModule_DictIteratorStop(iter);
+    }
+
+    // The word index itself is not saved, only whether to rebuild it.
+    RedisModule_SaveUnsigned(rdb, fs->index != NULL);
+
+    // Open uploads are saved so that a replica's full sync (or a restart)
+    // does not lose chunks the master has already acknowledged.
+    RedisModule_SaveUnsigned(rdb, fs->upload_clock);
+    RedisModule_SaveUnsigned(rdb, fsUploadCount(fs));
+    if (fsUploadCount(fs)) {
+        iter = RedisModule_DictIteratorStartC(fs->uploads, "^", NULL, 0);
+        char *k;
+        size_t klen;
+        fsUpload *up;
+        while ((k = RedisModule_DictNextC(iter, &klen, (void**)&up)) != NULL) {
+            uint64_t handle = 0;
+            for (int i = 0; i < 8; i++) handle = (handle << 8) | (uint8_t)k[i];
+            RedisModule_SaveUnsigned(rdb, handle);
+            RedisModule_SaveStringBuffer(rdb, up->path, strlen(up->path));
+            RedisModule_SaveSigned(rdb, up->timeout);
+            RedisModule_SaveSigned(rdb, up->deadline);
+            const fsInode *inode = up->inode;
+            RedisModule_SaveStringBuffer(rdb,
+                inode->payload.file.data ? inode->payload.file.data : "",
+                inode->payload.file.size);
+        }
+        RedisModule_DictIteratorStop(iter);
+    }
+}
+
+/* Point every directory entry at its child's inode. Entries are loaded
+ * before the inodes they name, so this runs once the dict is complete; a
+ * name with no inode behind it keeps NULL, which lists as "unknown". */
+static void fsLinkDirents(fsObject *fs) {
+    RedisModuleDictIter *iter = RedisModule_DictIteratorStartC(fs->inodes, "^", NULL, 0);
+    char *path;
+    size_t pathlen;
+    fsInode *inode;
+    while ((path = RedisModule_DictNextC(iter, &pathlen, (void**)&inode)) != NULL) {
+        if (inode->type != FS_INODE_DIR) continue;
+        for (size_t i = 0; i < inode->payload.dir.count; i++) {
+            fsDirent *e = &inode->payload.dir.children[i];
+            char *childpath = fsJoinPath(path, pathlen, e->name, strlen(e->name));
+            if (!childpath) continue;
+            e->inode = fsLookup(fs, childpath, strlen(childpath));
+            RedisModule_Free(childpath);
+        }
+    }
+    RedisModule_DictIteratorStop(iter);
 }
 
 void *FSRdbLoad(RedisModuleIO *rdb, int encver) {
-    if (encver != 0) return NULL;
+    if (encver > FS_RDB_ENCVER) return NULL;
 
     fsObject *fs = fsObjectCreate();
     uint64_t count = RedisModule_LoadUnsigned(rdb);
+    if (encver >= 1) fs->version_clock = RedisModule_LoadUnsigned(rdb);
     if (RedisModule_IsIOError(rdb)) goto ioerr;
 
     for (uint64_t i = 0; i < count; i++) {
@@ -698,6 +1520,10 @@ void *FSRdbLoad(RedisModuleIO *rdb, int encver) {
         int64_t ctime_val = RedisModule_LoadSigned(rdb);
         int64_t mtime = RedisModule_LoadSigned(rdb);
         int64_t atime = RedisModule_LoadSigned(rdb);
+        // v0 dumps carry no versions: hand out fresh ones from the clock.
+        uint64_t version = (encver >= 1) ? RedisModule_LoadUnsigned(rdb)
+                                         : ++fs->version_clock;
+        int64_t expire_at = (encver >= 2) ? RedisModule_LoadSigned(rdb) : 0;
         if (RedisModule_IsIOError(rdb)) {
             RedisModule_Free(path);
             goto ioerr;
@@ -712,16 +1538,27 @@ void *FSRdbLoad(RedisModuleIO *rdb, int encver) {
         inode->ctime = ctime_val;
         inode->mtime = mtime;
         inode->atime = atime;
+        inode->version = version;
+        inode->expire_at = expire_at;
 
         switch (type) {
         case FS_INODE_FILE: {
             uint64_t size = RedisModule_LoadUnsigned(rdb);
+            uint64_t islog = (encver >= 6) ? RedisModule_LoadUnsigned(rdb) : 0;
             if (RedisModule_IsIOError(rdb)) {
                 RedisModule_Free(path);
                 RedisModule_Free(inode);
                 goto ioerr;
             }
-            if (size > 0) {
+            if (islog) {
+                inode->payload.file.log = fsLogLoad(rdb);
+                if (!inode->payload.file.log) {
+                    RedisModule_Free(path);
+                    RedisModule_Free(inode);
+                    goto ioerr;
+                }
+                inode->payload.file.size = inode->payload.file.log->size;
+            } else if (size > 0) {
                 size_t datalen;
                 inode->payload.file.data = RedisModule_LoadStringBuffer(rdb, &datalen);
                 inode->payload.file.size = datalen;
@@ -749,7 +1586,7 @@ void *FSRdbLoad(RedisModuleIO *rdb, int encver) {
             inode->payload.dir.count = 0;
             inode->payload.dir.capacity = nchildren ? nchildren : 0;
             inode->payload.dir.children = nchildren ?
-                RedisModule_Alloc(sizeof(char*) * nchildren) : NULL;
+                RedisModule_Alloc(sizeof(fsDirent) * nchildren) : NULL;
             for (uint64_t j = 0; j < nchildren; j++) {
                 size_t clen;
                 char *child = RedisModule_LoadStringBuffer(rdb, &clen);
@@ -757,7 +1594,7 @@ void *FSRdbLoad(RedisModuleIO *rdb, int encver) {
                     RedisModule_Free(path);
                     // Free already loaded children.
                     for (uint64_t k = 0; k < j; k++)
-                        RedisModule_Free(inode->payload.dir.children[k]);
+                        RedisModule_Free(inode->payload.dir.children[k].name);
                     if (inode->payload.dir.children)
                         RedisModule_Free(inode->payload.dir.children);
                     RedisModule_Free(inode);
@@ -768,7 +1605,10 @@ void *FSRdbLoad(RedisModuleIO *rdb, int encver) {
                 memcpy(copy, child, clen);
                 copy[clen] = '\0';
                 RedisModule_Free(child);
-                inode->payload.dir.children[inode->payload.dir.count++] = copy;
+                // Pointed at the child's inode once every inode is loaded.
+                fsDirent *e = &inode->payload.dir.children[inode->payload.dir.count++];
+                e->name = copy;
+                e->inode = NULL;
             }
             fs->dir_count++;
             break;
@@ -795,9 +1635,88 @@ void *FSRdbLoad(RedisModuleIO *rdb, int encver) {
         }
 
         RedisModule_DictSetC(fs->inodes, path, pathlen, inode);
+        if (expire_at) fsExpireIndexAdd(fs, path, pathlen, expire_at);
         RedisModule_Free(path);
     }
 
+    if (encver >= 3) {
+        uint64_t nmounts = RedisModule_LoadUnsigned(rdb);
+        if (RedisModule_IsIOError(rdb)) goto ioerr;
+        for (uint64_t i = 0; i < nmounts; i++) {
+            size_t pathlen, tlen;
+            char *path = RedisModule_LoadStringBuffer(rdb, &pathlen);
+            if (RedisModule_IsIOError(rdb)) goto ioerr;
+            char *target = RedisModule_LoadStringBuffer(rdb, &tlen);
+            if (RedisModule_IsIOError(rdb)) {
+                RedisModule_Free(path);
+                goto ioerr;
+            }
+            char *copy = RedisModule_Alloc(tlen + 1);
+            memcpy(copy, target, tlen);
+            copy[tlen] = '\0';
+            RedisModule_Free(target);
+            if (!fs->mounts) fs->mounts = RedisModule_CreateDict(NULL);
+            RedisModule_DictSetC(fs->mounts, path, pathlen, copy);
+            RedisModule_Free(path);
+        }
+    }
+
+    if (encver >= 4) {
+        uint64_t indexed = RedisModule_LoadUnsigned(rdb);
+        if (RedisModule_IsIOError(rdb)) goto ioerr;
+        if (indexed) fsIndexEnable(fs);
+    }
+
+    if (encver >= 5) {
+        fs->upload_clock = RedisModule_LoadUnsigned(rdb);
+        uint64_t nuploads = RedisModule_LoadUnsigned(rdb);
+        if (RedisModule_IsIOError(rdb)) goto ioerr;
+        for (uint64_t i = 0; i < nuploads; i++) {
+            uint64_t handle = RedisModule_LoadUnsigned(rdb);
+            size_t pathlen, datalen;
+            char *path = RedisModule_LoadStringBuffer(rdb, &pathlen);
+            if (RedisModule_IsIOError(rdb)) goto ioerr;
+            int64_t timeout = RedisModule_LoadSigned(rdb);
+            int64_t deadline = RedisModule_LoadSigned(rdb);
+            char *data = RedisModule_LoadStringBuffer(rdb, &datalen);
+            if (RedisModule_IsIOError(rdb)) {
+                RedisModule_Free(path);
+                goto ioerr;
+            }
+            fsUpload *up = RedisModule_Alloc(sizeof(*up));
+            up->path = RedisModule_Alloc(pathlen + 1);
+            memcpy(up->path, path, pathlen);
+            up->path[pathlen] = '\0';
+            RedisModule_Free(path);
+            up->inode = fsInodeCreate(FS_INODE_FILE, 0);
+            if (datalen > 0) {
+                up->inode->payload.file.data = data;
+                up->inode->payload.file.size = datalen;
+                fsBloomBuild(up->inode);
+            } else {
+                RedisModule_Free(data);
+            }
+            up->capacity = datalen;
+            up->timeout = timeout;
+            up->deadline = deadline;
+            char k[8];
+            fsUploadKey(handle, k);
+            if (!fs->uploads) fs->uploads = RedisModule_CreateDict(NULL);
+            RedisModule_DictSetC(fs->uploads, k, 8, up);
+        }
+    }
+
+    // Let the reclaimer know about this key if anything in it expires.
+    if ((fs->expires && RedisModule_DictSize(fs->expires) > 0) || fsUploadCount(fs) > 0) {
+        const RedisModuleString *keyname = RedisModule_GetKeyNameFromIO(rdb);
+        if (keyname) {
+            size_t namelen;
+            const char *name = RedisModule_StringPtrLen(keyname, &namelen);
+            fsExpireTrack(RedisModule_GetDbIdFromIO(rdb), name, namelen);
+        }
+    }
+
+    fsLinkDirents(fs);
     return fs;
 
 ioerr:
@@ -809,6 +1728,27 @@ void FSFree(void *value) {
     fsObjectFree((fsObject*)value);
 }
 
+/* Memory outside the inodes: indexes, caches and open uploads. */
+static size_t fsSideMemUsage(const fsObject *fs) {
+    size_t mem = 0;
+    if (fs->expires)
+        mem += RedisModule_DictSize(fs->expires) * 64; // index entry overhead
+    if (fs->resolved)
+        mem += RedisModule_DictSize(fs->resolved) * 128; // two paths + entry overhead
+    mem += fsIndexMemUsage(fs->index);
+    mem += fsColumnsMemUsage(fs->columns);
+    mem += fsHotMemUsage(fs->hot);
+    mem += fsJournalMemUsage(fs->journal);
+    if (fs->uploads) {
+        RedisModuleDictIter *iter = RedisModule_DictIteratorStartC(fs->uploads, "^", NULL, 0);
+        fsUpload *up;
+        while (RedisModule_DictNextC(iter, NULL, (void**)&up) != NULL)
+            mem += sizeof(*up) + sizeof(fsInode) + strlen(up->path) + up->capacity;
+        RedisModule_DictIteratorStop(iter);
+    }
+    return mem;
+}
+
 size_t FSMemUsage(const void *value) {
     const fsObject *fs = value;
     size_t mem = sizeof(fsObject);
@@ -816,7 +1756,7 @@ size_t FSMemUsage(const void *value) {
     uint64_t total = fs->file_count + fs->dir_count + fs->symlink_count;
     mem += total * (sizeof(fsInode) + 64); // inode + dict entry overhead
     mem += fs->total_data_size;
-    return mem;
+    return mem + fsSideMemUsage(fs);
 }
 
 void FSDigest(RedisModuleDigest *md, void *value) {
@@ -829,7 +1769,12 @@ void FSDigest(RedisModuleDigest *md, void *value) {
         RedisModule_DigestAddStringBuffer(md, path, pathlen);
         RedisModule_DigestAddLongLong(md, inode->type);
         RedisModule_DigestAddLongLong(md, inode->mode);
-        if (inode->type == FS_INODE_FILE && inode->payload.file.size > 0) {
+        if (inode->type == FS_INODE_FILE && inode->payload.file.log) {
+            const fsLog *log = inode->payload.file.log;
+            for (size_t i = 0; i < log->count; i++)
+                RedisModule_DigestAddStringBuffer(md, log->segments[i].data,
+                                                   log->segments[i].size);
+        } else if (inode->type == FS_INODE_FILE && inode->payload.file.size > 0) {
             RedisModule_DigestAddStringBuffer(md, inode->payload.file.data,
                                                inode->payload.file.size);
         }
@@ -854,7 +1799,7 @@ static int INFO_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int
         return RedisModule_ReplyWithError(ctx, "ERR no such filesystem key");
     }
 
-    RedisModule_ReplyWithArray(ctx, 10);
+    RedisModule_ReplyWithArray(ctx, 18);
     RedisModule_ReplyWithCString(ctx, "files");
     RedisModule_ReplyWithLongLong(ctx, fs->file_count);
     RedisModule_ReplyWithCString(ctx, "directories");
@@ -865,18 +1810,132 @@ static int INFO_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int
     RedisModule_ReplyWithLongLong(ctx, fs->total_data_size);
     RedisModule_ReplyWithCString(ctx, "total_inodes");
     RedisModule_ReplyWithLongLong(ctx, fs->file_count + fs->dir_count + fs->symlink_count);
+    RedisModule_ReplyWithCString(ctx, "mounts");
+    RedisModule_ReplyWithLongLong(ctx, fs->mounts ? (long long)RedisModule_DictSize(fs->mounts) : 0);
+    RedisModule_ReplyWithCString(ctx, "index_bytes");
+    RedisModule_ReplyWithLongLong(ctx, (long long)fsIndexMemUsage(fs->index));
+    RedisModule_ReplyWithCString(ctx, "columns_bytes");
+    RedisModule_ReplyWithLongLong(ctx, (long long)fsColumnsMemUsage(fs->columns));
+    RedisModule_ReplyWithCString(ctx, "uploads");
+    RedisModule_ReplyWithLongLong(ctx, (long long)fsUploadCount(fs));
     return REDISMODULE_OK;
 }
 
+/* A file's content in one piece, for readers that need it so. A log file
+ * is copied into memory that is freed when the command returns. */
+static const char *fsFileContent(RedisModuleCtx *ctx, const fsInode *inode) {
+    const fsLog *log = inode->payload.file.log;
+    if (!log) return inode->payload.file.data;
+    if (log->size == 0) return NULL;
+    char *buf = RedisModule_PoolAlloc(ctx, log->size);
+    fsLogRead(log, 0, log->size, buf);
+    return buf;
+}
+
+/* ===================================================================
+ * Log retention
+ * =================================================================== */
+
+/* Drop the n oldest sealed segments of a log file, keeping the inode's
+ * and the key's byte counts in step. */
+static void fsLogDropSegments(fsObject *fs, fsInode *inode, size_t n) {
+    fsLog *log = inode->payload.file.log;
+    if (!log || n == 0) return;
+    uint64_t before = log->size;
+    fsLogDrop(log, n);
+    fs->total_data_size -= before - log->size;
+    inode->payload.file.size = log->size;
+}
+
+/* Age retention, before a write to a log file. Only a master applies it,
+ * since it depends on the clock, and it is replicated as FS.LOG .. DROP n
+ * ahead of the write so that replicas drop the same segments. FS.LOG bumps
+ * the version where it is replayed, so the drop bumps it here too, keeping
+ * versions equal on master and replicas. */
+static void fsLogExpire(RedisModuleCtx *ctx, RedisModuleString *keyname,
+                        fsObject *fs, fsInode *inode, const char *path) {
+    fsLog *log = inode->payload.file.log;
+    if (!log || log->max_age == 0) return;
+    int flags = RedisModule_GetContextFlags(ctx);
+    if (!(flags & REDISMODULE_CTX_FLAGS_MASTER) || (flags & REDISMODULE_CTX_FLAGS_LOADING))
+        return;
+    size_t n = fsLogExpired(log, fsNowMs());
+    if (n == 0) return;
+    fsLogDropSegments(fs, inode, n);
+    fsInodeBump(fs, inode);
+    RedisModule_Replicate(ctx, "FS.LOG", "sccl", keyname, path, "DROP", (long long)n);
+}
+
+/* Size retention, after a write to a log file. Segment boundaries depend
+ * only on the appends, so this replays identically everywhere. */
+static void fsLogRetain(fsObject *fs, fsInode *inode) {
+    if (inode->payload.file.log)
+        fsLogDropSegments(fs, inode, fsLogOverSize(inode->payload.file.log));
+}
+
+/* ===================================================================
+ * Change notification (FS.TAIL ... FOLLOW, FS.WATCH)
+ * =================================================================== */
+
+/* Clients blocked in FS.TAIL ... FOLLOW, across all keys. */
+static long long fsFollowers = 0;
+
+/* After a write to path (normalized) in keyname: record it in the key's
+ * change journal, wake the FS.WATCH clients it concerns, and signal the
+ * FS.TAIL ... FOLLOW clients blocked on the key, each of which checks its
+ * own file. Until something follows or watches, this is two counter
+ * checks. The key may be gone by now (the write emptied it). */
+static void fsNotifyWrite(RedisModuleCtx *ctx, RedisModuleString *keyname,
+                          const char *path, size_t pathlen) {
+    if (fsFollowers) RedisModule_SignalKeyAsReady(ctx, keyname);
+    if (!fsWatchCount && !fsJournalCount) return;
+
+    RedisModuleKey *key = RedisModule_OpenKey(ctx, keyname,
+        REDISMODULE_READ|REDISMODULE_OPEN_KEY_NOTOUCH|REDISMODULE_OPEN_KEY_NOSTATS);
+    fsObject *fs = NULL;
+    if (RedisModule_ModuleTypeGetType(key) == FSType)
+        fs = RedisModule_ModuleTypeGetValue(key);
+    RedisModule_CloseKey(key);
+
+    size_t keylen, prefixlen;
+    const char *k = RedisModule_StringPtrLen(keyname, &keylen);
+    char *prefix = fsWatchKey(RedisModule_GetSelectedDb(ctx), k, keylen, "", 0,
+                              &prefixlen, NULL);
+    // A watcher that blocked before the key existed has no journal to
+    // resume from; start one for it.
+    if (fs && !fs->journal && fsWatchAnyOnKey(prefix, prefixlen))
+        fs->journal = fsJournalCreate();
+    if (fs && fs->journal) fsJournalAppend(fs->journal, path, pathlen);
+    fsWatchWake(prefix, prefixlen, path, pathlen);
+    RedisModule_Free(prefix);
+}
+
+/* fsNotifyWrite for a path argument, for commands that do not keep the
+ * normalized path until they reply. */
+static void fsNotifyWriteArg(RedisModuleCtx *ctx, RedisModuleString *keyname,
+                             RedisModuleString *patharg) {
+    if (!fsFollowers && !fsWatchCount && !fsJournalCount) return;
+    size_t rawlen;
+    const char *raw = RedisModule_StringPtrLen(patharg, &rawlen);
+    char *path = fsNormalizePath(raw, rawlen);
+    if (!path) return;
+    fsNotifyWrite(ctx, keyname, path, strlen(path));
+    RedisModule_Free(path);
+}
+
 /* ===================================================================
- * FS.ECHO key path content [APPEND]
+ * FS.ECHO key path content [APPEND] [IFVERSION v]
  *
  * Write (create or overwrite) a file. Creates parent dirs automatically.
  * With APPEND, appends to an existing file instead of overwriting.
  * =================================================================== */
 static int ECHO_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
     RedisModule_AutoMemory(ctx);
+    long long ifversion;
+    if (fsParseIfVersion(ctx, argv, &argc, 4, &ifversion) != REDISMODULE_OK)
+        return REDISMODULE_OK;
     if (argc < 4 || argc > 5) return RedisModule_WrongArity(ctx);
+    if (fsRoute(ctx, argv, argc, 2, 0)) return REDISMODULE_OK;
 
     int append = 0;
     if (argc == 5) {
@@ -904,6 +1963,12 @@ static int ECHO_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int
         return RedisModule_ReplyWithError(ctx, "ERR cannot write to root directory");
     }
 
+    fsInode *existing = fsLookup(fs, path, npathlen);
+    if (!fsCheckVersion(ctx, existing, ifversion)) {
+        RedisModule_Free(path);
+        return REDISMODULE_OK;
+    }
+
     // Ensure parents exist.
     if (fsEnsureParents(fs, path, npathlen) != 0) {
         RedisModule_Free(path);
@@ -913,53 +1978,71 @@ static int ECHO_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int
     size_t datalen;
     const char *data = RedisModule_StringPtrLen(argv[3], &datalen);
 
-    fsInode *existing = fsLookup(fs, path, npathlen);
     if (existing) {
         if (existing->type != FS_INODE_FILE) {
             RedisModule_Free(path);
             return RedisModule_ReplyWithError(ctx, "ERR path exists and is not a file");
         }
         if (append) {
+            fsLogExpire(ctx, argv[1], fs, existing, path);
             fsFileAppendData(existing, data, datalen);
             fs->total_data_size += datalen;
+            fsLogRetain(fs, existing);
         } else {
             fs->total_data_size -= existing->payload.file.size;
             fsFileSetData(existing, data, datalen);
             fs->total_data_size += datalen;
         }
         existing->mtime = fsNowMs();
+        fsInodeBump(fs, existing);
+        fsCountAccess(fs, existing, FS_HOT_WRITES, path);
     } else {
         fsInode *inode = fsInodeCreate(FS_INODE_FILE, 0);
         fsFileSetData(inode, data, datalen);
         fsInsert(fs, path, npathlen, inode);
         fs->total_data_size += datalen;
+        fsCountAccess(fs, inode, FS_HOT_WRITES, path);
 
         // Add to parent's children.
         char *parent = fsParentPath(path, npathlen);
         fsInode *pnode = fsLookup(fs, parent, strlen(parent));
         if (pnode && pnode->type == FS_INODE_DIR) {
             char *base = fsBaseName(path, npathlen);
-            fsDirAddChild(pnode, base, strlen(base));
+            fsDirAddChild(pnode, base, strlen(base), inode);
             RedisModule_Free(base);
             pnode->mtime = fsNowMs();
+            fsInodeBump(fs, pnode);
         }
         RedisModule_Free(parent);
     }
 
-    RedisModule_Free(path);
     RedisModule_ReplyWithSimpleString(ctx, "OK");
-    RedisModule_ReplicateVerbatim(ctx);
+    fsReplicateWrite(ctx, argv, argc, ifversion);
+    fsNotifyWrite(ctx, argv[1], path, npathlen);
+    RedisModule_Free(path);
     return REDISMODULE_OK;
 }
 
 /* ===================================================================
- * FS.CAT key path
+ * FS.CAT key path [WITHVERSION]
  *
- * Read file content. Follows symlinks.
+ * Read file content. Follows symlinks. With WITHVERSION, the reply is a
+ * two-element array [content, version] for use with IFVERSION writes.
  * =================================================================== */
 static int CAT_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
     RedisModule_AutoMemory(ctx);
-    if (argc != 3) return RedisModule_WrongArity(ctx);
+    if (argc < 3 || argc > 4) return RedisModule_WrongArity(ctx);
+    if (fsRoute(ctx, argv, argc, 2, 0)) return REDISMODULE_OK;
+
+    int withversion = 0;
+    if (argc == 4) {
+        const char *opt = RedisModule_StringPtrLen(argv[3], NULL);
+        if (!strcasecmp(opt, "WITHVERSION")) {
+            withversion = 1;
+        } else {
+            return RedisModule_ReplyWithError(ctx, "ERR syntax error — expected WITHVERSION");
+        }
+    }
 
     RedisModuleKey *key;
     fsObject *fs = fsGetObject(ctx, argv[1], REDISMODULE_READ, &key);
@@ -981,6 +2064,7 @@ static int CAT_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int a
         return RedisModule_ReplyWithError(ctx, "ERR path depth exceeds limit");
 
     fsInode *inode = fsLookup(fs, resolved, strlen(resolved));
+    fsCountAccess(fs, inode, FS_HOT_READS, resolved);
     RedisModule_Free(resolved);
 
     if (!inode)
@@ -990,11 +2074,14 @@ static int CAT_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int a
 
     inode->atime = fsNowMs();
 
+    if (withversion) RedisModule_ReplyWithArray(ctx, 2);
     if (inode->payload.file.size == 0)
-        return RedisModule_ReplyWithStringBuffer(ctx, "", 0);
-
-    return RedisModule_ReplyWithStringBuffer(ctx, inode->payload.file.data,
-                                              inode->payload.file.size);
+        RedisModule_ReplyWithStringBuffer(ctx, "", 0);
+    else
+        RedisModule_ReplyWithStringBuffer(ctx, fsFileContent(ctx, inode),
+                                          inode->payload.file.size);
+    if (withversion) RedisModule_ReplyWithLongLong(ctx, (long long)inode->version);
+    return REDISMODULE_OK;
 }
 
 /* ===================================================================
@@ -1007,6 +2094,7 @@ static int CAT_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int a
 static int LINES_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
     RedisModule_AutoMemory(ctx);
     if (argc < 3 || argc > 5) return RedisModule_WrongArity(ctx);
+    if (fsRoute(ctx, argv, argc, 2, 0)) return REDISMODULE_OK;
 
     RedisModuleKey *key;
     fsObject *fs = fsGetObject(ctx, argv[1], REDISMODULE_READ, &key);
@@ -1024,6 +2112,7 @@ static int LINES_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int
     if (err) return RedisModule_ReplyWithError(ctx, "ERR too many levels of symbolic links");
 
     fsInode *inode = fsLookup(fs, resolved, strlen(resolved));
+    fsCountAccess(fs, inode, FS_HOT_READS, resolved);
     RedisModule_Free(resolved);
 
     if (!inode)
@@ -1035,7 +2124,7 @@ static int LINES_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int
 
     // If no range specified, return entire file.
     if (argc == 3) {
-        return RedisModule_ReplyWithStringBuffer(ctx, inode->payload.file.data,
+        return RedisModule_ReplyWithStringBuffer(ctx, fsFileContent(ctx, inode),
                                                   inode->payload.file.size);
     }
 
@@ -1061,7 +2150,7 @@ static int LINES_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int
     if (inode->payload.file.size == 0)
         return RedisModule_ReplyWithStringBuffer(ctx, "", 0);
 
-    const char *data = inode->payload.file.data;
+    const char *data = fsFileContent(ctx, inode);
     size_t size = inode->payload.file.size;
 
     // Find line boundaries.
@@ -1101,14 +2190,18 @@ static int LINES_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int
 }
 
 /* ===================================================================
- * FS.REPLACE key path old_str new_str [ALL] [LINE start end]
+ * FS.REPLACE key path old_str new_str [ALL] [LINE start end] [IFVERSION v]
  *
  * Replace exact string in a file.
  * Returns the number of replacements made.
  * =================================================================== */
 static int REPLACE_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
     RedisModule_AutoMemory(ctx);
+    long long ifversion;
+    if (fsParseIfVersion(ctx, argv, &argc, 5, &ifversion) != REDISMODULE_OK)
+        return REDISMODULE_OK;
     if (argc < 5) return RedisModule_WrongArity(ctx);
+    if (fsRoute(ctx, argv, argc, 2, 0)) return REDISMODULE_OK;
 
     RedisModuleKey *key;
     fsObject *fs = fsGetObject(ctx, argv[1], REDISMODULE_READ|REDISMODULE_WRITE, &key);
@@ -1126,19 +2219,31 @@ static int REPLACE_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, i
     if (err) return RedisModule_ReplyWithError(ctx, "ERR too many levels of symbolic links");
 
     fsInode *inode = fsLookup(fs, resolved, strlen(resolved));
-    RedisModule_Free(resolved);
-
-    if (!inode)
+    if (!fsCheckVersion(ctx, inode, ifversion)) {
+        RedisModule_Free(resolved);
+        return REDISMODULE_OK;
+    }
+    if (!inode) {
+        RedisModule_Free(resolved);
         return RedisModule_ReplyWithNull(ctx);
-    if (inode->type != FS_INODE_FILE)
+    }
+    if (inode->type != FS_INODE_FILE) {
+        RedisModule_Free(resolved);
         return RedisModule_ReplyWithError(ctx, "ERR not a file");
+    }
+    if (inode->payload.file.log) {
+        RedisModule_Free(resolved);
+        return RedisModule_ReplyWithError(ctx, "ERR log files are append-only — rewrite with FS.ECHO");
+    }
 
     size_t oldlen, newlen;
     const char *oldstr = RedisModule_StringPtrLen(argv[3], &oldlen);
     const char *newstr = RedisModule_StringPtrLen(argv[4], &newlen);
 
-    if (oldlen == 0)
+    if (oldlen == 0) {
+        RedisModule_Free(resolved);
         return RedisModule_ReplyWithError(ctx, "ERR search string cannot be empty");
+    }
 
     // Parse optional flags.
     int replace_all = 0;
@@ -1151,13 +2256,16 @@ static int REPLACE_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, i
         if (flaglen == 3 && strncasecmp(flag, "ALL", 3) == 0) {
             replace_all = 1;
         } else if (flaglen == 4 && strncasecmp(flag, "LINE", 4) == 0) {
-            if (i + 2 >= argc)
+            if (i + 2 >= argc) {
+                RedisModule_Free(resolved);
                 return RedisModule_ReplyWithError(ctx, "ERR LINE requires start and end arguments");
+            }
             if (RedisModule_StringToLongLong(argv[i+1], &line_start) != REDISMODULE_OK ||
-                RedisModule_StringToLongLong(argv[i+2], &line_end) != REDISMODULE_OK)
-                return RedisModule_ReplyWithError(ctx, "ERR invalid LINE range");
-            if (line_start < 1 || line_end < line_start)
+                RedisModule_StringToLongLong(argv[i+2], &line_end) != REDISMODULE_OK ||
+                line_start < 1 || line_end < line_start) {
+                RedisModule_Free(resolved);
                 return RedisModule_ReplyWithError(ctx, "ERR invalid LINE range");
+            }
             have_line_constraint = 1;
             i += 2;
         }
@@ -1166,19 +2274,17 @@ static int REPLACE_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, i
     const char *data = inode->payload.file.data;
     size_t size = inode->payload.file.size;
 
-    // Build result buffer.
-    size_t capacity = size + 256;
-    char *result = RedisModule_Alloc(capacity);
-    size_t result_len = 0;
+    // Collect the matches as splices; the file is rewritten in place and
+    // the same list is what gets replicated.
+    fsSplice *splices = NULL;
+    size_t capacity = 0;
     long long replacements = 0;
     long long current_line = 1;
-    size_t line_start_pos = 0;
 
     for (size_t i = 0; i <= size; ) {
         // Track line boundaries for LINE constraint.
         if (i < size && data[i] == '\n') {
             current_line++;
-            line_start_pos = i + 1;
         }
 
         // Check if we're within line constraint.
@@ -1196,22 +2302,17 @@ static int REPLACE_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, i
         }
 
         if (match) {
-            // Ensure capacity for new string.
-            while (result_len + newlen + (size - i - oldlen) + 1 > capacity) {
-                capacity *= 2;
-                result = RedisModule_Realloc(result, capacity);
+            if ((size_t)replacements == capacity) {
+                capacity = capacity ? capacity * 2 : 16;
+                splices = RedisModule_Realloc(splices, sizeof(*splices) * capacity);
             }
-            memcpy(result + result_len, newstr, newlen);
-            result_len += newlen;
+            splices[replacements].off = i;
+            splices[replacements].del = oldlen;
+            splices[replacements].data = newstr;
+            splices[replacements].len = newlen;
             i += oldlen;
             replacements++;
         } else if (i < size) {
-            // Copy character.
-            if (result_len + 1 >= capacity) {
-                capacity *= 2;
-                result = RedisModule_Realloc(result, capacity);
-            }
-            result[result_len++] = data[i];
             i++;
         } else {
             break;
@@ -1221,25 +2322,33 @@ static int REPLACE_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, i
     // Update file if replacements were made.
     if (replacements > 0) {
         size_t old_size = inode->payload.file.size;
-        fsFileSetData(inode, result, result_len);
-        fs->total_data_size = fs->total_data_size - old_size + result_len;
+        fsFileSplice(inode, splices, (size_t)replacements);
+        fs->total_data_size = fs->total_data_size - old_size + inode->payload.file.size;
         inode->mtime = fsNowMs();
-        RedisModule_ReplicateVerbatim(ctx);
+        fsInodeBump(fs, inode);
+        fsCountAccess(fs, inode, FS_HOT_WRITES, resolved);
+        fsReplicateSplices(ctx, argv[1], resolved, splices, (size_t)replacements, inode);
+        fsNotifyWrite(ctx, argv[1], resolved, strlen(resolved));
     }
 
-    RedisModule_Free(result);
+    if (splices) RedisModule_Free(splices);
+    RedisModule_Free(resolved);
     return RedisModule_ReplyWithLongLong(ctx, replacements);
 }
 
 /* ===================================================================
- * FS.INSERT key path line_num content
+ * FS.INSERT key path line_num content [IFVERSION v]
  *
  * Insert content after line_num. Line 0 means insert at beginning.
  * Line -1 means append at end. Returns OK.
  * =================================================================== */
 static int INSERT_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
     RedisModule_AutoMemory(ctx);
+    long long ifversion;
+    if (fsParseIfVersion(ctx, argv, &argc, 5, &ifversion) != REDISMODULE_OK)
+        return REDISMODULE_OK;
     if (argc != 5) return RedisModule_WrongArity(ctx);
+    if (fsRoute(ctx, argv, argc, 2, 0)) return REDISMODULE_OK;
 
     RedisModuleKey *key;
     fsObject *fs = fsGetObject(ctx, argv[1], REDISMODULE_READ|REDISMODULE_WRITE, &key);
@@ -1271,6 +2380,10 @@ static int INSERT_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, in
     if (err) return RedisModule_ReplyWithError(ctx, "ERR too many levels of symbolic links");
 
     fsInode *inode = fsLookup(fs, resolved, strlen(resolved));
+    if (!fsCheckVersion(ctx, inode, ifversion)) {
+        RedisModule_Free(resolved);
+        return REDISMODULE_OK;
+    }
 
     // If file doesn't exist, create it.
     if (!inode) {
@@ -1280,23 +2393,27 @@ static int INSERT_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, in
             return RedisModule_ReplyWithError(ctx, "ERR cannot create parent directories");
         }
         inode = fsInodeCreate(FS_INODE_FILE, 0);
-        RedisModule_DictSetC(fs->inodes, resolved, strlen(resolved), inode);
-        fs->file_count++;
+        fsInsert(fs, resolved, strlen(resolved), inode);
         // Add to parent.
         char *parent = fsParentPath(resolved, strlen(resolved));
         fsInode *parent_inode = fsLookup(fs, parent, strlen(parent));
         if (parent_inode && parent_inode->type == FS_INODE_DIR) {
             char *base = fsBaseName(resolved, strlen(resolved));
-            fsDirAddChild(parent_inode, base, strlen(base));
+            fsDirAddChild(parent_inode, base, strlen(base), inode);
             RedisModule_Free(base);
+            fsInodeBump(fs, parent_inode);
         }
         RedisModule_Free(parent);
     }
 
-    RedisModule_Free(resolved);
-
-    if (inode->type != FS_INODE_FILE)
+    if (inode->type != FS_INODE_FILE) {
+        RedisModule_Free(resolved);
         return RedisModule_ReplyWithError(ctx, "ERR not a file");
+    }
+    if (inode->payload.file.log) {
+        RedisModule_Free(resolved);
+        return RedisModule_ReplyWithError(ctx, "ERR log files are append-only — rewrite with FS.ECHO");
+    }
 
     const char *data = inode->payload.file.data;
     size_t size = inode->payload.file.size;
@@ -1331,59 +2448,50 @@ static int INSERT_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, in
         }
     }
 
-    // Build new content.
+    // Build the inserted bytes, with newlines added as needed to keep the
+    // content on lines of its own.
     int need_newline_before = (insert_pos > 0 && insert_pos == size &&
                                size > 0 && data[size-1] != '\n');
     int need_newline_after = (insert_pos < size && contentlen > 0 &&
                               content[contentlen-1] != '\n');
 
-    size_t new_size = size + contentlen + (need_newline_before ? 1 : 0) +
-                      (need_newline_after ? 1 : 0);
-    char *new_data = RedisModule_Alloc(new_size + 1);
+    size_t inslen = contentlen + (need_newline_before ? 1 : 0) +
+                    (need_newline_after ? 1 : 0);
+    char *ins = RedisModule_Alloc(inslen + 1);
     size_t pos = 0;
-
-    // Copy before insertion point.
-    memcpy(new_data, data, insert_pos);
-    pos = insert_pos;
-
-    // Add newline before if needed.
-    if (need_newline_before) {
-        new_data[pos++] = '\n';
-    }
-
-    // Insert content.
-    memcpy(new_data + pos, content, contentlen);
+    if (need_newline_before) ins[pos++] = '\n';
+    memcpy(ins + pos, content, contentlen);
     pos += contentlen;
+    if (need_newline_after) ins[pos++] = '\n';
 
-    // Add newline after if needed.
-    if (need_newline_after) {
-        new_data[pos++] = '\n';
-    }
-
-    // Copy after insertion point.
-    memcpy(new_data + pos, data + insert_pos, size - insert_pos);
-    pos += size - insert_pos;
-
-    size_t old_size = inode->payload.file.size;
-    fsFileSetData(inode, new_data, pos);
-    fs->total_data_size = fs->total_data_size - old_size + pos;
+    fsSplice splice = { insert_pos, 0, ins, inslen };
+    fsFileSplice(inode, &splice, 1);
+    fs->total_data_size += inslen;
     inode->mtime = fsNowMs();
+    fsInodeBump(fs, inode);
+    fsCountAccess(fs, inode, FS_HOT_WRITES, resolved);
 
-    RedisModule_Free(new_data);
-    RedisModule_ReplicateVerbatim(ctx);
+    fsReplicateSplices(ctx, argv[1], resolved, &splice, 1, inode);
+    fsNotifyWrite(ctx, argv[1], resolved, strlen(resolved));
+    RedisModule_Free(ins);
+    RedisModule_Free(resolved);
 
     return RedisModule_ReplyWithSimpleString(ctx, "OK");
 }
 
 /* ===================================================================
- * FS.DELETELINES key path start end
+ * FS.DELETELINES key path start end [IFVERSION v]
  *
  * Delete lines from start to end (inclusive, 1-indexed).
  * Returns the number of lines deleted.
  * =================================================================== */
 static int DELETELINES_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
     RedisModule_AutoMemory(ctx);
+    long long ifversion;
+    if (fsParseIfVersion(ctx, argv, &argc, 5, &ifversion) != REDISMODULE_OK)
+        return REDISMODULE_OK;
     if (argc != 5) return RedisModule_WrongArity(ctx);
+    if (fsRoute(ctx, argv, argc, 2, 0)) return REDISMODULE_OK;
 
     RedisModuleKey *key;
     fsObject *fs = fsGetObject(ctx, argv[1], REDISMODULE_READ|REDISMODULE_WRITE, &key);
@@ -1416,18 +2524,30 @@ static int DELETELINES_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **arg
     if (err) return RedisModule_ReplyWithError(ctx, "ERR too many levels of symbolic links");
 
     fsInode *inode = fsLookup(fs, resolved, strlen(resolved));
-    RedisModule_Free(resolved);
-
-    if (!inode)
+    if (!fsCheckVersion(ctx, inode, ifversion)) {
+        RedisModule_Free(resolved);
+        return REDISMODULE_OK;
+    }
+    if (!inode) {
+        RedisModule_Free(resolved);
         return RedisModule_ReplyWithNull(ctx);
-    if (inode->type != FS_INODE_FILE)
+    }
+    if (inode->type != FS_INODE_FILE) {
+        RedisModule_Free(resolved);
         return RedisModule_ReplyWithError(ctx, "ERR not a file");
+    }
+    if (inode->payload.file.log) {
+        RedisModule_Free(resolved);
+        return RedisModule_ReplyWithError(ctx, "ERR log files are append-only — rewrite with FS.ECHO");
+    }
 
     const char *data = inode->payload.file.data;
     size_t size = inode->payload.file.size;
 
-    if (size == 0)
+    if (size == 0) {
+        RedisModule_Free(resolved);
         return RedisModule_ReplyWithLongLong(ctx, 0);
+    }
 
     // Find line boundaries.
     size_t delete_start = 0, delete_end = 0;
@@ -1458,29 +2578,141 @@ static int DELETELINES_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **arg
     }
 
     if (!found_start || !found_end) {
+        RedisModule_Free(resolved);
         return RedisModule_ReplyWithLongLong(ctx, 0);
     }
 
-    // Build new content without the deleted lines.
-    size_t new_size = size - (delete_end - delete_start);
-    char *new_data = RedisModule_Alloc(new_size + 1);
-    memcpy(new_data, data, delete_start);
-    memcpy(new_data + delete_start, data + delete_end, size - delete_end);
+    // Cut the lines out in place.
+    fsSplice splice = { delete_start, delete_end - delete_start, NULL, 0 };
+    fsFileSplice(inode, &splice, 1);
+    fs->total_data_size -= splice.del;
+    inode->mtime = fsNowMs();
+    fsInodeBump(fs, inode);
+    fsCountAccess(fs, inode, FS_HOT_WRITES, resolved);
+
+    fsReplicateSplices(ctx, argv[1], resolved, &splice, 1, inode);
+    fsNotifyWrite(ctx, argv[1], resolved, strlen(resolved));
+    RedisModule_Free(resolved);
+
+    return RedisModule_ReplyWithLongLong(ctx, lines_deleted);
+}
+
+/* ===================================================================
+ * FS.SPLICE key path offset delete data [offset delete data ...]
+ *           [IFVERSION v]
+ *
+ * Edit a file by byte ranges: at each offset, delete `delete` bytes and
+ * insert `data`. Offsets refer to the file as it was before the command
+ * and must be ascending and non-overlapping. A missing file is created,
+ * with its parents, in which case every range must be at offset 0.
+ * Follows symlinks. Returns the new file size.
+ *
+ * This is also how FS.REPLACE, FS.INSERT and FS.DELETELINES replicate:
+ * replicas and the AOF apply the computed ranges instead of repeating
+ * the scan, so an edit costs them O(delta) plus a memmove of the tail.
+ * =================================================================== */
+static int SPLICE_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+    RedisModule_AutoMemory(ctx);
+    long long ifversion = -1;
+    // Ranges come in threes, so only a trailing pair can be IFVERSION.
+    if (argc % 3 == 2 &&
+        fsParseIfVersion(ctx, argv, &argc, 6, &ifversion) != REDISMODULE_OK)
+        return REDISMODULE_OK;
+    if (argc < 6 || argc % 3 != 0) return RedisModule_WrongArity(ctx);
+    if (fsRoute(ctx, argv, argc, 2, 0)) return REDISMODULE_OK;
+
+    size_t n = (size_t)(argc - 3) / 3;
+    fsSplice *splices = RedisModule_Alloc(sizeof(*splices) * n);
+    size_t prev_end = 0;
+    for (size_t i = 0; i < n; i++) {
+        long long off, del;
+        if (RedisModule_StringToLongLong(argv[3 + 3*i], &off) != REDISMODULE_OK ||
+            RedisModule_StringToLongLong(argv[4 + 3*i], &del) != REDISMODULE_OK ||
+            off < 0 || del < 0) {
+            RedisModule_Free(splices);
+            return RedisModule_ReplyWithError(ctx, "ERR offset and delete length must be non-negative integers");
+        }
+        if ((size_t)off < prev_end) {
+            RedisModule_Free(splices);
+            return RedisModule_ReplyWithError(ctx, "ERR splice ranges must be ascending and non-overlapping");
+        }
+        splices[i].off = (size_t)off;
+        splices[i].del = (size_t)del;
+        splices[i].data = RedisModule_StringPtrLen(argv[5 + 3*i], &splices[i].len);
+        prev_end = splices[i].off + splices[i].del;
+    }
+
+    RedisModuleKey *key;
+    fsObject *fs = fsGetObject(ctx, argv[1], REDISMODULE_READ|REDISMODULE_WRITE, &key);
+    if (!key) {
+        RedisModule_Free(splices);
+        return REDISMODULE_OK;
+    }
+
+    size_t pathlen;
+    const char *rawpath = RedisModule_StringPtrLen(argv[2], &pathlen);
+    char *path = fsNormalizeOrReply(ctx, rawpath, pathlen);
+    if (!path) {
+        RedisModule_Free(splices);
+        return REDISMODULE_OK;
+    }
+
+    int err;
+    char *resolved = fsResolvePath(fs, path, strlen(path), &err);
+    RedisModule_Free(path);
+    if (err) {
+        RedisModule_Free(splices);
+        return RedisModule_ReplyWithError(ctx, "ERR too many levels of symbolic links");
+    }
+    size_t rlen = strlen(resolved);
+
+    fsInode *inode = fsLookup(fs, resolved, rlen);
+    const char *errmsg = NULL;
+    if (inode && inode->type != FS_INODE_FILE)
+        errmsg = "ERR not a file";
+    else if (inode && inode->payload.file.log)
+        errmsg = "ERR log files are append-only — rewrite with FS.ECHO";
+    else if (prev_end > (inode ? inode->payload.file.size : 0))
+        errmsg = "ERR splice range beyond end of file";
+    if (errmsg || !fsCheckVersion(ctx, inode, ifversion)) {
+        RedisModule_Free(splices);
+        RedisModule_Free(resolved);
+        fsMaybeDeleteKey(key, fs);
+        return errmsg ? RedisModule_ReplyWithError(ctx, errmsg) : REDISMODULE_OK;
+    }
 
-    // Remove trailing newline if we deleted to end and there's a trailing newline.
-    if (new_size > 0 && new_data[new_size - 1] == '\n' && delete_end == size) {
-        // Don't remove - keep file consistent.
+    if (!inode) {
+        if (fsEnsureParents(fs, resolved, rlen) != 0) {
+            RedisModule_Free(splices);
+            RedisModule_Free(resolved);
+            return RedisModule_ReplyWithError(ctx, "ERR cannot create parent directories");
+        }
+        inode = fsInodeCreate(FS_INODE_FILE, 0);
+        fsInsert(fs, resolved, rlen, inode);
+        char *parent = fsParentPath(resolved, rlen);
+        fsInode *parent_inode = fsLookup(fs, parent, strlen(parent));
+        if (parent_inode && parent_inode->type == FS_INODE_DIR) {
+            char *base = fsBaseName(resolved, rlen);
+            fsDirAddChild(parent_inode, base, strlen(base), inode);
+            RedisModule_Free(base);
+            fsInodeBump(fs, parent_inode);
+        }
+        RedisModule_Free(parent);
     }
 
     size_t old_size = inode->payload.file.size;
-    fsFileSetData(inode, new_data, new_size);
-    fs->total_data_size = fs->total_data_size - old_size + new_size;
+    fsFileSplice(inode, splices, n);
+    fs->total_data_size = fs->total_data_size - old_size + inode->payload.file.size;
     inode->mtime = fsNowMs();
+    fsInodeBump(fs, inode);
+    fsCountAccess(fs, inode, FS_HOT_WRITES, resolved);
+    RedisModule_Free(splices);
 
-    RedisModule_Free(new_data);
-    RedisModule_ReplicateVerbatim(ctx);
-
-    return RedisModule_ReplyWithLongLong(ctx, lines_deleted);
+    RedisModule_ReplyWithLongLong(ctx, (long long)inode->payload.file.size);
+    fsReplicateWrite(ctx, argv, argc, ifversion);
+    fsNotifyWrite(ctx, argv[1], resolved, rlen);
+    RedisModule_Free(resolved);
+    return REDISMODULE_OK;
 }
 
 /* ===================================================================
@@ -1491,6 +2723,7 @@ static int DELETELINES_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **arg
 static int HEAD_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
     RedisModule_AutoMemory(ctx);
     if (argc < 3 || argc > 4) return RedisModule_WrongArity(ctx);
+    if (fsRoute(ctx, argv, argc, 2, 0)) return REDISMODULE_OK;
 
     RedisModuleKey *key;
     fsObject *fs = fsGetObject(ctx, argv[1], REDISMODULE_READ, &key);
@@ -1520,6 +2753,7 @@ static int HEAD_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int
     if (err) return RedisModule_ReplyWithError(ctx, "ERR too many levels of symbolic links");
 
     fsInode *inode = fsLookup(fs, resolved, strlen(resolved));
+    fsCountAccess(fs, inode, FS_HOT_READS, resolved);
     RedisModule_Free(resolved);
 
     if (!inode)
@@ -1532,7 +2766,7 @@ static int HEAD_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int
     if (n == 0 || inode->payload.file.size == 0)
         return RedisModule_ReplyWithStringBuffer(ctx, "", 0);
 
-    const char *data = inode->payload.file.data;
+    const char *data = fsFileContent(ctx, inode);
     size_t size = inode->payload.file.size;
 
     // Find end of line N.
@@ -1552,14 +2786,180 @@ static int HEAD_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int
     return RedisModule_ReplyWithStringBuffer(ctx, data, end_pos);
 }
 
+/* Default and largest COUNT for FS.TAIL ... FOLLOW. */
+#define FS_FOLLOW_COUNT      (1024 * 1024)
+#define FS_FOLLOW_MAX_COUNT  (64 * 1024 * 1024)
+
+/* A follower's position, kept while it is blocked. */
+typedef struct fsFollow {
+    char *path;             /* Normalized, not yet resolved */
+    long long offset;       /* Next byte to return */
+    long long count;        /* Most bytes per reply */
+} fsFollow;
+
+/* Reply with what the file holds from f->offset on, if anything. Offsets
+ * into a log count the bytes retention dropped, so they stay valid as
+ * segments go; an offset before the oldest byte kept reads from there,
+ * and one past the end (the file was truncated) from the start. Returns
+ * 1 once a reply was sent (data or an error), 0 if there is nothing new
+ * yet, including when the key or the file does not exist. */
+static int fsFollowTry(RedisModuleCtx *ctx, RedisModuleString *keyname, fsFollow *f) {
+    RedisModuleKey *key = RedisModule_OpenKey(ctx, keyname, REDISMODULE_READ);
+    int type = RedisModule_KeyType(key);
+    if (type == REDISMODULE_KEYTYPE_EMPTY) {
+        RedisModule_CloseKey(key);
+        return 0;
+    }
+    if (RedisModule_ModuleTypeGetType(key) != FSType) {
+        RedisModule_CloseKey(key);
+        RedisModule_ReplyWithError(ctx, REDISMODULE_ERRORMSG_WRONGTYPE);
+        return 1;
+    }
+    fsObject *fs = RedisModule_ModuleTypeGetValue(key);
+
+    int err;
+    char *resolved = fsResolvePath(fs, f->path, strlen(f->path), &err);
+    if (err) {
+        RedisModule_CloseKey(key);
+        RedisModule_ReplyWithError(ctx, err == FS_RESOLVE_ERR_SYMLINK_LOOP
+            ? "ERR too many levels of symbolic links"
+            : "ERR path depth exceeds limit");
+        return 1;
+    }
+    fsInode *inode = fsLookup(fs, resolved, strlen(resolved));
+    fsCountAccess(fs, inode, FS_HOT_READS, resolved);
+    RedisModule_Free(resolved);
+    if (!inode) {
+        RedisModule_CloseKey(key);
+        return 0;
+    }
+    if (inode->type != FS_INODE_FILE) {
+        RedisModule_CloseKey(key);
+        RedisModule_ReplyWithError(ctx, "ERR not a file");
+        return 1;
+    }
+
+    const fsLog *log = inode->payload.file.log;
+    long long base = log ? (long long)log->dropped : 0;
+    long long end = base + (long long)inode->payload.file.size;
+    if (f->offset > end || f->offset < base) f->offset = base;
+    if (f->offset == end) {
+        RedisModule_CloseKey(key);
+        return 0;
+    }
+
+    size_t n = (size_t)(end - f->offset);
+    if ((long long)n > f->count) n = (size_t)f->count;
+    size_t off = (size_t)(f->offset - base);
+    inode->atime = fsNowMs();
+    RedisModule_ReplyWithArray(ctx, 2);
+    RedisModule_ReplyWithLongLong(ctx, f->offset + (long long)n);
+    if (log) {
+        char *buf = RedisModule_Alloc(n);
+        fsLogRead(log, off, n, buf);
+        RedisModule_ReplyWithStringBuffer(ctx, buf, n);
+        RedisModule_Free(buf);
+    } else {
+        RedisModule_ReplyWithStringBuffer(ctx, inode->payload.file.data + off, n);
+    }
+    RedisModule_CloseKey(key);
+    return 1;
+}
+
+/* Called when a write signals the key a follower is blocked on. Returning
+ * REDISMODULE_ERR keeps it blocked. */
+static int fsFollowReady(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+    REDISMODULE_NOT_USED(argv);
+    REDISMODULE_NOT_USED(argc);
+    fsFollow *f = RedisModule_GetBlockedClientPrivateData(ctx);
+    RedisModuleString *keyname = RedisModule_GetBlockedClientReadyKey(ctx);
+    return fsFollowTry(ctx, keyname, f) ? REDISMODULE_OK : REDISMODULE_ERR;
+}
+
+static int fsFollowTimeout(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+    REDISMODULE_NOT_USED(argv);
+    REDISMODULE_NOT_USED(argc);
+    return RedisModule_ReplyWithNull(ctx);
+}
+
+static void fsFollowFree(RedisModuleCtx *ctx, void *privdata) {
+    REDISMODULE_NOT_USED(ctx);
+    fsFollow *f = privdata;
+    RedisModule_Free(f->path);
+    RedisModule_Free(f);
+    fsFollowers--;
+}
+
+/* FS.TAIL key path FOLLOW offset [BLOCK ms] [COUNT bytes] */
+static int fsTailFollow(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+    if (argc % 2 == 0) return RedisModule_WrongArity(ctx);
+
+    long long offset, block = -1, count = FS_FOLLOW_COUNT;
+    if (RedisModule_StringToLongLong(argv[4], &offset) != REDISMODULE_OK || offset < 0)
+        return RedisModule_ReplyWithError(ctx, "ERR offset must be a non-negative integer");
+    for (int i = 5; i < argc; i += 2) {
+        const char *opt = RedisModule_StringPtrLen(argv[i], NULL);
+        if (!strcasecmp(opt, "BLOCK")) {
+            if (RedisModule_StringToLongLong(argv[i + 1], &block) != REDISMODULE_OK || block < 0)
+                return RedisModule_ReplyWithError(ctx, "ERR BLOCK must be a non-negative integer");
+        } else if (!strcasecmp(opt, "COUNT")) {
+            if (RedisModule_StringToLongLong(argv[i + 1], &count) != REDISMODULE_OK ||
+                count < 1 || count > FS_FOLLOW_MAX_COUNT)
+                return RedisModule_ReplyWithError(ctx,
+                    "ERR COUNT must be between 1 and 67108864");
+        } else {
+            return RedisModule_ReplyWithError(ctx, "ERR syntax error — expected BLOCK or COUNT");
+        }
+    }
+
+    size_t pathlen;
+    const char *rawpath = RedisModule_StringPtrLen(argv[2], &pathlen);
+    char *path = fsNormalizeOrReply(ctx, rawpath, pathlen);
+    if (!path) return REDISMODULE_OK;
+
+    fsFollow f = { path, offset, count };
+    if (fsFollowTry(ctx, argv[1], &f)) {
+        RedisModule_Free(path);
+        return REDISMODULE_OK;
+    }
+
+    // Nothing new. Like XREAD, only block when asked to and when the
+    // client can be blocked (not inside MULTI or a script).
+    int flags = RedisModule_GetContextFlags(ctx);
+    if (block < 0 || (flags & (REDISMODULE_CTX_FLAGS_MULTI |
+                               REDISMODULE_CTX_FLAGS_LUA |
+                               REDISMODULE_CTX_FLAGS_DENY_BLOCKING))) {
+        RedisModule_Free(path);
+        return RedisModule_ReplyWithNull(ctx);
+    }
+    fsFollow *wait = RedisModule_Alloc(sizeof(*wait));
+    *wait = f;
+    fsFollowers++;
+    RedisModule_BlockClientOnKeys(ctx, fsFollowReady, fsFollowTimeout, fsFollowFree,
+                                  block, &argv[1], 1, wait);
+    return REDISMODULE_OK;
+}
+
 /* ===================================================================
  * FS.TAIL key path [n]
+ * FS.TAIL key path FOLLOW offset [BLOCK ms] [COUNT bytes]
  *
  * Return the last N lines of a file (default 10).
+ *
+ * With FOLLOW, return [next offset, bytes] for what the file holds from
+ * offset on, at most COUNT bytes (default 1MB). When there is nothing
+ * new, BLOCK waits up to ms milliseconds (0 = forever) for a write to
+ * the file, like XREAD BLOCK, and replies nil on timeout; without BLOCK
+ * it replies nil at once. The file need not exist yet.
  * =================================================================== */
 static int TAIL_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
     RedisModule_AutoMemory(ctx);
+    if (argc >= 5 && !strcasecmp(RedisModule_StringPtrLen(argv[3], NULL), "FOLLOW")) {
+        if (fsRoute(ctx, argv, argc, 2, 0)) return REDISMODULE_OK;
+        return fsTailFollow(ctx, argv, argc);
+    }
     if (argc < 3 || argc > 4) return RedisModule_WrongArity(ctx);
+    if (fsRoute(ctx, argv, argc, 2, 0)) return REDISMODULE_OK;
 
     RedisModuleKey *key;
     fsObject *fs = fsGetObject(ctx, argv[1], REDISMODULE_READ, &key);
@@ -1589,6 +2989,7 @@ static int TAIL_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int
     if (err) return RedisModule_ReplyWithError(ctx, "ERR too many levels of symbolic links");
 
     fsInode *inode = fsLookup(fs, resolved, strlen(resolved));
+    fsCountAccess(fs, inode, FS_HOT_READS, resolved);
     RedisModule_Free(resolved);
 
     if (!inode)
@@ -1601,6 +3002,16 @@ static int TAIL_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int
     if (n == 0 || inode->payload.file.size == 0)
         return RedisModule_ReplyWithStringBuffer(ctx, "", 0);
 
+    if (inode->payload.file.log) {
+        // Read back only the segments the last n lines span.
+        const fsLog *log = inode->payload.file.log;
+        uint64_t start = fsLogTailOffset(log, n);
+        size_t len = (size_t)(log->size - start);
+        char *buf = RedisModule_PoolAlloc(ctx, len);
+        fsLogRead(log, start, len, buf);
+        return RedisModule_ReplyWithStringBuffer(ctx, buf, len);
+    }
+
     const char *data = inode->payload.file.data;
     size_t size = inode->payload.file.size;
 
@@ -1637,53 +3048,271 @@ static int TAIL_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int
 }
 
 /* ===================================================================
- * FS.WC key path
+ * FS.WATCH key path [RECURSIVE] [SINCE token] [TIMEOUT ms]
  *
- * Return line, word, and character counts for a file.
- * Returns: [lines, N, words, N, chars, N]
+ * Wait for a write that concerns path: to path itself, to a child (with
+ * RECURSIVE, to anything below it), or to an ancestor that took it along.
+ * Replies [token, [changed paths]]; passing the token as SINCE next time
+ * returns at once whatever changed in between. A token the journal no
+ * longer covers (too old, or from before a restart) gets [token, [path]],
+ * meaning rescan path. TIMEOUT (default 0 = forever) ends the wait with
+ * [token, []].
  * =================================================================== */
-static int WC_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
-    RedisModule_AutoMemory(ctx);
-    if (argc != 3) return RedisModule_WrongArity(ctx);
-
-    RedisModuleKey *key;
-    fsObject *fs = fsGetObject(ctx, argv[1], REDISMODULE_READ, &key);
-    if (!key) return REDISMODULE_OK;
-    if (!fs) return RedisModule_ReplyWithNull(ctx);
-
-    size_t pathlen;
-    const char *rawpath = RedisModule_StringPtrLen(argv[2], &pathlen);
-    char *path = fsNormalizePath(rawpath, pathlen);
 
-    // Resolve symlinks.
-    int err;
-    char *resolved = fsResolvePath(fs, path, strlen(path), &err);
-    RedisModule_Free(path);
-    if (err) return RedisModule_ReplyWithError(ctx, "ERR too many levels of symbolic links");
+static void fsWatchReplyToken(RedisModuleCtx *ctx, int64_t epoch, uint64_t seq) {
+    char buf[64];
+    int len = snprintf(buf, sizeof(buf), "%lld-%llu",
+                       (long long)epoch, (unsigned long long)seq);
+    RedisModule_ReplyWithStringBuffer(ctx, buf, (size_t)len);
+}
 
-    fsInode *inode = fsLookup(fs, resolved, strlen(resolved));
-    RedisModule_Free(resolved);
+/* Can the journal (NULL if the key has none) answer from this token? */
+static int fsWatchTokenValid(const fsJournal *j, int64_t epoch, uint64_t seq) {
+    if (!j) return epoch == 0 && seq == 0;
+    return epoch == j->epoch && seq <= j->seq && seq + 1 >= fsJournalOldest(j);
+}
 
-    if (!inode)
-        return RedisModule_ReplyWithNull(ctx);
-    if (inode->type != FS_INODE_FILE)
-        return RedisModule_ReplyWithError(ctx, "ERR not a file");
+/* Reply [current token, changes after seq that concern the watch], each
+ * path once, in the order first changed. When there are none, reply
+ * nothing and return 0, unless always is set. */
+static int fsWatchReplyChanges(RedisModuleCtx *ctx, const fsJournal *j,
+                               const char *path, size_t pathlen, int recursive,
+                               uint64_t seq, int always) {
+    RedisModuleDict *seen = NULL;
+    for (uint64_t s = seq + 1; s <= j->seq; s++) {
+        const fsJournalEntry *e = fsJournalGet(j, s);
+        if (!fsWatchMatches(path, pathlen, recursive, e->path, e->pathlen)) continue;
+        if (!seen) seen = RedisModule_CreateDict(NULL);
+        RedisModule_DictSetC(seen, e->path, e->pathlen, (void*)e);
+    }
+    if (!seen && !always) return 0;
 
-    inode->atime = fsNowMs();
+    RedisModule_ReplyWithArray(ctx, 2);
+    fsWatchReplyToken(ctx, j->epoch, j->seq);
+    if (!seen) {
+        RedisModule_ReplyWithArray(ctx, 0);
+        return 1;
+    }
+    RedisModule_ReplyWithArray(ctx, (long)RedisModule_DictSize(seen));
+    for (uint64_t s = seq + 1; s <= j->seq; s++) {
+        const fsJournalEntry *e = fsJournalGet(j, s);
+        int nokey = 0;
+        if (RedisModule_DictGetC(seen, e->path, e->pathlen, &nokey) != e) continue;
+        RedisModule_ReplyWithStringBuffer(ctx, e->path, e->pathlen);
+    }
+    RedisModule_FreeDict(NULL, seen);
+    return 1;
+}
 
-    const char *data = inode->payload.file.data;
-    size_t size = inode->payload.file.size;
+/* The journal of the key a watcher is on, if the key still exists. */
+static fsJournal *fsWatcherJournal(RedisModuleCtx *ctx, fsWatcher *w) {
+    RedisModuleString *keyname = RedisModule_CreateString(ctx,
+        w->regkey + 8, w->pathoff - 8);
+    RedisModuleKey *key = RedisModule_OpenKey(ctx, keyname,
+        REDISMODULE_READ|REDISMODULE_OPEN_KEY_NOTOUCH|REDISMODULE_OPEN_KEY_NOSTATS);
+    fsJournal *j = NULL;
+    if (RedisModule_ModuleTypeGetType(key) == FSType)
+        j = ((fsObject*)RedisModule_ModuleTypeGetValue(key))->journal;
+    RedisModule_CloseKey(key);
+    RedisModule_FreeString(ctx, keyname);
+    return j;
+}
 
-    long long lines = 0, words = 0, chars = (long long)size;
-    int in_word = 0;
+/* Woken by fsWatchWake. */
+static int fsWatchReady(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+    REDISMODULE_NOT_USED(argv);
+    REDISMODULE_NOT_USED(argc);
+    fsWatcher *w = RedisModule_GetBlockedClientPrivateData(ctx);
+    const char *path = w->regkey + w->pathoff;
+    size_t pathlen = w->regkeylen - w->pathoff;
+    fsJournal *j = fsWatcherJournal(ctx, w);
+    // A watcher that blocked before the key had a journal can read all of
+    // it, as long as it still starts at the first change: the write that
+    // woke us started it.
+    if (j && (fsWatchTokenValid(j, w->epoch, w->seq) ||
+              (w->epoch == 0 && fsJournalOldest(j) == 1))) {
+        fsWatchReplyChanges(ctx, j, path, pathlen, w->recursive, w->seq, 1);
+        return REDISMODULE_OK;
+    }
+    // The journal moved on too far, or went with the key: report what woke
+    // us, or ask for a rescan when changes may have been missed.
+    RedisModule_ReplyWithArray(ctx, 2);
+    if (j) {
+        fsWatchReplyToken(ctx, j->epoch, j->seq);
+        RedisModule_ReplyWithArray(ctx, 1);
+        RedisModule_ReplyWithStringBuffer(ctx, path, pathlen);
+    } else {
+        fsWatchReplyToken(ctx, 0, 0);
+        RedisModule_ReplyWithArray(ctx, 1);
+        RedisModule_ReplyWithStringBuffer(ctx, w->changed, w->changedlen);
+    }
+    return REDISMODULE_OK;
+}
 
-    for (size_t i = 0; i < size; i++) {
-        unsigned char c = (unsigned char)data[i];
+/* Nothing the watch cares about changed, so the current token is safe to
+ * resume from. */
+static int fsWatchTimeout(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+    REDISMODULE_NOT_USED(argv);
+    REDISMODULE_NOT_USED(argc);
+    fsWatcher *w = RedisModule_GetBlockedClientPrivateData(ctx);
+    fsJournal *j = fsWatcherJournal(ctx, w);
+    RedisModule_ReplyWithArray(ctx, 2);
+    if (j && j->epoch == w->epoch)
+        fsWatchReplyToken(ctx, j->epoch, j->seq);
+    else
+        fsWatchReplyToken(ctx, w->epoch, w->seq);
+    return RedisModule_ReplyWithArray(ctx, 0);
+}
 
-        // Count newlines.
-        if (c == '\n') {
-            lines++;
-        }
+static void fsWatchFree(RedisModuleCtx *ctx, void *privdata) {
+    REDISMODULE_NOT_USED(ctx);
+    fsWatcher *w = privdata;
+    fsWatcherUnregister(w);
+    RedisModule_Free(w->regkey);
+    if (w->changed) RedisModule_Free(w->changed);
+    RedisModule_Free(w);
+}
+
+static int WATCH_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+    RedisModule_AutoMemory(ctx);
+    if (argc < 3) return RedisModule_WrongArity(ctx);
+
+    int recursive = 0, since = 0;
+    int64_t epoch = 0;
+    uint64_t seq = 0;
+    long long timeout = 0;
+    for (int i = 3; i < argc; i++) {
+        const char *opt = RedisModule_StringPtrLen(argv[i], NULL);
+        if (!strcasecmp(opt, "RECURSIVE")) {
+            recursive = 1;
+        } else if (!strcasecmp(opt, "SINCE") && i + 1 < argc) {
+            size_t toklen;
+            const char *tok = RedisModule_StringPtrLen(argv[++i], &toklen);
+            if (!fsWatchParseToken(tok, toklen, &epoch, &seq))
+                return RedisModule_ReplyWithError(ctx, "ERR invalid SINCE token");
+            since = 1;
+        } else if (!strcasecmp(opt, "TIMEOUT") && i + 1 < argc) {
+            if (RedisModule_StringToLongLong(argv[++i], &timeout) != REDISMODULE_OK || timeout < 0)
+                return RedisModule_ReplyWithError(ctx, "ERR TIMEOUT must be a non-negative integer");
+        } else {
+            return RedisModule_ReplyWithError(ctx, "ERR syntax error — expected RECURSIVE, SINCE or TIMEOUT");
+        }
+    }
+    if (fsRoute(ctx, argv, argc, 2, 0)) return REDISMODULE_OK;
+
+    RedisModuleKey *key = RedisModule_OpenKey(ctx, argv[1], REDISMODULE_READ);
+    fsObject *fs = NULL;
+    if (RedisModule_KeyType(key) != REDISMODULE_KEYTYPE_EMPTY) {
+        if (RedisModule_ModuleTypeGetType(key) != FSType)
+            return RedisModule_ReplyWithError(ctx, REDISMODULE_ERRORMSG_WRONGTYPE);
+        fs = RedisModule_ModuleTypeGetValue(key);
+    }
+
+    size_t pathlen;
+    const char *rawpath = RedisModule_StringPtrLen(argv[2], &pathlen);
+    char *path = fsNormalizeOrReply(ctx, rawpath, pathlen);
+    if (!path) return REDISMODULE_OK;
+    size_t npathlen = strlen(path);
+
+    // From the first watch on, the key records its changes.
+    if (fs && !fs->journal) fs->journal = fsJournalCreate();
+    fsJournal *j = fs ? fs->journal : NULL;
+
+    if (since) {
+        if (!fsWatchTokenValid(j, epoch, seq)) {
+            RedisModule_ReplyWithArray(ctx, 2);
+            fsWatchReplyToken(ctx, j ? j->epoch : 0, j ? j->seq : 0);
+            RedisModule_ReplyWithArray(ctx, 1);
+            RedisModule_ReplyWithStringBuffer(ctx, path, npathlen);
+            RedisModule_Free(path);
+            return REDISMODULE_OK;
+        }
+        if (j && fsWatchReplyChanges(ctx, j, path, npathlen, recursive, seq, 0)) {
+            RedisModule_Free(path);
+            return REDISMODULE_OK;
+        }
+    } else if (j) {
+        epoch = j->epoch;
+        seq = j->seq;
+    }
+
+    int flags = RedisModule_GetContextFlags(ctx);
+    if (flags & (REDISMODULE_CTX_FLAGS_MULTI |
+                 REDISMODULE_CTX_FLAGS_LUA |
+                 REDISMODULE_CTX_FLAGS_DENY_BLOCKING)) {
+        RedisModule_ReplyWithArray(ctx, 2);
+        fsWatchReplyToken(ctx, j ? j->epoch : 0, j ? j->seq : 0);
+        RedisModule_ReplyWithArray(ctx, 0);
+        RedisModule_Free(path);
+        return REDISMODULE_OK;
+    }
+
+    fsWatcher *w = RedisModule_Alloc(sizeof(*w));
+    memset(w, 0, sizeof(*w));
+    size_t keylen;
+    const char *k = RedisModule_StringPtrLen(argv[1], &keylen);
+    w->regkey = fsWatchKey(RedisModule_GetSelectedDb(ctx), k, keylen,
+                           path, npathlen, &w->regkeylen, &w->pathoff);
+    w->recursive = recursive;
+    w->epoch = epoch;
+    w->seq = seq;
+    RedisModule_Free(path);
+    w->bc = RedisModule_BlockClient(ctx, fsWatchReady, fsWatchTimeout, fsWatchFree, timeout);
+    RedisModule_BlockClientSetPrivateData(w->bc, w);
+    fsWatcherRegister(w);
+    return REDISMODULE_OK;
+}
+
+/* ===================================================================
+ * FS.WC key path
+ *
+ * Return line, word, and character counts for a file.
+ * Returns: [lines, N, words, N, chars, N]
+ * =================================================================== */
+static int WC_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+    RedisModule_AutoMemory(ctx);
+    if (argc != 3) return RedisModule_WrongArity(ctx);
+    if (fsRoute(ctx, argv, argc, 2, 0)) return REDISMODULE_OK;
+
+    RedisModuleKey *key;
+    fsObject *fs = fsGetObject(ctx, argv[1], REDISMODULE_READ, &key);
+    if (!key) return REDISMODULE_OK;
+    if (!fs) return RedisModule_ReplyWithNull(ctx);
+
+    size_t pathlen;
+    const char *rawpath = RedisModule_StringPtrLen(argv[2], &pathlen);
+    char *path = fsNormalizePath(rawpath, pathlen);
+
+    // Resolve symlinks.
+    int err;
+    char *resolved = fsResolvePath(fs, path, strlen(path), &err);
+    RedisModule_Free(path);
+    if (err) return RedisModule_ReplyWithError(ctx, "ERR too many levels of symbolic links");
+
+    fsInode *inode = fsLookup(fs, resolved, strlen(resolved));
+    fsCountAccess(fs, inode, FS_HOT_READS, resolved);
+    RedisModule_Free(resolved);
+
+    if (!inode)
+        return RedisModule_ReplyWithNull(ctx);
+    if (inode->type != FS_INODE_FILE)
+        return RedisModule_ReplyWithError(ctx, "ERR not a file");
+
+    inode->atime = fsNowMs();
+
+    const char *data = fsFileContent(ctx, inode);
+    size_t size = inode->payload.file.size;
+
+    long long lines = 0, words = 0, chars = (long long)size;
+    int in_word = 0;
+
+    for (size_t i = 0; i < size; i++) {
+        unsigned char c = (unsigned char)data[i];
+
+        // Count newlines.
+        if (c == '\n') {
+            lines++;
+        }
 
         // Count words (whitespace-separated).
         int is_space = (c == ' ' || c == '\t' || c == '\n' || c == '\r' ||
@@ -1715,14 +3344,19 @@ static int WC_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int ar
 }
 
 /* ===================================================================
- * FS.APPEND key path content
+ * FS.APPEND key path content [IFVERSION v]
  *
  * Append to a file. Creates the file if it doesn't exist.
- * Returns the new size.
+ * Returns the new size. Appending nothing to an existing file changes
+ * nothing: no version bump, replication or watch event.
  * =================================================================== */
 static int APPEND_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
     RedisModule_AutoMemory(ctx);
+    long long ifversion;
+    if (fsParseIfVersion(ctx, argv, &argc, 4, &ifversion) != REDISMODULE_OK)
+        return REDISMODULE_OK;
     if (argc != 4) return RedisModule_WrongArity(ctx);
+    if (fsRoute(ctx, argv, argc, 2, 0)) return REDISMODULE_OK;
 
     RedisModuleKey *key;
     fsObject *fs = fsGetObject(ctx, argv[1], REDISMODULE_READ|REDISMODULE_WRITE, &key);
@@ -1740,6 +3374,12 @@ static int APPEND_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, in
         return RedisModule_ReplyWithError(ctx, "ERR cannot append to root directory");
     }
 
+    fsInode *existing = fsLookup(fs, path, npathlen);
+    if (!fsCheckVersion(ctx, existing, ifversion)) {
+        RedisModule_Free(path);
+        return REDISMODULE_OK;
+    }
+
     if (fsEnsureParents(fs, path, npathlen) != 0) {
         RedisModule_Free(path);
         return RedisModule_ReplyWithError(ctx, "ERR parent path conflict");
@@ -1748,82 +3388,165 @@ static int APPEND_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, in
     size_t datalen;
     const char *data = RedisModule_StringPtrLen(argv[3], &datalen);
 
-    fsInode *existing = fsLookup(fs, path, npathlen);
     if (existing) {
         if (existing->type != FS_INODE_FILE) {
             RedisModule_Free(path);
             return RedisModule_ReplyWithError(ctx, "ERR not a file");
         }
+        if (datalen == 0) {
+            RedisModule_Free(path);
+            return RedisModule_ReplyWithLongLong(ctx, existing->payload.file.size);
+        }
+        fsLogExpire(ctx, argv[1], fs, existing, path);
         fsFileAppendData(existing, data, datalen);
         fs->total_data_size += datalen;
+        fsLogRetain(fs, existing);
         existing->mtime = fsNowMs();
-        RedisModule_Free(path);
+        fsInodeBump(fs, existing);
+        fsCountAccess(fs, existing, FS_HOT_WRITES, path);
         RedisModule_ReplyWithLongLong(ctx, existing->payload.file.size);
     } else {
         fsInode *inode = fsInodeCreate(FS_INODE_FILE, 0);
         fsFileSetData(inode, data, datalen);
         fsInsert(fs, path, npathlen, inode);
         fs->total_data_size += datalen;
+        fsCountAccess(fs, inode, FS_HOT_WRITES, path);
 
         char *parent = fsParentPath(path, npathlen);
         fsInode *pnode = fsLookup(fs, parent, strlen(parent));
         if (pnode && pnode->type == FS_INODE_DIR) {
             char *base = fsBaseName(path, npathlen);
-            fsDirAddChild(pnode, base, strlen(base));
+            fsDirAddChild(pnode, base, strlen(base), inode);
             RedisModule_Free(base);
             pnode->mtime = fsNowMs();
+            fsInodeBump(fs, pnode);
         }
         RedisModule_Free(parent);
-        RedisModule_Free(path);
         RedisModule_ReplyWithLongLong(ctx, datalen);
     }
 
-    RedisModule_ReplicateVerbatim(ctx);
+    fsReplicateWrite(ctx, argv, argc, ifversion);
+    fsNotifyWrite(ctx, argv[1], path, npathlen);
+    RedisModule_Free(path);
     return REDISMODULE_OK;
 }
 
 /* ===================================================================
- * FS.RM key path [RECURSIVE]
+ * FS.LOG key path [SEGMENT bytes] [MAXSIZE bytes] [MAXAGE ms] [DROP n]
  *
- * Delete a file, directory, or symlink. Directories must be empty
- * unless RECURSIVE is specified.
+ * Make a file a log: create it empty, or convert a plain file, whose
+ * content becomes the first segment. Options left out keep their value
+ * (a new log has 1MB segments and no retention; 0 turns MAXSIZE or
+ * MAXAGE off). DROP removes the n oldest sealed segments. Retention is
+ * applied here and after every append.
  * =================================================================== */
-/* Depth-first deletion of an entire subtree. We delete children before
- * the directory itself because removing a child modifies the parent's
- * children array. To avoid iterator invalidation, we snapshot the
- * children list before recursing. */
-static int fsDeleteRecursive(fsObject *fs, const char *path, size_t pathlen) {
-    fsInode *inode = fsLookup(fs, path, pathlen);
-    if (!inode) return -1;
+static int LOG_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+    RedisModule_AutoMemory(ctx);
+    if (argc < 3 || argc % 2 == 0) return RedisModule_WrongArity(ctx);
+    if (fsRoute(ctx, argv, argc, 2, 0)) return REDISMODULE_OK;
+
+    long long segment = -1, maxsize = -1, maxage = -1, drop = 0;
+    for (int i = 3; i < argc; i += 2) {
+        const char *opt = RedisModule_StringPtrLen(argv[i], NULL);
+        long long *slot;
+        if (!strcasecmp(opt, "SEGMENT")) slot = &segment;
+        else if (!strcasecmp(opt, "MAXSIZE")) slot = &maxsize;
+        else if (!strcasecmp(opt, "MAXAGE")) slot = &maxage;
+        else if (!strcasecmp(opt, "DROP")) slot = &drop;
+        else return RedisModule_ReplyWithError(ctx, "ERR syntax error — expected SEGMENT, MAXSIZE, MAXAGE or DROP");
+        if (RedisModule_StringToLongLong(argv[i+1], slot) != REDISMODULE_OK || *slot < 0)
+            return RedisModule_ReplyWithError(ctx, "ERR log options must be non-negative integers");
+    }
+    if (segment != -1 && (segment < FS_LOG_MIN_SEGMENT || segment > FS_LOG_MAX_SEGMENT))
+        return RedisModule_ReplyWithError(ctx, "ERR SEGMENT must be between 1024 and 67108864");
 
-    if (inode->type == FS_INODE_DIR) {
-        // Snapshot children list — recursion will modify the original.
-        size_t nchildren = inode->payload.dir.count;
-        char **children_copy = NULL;
-        if (nchildren > 0) {
-            children_copy = RedisModule_Alloc(sizeof(char*) * nchildren);
-            for (size_t i = 0; i < nchildren; i++) {
-                size_t clen = strlen(inode->payload.dir.children[i]);
-                children_copy[i] = RedisModule_Alloc(clen + 1);
-                memcpy(children_copy[i], inode->payload.dir.children[i], clen + 1);
-            }
+    RedisModuleKey *key;
+    fsObject *fs = fsGetObject(ctx, argv[1], REDISMODULE_READ|REDISMODULE_WRITE, &key);
+    if (!key) return REDISMODULE_OK;
+
+    size_t pathlen;
+    const char *rawpath = RedisModule_StringPtrLen(argv[2], &pathlen);
+    char *path = fsNormalizeOrReply(ctx, rawpath, pathlen);
+    if (!path) return REDISMODULE_OK;
+    size_t npathlen = strlen(path);
+
+    if (fsIsRoot(path, npathlen)) {
+        RedisModule_Free(path);
+        return RedisModule_ReplyWithError(ctx, "ERR not a file");
+    }
+
+    fsInode *inode = fsLookup(fs, path, npathlen);
+    if (inode && inode->type != FS_INODE_FILE) {
+        RedisModule_Free(path);
+        return RedisModule_ReplyWithError(ctx, "ERR not a file");
+    }
+    if (!inode) {
+        if (fsEnsureParents(fs, path, npathlen) != 0) {
+            RedisModule_Free(path);
+            return RedisModule_ReplyWithError(ctx, "ERR parent path conflict");
         }
+        inode = fsInodeCreate(FS_INODE_FILE, 0);
+        fsInsert(fs, path, npathlen, inode);
 
-        for (size_t i = 0; i < nchildren; i++) {
-            char *childpath = fsJoinPath(path, pathlen,
-                                          children_copy[i], strlen(children_copy[i]));
-            if (!childpath) {
-                RedisModule_Free(children_copy[i]);
-                continue;
-            }
-            fsDeleteRecursive(fs, childpath, strlen(childpath));
-            RedisModule_Free(childpath);
-            RedisModule_Free(children_copy[i]);
+        char *parent = fsParentPath(path, npathlen);
+        fsInode *pnode = fsLookup(fs, parent, strlen(parent));
+        if (pnode && pnode->type == FS_INODE_DIR) {
+            char *base = fsBaseName(path, npathlen);
+            fsDirAddChild(pnode, base, strlen(base), inode);
+            RedisModule_Free(base);
+            pnode->mtime = fsNowMs();
+            fsInodeBump(fs, pnode);
         }
-        if (children_copy) RedisModule_Free(children_copy);
+        RedisModule_Free(parent);
+    }
+
+    fsLog *log = inode->payload.file.log;
+    if (!log) {
+        log = fsLogCreate();
+        fsLogAdopt(log, inode->payload.file.data, inode->payload.file.size,
+                   inode->payload.file.bloom, inode->mtime);
+        inode->payload.file.data = NULL;
+        memset(inode->payload.file.bloom, 0, FS_BLOOM_BYTES);
+        inode->payload.file.log = log;
     }
+    if (segment != -1) log->segment_bytes = (uint64_t)segment;
+    if (maxsize != -1) log->max_size = (uint64_t)maxsize;
+    if (maxage != -1) log->max_age = maxage;
+
+    size_t dropped = fsLogDrop(log, (size_t)drop);
+    fs->total_data_size -= inode->payload.file.size - log->size;
+    inode->payload.file.size = log->size;
+
+    // Replicate the effect: the options in force and every segment
+    // dropped, age included; size retention then replays by itself.
+    int flags = RedisModule_GetContextFlags(ctx);
+    if ((flags & REDISMODULE_CTX_FLAGS_MASTER) && !(flags & REDISMODULE_CTX_FLAGS_LOADING)) {
+        size_t expired = fsLogExpired(log, fsNowMs());
+        fsLogDropSegments(fs, inode, expired);
+        dropped += expired;
+    }
+    fsLogRetain(fs, inode);
+    fsInodeBump(fs, inode);
+
+    RedisModule_Replicate(ctx, "FS.LOG", "sbclclclcl", argv[1], path, npathlen,
+                          "SEGMENT", (long long)log->segment_bytes,
+                          "MAXSIZE", (long long)log->max_size,
+                          "MAXAGE", (long long)log->max_age,
+                          "DROP", (long long)dropped);
+    fsNotifyWrite(ctx, argv[1], path, npathlen);
+    RedisModule_Free(path);
+    return RedisModule_ReplyWithSimpleString(ctx, "OK");
+}
 
-    // Remove from parent's children.
+/* ===================================================================
+ * FS.RM key path [RECURSIVE] [IFVERSION v]
+ *
+ * Delete a file, directory, or symlink. Directories must be empty
+ * unless RECURSIVE is specified.
+ * =================================================================== */
+/* Detach a single inode from its parent directory and free it. The caller
+ * guarantees it is not a non-empty directory. */
+static void fsUnlink(fsObject *fs, const char *path, size_t pathlen) {
     if (!fsIsRoot(path, pathlen)) {
         char *parent = fsParentPath(path, pathlen);
         fsInode *pnode = fsLookup(fs, parent, strlen(parent));
@@ -1832,18 +3555,50 @@ static int fsDeleteRecursive(fsObject *fs, const char *path, size_t pathlen) {
             fsDirRemoveChild(pnode, base, strlen(base));
             RedisModule_Free(base);
             pnode->mtime = fsNowMs();
+            fsInodeBump(fs, pnode);
         }
         RedisModule_Free(parent);
     }
 
     fsInode *removed = fsRemove(fs, path, pathlen);
     if (removed) fsInodeFree(removed);
+}
+
+/* Free everything below the directory inode at path, emptying it.
+ * Children are taken off the end of the array, so nothing shifts and the
+ * array needs no snapshot, and each is reached through its entry rather
+ * than looked up. */
+static void fsFreeChildren(fsObject *fs, const char *path, size_t pathlen, fsInode *inode) {
+    while (inode->payload.dir.count > 0) {
+        fsDirent e = inode->payload.dir.children[--inode->payload.dir.count];
+        char *childpath = fsJoinPath(path, pathlen, e.name, strlen(e.name));
+        RedisModule_Free(e.name);
+        if (!childpath) continue;
+        size_t childlen = strlen(childpath);
+        if (e.inode && e.inode->type == FS_INODE_DIR)
+            fsFreeChildren(fs, childpath, childlen, e.inode);
+        fsInode *removed = fsRemove(fs, childpath, childlen);
+        if (removed) fsInodeFree(removed);
+        RedisModule_Free(childpath);
+    }
+}
+
+/* Delete an entire subtree: its descendants, then path itself. */
+static int fsDeleteRecursive(fsObject *fs, const char *path, size_t pathlen) {
+    fsInode *inode = fsLookup(fs, path, pathlen);
+    if (!inode) return -1;
+    if (inode->type == FS_INODE_DIR) fsFreeChildren(fs, path, pathlen, inode);
+    fsUnlink(fs, path, pathlen);
     return 0;
 }
 
 static int RM_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
     RedisModule_AutoMemory(ctx);
+    long long ifversion;
+    if (fsParseIfVersion(ctx, argv, &argc, 3, &ifversion) != REDISMODULE_OK)
+        return REDISMODULE_OK;
     if (argc < 3 || argc > 4) return RedisModule_WrongArity(ctx);
+    if (fsRoute(ctx, argv, argc, 2, 0)) return REDISMODULE_OK;
 
     int recursive = 0;
     if (argc == 4) {
@@ -1877,6 +3632,10 @@ static int RM_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int ar
     }
 
     fsInode *inode = fsLookup(fs, path, npathlen);
+    if (!fsCheckVersion(ctx, inode, ifversion)) {
+        RedisModule_Free(path);
+        return REDISMODULE_OK;
+    }
     if (!inode) {
         RedisModule_Free(path);
         return RedisModule_ReplyWithLongLong(ctx, 0);
@@ -1887,42 +3646,39 @@ static int RM_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int ar
         return RedisModule_ReplyWithError(ctx, "ERR directory not empty — use RECURSIVE");
     }
 
+    if (recursive && fsMountsUnder(fs, path, npathlen)) {
+        RedisModule_Free(path);
+        return RedisModule_ReplyWithError(ctx, "ERR subtree contains a mount point — unmount it first");
+    }
+
     if (recursive) {
         fsDeleteRecursive(fs, path, npathlen);
     } else {
-        // Remove from parent.
-        char *parent = fsParentPath(path, npathlen);
-        fsInode *pnode = fsLookup(fs, parent, strlen(parent));
-        if (pnode && pnode->type == FS_INODE_DIR) {
-            char *base = fsBaseName(path, npathlen);
-            fsDirRemoveChild(pnode, base, strlen(base));
-            RedisModule_Free(base);
-            pnode->mtime = fsNowMs();
-        }
-        RedisModule_Free(parent);
-
-        fsInode *removed = fsRemove(fs, path, npathlen);
-        if (removed) fsInodeFree(removed);
+        fsUnlink(fs, path, npathlen);
     }
 
-    RedisModule_Free(path);
-
     // Redis convention: delete key when empty (only root left).
     fsMaybeDeleteKey(key, fs);
 
     RedisModule_ReplyWithLongLong(ctx, 1);
-    RedisModule_ReplicateVerbatim(ctx);
+    fsReplicateWrite(ctx, argv, argc, ifversion);
+    fsNotifyWrite(ctx, argv[1], path, npathlen);
+    RedisModule_Free(path);
     return REDISMODULE_OK;
 }
 
 /* ===================================================================
- * FS.TOUCH key path
+ * FS.TOUCH key path [IFVERSION v]
  *
  * Create an empty file or update its mtime. Creates parent dirs.
  * =================================================================== */
 static int TOUCH_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
     RedisModule_AutoMemory(ctx);
+    long long ifversion;
+    if (fsParseIfVersion(ctx, argv, &argc, 3, &ifversion) != REDISMODULE_OK)
+        return REDISMODULE_OK;
     if (argc != 3) return RedisModule_WrongArity(ctx);
+    if (fsRoute(ctx, argv, argc, 2, 0)) return REDISMODULE_OK;
 
     RedisModuleKey *key;
     fsObject *fs = fsGetObject(ctx, argv[1], REDISMODULE_READ|REDISMODULE_WRITE, &key);
@@ -1935,15 +3691,21 @@ static int TOUCH_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int
     if (!path) return REDISMODULE_OK;
     size_t npathlen = strlen(path);
 
+    fsInode *existing = fsLookup(fs, path, npathlen);
+    if (!fsCheckVersion(ctx, existing, ifversion)) {
+        RedisModule_Free(path);
+        return REDISMODULE_OK;
+    }
+
     if (fsEnsureParents(fs, path, npathlen) != 0) {
         RedisModule_Free(path);
         return RedisModule_ReplyWithError(ctx, "ERR parent path conflict");
     }
 
-    fsInode *existing = fsLookup(fs, path, npathlen);
     if (existing) {
         existing->mtime = fsNowMs();
         existing->atime = fsNowMs();
+        fsInodeBump(fs, existing);
     } else {
         fsInode *inode = fsInodeCreate(FS_INODE_FILE, 0);
         fsInsert(fs, path, npathlen, inode);
@@ -1952,27 +3714,33 @@ static int TOUCH_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int
         fsInode *pnode = fsLookup(fs, parent, strlen(parent));
         if (pnode && pnode->type == FS_INODE_DIR) {
             char *base = fsBaseName(path, npathlen);
-            fsDirAddChild(pnode, base, strlen(base));
+            fsDirAddChild(pnode, base, strlen(base), inode);
             RedisModule_Free(base);
             pnode->mtime = fsNowMs();
+            fsInodeBump(fs, pnode);
         }
         RedisModule_Free(parent);
     }
 
     RedisModule_Free(path);
     RedisModule_ReplyWithSimpleString(ctx, "OK");
-    RedisModule_ReplicateVerbatim(ctx);
+    fsReplicateWrite(ctx, argv, argc, ifversion);
+    fsNotifyWriteArg(ctx, argv[1], argv[2]);
     return REDISMODULE_OK;
 }
 
 /* ===================================================================
- * FS.MKDIR key path [PARENTS]
+ * FS.MKDIR key path [PARENTS] [IFVERSION v]
  *
  * Create a directory. With PARENTS, create intermediate dirs (mkdir -p).
  * =================================================================== */
 static int MKDIR_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
     RedisModule_AutoMemory(ctx);
+    long long ifversion;
+    if (fsParseIfVersion(ctx, argv, &argc, 3, &ifversion) != REDISMODULE_OK)
+        return REDISMODULE_OK;
     if (argc < 3 || argc > 4) return RedisModule_WrongArity(ctx);
+    if (fsRoute(ctx, argv, argc, 2, 0)) return REDISMODULE_OK;
 
     int parents = 0;
     if (argc == 4) {
@@ -1997,6 +3765,10 @@ static int MKDIR_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int
 
     // Check if already exists.
     fsInode *existing = fsLookup(fs, path, npathlen);
+    if (!fsCheckVersion(ctx, existing, ifversion)) {
+        RedisModule_Free(path);
+        return REDISMODULE_OK;
+    }
     if (existing) {
         if (existing->type == FS_INODE_DIR && parents) {
             // mkdir -p on existing dir is ok.
@@ -2032,135 +3804,17 @@ static int MKDIR_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int
     fsInode *pnode = fsLookup(fs, parent, strlen(parent));
     if (pnode && pnode->type == FS_INODE_DIR) {
         char *base = fsBaseName(path, npathlen);
-        fsDirAddChild(pnode, base, strlen(base));
+        fsDirAddChild(pnode, base, strlen(base), dir);
         RedisModule_Free(base);
         pnode->mtime = fsNowMs();
+        fsInodeBump(fs, pnode);
     }
     RedisModule_Free(parent);
 
     RedisModule_Free(path);
     RedisModule_ReplyWithSimpleString(ctx, "OK");
-    RedisModule_ReplicateVerbatim(ctx);
-    return REDISMODULE_OK;
-}
-
-/* ===================================================================
- * FS.LS key path [LONG]
- *
- * List directory contents. LONG returns metadata with each entry.
- * =================================================================== */
-static int LS_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
-    RedisModule_AutoMemory(ctx);
-    if (argc < 2 || argc > 4) return RedisModule_WrongArity(ctx);
-
-    /* Parse optional path and LONG flag.
-     * Forms: FS.LS key [path] [LONG] */
-    int longformat = 0;
-    const char *rawpath = "/";
-    size_t pathlen = 1;
-
-    if (argc == 4) {
-        // FS.LS key path LONG
-        const char *opt = RedisModule_StringPtrLen(argv[3], NULL);
-        if (!strcasecmp(opt, "LONG")) {
-            longformat = 1;
-        } else {
-            return RedisModule_ReplyWithError(ctx, "ERR syntax error — expected LONG");
-        }
-        rawpath = RedisModule_StringPtrLen(argv[2], &pathlen);
-    } else if (argc == 3) {
-        // FS.LS key <path|LONG>
-        size_t arglen;
-        const char *arg = RedisModule_StringPtrLen(argv[2], &arglen);
-        if (!strcasecmp(arg, "LONG")) {
-            longformat = 1; // path stays "/"
-        } else {
-            rawpath = arg;
-            pathlen = arglen;
-        }
-    }
-    // argc == 2: FS.LS key — path defaults to "/"
-
-    RedisModuleKey *key;
-    fsObject *fs = fsGetObject(ctx, argv[1], REDISMODULE_READ, &key);
-    if (!key) return REDISMODULE_OK;
-    if (!fs) return RedisModule_ReplyWithError(ctx, "ERR no such filesystem key");
-    char *path = fsNormalizeOrReply(ctx, rawpath, pathlen);
-    if (!path) return REDISMODULE_OK;
-    size_t npathlen = strlen(path);
-
-    // Resolve symlinks.
-    int err;
-    char *resolved = fsResolvePath(fs, path, npathlen, &err);
-    RedisModule_Free(path);
-    if (err == FS_RESOLVE_ERR_SYMLINK_LOOP)
-        return RedisModule_ReplyWithError(ctx, "ERR too many levels of symbolic links");
-    if (err == FS_RESOLVE_ERR_PATH_DEPTH)
-        return RedisModule_ReplyWithError(ctx, "ERR path depth exceeds limit");
-
-    fsInode *dir = fsLookup(fs, resolved, strlen(resolved));
-    if (!dir) {
-        RedisModule_Free(resolved);
-        return RedisModule_ReplyWithError(ctx, "ERR no such directory");
-    }
-    if (dir->type != FS_INODE_DIR) {
-        RedisModule_Free(resolved);
-        return RedisModule_ReplyWithError(ctx, "ERR not a directory");
-    }
-
-    dir->atime = fsNowMs();
-
-    if (!longformat) {
-        RedisModule_ReplyWithArray(ctx, dir->payload.dir.count);
-        for (size_t i = 0; i < dir->payload.dir.count; i++) {
-            RedisModule_ReplyWithCString(ctx, dir->payload.dir.children[i]);
-        }
-    } else {
-        // Long format: each entry is [name, type, mode, size, mtime].
-        RedisModule_ReplyWithArray(ctx, dir->payload.dir.count);
-        for (size_t i = 0; i < dir->payload.dir.count; i++) {
-            char *childpath = fsJoinPath(resolved, strlen(resolved),
-                                          dir->payload.dir.children[i],
-                                          strlen(dir->payload.dir.children[i]));
-            if (!childpath) {
-                RedisModule_ReplyWithArray(ctx, 5);
-                RedisModule_ReplyWithCString(ctx, dir->payload.dir.children[i]);
-                RedisModule_ReplyWithCString(ctx, "unknown");
-                RedisModule_ReplyWithCString(ctx, "0000");
-                RedisModule_ReplyWithLongLong(ctx, 0);
-                RedisModule_ReplyWithLongLong(ctx, 0);
-                continue;
-            }
-            fsInode *child = fsLookup(fs, childpath, strlen(childpath));
-            RedisModule_Free(childpath);
-
-            RedisModule_ReplyWithArray(ctx, 5);
-            RedisModule_ReplyWithCString(ctx, dir->payload.dir.children[i]);
-            if (child) {
-                const char *typestr = "unknown";
-                switch (child->type) {
-                case FS_INODE_FILE: typestr = "file"; break;
-                case FS_INODE_DIR: typestr = "dir"; break;
-                case FS_INODE_SYMLINK: typestr = "symlink"; break;
-                }
-                RedisModule_ReplyWithCString(ctx, typestr);
-                char modebuf[8];
-                snprintf(modebuf, sizeof(modebuf), "%04o", child->mode);
-                RedisModule_ReplyWithCString(ctx, modebuf);
-                int64_t size = 0;
-                if (child->type == FS_INODE_FILE) size = child->payload.file.size;
-                RedisModule_ReplyWithLongLong(ctx, size);
-                RedisModule_ReplyWithLongLong(ctx, child->mtime);
-            } else {
-                RedisModule_ReplyWithCString(ctx, "unknown");
-                RedisModule_ReplyWithCString(ctx, "0000");
-                RedisModule_ReplyWithLongLong(ctx, 0);
-                RedisModule_ReplyWithLongLong(ctx, 0);
-            }
-        }
-    }
-
-    RedisModule_Free(resolved);
+    fsReplicateWrite(ctx, argv, argc, ifversion);
+    fsNotifyWriteArg(ctx, argv[1], argv[2]);
     return REDISMODULE_OK;
 }
 
@@ -2172,6 +3826,7 @@ static int LS_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int ar
 static int STAT_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
     RedisModule_AutoMemory(ctx);
     if (argc != 3) return RedisModule_WrongArity(ctx);
+    if (fsRoute(ctx, argv, argc, 2, 0)) return REDISMODULE_OK;
 
     RedisModuleKey *key;
     fsObject *fs = fsGetObject(ctx, argv[1], REDISMODULE_READ, &key);
@@ -2188,8 +3843,9 @@ static int STAT_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int
 
     if (!inode) return RedisModule_ReplyWithNull(ctx);
 
-    // Return 16 elements: 8 field-value pairs.
-    RedisModule_ReplyWithArray(ctx, 16);
+    // 9 field-value pairs, and 5 more describing a log file.
+    const fsLog *log = inode->type == FS_INODE_FILE ? inode->payload.file.log : NULL;
+    RedisModule_ReplyWithArray(ctx, log ? 28 : 18);
 
     const char *typestr = "unknown";
     switch (inode->type) {
@@ -2228,6 +3884,21 @@ static int STAT_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int
     RedisModule_ReplyWithCString(ctx, "atime");
     RedisModule_ReplyWithLongLong(ctx, inode->atime);
 
+    RedisModule_ReplyWithCString(ctx, "version");
+    RedisModule_ReplyWithLongLong(ctx, (long long)inode->version);
+
+    if (log) {
+        RedisModule_ReplyWithCString(ctx, "segments");
+        RedisModule_ReplyWithLongLong(ctx, (long long)log->count);
+        RedisModule_ReplyWithCString(ctx, "segment_size");
+        RedisModule_ReplyWithLongLong(ctx, (long long)log->segment_bytes);
+        RedisModule_ReplyWithCString(ctx, "max_size");
+        RedisModule_ReplyWithLongLong(ctx, (long long)log->max_size);
+        RedisModule_ReplyWithCString(ctx, "max_age");
+        RedisModule_ReplyWithLongLong(ctx, log->max_age);
+        RedisModule_ReplyWithCString(ctx, "dropped");
+        RedisModule_ReplyWithLongLong(ctx, (long long)log->dropped);
+    }
     return REDISMODULE_OK;
 }
 
@@ -2239,6 +3910,7 @@ static int STAT_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int
 static int TEST_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
     RedisModule_AutoMemory(ctx);
     if (argc != 3) return RedisModule_WrongArity(ctx);
+    if (fsRoute(ctx, argv, argc, 2, 0)) return REDISMODULE_OK;
 
     RedisModuleKey *key;
     fsObject *fs = fsGetObject(ctx, argv[1], REDISMODULE_READ, &key);
@@ -2256,14 +3928,18 @@ static int TEST_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int
 }
 
 /* ===================================================================
- * FS.CHMOD key path mode
+ * FS.CHMOD key path mode [IFVERSION v]
  *
  * Change the mode (permission bits) of a path.
  * Mode is an octal string like "0755" or a decimal integer.
  * =================================================================== */
 static int CHMOD_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
     RedisModule_AutoMemory(ctx);
+    long long ifversion;
+    if (fsParseIfVersion(ctx, argv, &argc, 4, &ifversion) != REDISMODULE_OK)
+        return REDISMODULE_OK;
     if (argc != 4) return RedisModule_WrongArity(ctx);
+    if (fsRoute(ctx, argv, argc, 2, 0)) return REDISMODULE_OK;
 
     RedisModuleKey *key;
     fsObject *fs = fsGetObject(ctx, argv[1], REDISMODULE_READ|REDISMODULE_WRITE, &key);
@@ -2277,6 +3953,7 @@ static int CHMOD_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int
 
     fsInode *inode = fsLookup(fs, path, strlen(path));
     RedisModule_Free(path);
+    if (!fsCheckVersion(ctx, inode, ifversion)) return REDISMODULE_OK;
     if (!inode) return RedisModule_ReplyWithError(ctx, "ERR no such file or directory");
 
     size_t modelen;
@@ -2286,20 +3963,26 @@ static int CHMOD_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int
         return RedisModule_ReplyWithError(ctx, "ERR mode must be an octal value between 0000 and 07777");
     }
     inode->mode = mode;
+    fsInodeBump(fs, inode);
 
     RedisModule_ReplyWithSimpleString(ctx, "OK");
-    RedisModule_ReplicateVerbatim(ctx);
+    fsReplicateWrite(ctx, argv, argc, ifversion);
+    fsNotifyWriteArg(ctx, argv[1], argv[2]);
     return REDISMODULE_OK;
 }
 
 /* ===================================================================
- * FS.CHOWN key path uid [gid]
+ * FS.CHOWN key path uid [gid] [IFVERSION v]
  *
  * Change the owner (and optionally group) of a path.
  * =================================================================== */
 static int CHOWN_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
     RedisModule_AutoMemory(ctx);
+    long long ifversion;
+    if (fsParseIfVersion(ctx, argv, &argc, 4, &ifversion) != REDISMODULE_OK)
+        return REDISMODULE_OK;
     if (argc < 4 || argc > 5) return RedisModule_WrongArity(ctx);
+    if (fsRoute(ctx, argv, argc, 2, 0)) return REDISMODULE_OK;
 
     RedisModuleKey *key;
     fsObject *fs = fsGetObject(ctx, argv[1], REDISMODULE_READ|REDISMODULE_WRITE, &key);
@@ -2313,6 +3996,7 @@ static int CHOWN_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int
 
     fsInode *inode = fsLookup(fs, path, strlen(path));
     RedisModule_Free(path);
+    if (!fsCheckVersion(ctx, inode, ifversion)) return REDISMODULE_OK;
     if (!inode) return RedisModule_ReplyWithError(ctx, "ERR no such file or directory");
 
     long long uid_val;
@@ -2322,32 +4006,39 @@ static int CHOWN_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int
     if (uid_val < 0 || uid_val > UINT32_MAX) {
         return RedisModule_ReplyWithError(ctx, "ERR uid out of range");
     }
-    inode->uid = (uint32_t)uid_val;
 
+    long long gid_val = inode->gid;
     if (argc == 5) {
-        long long gid_val;
         if (RedisModule_StringToLongLong(argv[4], &gid_val) != REDISMODULE_OK) {
             return RedisModule_ReplyWithError(ctx, "ERR gid must be an integer");
         }
         if (gid_val < 0 || gid_val > UINT32_MAX) {
             return RedisModule_ReplyWithError(ctx, "ERR gid out of range");
         }
-        inode->gid = (uint32_t)gid_val;
     }
+    inode->uid = (uint32_t)uid_val;
+    inode->gid = (uint32_t)gid_val;
+    fsInodeBump(fs, inode);
 
     RedisModule_ReplyWithSimpleString(ctx, "OK");
-    RedisModule_ReplicateVerbatim(ctx);
+    fsReplicateWrite(ctx, argv, argc, ifversion);
+    fsNotifyWriteArg(ctx, argv[1], argv[2]);
     return REDISMODULE_OK;
 }
 
 /* ===================================================================
- * FS.LN key target linkpath
+ * FS.LN key target linkpath [IFVERSION v]
  *
- * Create a symbolic link at linkpath pointing to target.
+ * Create a symbolic link at linkpath pointing to target. IFVERSION is
+ * checked against linkpath, which must not exist, so only 0 can match.
  * =================================================================== */
 static int LN_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
     RedisModule_AutoMemory(ctx);
+    long long ifversion;
+    if (fsParseIfVersion(ctx, argv, &argc, 4, &ifversion) != REDISMODULE_OK)
+        return REDISMODULE_OK;
     if (argc != 4) return RedisModule_WrongArity(ctx);
+    if (fsRoute(ctx, argv, argc, 3, 0)) return REDISMODULE_OK;
 
     RedisModuleKey *key;
     fsObject *fs = fsGetObject(ctx, argv[1], REDISMODULE_READ|REDISMODULE_WRITE, &key);
@@ -2368,7 +4059,12 @@ static int LN_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int ar
         return RedisModule_ReplyWithError(ctx, "ERR cannot create symlink at root");
     }
 
-    if (fsLookup(fs, linkpath, nlinklen)) {
+    fsInode *existing = fsLookup(fs, linkpath, nlinklen);
+    if (!fsCheckVersion(ctx, existing, ifversion)) {
+        RedisModule_Free(linkpath);
+        return REDISMODULE_OK;
+    }
+    if (existing) {
         RedisModule_Free(linkpath);
         return RedisModule_ReplyWithError(ctx, "ERR path already exists");
     }
@@ -2388,15 +4084,17 @@ static int LN_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int ar
     fsInode *pnode = fsLookup(fs, parent, strlen(parent));
     if (pnode && pnode->type == FS_INODE_DIR) {
         char *base = fsBaseName(linkpath, nlinklen);
-        fsDirAddChild(pnode, base, strlen(base));
+        fsDirAddChild(pnode, base, strlen(base), inode);
         RedisModule_Free(base);
         pnode->mtime = fsNowMs();
+        fsInodeBump(fs, pnode);
     }
     RedisModule_Free(parent);
 
     RedisModule_Free(linkpath);
     RedisModule_ReplyWithSimpleString(ctx, "OK");
-    RedisModule_ReplicateVerbatim(ctx);
+    fsReplicateWrite(ctx, argv, argc, ifversion);
+    fsNotifyWriteArg(ctx, argv[1], argv[3]);
     return REDISMODULE_OK;
 }
 
@@ -2408,6 +4106,7 @@ static int LN_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int ar
 static int READLINK_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
     RedisModule_AutoMemory(ctx);
     if (argc != 3) return RedisModule_WrongArity(ctx);
+    if (fsRoute(ctx, argv, argc, 2, 0)) return REDISMODULE_OK;
 
     RedisModuleKey *key;
     fsObject *fs = fsGetObject(ctx, argv[1], REDISMODULE_READ, &key);
@@ -2430,15 +4129,16 @@ static int READLINK_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv,
 }
 
 /* ===================================================================
- * FS.CP key src dst [RECURSIVE]
+ * FS.CP key src dst [RECURSIVE] [IFVERSION v]
  *
- * Copy a file or directory.
+ * Copy a file or directory. IFVERSION is checked against dst, which must
+ * not exist, so only 0 can match.
  * =================================================================== */
-static int fsCopyRecursive(fsObject *fs, const char *src, size_t srclen,
-                            const char *dst, size_t dstlen) {
-    fsInode *sinode = fsLookup(fs, src, srclen);
-    if (!sinode) return -1;
-
+/* Copy sinode and everything below it to dst. Children are reached
+ * through their entries, so only destination paths are built. Returns
+ * the new inode, or NULL on failure. */
+static fsInode *fsCopyRecursive(fsObject *fs, fsInode *sinode,
+                                const char *dst, size_t dstlen) {
     if (sinode->type == FS_INODE_FILE) {
         fsInode *newinode = fsInodeCreate(FS_INODE_FILE, sinode->mode);
         newinode->uid = sinode->uid;
@@ -2446,12 +4146,15 @@ static int fsCopyRecursive(fsObject *fs, const char *src, size_t srclen,
         newinode->ctime = sinode->ctime;
         newinode->mtime = sinode->mtime;
         newinode->atime = sinode->atime;
-        if (sinode->payload.file.size > 0) {
+        if (sinode->payload.file.log) {
+            newinode->payload.file.log = fsLogCopy(sinode->payload.file.log);
+            newinode->payload.file.size = sinode->payload.file.size;
+        } else if (sinode->payload.file.size > 0) {
             fsFileSetData(newinode, sinode->payload.file.data, sinode->payload.file.size);
         }
         fsInsert(fs, dst, dstlen, newinode);
         fs->total_data_size += newinode->payload.file.size;
-        return 0;
+        return newinode;
     } else if (sinode->type == FS_INODE_DIR) {
         fsInode *newdir = fsInodeCreate(FS_INODE_DIR, sinode->mode);
         newdir->uid = sinode->uid;
@@ -2462,25 +4165,17 @@ static int fsCopyRecursive(fsObject *fs, const char *src, size_t srclen,
         fsInsert(fs, dst, dstlen, newdir);
 
         for (size_t i = 0; i < sinode->payload.dir.count; i++) {
-            char *childname = sinode->payload.dir.children[i];
-            size_t cnamelen = strlen(childname);
-            char *srcc = fsJoinPath(src, srclen, childname, cnamelen);
-            char *dstc = fsJoinPath(dst, dstlen, childname, cnamelen);
-            if (!srcc || !dstc) {
-                if (srcc) RedisModule_Free(srcc);
-                if (dstc) RedisModule_Free(dstc);
-                return -1;
-            }
-            fsDirAddChild(newdir, childname, cnamelen);
-            if (fsCopyRecursive(fs, srcc, strlen(srcc), dstc, strlen(dstc)) != 0) {
-                RedisModule_Free(srcc);
-                RedisModule_Free(dstc);
-                return -1;
-            }
-            RedisModule_Free(srcc);
+            const fsDirent *e = &sinode->payload.dir.children[i];
+            if (!e->inode) continue;
+            size_t cnamelen = strlen(e->name);
+            char *dstc = fsJoinPath(dst, dstlen, e->name, cnamelen);
+            if (!dstc) return NULL;
+            fsInode *copy = fsCopyRecursive(fs, e->inode, dstc, strlen(dstc));
             RedisModule_Free(dstc);
+            if (!copy) return NULL;
+            fsDirAddChild(newdir, e->name, cnamelen, copy);
         }
-        return 0;
+        return newdir;
     } else if (sinode->type == FS_INODE_SYMLINK) {
         fsInode *newlink = fsInodeCreate(FS_INODE_SYMLINK, sinode->mode);
         newlink->uid = sinode->uid;
@@ -2493,14 +4188,18 @@ static int fsCopyRecursive(fsObject *fs, const char *src, size_t srclen,
         newlink->payload.symlink.target = RedisModule_Alloc(tlen + 1);
         memcpy(newlink->payload.symlink.target, target, tlen + 1);
         fsInsert(fs, dst, dstlen, newlink);
-        return 0;
+        return newlink;
     }
-    return -1;
+    return NULL;
 }
 
 static int CP_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
     RedisModule_AutoMemory(ctx);
+    long long ifversion;
+    if (fsParseIfVersion(ctx, argv, &argc, 4, &ifversion) != REDISMODULE_OK)
+        return REDISMODULE_OK;
     if (argc < 4 || argc > 5) return RedisModule_WrongArity(ctx);
+    if (fsRoute(ctx, argv, argc, 2, 3)) return REDISMODULE_OK;
 
     int recursive = 0;
     if (argc == 5) {
@@ -2545,7 +4244,19 @@ static int CP_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int ar
         return RedisModule_ReplyWithError(ctx, "ERR source is a directory — use RECURSIVE");
     }
 
-    if (fsLookup(fs, dst, ndstlen)) {
+    if (fsMountsUnder(fs, src, nsrclen)) {
+        RedisModule_Free(src);
+        RedisModule_Free(dst);
+        return RedisModule_ReplyWithError(ctx, "ERR subtree contains a mount point — unmount it first");
+    }
+
+    fsInode *existing = fsLookup(fs, dst, ndstlen);
+    if (!fsCheckVersion(ctx, existing, ifversion)) {
+        RedisModule_Free(src);
+        RedisModule_Free(dst);
+        return REDISMODULE_OK;
+    }
+    if (existing) {
         RedisModule_Free(src);
         RedisModule_Free(dst);
         return RedisModule_ReplyWithError(ctx, "ERR destination already exists");
@@ -2557,7 +4268,8 @@ static int CP_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int ar
         return RedisModule_ReplyWithError(ctx, "ERR destination parent path conflict");
     }
 
-    if (fsCopyRecursive(fs, src, nsrclen, dst, ndstlen) != 0) {
+    fsInode *copy = fsCopyRecursive(fs, sinode, dst, ndstlen);
+    if (!copy) {
         RedisModule_Free(src);
         RedisModule_Free(dst);
         return RedisModule_ReplyWithError(ctx, "ERR copy failed");
@@ -2568,27 +4280,33 @@ static int CP_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int ar
     fsInode *pnode = fsLookup(fs, parent, strlen(parent));
     if (pnode && pnode->type == FS_INODE_DIR) {
         char *base = fsBaseName(dst, ndstlen);
-        fsDirAddChild(pnode, base, strlen(base));
+        fsDirAddChild(pnode, base, strlen(base), copy);
         RedisModule_Free(base);
         pnode->mtime = fsNowMs();
+        fsInodeBump(fs, pnode);
     }
     RedisModule_Free(parent);
 
+    RedisModule_ReplyWithSimpleString(ctx, "OK");
+    fsReplicateWrite(ctx, argv, argc, ifversion);
+    fsNotifyWrite(ctx, argv[1], dst, ndstlen);
     RedisModule_Free(src);
     RedisModule_Free(dst);
-    RedisModule_ReplyWithSimpleString(ctx, "OK");
-    RedisModule_ReplicateVerbatim(ctx);
     return REDISMODULE_OK;
 }
 
 /* ===================================================================
- * FS.MV key src dst
+ * FS.MV key src dst [IFVERSION v]
  *
  * Move/rename a file or directory.
  * =================================================================== */
 static int MV_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
     RedisModule_AutoMemory(ctx);
+    long long ifversion;
+    if (fsParseIfVersion(ctx, argv, &argc, 4, &ifversion) != REDISMODULE_OK)
+        return REDISMODULE_OK;
     if (argc != 4) return RedisModule_WrongArity(ctx);
+    if (fsRoute(ctx, argv, argc, 2, 3)) return REDISMODULE_OK;
 
     RedisModuleKey *key;
     fsObject *fs = fsGetObject(ctx, argv[1], REDISMODULE_READ|REDISMODULE_WRITE, &key);
@@ -2622,6 +4340,11 @@ static int MV_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int ar
         RedisModule_Free(dst);
         return RedisModule_ReplyWithError(ctx, "ERR source not found");
     }
+    if (!fsCheckVersion(ctx, sinode, ifversion)) {
+        RedisModule_Free(src);
+        RedisModule_Free(dst);
+        return REDISMODULE_OK;
+    }
 
     if (fsLookup(fs, dst, ndstlen)) {
         RedisModule_Free(src);
@@ -2635,6 +4358,12 @@ static int MV_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int ar
         return RedisModule_ReplyWithError(ctx, "ERR cannot move a directory into its own subtree");
     }
 
+    if (sinode->type == FS_INODE_DIR && fsMountsUnder(fs, src, nsrclen)) {
+        RedisModule_Free(src);
+        RedisModule_Free(dst);
+        return RedisModule_ReplyWithError(ctx, "ERR subtree contains a mount point — unmount it first");
+    }
+
     if (fsEnsureParents(fs, dst, ndstlen) != 0) {
         RedisModule_Free(src);
         RedisModule_Free(dst);
@@ -2691,10 +4420,9 @@ static int MV_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int ar
             newpath[newlen] = '\0';
 
             fsInode *inode_val = fsLookup(fs, moves[i].oldpath, moves[i].oldlen);
-            if (inode_val) {
-                RedisModule_DictDelC(fs->inodes, moves[i].oldpath, moves[i].oldlen, NULL);
-                RedisModule_DictSetC(fs->inodes, newpath, newlen, inode_val);
-            }
+            if (inode_val)
+                fsRelocate(fs, moves[i].oldpath, moves[i].oldlen,
+                           newpath, newlen, inode_val);
             RedisModule_Free(newpath);
             RedisModule_Free(moves[i].oldpath);
         }
@@ -2703,8 +4431,8 @@ static int MV_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int ar
     }
 
     // Move the inode itself.
-    RedisModule_DictDelC(fs->inodes, src, nsrclen, NULL);
-    RedisModule_DictSetC(fs->inodes, dst, ndstlen, sinode);
+    fsRelocate(fs, src, nsrclen, dst, ndstlen, sinode);
+    fsInodeBump(fs, sinode);
 
     // Update old parent.
     char *oldparent = fsParentPath(src, nsrclen);
@@ -2714,6 +4442,7 @@ static int MV_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int ar
         fsDirRemoveChild(opnode, oldbase, strlen(oldbase));
         RedisModule_Free(oldbase);
         opnode->mtime = fsNowMs();
+        fsInodeBump(fs, opnode);
     }
     RedisModule_Free(oldparent);
 
@@ -2722,167 +4451,539 @@ static int MV_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int ar
     fsInode *npnode = fsLookup(fs, newparent, strlen(newparent));
     if (npnode && npnode->type == FS_INODE_DIR) {
         char *newbase = fsBaseName(dst, ndstlen);
-        fsDirAddChild(npnode, newbase, strlen(newbase));
+        fsDirAddChild(npnode, newbase, strlen(newbase), sinode);
         RedisModule_Free(newbase);
         npnode->mtime = fsNowMs();
+        fsInodeBump(fs, npnode);
     }
     RedisModule_Free(newparent);
 
+    RedisModule_ReplyWithSimpleString(ctx, "OK");
+    fsReplicateWrite(ctx, argv, argc, ifversion);
+    fsNotifyWrite(ctx, argv[1], src, nsrclen);
+    fsNotifyWrite(ctx, argv[1], dst, ndstlen);
     RedisModule_Free(src);
     RedisModule_Free(dst);
-    RedisModule_ReplyWithSimpleString(ctx, "OK");
-    RedisModule_ReplicateVerbatim(ctx);
     return REDISMODULE_OK;
 }
 
 /* ===================================================================
- * FS.TREE key path [DEPTH depth]
+ * Paging (LIMIT / CURSOR)
  *
- * Returns a tree view of the filesystem rooted at path.
- * Response is a nested array structure.
+ * FS.FIND, FS.GREP and FS.TREE accept LIMIT n and CURSOR c. With either,
+ * the reply becomes [results, cursor] and the walk stops after n results
+ * (or once the scan budget in fs.h runs out). cursor is "0" when the walk
+ * is complete; otherwise passing it back as CURSOR continues where the
+ * page ended. Cursors name the next path to visit, so they stay valid
+ * across writes: entries added or removed behind the cursor are simply
+ * not seen again.
  * =================================================================== */
-static void fsTreeReply(RedisModuleCtx *ctx, fsObject *fs,
-                         const char *path, size_t pathlen,
-                         int depth, int maxdepth) {
-    fsInode *inode = fsLookup(fs, path, pathlen);
-    if (!inode) return;
+typedef struct fsPage {
+    int paging;             /* LIMIT or CURSOR given */
+    long long left;         /* results still allowed; -1 = unlimited */
+    int64_t inodes;         /* inode visits left */
+    int64_t bytes;          /* content bytes left to scan (GREP) */
+    long count;             /* results replied */
+    RedisModuleString *next;    /* cursor for the next page, once stopped */
+} fsPage;
+
+static void fsPageInit(fsPage *page) {
+    page->paging = 0;
+    page->left = -1;
+    page->inodes = INT64_MAX;
+    page->bytes = INT64_MAX;
+    page->count = 0;
+    page->next = NULL;
+}
 
-    char *base = fsBaseName(path, pathlen);
+/* Consume "LIMIT n" or "CURSOR c" at argv[*i]. Returns 1 if consumed, 0 if
+ * argv[*i] is another option, -1 after replying with an error. */
+static int fsParsePageOption(RedisModuleCtx *ctx, RedisModuleString **argv, int argc,
+                             int *i, fsPage *page, RedisModuleString **cursor) {
+    const char *opt = RedisModule_StringPtrLen(argv[*i], NULL);
+    int islimit = !strcasecmp(opt, "LIMIT");
+    if (!islimit && strcasecmp(opt, "CURSOR")) return 0;
+    if (*i + 1 >= argc) {
+        RedisModule_ReplyWithError(ctx, "ERR syntax error — LIMIT and CURSOR take a value");
+        return -1;
+    }
+    if (islimit) {
+        long long n;
+        if (RedisModule_StringToLongLong(argv[*i + 1], &n) != REDISMODULE_OK ||
+            n < 1 || n > FS_PAGE_MAX_LIMIT) {
+            RedisModule_ReplyWithError(ctx, "ERR LIMIT must be between 1 and 10000");
+            return -1;
+        }
+        page->left = n;
+    } else {
+        *cursor = argv[*i + 1];
+    }
+    if (page->inodes == INT64_MAX) {
+        page->inodes = FS_PAGE_SCAN_INODES;
+        page->bytes = FS_PAGE_SCAN_BYTES;
+    }
+    page->paging = 1;
+    *i += 2;
+    return 1;
+}
 
-    if (inode->type != FS_INODE_DIR || depth >= maxdepth) {
-        // Leaf node: just the name.
-        const char *suffix = "";
-        if (inode->type == FS_INODE_DIR) suffix = "/";
-        else if (inode->type == FS_INODE_SYMLINK) suffix = "@";
-
-        size_t blen = strlen(base);
-        size_t slen = strlen(suffix);
-        char *display = RedisModule_Alloc(blen + slen + 1);
-        memcpy(display, base, blen);
-        memcpy(display + blen, suffix, slen);
-        display[blen + slen] = '\0';
-
-        RedisModule_ReplyWithCString(ctx, display);
-        RedisModule_Free(display);
-        RedisModule_Free(base);
-        return;
+/* Is p (a normalized path) path itself or below it? */
+static int fsPathWithin(const char *p, size_t plen, const char *path, size_t pathlen) {
+    if (fsIsRoot(path, pathlen)) return plen >= 1 && p[0] == '/';
+    return fsPathHasPrefix(p, plen, path, pathlen);
+}
+
+/* Check that a FIND/TREE cursor names path or a path below it. */
+static int fsCursorValid(RedisModuleString *cursor, const char *path, size_t pathlen) {
+    size_t clen;
+    const char *c = RedisModule_StringPtrLen(cursor, &clen);
+    return fsPathWithin(c, clen, path, pathlen);
+}
+
+/* Close a paged reply: the results array, then the cursor. */
+static void fsPageReply(RedisModuleCtx *ctx, fsPage *page) {
+    RedisModule_ReplySetArrayLength(ctx, page->count);
+    if (!page->paging) return;
+    if (page->next) RedisModule_ReplyWithString(ctx, page->next);
+    else RedisModule_ReplyWithCString(ctx, "0");
+}
+
+typedef int (*fsSubtreeVisitor)(RedisModuleCtx *ctx, const char *path, size_t pathlen,
+                                fsInode *inode, void *privdata);
+
+/* Visit path and every path below it in key (byte) order, starting at
+ * from when given (path itself or a path below it). Visiting the inode
+ * dict in order, rather than recursing through directories, is what makes
+ * a walk resumable from a single path. Stops when visit returns nonzero. */
+static void fsWalkSubtree(RedisModuleCtx *ctx, fsObject *fs,
+                          const char *path, size_t pathlen,
+                          const char *from, size_t fromlen,
+                          fsSubtreeVisitor visit, void *privdata) {
+    int root = fsIsRoot(path, pathlen);
+    if (!from || (fromlen == pathlen && !memcmp(from, path, pathlen))) {
+        fsInode *self = fsLookup(fs, path, pathlen);
+        if (!self) return;
+        if (visit(ctx, path, pathlen, self, privdata)) return;
+        from = NULL;
     }
 
-    // Directory: [name, [child1, child2, ...]]
-    RedisModule_ReplyWithArray(ctx, 2);
+    /* Descendants are the keys starting with "path/". */
+    char *prefix = RedisModule_Alloc(pathlen + 2);
+    memcpy(prefix, path, pathlen);
+    size_t prefixlen = pathlen;
+    if (!root) prefix[prefixlen++] = '/';
+    prefix[prefixlen] = '\0';
+
+    RedisModuleDictIter *iter = from ?
+        RedisModule_DictIteratorStartC(fs->inodes, ">=", (void*)from, fromlen) :
+        RedisModule_DictIteratorStartC(fs->inodes, root ? ">" : ">=", prefix, prefixlen);
+    char *k;
+    size_t klen;
+    fsInode *inode;
+    while ((k = RedisModule_DictNextC(iter, &klen, (void**)&inode)) != NULL) {
+        if (klen < prefixlen || memcmp(k, prefix, prefixlen) != 0) break;
+        if (visit(ctx, k, klen, inode, privdata)) break;
+    }
+    RedisModule_DictIteratorStop(iter);
+    RedisModule_Free(prefix);
+}
+
+/* ===================================================================
+ * FS.LS key [path] [LONG] [SORTED] [CURSOR c] [COUNT n]
+ *
+ * List directory contents. LONG returns metadata with each entry. By
+ * default entries come in the order they were added; SORTED returns them
+ * by name instead.
+ *
+ * With CURSOR or COUNT the listing is paged like FS.FIND: the reply is
+ * [entries, cursor], entries in name order, at most n per page (or as many
+ * as the scan budget allows), and cursor is "0" after the last page. The
+ * cursor is the path of the next entry, so entries added or removed
+ * between pages never shift the ones still to come.
+ * =================================================================== */
+
+/* Reply one LONG entry: [name, type, mode, size, mtime]. */
+static void fsLsReplyLong(RedisModuleCtx *ctx, const char *name, size_t namelen,
+                          fsInode *child) {
+    RedisModule_ReplyWithArray(ctx, 5);
+    RedisModule_ReplyWithStringBuffer(ctx, name, namelen);
+    if (!child) {
+        RedisModule_ReplyWithCString(ctx, "unknown");
+        RedisModule_ReplyWithCString(ctx, "0000");
+        RedisModule_ReplyWithLongLong(ctx, 0);
+        RedisModule_ReplyWithLongLong(ctx, 0);
+        return;
+    }
+    const char *typestr = "unknown";
+    switch (child->type) {
+    case FS_INODE_FILE: typestr = "file"; break;
+    case FS_INODE_DIR: typestr = "dir"; break;
+    case FS_INODE_SYMLINK: typestr = "symlink"; break;
+    }
+    RedisModule_ReplyWithCString(ctx, typestr);
+    char modebuf[8];
+    snprintf(modebuf, sizeof(modebuf), "%04o", child->mode);
+    RedisModule_ReplyWithCString(ctx, modebuf);
+    int64_t size = 0;
+    if (child->type == FS_INODE_FILE) size = child->payload.file.size;
+    RedisModule_ReplyWithLongLong(ctx, size);
+    RedisModule_ReplyWithLongLong(ctx, child->mtime);
+}
 
-    // Root "/" should display as "/" not "//".
-    if (fsIsRoot(path, pathlen)) {
-        RedisModule_ReplyWithCString(ctx, "/");
+/* Reply the children of dir in name order, from the child named from on
+ * when given. Children are read straight off the inode dict, which holds
+ * them in that order along with their inodes; after each child that has
+ * entries of its own the iterator seeks past them, so one page costs a
+ * seek per child rather than a walk of the subtree. Stopping early sets
+ * page->next to shown (the path as the client named it) joined with the
+ * next child's name. */
+static void fsLsWalk(RedisModuleCtx *ctx, fsObject *fs, const char *dir, size_t dirlen,
+                     const char *shown, size_t shownlen, const char *from, size_t fromlen,
+                     int longformat, fsPage *page) {
+    int root = fsIsRoot(dir, dirlen);
+    size_t prefixlen = root ? 1 : dirlen + 1;
+    size_t cap = prefixlen + 64;
+    char *seek = RedisModule_Alloc(cap);
+    memcpy(seek, dir, dirlen);
+    seek[prefixlen - 1] = '/';
+
+    RedisModuleDictIter *iter;
+    if (from) {
+        if (prefixlen + fromlen > cap) {
+            cap = prefixlen + fromlen;
+            seek = RedisModule_Realloc(seek, cap);
+        }
+        memcpy(seek + prefixlen, from, fromlen);
+        iter = RedisModule_DictIteratorStartC(fs->inodes, ">=", seek, prefixlen + fromlen);
     } else {
-        char *dirname = RedisModule_Alloc(strlen(base) + 2);
-        sprintf(dirname, "%s/", base);
-        RedisModule_ReplyWithCString(ctx, dirname);
-        RedisModule_Free(dirname);
+        iter = RedisModule_DictIteratorStartC(fs->inodes, ">", seek, prefixlen);
     }
-    RedisModule_Free(base);
 
-    RedisModule_ReplyWithArray(ctx, inode->payload.dir.count);
-    for (size_t i = 0; i < inode->payload.dir.count; i++) {
-        char *childpath = fsJoinPath(path, pathlen,
-                                      inode->payload.dir.children[i],
-                                      strlen(inode->payload.dir.children[i]));
-        if (!childpath) continue;
-        fsTreeReply(ctx, fs, childpath, strlen(childpath), depth + 1, maxdepth);
-        RedisModule_Free(childpath);
+    char *k;
+    size_t klen;
+    fsInode *inode;
+    while ((k = RedisModule_DictNextC(iter, &klen, (void**)&inode)) != NULL) {
+        if (klen <= prefixlen || memcmp(k, dir, prefixlen - 1) != 0 ||
+            k[prefixlen - 1] != '/') break;
+        const char *name = k + prefixlen;
+        size_t namelen = klen - prefixlen;
+        const char *slash = memchr(name, '/', namelen);
+        if (slash) {
+            /* Below a child already listed: skip the rest of its subtree.
+             * Every key under "dir/name/" sorts before "dir/name0". */
+            namelen = slash - name;
+            if (prefixlen + namelen + 1 > cap) {
+                cap = prefixlen + namelen + 1;
+                seek = RedisModule_Realloc(seek, cap);
+            }
+            memcpy(seek + prefixlen, name, namelen);
+            seek[prefixlen + namelen] = '/' + 1;
+            RedisModule_DictIteratorReseekC(iter, ">=", seek, prefixlen + namelen + 1);
+            page->inodes--;
+            continue;
+        }
+        if (page->left == 0 || page->inodes <= 0) {
+            char *next = fsJoinPath(shown, shownlen, name, namelen);
+            if (next) {
+                page->next = RedisModule_CreateString(ctx, next, strlen(next));
+                RedisModule_Free(next);
+            }
+            break;
+        }
+        page->inodes--;
+        if (longformat) fsLsReplyLong(ctx, name, namelen, inode);
+        else RedisModule_ReplyWithStringBuffer(ctx, name, namelen);
+        page->count++;
+        if (page->left > 0) page->left--;
     }
+    RedisModule_DictIteratorStop(iter);
+    RedisModule_Free(seek);
 }
 
-static int TREE_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+static int LS_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
     RedisModule_AutoMemory(ctx);
-    if (argc < 3 || argc > 5) return RedisModule_WrongArity(ctx);
+    if (argc < 2) return RedisModule_WrongArity(ctx);
+    if (fsRoute(ctx, argv, argc, 2, 0)) return REDISMODULE_OK;
 
-    int maxdepth = FS_MAX_TREE_DEPTH;
-    if (argc >= 5) {
-        const char *opt = RedisModule_StringPtrLen(argv[3], NULL);
-        if (!strcasecmp(opt, "DEPTH")) {
-            long long d;
-            if (RedisModule_StringToLongLong(argv[4], &d) != REDISMODULE_OK || d < 0) {
-                return RedisModule_ReplyWithError(ctx, "ERR DEPTH must be a non-negative integer");
-            }
-            maxdepth = (int)d;
+    /* The path is optional: FS.LS key [path] [options]. A bare option
+     * word in its place lists "/". */
+    const char *rawpath = "/";
+    size_t pathlen = 1;
+    int i = 2;
+    if (argc > 2) {
+        const char *arg = RedisModule_StringPtrLen(argv[2], &pathlen);
+        if (strcasecmp(arg, "LONG") && strcasecmp(arg, "SORTED") &&
+            strcasecmp(arg, "CURSOR") && strcasecmp(arg, "COUNT")) {
+            rawpath = arg;
+            i = 3;
+        } else {
+            pathlen = 1;
+        }
+    }
+
+    int longformat = 0, sorted = 0;
+    fsPage page;
+    fsPageInit(&page);
+    RedisModuleString *cursor = NULL;
+    for (; i < argc; i++) {
+        const char *opt = RedisModule_StringPtrLen(argv[i], NULL);
+        if (!strcasecmp(opt, "LONG")) {
+            longformat = 1;
+        } else if (!strcasecmp(opt, "SORTED")) {
+            sorted = 1;
+        } else if (!strcasecmp(opt, "CURSOR") && i + 1 < argc) {
+            cursor = argv[++i];
+            page.paging = 1;
+        } else if (!strcasecmp(opt, "COUNT") && i + 1 < argc) {
+            long long n;
+            if (RedisModule_StringToLongLong(argv[++i], &n) != REDISMODULE_OK ||
+                n < 1 || n > FS_PAGE_MAX_LIMIT)
+                return RedisModule_ReplyWithError(ctx, "ERR COUNT must be between 1 and 10000");
+            page.left = n;
+            page.paging = 1;
         } else {
-            return RedisModule_ReplyWithError(ctx, "ERR syntax error — expected DEPTH <n>");
+            return RedisModule_ReplyWithError(ctx, "ERR syntax error — expected LONG, SORTED, CURSOR <c> or COUNT <n>");
         }
     }
+    if (page.paging) page.inodes = FS_PAGE_SCAN_INODES;
 
     RedisModuleKey *key;
     fsObject *fs = fsGetObject(ctx, argv[1], REDISMODULE_READ, &key);
     if (!key) return REDISMODULE_OK;
     if (!fs) return RedisModule_ReplyWithError(ctx, "ERR no such filesystem key");
-
-    size_t pathlen;
-    const char *rawpath = RedisModule_StringPtrLen(argv[2], &pathlen);
     char *path = fsNormalizeOrReply(ctx, rawpath, pathlen);
     if (!path) return REDISMODULE_OK;
+    size_t npathlen = strlen(path);
 
-    fsInode *inode = fsLookup(fs, path, strlen(path));
-    if (!inode) {
+    /* A cursor names an entry of this directory. */
+    const char *from = NULL;
+    size_t fromlen = 0;
+    if (cursor) {
+        size_t clen;
+        const char *c = RedisModule_StringPtrLen(cursor, &clen);
+        size_t skip = fsIsRoot(path, npathlen) ? 1 : npathlen + 1;
+        if (!fsCursorValid(cursor, path, npathlen) || clen <= skip ||
+            memchr(c + skip, '/', clen - skip)) {
+            RedisModule_Free(path);
+            return RedisModule_ReplyWithError(ctx, "ERR invalid cursor — not in this directory");
+        }
+        from = c + skip;
+        fromlen = clen - skip;
+    }
+
+    // Resolve symlinks.
+    int err;
+    char *resolved = fsResolvePath(fs, path, npathlen, &err);
+    if (err == FS_RESOLVE_ERR_SYMLINK_LOOP) {
         RedisModule_Free(path);
-        return RedisModule_ReplyWithError(ctx, "ERR no such path");
+        return RedisModule_ReplyWithError(ctx, "ERR too many levels of symbolic links");
+    }
+    if (err == FS_RESOLVE_ERR_PATH_DEPTH) {
+        RedisModule_Free(path);
+        return RedisModule_ReplyWithError(ctx, "ERR path depth exceeds limit");
+    }
+    size_t rlen = strlen(resolved);
+
+    fsInode *dir = fsLookup(fs, resolved, rlen);
+    if (!dir || dir->type != FS_INODE_DIR) {
+        RedisModule_Free(path);
+        RedisModule_Free(resolved);
+        return RedisModule_ReplyWithError(ctx, dir ? "ERR not a directory" : "ERR no such directory");
     }
 
-    fsTreeReply(ctx, fs, path, strlen(path), 0, maxdepth);
+    dir->atime = fsNowMs();
+
+    if (page.paging || sorted) {
+        if (page.paging) RedisModule_ReplyWithArray(ctx, 2);
+        RedisModule_ReplyWithArray(ctx, REDISMODULE_POSTPONED_LEN);
+        fsLsWalk(ctx, fs, resolved, rlen, path, npathlen, from, fromlen, longformat, &page);
+        fsPageReply(ctx, &page);
+    } else {
+        RedisModule_ReplyWithArray(ctx, dir->payload.dir.count);
+        for (size_t j = 0; j < dir->payload.dir.count; j++) {
+            const fsDirent *e = &dir->payload.dir.children[j];
+            size_t namelen = strlen(e->name);
+            if (longformat) fsLsReplyLong(ctx, e->name, namelen, e->inode);
+            else RedisModule_ReplyWithStringBuffer(ctx, e->name, namelen);
+        }
+    }
 
     RedisModule_Free(path);
+    RedisModule_Free(resolved);
     return REDISMODULE_OK;
 }
 
 /* ===================================================================
- * FS.FIND key path pattern [TYPE file|dir|symlink]
+ * FS.TREE key path [DEPTH depth] [FLAT] [LIMIT n] [CURSOR c]
+ *
+ * Returns a tree view of the filesystem rooted at path, children sorted
+ * by name. Response is a nested array structure.
+ *
+ * FLAT returns the same nodes in the same (pre-order) order as one array
+ * of depth, type, name triples instead: depth is 0 for path itself, type
+ * is "file", "dir" or "symlink", and name carries no "/" or "@" suffix.
+ * A node's parent is the closest node before it with a smaller depth.
  *
- * Find files matching a glob pattern. DFS from the given path.
- * Returns an array of matching paths.
+ * With LIMIT, at most n nodes are returned and the reply is [tree,
+ * cursor]. A page resumed with CURSOR repeats the cursor's ancestor
+ * directories (not counted against the limit) so it nests the same way.
  * =================================================================== */
-static void fsFindWalk(fsObject *fs, const char *path, size_t pathlen,
-                        const char *pattern, int typefilter,
-                        RedisModuleCtx *ctx, long *count) {
-    fsInode *inode = fsLookup(fs, path, pathlen);
-    if (!inode) return;
+typedef struct fsTreeWalk {
+    fsPage *page;
+    const char *cursor;     /* skip nodes before this path; NULL once reached */
+    size_t cursorlen;
+    int flat;               /* FLAT: triples in one array */
+    long flatlen;           /* elements replied so far in FLAT mode */
+    char *path;             /* path of the current node, extended in place */
+    size_t pathlen;
+    size_t pathcap;
+    fsDirent *sorted;       /* sorted children of each open directory, stacked */
+    size_t sortedlen;
+    size_t sortedcap;
+} fsTreeWalk;
+
+static int fsTreeNameCmp(const void *a, const void *b) {
+    return strcmp(((const fsDirent *)a)->name, ((const fsDirent *)b)->name);
+}
 
-    // Check if this path matches.
-    char *base = fsBaseName(path, pathlen);
-    if (fsGlobMatch(pattern, base)) {
-        if (typefilter < 0 || typefilter == inode->type) {
-            RedisModule_ReplyWithCString(ctx, path);
-            (*count)++;
+/* Make room for extra more bytes after the current path (and a NUL). */
+static void fsTreeReservePath(fsTreeWalk *walk, size_t extra) {
+    if (walk->pathlen + extra + 1 <= walk->pathcap) return;
+    walk->pathcap = (walk->pathlen + extra + 1) * 2;
+    walk->path = RedisModule_Realloc(walk->path, walk->pathcap);
+}
+
+/* Reply with inode, the node at walk->path; returns 1 if a node was
+ * replied. Names are replied straight out of the path buffer and each
+ * directory's sorted children go on one shared stack, so the walk doesn't
+ * allocate per node. */
+static int fsTreeReply(RedisModuleCtx *ctx, fsInode *inode, int depth, int maxdepth,
+                       fsTreeWalk *walk) {
+    size_t pathlen = walk->pathlen;
+    int root = fsIsRoot(walk->path, pathlen);
+
+    /* Directories above the cursor are replied but not counted. */
+    int ancestor = walk->cursor && walk->cursorlen > pathlen &&
+                   fsPathWithin(walk->cursor, walk->cursorlen, walk->path, pathlen);
+    if (!ancestor) {
+        walk->cursor = NULL;
+        if (walk->page->left == 0) {
+            walk->page->next = RedisModule_CreateString(ctx, walk->path, pathlen);
+            return 0;
         }
+        if (walk->page->left > 0) walk->page->left--;
     }
-    RedisModule_Free(base);
 
-    // Recurse into directories.
-    if (inode->type == FS_INODE_DIR) {
-        for (size_t i = 0; i < inode->payload.dir.count; i++) {
-            char *childpath = fsJoinPath(path, pathlen,
-                                          inode->payload.dir.children[i],
-                                          strlen(inode->payload.dir.children[i]));
-            if (!childpath) continue;
-            fsFindWalk(fs, childpath, strlen(childpath), pattern, typefilter, ctx, count);
-            RedisModule_Free(childpath);
+    int leaf = inode->type != FS_INODE_DIR || depth >= maxdepth;
+    size_t base = pathlen;
+    while (base > 0 && walk->path[base - 1] != '/') base--;
+    if (root) base = 0;
+
+    if (walk->flat) {
+        const char *typestr = "unknown";
+        switch (inode->type) {
+        case FS_INODE_FILE: typestr = "file"; break;
+        case FS_INODE_DIR: typestr = "dir"; break;
+        case FS_INODE_SYMLINK: typestr = "symlink"; break;
+        }
+        RedisModule_ReplyWithLongLong(ctx, depth);
+        RedisModule_ReplyWithCString(ctx, typestr);
+        RedisModule_ReplyWithStringBuffer(ctx, walk->path + base, pathlen - base);
+        walk->flatlen += 3;
+        if (leaf) return 1;
+    } else {
+        /* The display name is the base name plus "/" for directories and
+         * "@" for symlinks; root is just "/". */
+        char suffix = 0;
+        if (inode->type == FS_INODE_DIR && !root) suffix = '/';
+        else if (inode->type == FS_INODE_SYMLINK) suffix = '@';
+        fsTreeReservePath(walk, 1);
+        walk->path[pathlen] = suffix;
+        // Directory: [name, [child1, child2, ...]]
+        if (!leaf) RedisModule_ReplyWithArray(ctx, 2);
+        RedisModule_ReplyWithStringBuffer(ctx, walk->path + base,
+                                          pathlen - base + (suffix != 0));
+        walk->path[pathlen] = '\0';
+        if (leaf) return 1;
+    }
+
+    size_t count = inode->payload.dir.count;
+    size_t off = walk->sortedlen;
+    if (off + count > walk->sortedcap) {
+        walk->sortedcap = (off + count) * 2;
+        walk->sorted = RedisModule_Realloc(walk->sorted, sizeof(fsDirent) * walk->sortedcap);
+    }
+    if (count) {
+        memcpy(walk->sorted + off, inode->payload.dir.children, sizeof(fsDirent) * count);
+        qsort(walk->sorted + off, count, sizeof(fsDirent), fsTreeNameCmp);
+    }
+    walk->sortedlen = off + count;
+
+    /* The cursor's path component at this level: children sorting before
+     * it were returned by earlier pages. */
+    const char *comp = NULL;
+    size_t complen = 0;
+    if (ancestor) {
+        comp = walk->cursor + pathlen + (root ? 0 : 1);
+        const char *end = memchr(comp, '/', walk->cursor + walk->cursorlen - comp);
+        complen = (end ? end : walk->cursor + walk->cursorlen) - comp;
+    }
+
+    if (!walk->flat) RedisModule_ReplyWithArray(ctx, REDISMODULE_POSTPONED_LEN);
+    long replied = 0;
+    for (size_t i = 0; i < count && !walk->page->next; i++) {
+        /* Deeper levels may move the stack: index it afresh each time. */
+        fsDirent *e = &walk->sorted[off + i];
+        if (!e->inode) continue;
+        size_t nlen = strlen(e->name);
+        if (walk->cursor && comp) {
+            int cmp = memcmp(e->name, comp, nlen < complen ? nlen : complen);
+            if (cmp == 0) cmp = (nlen > complen) - (nlen < complen);
+            if (cmp < 0) continue;
+            if (cmp > 0) walk->cursor = NULL;
         }
+        fsInode *child = e->inode;
+        fsTreeReservePath(walk, nlen + 2);
+        if (!root) walk->path[walk->pathlen++] = '/';
+        memcpy(walk->path + walk->pathlen, e->name, nlen);
+        walk->pathlen += nlen;
+        walk->path[walk->pathlen] = '\0';
+        replied += fsTreeReply(ctx, child, depth + 1, maxdepth, walk);
+        walk->pathlen = pathlen;
+        walk->path[pathlen] = '\0';
     }
+    if (!walk->flat) RedisModule_ReplySetArrayLength(ctx, replied);
+    walk->sortedlen = off;
+    return 1;
 }
 
-static int FIND_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+static int TREE_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
     RedisModule_AutoMemory(ctx);
-    if (argc < 4 || argc > 6) return RedisModule_WrongArity(ctx);
+    if (argc < 3) return RedisModule_WrongArity(ctx);
+    if (fsRoute(ctx, argv, argc, 2, 0)) return REDISMODULE_OK;
 
-    int typefilter = -1; // -1 = all types
-    if (argc >= 6) {
-        const char *opt = RedisModule_StringPtrLen(argv[4], NULL);
-        if (!strcasecmp(opt, "TYPE")) {
-            const char *tstr = RedisModule_StringPtrLen(argv[5], NULL);
-            if (!strcasecmp(tstr, "file")) typefilter = FS_INODE_FILE;
-            else if (!strcasecmp(tstr, "dir")) typefilter = FS_INODE_DIR;
-            else if (!strcasecmp(tstr, "symlink")) typefilter = FS_INODE_SYMLINK;
-            else return RedisModule_ReplyWithError(ctx, "ERR TYPE must be file, dir, or symlink");
+    int maxdepth = FS_MAX_TREE_DEPTH;
+    int flat = 0;
+    fsPage page;
+    fsPageInit(&page);
+    RedisModuleString *cursor = NULL;
+    for (int i = 3; i < argc;) {
+        int r = fsParsePageOption(ctx, argv, argc, &i, &page, &cursor);
+        if (r < 0) return REDISMODULE_OK;
+        if (r) continue;
+        const char *opt = RedisModule_StringPtrLen(argv[i], NULL);
+        if (!strcasecmp(opt, "DEPTH") && i + 1 < argc) {
+            long long d;
+            if (RedisModule_StringToLongLong(argv[i + 1], &d) != REDISMODULE_OK || d < 0) {
+                return RedisModule_ReplyWithError(ctx, "ERR DEPTH must be a non-negative integer");
+            }
+            maxdepth = (int)d;
+            i += 2;
+        } else if (!strcasecmp(opt, "FLAT")) {
+            flat = 1;
+            i++;
         } else {
-            return RedisModule_ReplyWithError(ctx, "ERR syntax error — expected TYPE <type>");
+            return RedisModule_ReplyWithError(ctx, "ERR syntax error — expected DEPTH <n>, FLAT, LIMIT <n> or CURSOR <c>");
         }
     }
 
@@ -2895,134 +4996,204 @@ static int FIND_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int
     const char *rawpath = RedisModule_StringPtrLen(argv[2], &pathlen);
     char *path = fsNormalizeOrReply(ctx, rawpath, pathlen);
     if (!path) return REDISMODULE_OK;
+    pathlen = strlen(path);
 
-    size_t patternlen;
-    const char *pattern = RedisModule_StringPtrLen(argv[3], &patternlen);
+    fsInode *inode = fsLookup(fs, path, pathlen);
+    if (!inode) {
+        RedisModule_Free(path);
+        return RedisModule_ReplyWithError(ctx, "ERR no such path");
+    }
+    if (cursor && !fsCursorValid(cursor, path, pathlen)) {
+        RedisModule_Free(path);
+        return RedisModule_ReplyWithError(ctx, "ERR invalid cursor — not under path");
+    }
 
-    // Use postponed array length since we don't know how many matches.
-    RedisModule_ReplyWithArray(ctx, REDISMODULE_POSTPONED_LEN);
-    long count = 0;
-    fsFindWalk(fs, path, strlen(path), pattern, typefilter, ctx, &count);
-    RedisModule_ReplySetArrayLength(ctx, count);
+    fsTreeWalk walk = {0};
+    walk.page = &page;
+    walk.flat = flat;
+    if (cursor) walk.cursor = RedisModule_StringPtrLen(cursor, &walk.cursorlen);
+    walk.path = path;
+    walk.pathlen = pathlen;
+    walk.pathcap = pathlen + 1;
+    if (page.paging) RedisModule_ReplyWithArray(ctx, 2);
+    if (flat) RedisModule_ReplyWithArray(ctx, REDISMODULE_POSTPONED_LEN);
+    fsTreeReply(ctx, inode, 0, maxdepth, &walk);
+    if (flat) RedisModule_ReplySetArrayLength(ctx, walk.flatlen);
+    if (page.paging) {
+        if (page.next) RedisModule_ReplyWithString(ctx, page.next);
+        else RedisModule_ReplyWithCString(ctx, "0");
+    }
 
-    RedisModule_Free(path);
+    RedisModule_Free(walk.path);
+    RedisModule_Free(walk.sorted);
     return REDISMODULE_OK;
 }
 
 /* ===================================================================
- * FS.GREP key path pattern [NOCASE]
+ * FS.FIND key path pattern [TYPE file|dir|symlink] [MINSIZE n] [MAXSIZE n]
+ *         [NEWER ms] [OLDER ms] [UID u] [LIMIT n] [CURSOR c]
+ *
+ * Find paths under path (inclusive) whose basename matches a glob
+ * pattern, in path order. Returns an array of matching paths, or
+ * [paths, cursor] with LIMIT/CURSOR.
  *
- * Search file contents under path for lines matching pattern.
- * Returns array of [filepath, line_number, line_content] triples.
+ * MINSIZE/MAXSIZE (inclusive; a directory's size is its entry count),
+ * NEWER/OLDER (mtime strictly after/before, in ms) and UID filter on
+ * metadata. A find with any of them scans the key's metadata columns
+ * (columns.c) instead of walking the subtree: the predicate runs over
+ * dense arrays first, and only its hits are checked against path and
+ * pattern and turned back into paths.
  * =================================================================== */
-static void fsGrepWalk(fsObject *fs, const char *path, size_t pathlen,
-                        const char *pattern, int nocase,
-                        RedisModuleCtx *ctx, long *count) {
-    fsInode *inode = fsLookup(fs, path, pathlen);
-    if (!inode) return;
+typedef struct fsFindWalk {
+    fsPage *page;
+    const char *pattern;
+    int typefilter;
+} fsFindWalk;
+
+static int fsFindVisit(RedisModuleCtx *ctx, const char *path, size_t pathlen,
+                       fsInode *inode, void *privdata) {
+    fsFindWalk *walk = privdata;
+    fsPage *page = walk->page;
+    if (page->left == 0 || page->inodes <= 0) {
+        page->next = RedisModule_CreateString(ctx, path, pathlen);
+        return 1;
+    }
+    page->inodes--;
 
-    if (inode->type == FS_INODE_FILE && inode->payload.file.size > 0) {
-        /* Bloom filter fast path: skip files that definitely don't match.
-         * The bloom is always built with lowercased trigrams, so it works
-         * for both case-sensitive and case-insensitive grep. */
-        if (!fsBloomMayMatch(inode, pattern)) goto recurse;
-
-        const char *data = inode->payload.file.data;
-        size_t size = inode->payload.file.size;
-
-        /* Binary file detection: check for NUL bytes (same heuristic as
-         * GNU grep). If binary, report "Binary file matches" instead of
-         * dumping raw content. */
-        int is_binary = (memchr(data, '\0', size) != NULL);
-
-        if (is_binary) {
-            /* Scan the raw bytes for the pattern's literal substring.
-             * We can't do line-by-line glob on binary, so just check if
-             * the literal is present anywhere (case-insensitive). */
-            const char *lit;
-            size_t litlen = fsBloomExtractLiteral(pattern, &lit);
-            int found = 0;
-            if (litlen >= 1) {
-                for (size_t i = 0; i + litlen <= size && !found; i++) {
-                    size_t j;
-                    for (j = 0; j < litlen; j++) {
-                        uint8_t a = fsLowerChar((uint8_t)data[i+j]);
-                        uint8_t b = fsLowerChar((uint8_t)lit[j]);
-                        if (a != b) break;
-                    }
-                    if (j == litlen) found = 1;
-                }
-            } else {
-                found = 1; // Pure wildcard pattern — assume match.
-            }
-            if (found) {
-                RedisModule_ReplyWithArray(ctx, 3);
-                RedisModule_ReplyWithCString(ctx, path);
-                RedisModule_ReplyWithLongLong(ctx, 0);
-                RedisModule_ReplyWithCString(ctx, "Binary file matches");
-                (*count)++;
-            }
-        } else {
-            // Text file: search line by line.
-            int lineno = 1;
-            size_t pos = 0;
-
-            while (pos < size) {
-                // Find line end.
-                size_t linestart = pos;
-                while (pos < size && data[pos] != '\n') pos++;
-                size_t linelen = pos - linestart;
-                if (pos < size) pos++; // skip newline
-
-                // Extract line as null-terminated string.
-                char *line = RedisModule_Alloc(linelen + 1);
-                memcpy(line, data + linestart, linelen);
-                line[linelen] = '\0';
-
-                int match;
-                if (nocase)
-                    match = fsGlobMatchNoCase(pattern, line);
-                else
-                    match = fsGlobMatch(pattern, line);
-
-                if (match) {
-                    RedisModule_ReplyWithArray(ctx, 3);
-                    RedisModule_ReplyWithCString(ctx, path);
-                    RedisModule_ReplyWithLongLong(ctx, lineno);
-                    RedisModule_ReplyWithStringBuffer(ctx, line, linelen);
-                    (*count)++;
-                }
+    char *base = fsBaseName(path, pathlen);
+    if (fsGlobMatch(walk->pattern, base) &&
+        (walk->typefilter < 0 || walk->typefilter == inode->type)) {
+        RedisModule_ReplyWithStringBuffer(ctx, path, pathlen);
+        page->count++;
+        if (page->left > 0) page->left--;
+    }
+    RedisModule_Free(base);
+    return 0;
+}
+
+typedef struct fsFindHit {
+    char *path;
+    size_t len;
+} fsFindHit;
+
+/* Byte order, the order of the inode dict. */
+static int fsFindHitCompare(const void *a, const void *b) {
+    const fsFindHit *x = a, *y = b;
+    int c = memcmp(x->path, y->path, x->len < y->len ? x->len : y->len);
+    if (c) return c;
+    return (x->len > y->len) - (x->len < y->len);
+}
 
-                RedisModule_Free(line);
-                lineno++;
+/* A predicate find: scan the metadata columns, then sort the hits under
+ * path into path order and reply with a page of them. The inode budget
+ * of a paged walk doesn't apply, as no inode is visited. */
+static void fsFindColumns(RedisModuleCtx *ctx, fsObject *fs, const char *path,
+                          size_t pathlen, const char *from, size_t fromlen,
+                          const char *pattern, const fsColumnsQuery *q,
+                          fsPage *page) {
+    fsInode *top = fsLookup(fs, path, pathlen);
+    if (!top) return;
+    fsColumnsEnable(fs);
+
+    uint32_t *slots;
+    size_t n = fsColumnsScan(fs->columns, q, fsIsRoot(path, pathlen) ? 0 : top->slot, &slots);
+    fsFindHit *hits = n ? RedisModule_Alloc(sizeof(*hits) * n) : NULL;
+    size_t nhits = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (!fsGlobMatch(pattern, fsColumnsName(fs->columns, slots[i]))) continue;
+        fsFindHit h;
+        h.path = fsColumnsPath(fs->columns, slots[i], &h.len);
+        if (from) {
+            fsFindHit cursor = {(char*)from, fromlen};
+            if (fsFindHitCompare(&h, &cursor) < 0) {
+                RedisModule_Free(h.path);
+                continue;
             }
         }
+        hits[nhits++] = h;
     }
+    if (slots) RedisModule_Free(slots);
 
-recurse:
-    if (inode->type == FS_INODE_DIR) {
-        for (size_t i = 0; i < inode->payload.dir.count; i++) {
-            char *childpath = fsJoinPath(path, pathlen,
-                                          inode->payload.dir.children[i],
-                                          strlen(inode->payload.dir.children[i]));
-            if (!childpath) continue;
-            fsGrepWalk(fs, childpath, strlen(childpath), pattern, nocase, ctx, count);
-            RedisModule_Free(childpath);
+    if (nhits > 1) qsort(hits, nhits, sizeof(*hits), fsFindHitCompare);
+    for (size_t i = 0; i < nhits; i++) {
+        if (page->left == 0) {
+            if (!page->next) page->next = RedisModule_CreateString(ctx, hits[i].path, hits[i].len);
+        } else {
+            RedisModule_ReplyWithStringBuffer(ctx, hits[i].path, hits[i].len);
+            page->count++;
+            if (page->left > 0) page->left--;
         }
+        RedisModule_Free(hits[i].path);
     }
+    if (hits) RedisModule_Free(hits);
 }
 
-static int GREP_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+/* Consume a metadata predicate at argv[*i] into q. Returns 1 if consumed,
+ * 0 if argv[*i] is another option, -1 after replying with an error. */
+static int fsParseFindPredicate(RedisModuleCtx *ctx, RedisModuleString **argv, int argc,
+                                int *i, fsColumnsQuery *q) {
+    const char *opt = RedisModule_StringPtrLen(argv[*i], NULL);
+    int minsize = !strcasecmp(opt, "MINSIZE"), maxsize = !strcasecmp(opt, "MAXSIZE");
+    int newer = !strcasecmp(opt, "NEWER"), older = !strcasecmp(opt, "OLDER");
+    int uid = !strcasecmp(opt, "UID");
+    if (!minsize && !maxsize && !newer && !older && !uid) return 0;
+    long long v;
+    if (*i + 1 >= argc || RedisModule_StringToLongLong(argv[*i + 1], &v) != REDISMODULE_OK) {
+        RedisModule_ReplyWithError(ctx, "ERR syntax error — MINSIZE, MAXSIZE, NEWER, OLDER and UID take an integer");
+        return -1;
+    }
+    if ((minsize || maxsize || uid) && v < 0) {
+        RedisModule_ReplyWithError(ctx, "ERR MINSIZE, MAXSIZE and UID must not be negative");
+        return -1;
+    }
+    if (uid && v > UINT32_MAX) {
+        RedisModule_ReplyWithError(ctx, "ERR uid out of range");
+        return -1;
+    }
+    if (minsize) q->minsize = (uint64_t)v;
+    else if (maxsize) q->maxsize = (uint64_t)v;
+    else if (uid) q->uid = v;
+    // Nothing is newer than INT64_MAX or older than INT64_MIN.
+    else if (newer && v == INT64_MAX) q->types = 0;
+    else if (older && v == INT64_MIN) q->types = 0;
+    else if (newer) q->minmtime = v + 1;
+    else q->maxmtime = v - 1;
+    *i += 2;
+    return 1;
+}
+
+static int FIND_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
     RedisModule_AutoMemory(ctx);
-    if (argc < 4 || argc > 5) return RedisModule_WrongArity(ctx);
+    if (argc < 4) return RedisModule_WrongArity(ctx);
+    if (fsRoute(ctx, argv, argc, 2, 0)) return REDISMODULE_OK;
 
-    int nocase = 0;
-    if (argc == 5) {
-        const char *opt = RedisModule_StringPtrLen(argv[4], NULL);
-        if (!strcasecmp(opt, "NOCASE")) {
-            nocase = 1;
+    int typefilter = -1; // -1 = all types
+    fsColumnsQuery q;
+    fsColumnsQueryInit(&q);
+    int predicate = 0;
+    fsPage page;
+    fsPageInit(&page);
+    RedisModuleString *cursor = NULL;
+    for (int i = 4; i < argc;) {
+        int r = fsParsePageOption(ctx, argv, argc, &i, &page, &cursor);
+        if (r < 0) return REDISMODULE_OK;
+        if (r) continue;
+        r = fsParseFindPredicate(ctx, argv, argc, &i, &q);
+        if (r < 0) return REDISMODULE_OK;
+        if (r) {
+            predicate = 1;
+            continue;
+        }
+        const char *opt = RedisModule_StringPtrLen(argv[i], NULL);
+        if (!strcasecmp(opt, "TYPE") && i + 1 < argc) {
+            const char *tstr = RedisModule_StringPtrLen(argv[i + 1], NULL);
+            if (!strcasecmp(tstr, "file")) typefilter = FS_INODE_FILE;
+            else if (!strcasecmp(tstr, "dir")) typefilter = FS_INODE_DIR;
+            else if (!strcasecmp(tstr, "symlink")) typefilter = FS_INODE_SYMLINK;
+            else return RedisModule_ReplyWithError(ctx, "ERR TYPE must be file, dir, or symlink");
+            i += 2;
         } else {
-            return RedisModule_ReplyWithError(ctx, "ERR syntax error — expected NOCASE");
+            return RedisModule_ReplyWithError(ctx, "ERR syntax error — expected TYPE, MINSIZE, MAXSIZE, NEWER, OLDER, UID, LIMIT or CURSOR");
         }
     }
 
@@ -3035,32 +5206,1381 @@ static int GREP_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int
     const char *rawpath = RedisModule_StringPtrLen(argv[2], &pathlen);
     char *path = fsNormalizeOrReply(ctx, rawpath, pathlen);
     if (!path) return REDISMODULE_OK;
+    pathlen = strlen(path);
+    if (cursor && !fsCursorValid(cursor, path, pathlen)) {
+        RedisModule_Free(path);
+        return RedisModule_ReplyWithError(ctx, "ERR invalid cursor — not under path");
+    }
 
-    size_t patternlen;
-    const char *pattern = RedisModule_StringPtrLen(argv[3], &patternlen);
+    const char *from = NULL;
+    size_t fromlen = 0;
+    if (cursor) from = RedisModule_StringPtrLen(cursor, &fromlen);
 
+    const char *pattern = RedisModule_StringPtrLen(argv[3], NULL);
+    if (page.paging) RedisModule_ReplyWithArray(ctx, 2);
     RedisModule_ReplyWithArray(ctx, REDISMODULE_POSTPONED_LEN);
-    long count = 0;
-    fsGrepWalk(fs, path, strlen(path), pattern, nocase, ctx, &count);
-    RedisModule_ReplySetArrayLength(ctx, count);
+    if (predicate) {
+        if (typefilter >= 0) q.types &= (uint8_t)(1 << typefilter);
+        fsFindColumns(ctx, fs, path, pathlen, from, fromlen, pattern, &q, &page);
+    } else {
+        fsFindWalk walk = {&page, pattern, typefilter};
+        fsWalkSubtree(ctx, fs, path, pathlen, from, fromlen, fsFindVisit, &walk);
+    }
+    fsPageReply(ctx, &page);
 
     RedisModule_Free(path);
     return REDISMODULE_OK;
 }
 
 /* ===================================================================
- * FS.TRUNCATE key path length
+ * FS.GREP key path pattern [NOCASE] [LIMIT n] [CURSOR c]
  *
- * Truncate or extend a file to the specified length.
- * Follows symlinks. length < size shrinks, length > size zero-extends.
+ * Search file contents under path for lines matching pattern, files in
+ * path order. Returns array of [filepath, line_number, line_content]
+ * triples, or [triples, cursor] with LIMIT/CURSOR. A page can end
+ * partway through a file; its cursor is "<line>:<path>".
+ *
+ * An unpaged GREP whose candidate files (those the blooms don't rule out)
+ * hold FS_GREP_BACKGROUND_BYTES or more runs in a background thread: the
+ * candidates are pinned in a read view (view.c), the client is blocked,
+ * and the thread scans the view while the server goes on serving writes.
+ * The result is the tree as it was when the command ran. Inside MULTI or
+ * a script, GREP always runs inline.
  * =================================================================== */
-static int TRUNCATE_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
-    RedisModule_AutoMemory(ctx);
-    if (argc != 4) return RedisModule_WrongArity(ctx);
-
-    RedisModuleKey *key;
-    fsObject *fs = fsGetObject(ctx, argv[1], REDISMODULE_READ|REDISMODULE_WRITE, &key);
-    if (!key) return REDISMODULE_OK;
+
+/* One match found by a background GREP. */
+typedef struct fsGrepMatch {
+    size_t file;            /* Index of its file in the view */
+    long long lineno;
+    size_t line;            /* Offset of the line in fsGrepJob.lines */
+    size_t linelen;
+} fsGrepMatch;
+
+typedef struct fsGrepJob {
+    RedisModuleBlockedClient *bc;
+    fsView *view;
+    char *pattern;
+    int nocase;
+    size_t file;            /* File being scanned */
+    fsGrepMatch *matches;
+    size_t count;
+    size_t capacity;
+    char *lines;            /* Matched lines, back to back */
+    size_t lineslen;
+    size_t linescap;
+} fsGrepJob;
+
+typedef struct fsGrepWalk {
+    fsPage *page;
+    const char *pattern;
+    int nocase;
+    const char *startpath;  /* the cursor's file, resumed at startline */
+    size_t startpathlen;
+    long long startline;
+    fsGrepJob *job;         /* background: matches are kept here, not replied */
+} fsGrepWalk;
+
+static void fsGrepEmit(RedisModuleCtx *ctx, fsGrepWalk *walk, const char *path,
+                       size_t pathlen, long long lineno, const char *line,
+                       size_t linelen) {
+    fsGrepJob *job = walk->job;
+    if (job) {
+        if (job->count == job->capacity) {
+            job->capacity = job->capacity ? job->capacity * 2 : 64;
+            job->matches = RedisModule_Realloc(job->matches,
+                                               sizeof(fsGrepMatch) * job->capacity);
+        }
+        if (job->lineslen + linelen > job->linescap) {
+            job->linescap = (job->lineslen + linelen) * 2;
+            job->lines = RedisModule_Realloc(job->lines, job->linescap);
+        }
+        fsGrepMatch *m = &job->matches[job->count++];
+        m->file = job->file;
+        m->lineno = lineno;
+        m->line = job->lineslen;
+        m->linelen = linelen;
+        memcpy(job->lines + job->lineslen, line, linelen);
+        job->lineslen += linelen;
+    } else {
+        RedisModule_ReplyWithArray(ctx, 3);
+        RedisModule_ReplyWithStringBuffer(ctx, path, pathlen);
+        RedisModule_ReplyWithLongLong(ctx, lineno);
+        RedisModule_ReplyWithStringBuffer(ctx, line, linelen);
+    }
+    walk->page->count++;
+    if (walk->page->left > 0) walk->page->left--;
+}
+
+static void fsGrepStop(RedisModuleCtx *ctx, fsPage *page, long long line,
+                       const char *path, size_t pathlen) {
+    page->next = RedisModule_CreateStringPrintf(ctx, "%lld:%.*s",
+                                                line, (int)pathlen, path);
+}
+
+/* Grep one block of file content whose first line is number *lineno,
+ * reporting matches from line startline on. Returns 1 once the page is
+ * full (its cursor already emitted), 2 if the block is binary, else 0. */
+static int fsGrepBlock(RedisModuleCtx *ctx, fsGrepWalk *walk, const char *path,
+                       size_t pathlen, const char *data, size_t size,
+                       long long startline, long long *lineno) {
+    fsPage *page = walk->page;
+    const char *pattern = walk->pattern;
+
+    /* Binary file detection: check for NUL bytes (same heuristic as
+     * GNU grep). If binary, report "Binary file matches" instead of
+     * dumping raw content. */
+    int is_binary = (memchr(data, '\0', size) != NULL);
+
+    if (is_binary) {
+        if (startline > *lineno) return 2;  // reported by an earlier page
+        page->bytes -= size;
+
+        /* Scan the raw bytes for the pattern's literal substring.
+         * We can't do line-by-line glob on binary, so just check if
+         * the literal is present anywhere (case-insensitive). */
+        const char *lit;
+        size_t litlen = fsBloomExtractLiteral(pattern, &lit);
+        int found = 0;
+        if (litlen >= 1) {
+            for (size_t i = 0; i + litlen <= size && !found; i++) {
+                size_t j;
+                for (j = 0; j < litlen; j++) {
+                    uint8_t a = fsLowerChar((uint8_t)data[i+j]);
+                    uint8_t b = fsLowerChar((uint8_t)lit[j]);
+                    if (a != b) break;
+                }
+                if (j == litlen) found = 1;
+            }
+        } else {
+            found = 1; // Pure wildcard pattern — assume match.
+        }
+        if (found) {
+            static const char msg[] = "Binary file matches";
+            fsGrepEmit(ctx, walk, path, pathlen, 0, msg, sizeof(msg) - 1);
+        }
+        return 2;
+    }
+
+    // Text: search line by line.
+    size_t pos = 0;
+
+    while (pos < size) {
+        // Find line end.
+        size_t linestart = pos;
+        const char *nl = memchr(data + pos, '\n', size - pos);
+        pos = nl ? (size_t)(nl - data) : size;
+        size_t linelen = pos - linestart;
+        if (pos < size) pos++; // skip newline
+
+        if (*lineno >= startline) {
+            if (page->left == 0 || page->bytes <= 0) {
+                fsGrepStop(ctx, page, *lineno, path, pathlen);
+                return 1;
+            }
+            page->bytes -= linelen + 1;
+
+            // Extract line as null-terminated string.
+            char *line = RedisModule_Alloc(linelen + 1);
+            memcpy(line, data + linestart, linelen);
+            line[linelen] = '\0';
+
+            int match;
+            if (walk->nocase)
+                match = fsGlobMatchNoCase(pattern, line);
+            else
+                match = fsGlobMatch(pattern, line);
+
+            if (match)
+                fsGrepEmit(ctx, walk, path, pathlen, *lineno, line, linelen);
+
+            RedisModule_Free(line);
+        }
+        (*lineno)++;
+    }
+    return 0;
+}
+
+/* A log file is grepped a run of segments at a time, each run ending at a
+ * segment that ends with a newline so that no line spans two runs. A run
+ * is skipped by its line count when its blooms rule the pattern out, or
+ * when it lies before the cursor. Runs of several segments (a line split
+ * by the segment size) are copied into one buffer and always scanned. */
+static int fsGrepLog(RedisModuleCtx *ctx, fsGrepWalk *walk, const char *path,
+                     size_t pathlen, const fsLog *log, long long startline) {
+    long long lineno = 1;
+    size_t i = 0;
+    while (i < log->count) {
+        size_t j = i;
+        while (j + 1 < log->count &&
+               log->segments[j].data[log->segments[j].size - 1] != '\n')
+            j++;
+
+        size_t size = 0;
+        uint64_t lines = 0;
+        int maybe = (i != j);
+        for (size_t k = i; k <= j; k++) {
+            const fsLogSegment *seg = &log->segments[k];
+            size += seg->size;
+            lines += seg->lines;
+            if (!maybe && (seg->size < 3 || fsBloomMayContain(seg->bloom, walk->pattern)))
+                maybe = 1;
+        }
+        if (!maybe || lineno + (long long)lines <= startline) {
+            lineno += (long long)lines;
+            i = j + 1;
+            continue;
+        }
+
+        char *joined = NULL;
+        const char *data = log->segments[i].data;
+        if (i != j) {
+            joined = RedisModule_Alloc(size);
+            size_t off = 0;
+            for (size_t k = i; k <= j; k++) {
+                memcpy(joined + off, log->segments[k].data, log->segments[k].size);
+                off += log->segments[k].size;
+            }
+            data = joined;
+        }
+        int rc = fsGrepBlock(ctx, walk, path, pathlen, data, size, startline, &lineno);
+        if (joined) RedisModule_Free(joined);
+        if (rc == 1) return 1;
+        if (rc == 2) return 0;
+        i = j + 1;
+    }
+    return 0;
+}
+
+static int fsGrepVisit(RedisModuleCtx *ctx, const char *path, size_t pathlen,
+                       fsInode *inode, void *privdata) {
+    fsGrepWalk *walk = privdata;
+    fsPage *page = walk->page;
+    long long startline = 1;
+    if (walk->startpath) {
+        if (pathlen == walk->startpathlen && !memcmp(path, walk->startpath, pathlen))
+            startline = walk->startline;
+        walk->startpath = NULL;
+    }
+    if (page->left == 0 || page->inodes <= 0 || page->bytes <= 0) {
+        fsGrepStop(ctx, page, startline, path, pathlen);
+        return 1;
+    }
+    page->inodes--;
+
+    if (inode->type != FS_INODE_FILE || inode->payload.file.size == 0) return 0;
+    if (inode->payload.file.log)
+        return fsGrepLog(ctx, walk, path, pathlen, inode->payload.file.log, startline);
+
+    /* Bloom filter fast path: skip files that definitely don't match.
+     * The bloom is always built with lowercased trigrams, so it works
+     * for both case-sensitive and case-insensitive grep. */
+    if (!fsBloomMayMatch(inode, walk->pattern)) return 0;
+
+    long long lineno = 1;
+    return fsGrepBlock(ctx, walk, path, pathlen, inode->payload.file.data,
+                       inode->payload.file.size, startline, &lineno) == 1;
+}
+
+/* Pin the files an unpaged grep would scan. */
+static int fsGrepPinVisit(RedisModuleCtx *ctx, const char *path, size_t pathlen,
+                          fsInode *inode, void *privdata) {
+    fsGrepJob *job = privdata;
+    if (inode->type != FS_INODE_FILE || inode->payload.file.size == 0) return 0;
+    if (!inode->payload.file.log && !fsBloomMayMatch(inode, job->pattern)) return 0;
+    fsViewAddFile(job->view, path, pathlen, inode);
+    return 0;
+}
+
+static void fsGrepJobFree(RedisModuleCtx *ctx, void *privdata) {
+    fsGrepJob *job = privdata;
+    fsViewRelease(job->view);
+    RedisModule_Free(job->pattern);
+    if (job->matches) RedisModule_Free(job->matches);
+    if (job->lines) RedisModule_Free(job->lines);
+    RedisModule_Free(job);
+}
+
+/* Runs without the module lock: it reads only the job and its view. */
+static void *fsGrepThread(void *arg) {
+    fsGrepJob *job = arg;
+    fsPage page;
+    fsPageInit(&page);
+    fsGrepWalk walk = {&page, job->pattern, job->nocase, NULL, 0, 1, job};
+    fsView *view = job->view;
+    for (job->file = 0; job->file < view->count; job->file++) {
+        const fsViewFile *f = &view->files[job->file];
+        const char *path = fsViewPath(view, f);
+        if (f->log) {
+            fsGrepLog(NULL, &walk, path, f->pathlen, f->log, 1);
+        } else {
+            long long lineno = 1;
+            fsGrepBlock(NULL, &walk, path, f->pathlen, f->data, f->size, 1, &lineno);
+        }
+    }
+    RedisModule_UnblockClient(job->bc, job);
+    return NULL;
+}
+
+static int fsGrepJobReply(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+    fsGrepJob *job = RedisModule_GetBlockedClientPrivateData(ctx);
+    RedisModule_ReplyWithArray(ctx, job->count);
+    for (size_t i = 0; i < job->count; i++) {
+        const fsGrepMatch *m = &job->matches[i];
+        const fsViewFile *f = &job->view->files[m->file];
+        RedisModule_ReplyWithArray(ctx, 3);
+        RedisModule_ReplyWithStringBuffer(ctx, fsViewPath(job->view, f), f->pathlen);
+        RedisModule_ReplyWithLongLong(ctx, m->lineno);
+        RedisModule_ReplyWithStringBuffer(ctx, job->lines + m->line, m->linelen);
+    }
+    return REDISMODULE_OK;
+}
+
+/* Start an unpaged grep in the background if it is big enough and the
+ * client may block. Returns 1 if the client is now blocked on it. */
+static int fsGrepBackground(RedisModuleCtx *ctx, fsObject *fs, const char *path,
+                            size_t pathlen, const char *pattern, int nocase) {
+    int flags = RedisModule_GetContextFlags(ctx);
+    if (flags & (REDISMODULE_CTX_FLAGS_MULTI |
+                 REDISMODULE_CTX_FLAGS_LUA |
+                 REDISMODULE_CTX_FLAGS_DENY_BLOCKING)) return 0;
+
+    fsGrepJob *job = RedisModule_Alloc(sizeof(*job));
+    memset(job, 0, sizeof(*job));
+    job->view = fsViewCreate();
+    job->pattern = RedisModule_Strdup(pattern);
+    job->nocase = nocase;
+    fsWalkSubtree(ctx, fs, path, pathlen, NULL, 0, fsGrepPinVisit, job);
+    if (job->view->bytes < FS_GREP_BACKGROUND_BYTES) {
+        fsGrepJobFree(ctx, job);
+        return 0;
+    }
+
+    job->bc = RedisModule_BlockClient(ctx, fsGrepJobReply, NULL, fsGrepJobFree, 0);
+    pthread_t tid;
+    if (pthread_create(&tid, NULL, fsGrepThread, job) != 0) {
+        RedisModule_AbortBlock(job->bc);
+        fsGrepJobFree(ctx, job);
+        return 0;
+    }
+    pthread_detach(tid);
+    return 1;
+}
+
+static int GREP_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+    RedisModule_AutoMemory(ctx);
+    if (argc < 4) return RedisModule_WrongArity(ctx);
+    if (fsRoute(ctx, argv, argc, 2, 0)) return REDISMODULE_OK;
+
+    int nocase = 0;
+    fsPage page;
+    fsPageInit(&page);
+    RedisModuleString *cursor = NULL;
+    for (int i = 4; i < argc;) {
+        int r = fsParsePageOption(ctx, argv, argc, &i, &page, &cursor);
+        if (r < 0) return REDISMODULE_OK;
+        if (r) continue;
+        const char *opt = RedisModule_StringPtrLen(argv[i], NULL);
+        if (!strcasecmp(opt, "NOCASE")) {
+            nocase = 1;
+            i++;
+        } else {
+            return RedisModule_ReplyWithError(ctx, "ERR syntax error — expected NOCASE, LIMIT <n> or CURSOR <c>");
+        }
+    }
+
+    /* A GREP cursor is "<line>:<path>". */
+    const char *from = NULL;
+    size_t fromlen = 0;
+    long long startline = 1;
+    if (cursor) {
+        size_t clen;
+        const char *c = RedisModule_StringPtrLen(cursor, &clen);
+        const char *colon = memchr(c, ':', clen);
+        char *end = NULL;
+        if (colon) startline = strtoll(c, &end, 10);
+        if (!colon || end != colon || startline < 1) {
+            return RedisModule_ReplyWithError(ctx, "ERR invalid cursor");
+        }
+        from = colon + 1;
+        fromlen = clen - (from - c);
+    }
+
+    RedisModuleKey *key;
+    fsObject *fs = fsGetObject(ctx, argv[1], REDISMODULE_READ, &key);
+    if (!key) return REDISMODULE_OK;
+    if (!fs) return RedisModule_ReplyWithError(ctx, "ERR no such filesystem key");
+
+    size_t pathlen;
+    const char *rawpath = RedisModule_StringPtrLen(argv[2], &pathlen);
+    char *path = fsNormalizeOrReply(ctx, rawpath, pathlen);
+    if (!path) return REDISMODULE_OK;
+    pathlen = strlen(path);
+    if (from && !fsPathWithin(from, fromlen, path, pathlen)) {
+        RedisModule_Free(path);
+        return RedisModule_ReplyWithError(ctx, "ERR invalid cursor — not under path");
+    }
+
+    const char *pattern = RedisModule_StringPtrLen(argv[3], NULL);
+    if (!page.paging && fsGrepBackground(ctx, fs, path, pathlen, pattern, nocase)) {
+        RedisModule_Free(path);
+        return REDISMODULE_OK;
+    }
+
+    fsGrepWalk walk = {&page, pattern, nocase, from, fromlen, startline, NULL};
+    if (page.paging) RedisModule_ReplyWithArray(ctx, 2);
+    RedisModule_ReplyWithArray(ctx, REDISMODULE_POSTPONED_LEN);
+    fsWalkSubtree(ctx, fs, path, pathlen, from, fromlen, fsGrepVisit, &walk);
+    fsPageReply(ctx, &page);
+
+    RedisModule_Free(path);
+    return REDISMODULE_OK;
+}
+
+/* ===================================================================
+ * FS.SEARCH key path "query terms" [LIMIT n] [INCLUDE glob]
+ *
+ * Rank the files under path by BM25 relevance to the query words and
+ * return the best ones as [path, score, line_number, line] entries, where
+ * line is the one containing the most query words. INCLUDE filters on the
+ * file's basename like FS.FIND. The first search on a key builds its word
+ * index; later ones only re-tokenize files changed since.
+ * =================================================================== */
+static int SEARCH_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+    RedisModule_AutoMemory(ctx);
+    if (argc < 4 || argc % 2) return RedisModule_WrongArity(ctx);
+    if (fsRoute(ctx, argv, argc, 2, 0)) return REDISMODULE_OK;
+
+    long long limit = FS_SEARCH_DEFAULT_LIMIT;
+    const char *include = NULL;
+    for (int i = 4; i < argc; i += 2) {
+        const char *opt = RedisModule_StringPtrLen(argv[i], NULL);
+        if (!strcasecmp(opt, "LIMIT")) {
+            if (RedisModule_StringToLongLong(argv[i+1], &limit) != REDISMODULE_OK ||
+                limit < 1 || limit > FS_SEARCH_MAX_LIMIT)
+                return RedisModule_ReplyWithError(ctx, "ERR LIMIT must be between 1 and 1000");
+        } else if (!strcasecmp(opt, "INCLUDE")) {
+            include = RedisModule_StringPtrLen(argv[i+1], NULL);
+        } else {
+            return RedisModule_ReplyWithError(ctx, "ERR syntax error — expected LIMIT <n> or INCLUDE <glob>");
+        }
+    }
+
+    RedisModuleKey *key;
+    fsObject *fs = fsGetObject(ctx, argv[1], REDISMODULE_READ, &key);
+    if (!key) return REDISMODULE_OK;
+    if (!fs) return RedisModule_ReplyWithError(ctx, "ERR no such filesystem key");
+
+    size_t pathlen;
+    const char *rawpath = RedisModule_StringPtrLen(argv[2], &pathlen);
+    char *path = fsNormalizeOrReply(ctx, rawpath, pathlen);
+    if (!path) return REDISMODULE_OK;
+
+    size_t qlen;
+    const char *query = RedisModule_StringPtrLen(argv[3], &qlen);
+
+    if (fs->index) fsIndexRefresh(fs->index);
+    else fsIndexEnable(fs);
+
+    fsSearchHit *hits = RedisModule_Alloc(sizeof(*hits) * limit);
+    size_t n = fsIndexSearch(fs->index, query, qlen, path, strlen(path),
+                             include, hits, (size_t)limit);
+    RedisModule_Free(path);
+
+    RedisModule_ReplyWithArray(ctx, n);
+    for (size_t i = 0; i < n; i++) {
+        fsInode *inode = hits[i].inode;
+        const char *data = fsFileContent(ctx, inode);
+        size_t lineno = 0, start = 0, end = 0;
+        fsIndexBestLine(data, inode->payload.file.size,
+                        query, qlen, &lineno, &start, &end);
+        if (end - start > FS_INDEX_SNIPPET_MAX) end = start + FS_INDEX_SNIPPET_MAX;
+
+        RedisModule_ReplyWithArray(ctx, 4);
+        RedisModule_ReplyWithCString(ctx, hits[i].path);
+        RedisModule_ReplyWithDouble(ctx, hits[i].score);
+        RedisModule_ReplyWithLongLong(ctx, (long long)lineno);
+        RedisModule_ReplyWithStringBuffer(ctx, data + start, end - start);
+    }
+    RedisModule_Free(hits);
+    return REDISMODULE_OK;
+}
+
+/* ===================================================================
+ * FS.HOT key [path] [LIMIT n] [READS|WRITES]
+ *
+ * The most read and written files at or below path (default "/"), as
+ * [path, reads, writes] entries, hottest first. The counts are the
+ * logarithmic access counters (0-255, see hot.h); READS or WRITES ranks
+ * by one of them, otherwise by both together. The answer comes from the
+ * key's hot pools, not a scan, so it is approximate.
+ * =================================================================== */
+static int HOT_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+    RedisModule_AutoMemory(ctx);
+    if (argc < 2) return RedisModule_WrongArity(ctx);
+    if (fsRoute(ctx, argv, argc, 2, 0)) return REDISMODULE_OK;
+
+    /* The path is optional, as for FS.LS. */
+    const char *rawpath = "/";
+    size_t pathlen = 1;
+    int i = 2;
+    if (argc > 2) {
+        const char *arg = RedisModule_StringPtrLen(argv[2], &pathlen);
+        if (strcasecmp(arg, "LIMIT") && strcasecmp(arg, "READS") &&
+            strcasecmp(arg, "WRITES")) {
+            rawpath = arg;
+            i = 3;
+        } else {
+            pathlen = 1;
+        }
+    }
+
+    long long limit = FS_HOT_DEFAULT_LIMIT;
+    int which = -1;
+    for (; i < argc; i++) {
+        const char *opt = RedisModule_StringPtrLen(argv[i], NULL);
+        if (!strcasecmp(opt, "LIMIT") && i + 1 < argc) {
+            if (RedisModule_StringToLongLong(argv[++i], &limit) != REDISMODULE_OK ||
+                limit < 1 || limit > FS_HOT_POOL)
+                return RedisModule_ReplyWithError(ctx, "ERR LIMIT must be between 1 and 256");
+        } else if (!strcasecmp(opt, "READS")) {
+            which = FS_HOT_READS;
+        } else if (!strcasecmp(opt, "WRITES")) {
+            which = FS_HOT_WRITES;
+        } else {
+            return RedisModule_ReplyWithError(ctx, "ERR syntax error — expected LIMIT <n>, READS or WRITES");
+        }
+    }
+
+    RedisModuleKey *key;
+    fsObject *fs = fsGetObject(ctx, argv[1], REDISMODULE_READ, &key);
+    if (!key) return REDISMODULE_OK;
+    if (!fs) return RedisModule_ReplyWithError(ctx, "ERR no such filesystem key");
+
+    char *path = fsNormalizeOrReply(ctx, rawpath, pathlen);
+    if (!path) return REDISMODULE_OK;
+
+    fsHotEntry *hits = RedisModule_Alloc(sizeof(*hits) * limit);
+    size_t n = fsHotTop(fs->hot, which, path, strlen(path), hits, (size_t)limit);
+    RedisModule_Free(path);
+
+    RedisModule_ReplyWithArray(ctx, n);
+    for (size_t j = 0; j < n; j++) {
+        RedisModule_ReplyWithArray(ctx, 3);
+        RedisModule_ReplyWithStringBuffer(ctx, hits[j].path, hits[j].pathlen);
+        RedisModule_ReplyWithLongLong(ctx, hits[j].reads);
+        RedisModule_ReplyWithLongLong(ctx, hits[j].writes);
+    }
+    RedisModule_Free(hits);
+    return REDISMODULE_OK;
+}
+
+/* ===================================================================
+ * FS.ANALYZE key [path] [COUNT n] [CURSOR c]
+ *
+ * Describe the shape of the subtree at path (default "/"): histograms of
+ * file sizes, directory fan-out, path lengths and depths, bloom filter
+ * fill, bytes per extension, an estimate of duplicate content, and where
+ * the memory goes (see analyze.h). Like SCAN the walk is incremental:
+ * each call looks at up to COUNT inodes (default 10000) and at most
+ * FS_PAGE_SCAN_BYTES of sampled content, and replies [stats, cursor],
+ * cursor "0" once the walk is done. Stats of successive pages add up,
+ * except the duplicate estimate, which covers one page: clients merge
+ * the pages' samples to estimate duplicates across the walk.
+ * =================================================================== */
+typedef struct fsAnalyzeWalk {
+    fsAnalysis *a;
+    long long left;             /* Inodes still to visit */
+    RedisModuleString *next;    /* Cursor, once stopped */
+} fsAnalyzeWalk;
+
+static int fsAnalyzeVisit(RedisModuleCtx *ctx, const char *path, size_t pathlen,
+                          fsInode *inode, void *privdata) {
+    fsAnalyzeWalk *walk = privdata;
+    if (walk->left == 0 || walk->a->hashed_bytes >= FS_PAGE_SCAN_BYTES) {
+        walk->next = RedisModule_CreateString(ctx, path, pathlen);
+        return 1;
+    }
+    walk->left--;
+    fsAnalysisAdd(walk->a, path, pathlen, inode);
+    return 0;
+}
+
+static int ANALYZE_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+    RedisModule_AutoMemory(ctx);
+    if (argc < 2) return RedisModule_WrongArity(ctx);
+    if (fsRoute(ctx, argv, argc, 2, 0)) return REDISMODULE_OK;
+
+    /* The path is optional, as for FS.LS. */
+    const char *rawpath = "/";
+    size_t pathlen = 1;
+    int i = 2;
+    if (argc > 2) {
+        const char *arg = RedisModule_StringPtrLen(argv[2], &pathlen);
+        if (strcasecmp(arg, "COUNT") && strcasecmp(arg, "CURSOR")) {
+            rawpath = arg;
+            i = 3;
+        } else {
+            pathlen = 1;
+        }
+    }
+
+    long long count = FS_ANALYZE_DEFAULT_COUNT;
+    RedisModuleString *cursor = NULL;
+    for (; i < argc; i++) {
+        const char *opt = RedisModule_StringPtrLen(argv[i], NULL);
+        if (!strcasecmp(opt, "COUNT") && i + 1 < argc) {
+            if (RedisModule_StringToLongLong(argv[++i], &count) != REDISMODULE_OK ||
+                count < 1 || count > FS_PAGE_SCAN_INODES)
+                return RedisModule_ReplyWithError(ctx, "ERR COUNT must be between 1 and 100000");
+        } else if (!strcasecmp(opt, "CURSOR") && i + 1 < argc) {
+            cursor = argv[++i];
+        } else {
+            return RedisModule_ReplyWithError(ctx, "ERR syntax error — expected COUNT <n> or CURSOR <c>");
+        }
+    }
+
+    RedisModuleKey *key;
+    fsObject *fs = fsGetObject(ctx, argv[1], REDISMODULE_READ, &key);
+    if (!key) return REDISMODULE_OK;
+    if (!fs) return RedisModule_ReplyWithError(ctx, "ERR no such filesystem key");
+
+    char *path = fsNormalizeOrReply(ctx, rawpath, pathlen);
+    if (!path) return REDISMODULE_OK;
+    pathlen = strlen(path);
+    if (!fsLookup(fs, path, pathlen)) {
+        RedisModule_Free(path);
+        return RedisModule_ReplyWithError(ctx, "ERR no such path");
+    }
+    if (cursor && !fsCursorValid(cursor, path, pathlen)) {
+        RedisModule_Free(path);
+        return RedisModule_ReplyWithError(ctx, "ERR invalid cursor — not under path");
+    }
+    const char *from = NULL;
+    size_t fromlen = 0;
+    if (cursor) from = RedisModule_StringPtrLen(cursor, &fromlen);
+
+    fsAnalysis a;
+    fsAnalysisInit(&a);
+    fsAnalyzeWalk walk = {&a, count, NULL};
+    fsWalkSubtree(ctx, fs, path, pathlen, from, fromlen, fsAnalyzeVisit, &walk);
+    RedisModule_Free(path);
+
+    // Side tables belong to the whole key; count them on the first page.
+    RedisModule_ReplyWithArray(ctx, 2);
+    fsAnalysisReply(ctx, &a, cursor ? 0 : fsSideMemUsage(fs));
+    if (walk.next) RedisModule_ReplyWithString(ctx, walk.next);
+    else RedisModule_ReplyWithCString(ctx, "0");
+    fsAnalysisFree(&a);
+    return REDISMODULE_OK;
+}
+
+/* ===================================================================
+ * FS.TRUNCATE key path length [IFVERSION v]
+ *
+ * Truncate or extend a file to the specified length.
+ * Follows symlinks. length < size shrinks, length > size zero-extends.
+ * =================================================================== */
+static int TRUNCATE_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+    RedisModule_AutoMemory(ctx);
+    long long ifversion;
+    if (fsParseIfVersion(ctx, argv, &argc, 4, &ifversion) != REDISMODULE_OK)
+        return REDISMODULE_OK;
+    if (argc != 4) return RedisModule_WrongArity(ctx);
+    if (fsRoute(ctx, argv, argc, 2, 0)) return REDISMODULE_OK;
+
+    RedisModuleKey *key;
+    fsObject *fs = fsGetObject(ctx, argv[1], REDISMODULE_READ|REDISMODULE_WRITE, &key);
+    if (!key) return REDISMODULE_OK;
+
+    size_t pathlen;
+    const char *rawpath = RedisModule_StringPtrLen(argv[2], &pathlen);
+    char *path = fsNormalizeOrReply(ctx, rawpath, pathlen);
+    if (!path) return REDISMODULE_OK;
+    size_t npathlen = strlen(path);
+
+    // Resolve symlinks.
+    int err;
+    char *resolved = fsResolvePath(fs, path, npathlen, &err);
+    RedisModule_Free(path);
+    if (err == FS_RESOLVE_ERR_SYMLINK_LOOP)
+        return RedisModule_ReplyWithError(ctx, "ERR too many levels of symbolic links");
+    if (err == FS_RESOLVE_ERR_PATH_DEPTH)
+        return RedisModule_ReplyWithError(ctx, "ERR path depth exceeds limit");
+
+    fsInode *inode = fsLookup(fs, resolved, strlen(resolved));
+    if (!inode) {
+        RedisModule_Free(resolved);
+        return RedisModule_ReplyWithError(ctx, "ERR no such file or directory");
+    }
+    if (!fsCheckVersion(ctx, inode, ifversion)) {
+        RedisModule_Free(resolved);
+        return REDISMODULE_OK;
+    }
+    if (inode->type != FS_INODE_FILE) {
+        RedisModule_Free(resolved);
+        return RedisModule_ReplyWithError(ctx, "ERR not a file");
+    }
+
+    long long length;
+    if (RedisModule_StringToLongLong(argv[3], &length) != REDISMODULE_OK || length < 0) {
+        RedisModule_Free(resolved);
+        return RedisModule_ReplyWithError(ctx, "ERR length must be a non-negative integer");
+    }
+
+    size_t newlen = (size_t)length;
+    size_t oldlen = inode->payload.file.size;
+    if (inode->payload.file.log && newlen != 0 && newlen != oldlen) {
+        RedisModule_Free(resolved);
+        return RedisModule_ReplyWithError(ctx, "ERR log files are append-only — truncate to 0 to empty one");
+    }
+
+    if (newlen == 0 && inode->payload.file.log) {
+        fs->total_data_size -= oldlen;
+        fsFileSetData(inode, NULL, 0);
+    } else if (newlen == 0) {
+        // Truncate to zero.
+        fs->total_data_size -= oldlen;
+        fsBufferFree(inode->payload.file.data);
+        inode->payload.file.data = NULL;
+        inode->payload.file.size = 0;
+        memset(inode->payload.file.bloom, 0, FS_BLOOM_BYTES);
+    } else if (newlen < oldlen) {
+        // Shrink.
+        fs->total_data_size -= (oldlen - newlen);
+        inode->payload.file.data = fsBufferRealloc(inode->payload.file.data, oldlen, newlen);
+        inode->payload.file.size = newlen;
+        fsBloomBuild(inode);
+    } else if (newlen > oldlen) {
+        // Zero-extend.
+        fs->total_data_size += (newlen - oldlen);
+        inode->payload.file.data = fsBufferRealloc(inode->payload.file.data, oldlen, newlen);
+        memset(inode->payload.file.data + oldlen, 0, newlen - oldlen);
+        inode->payload.file.size = newlen;
+        fsBloomBuild(inode);
+    }
+    // newlen == oldlen: no-op.
+
+    inode->mtime = fsNowMs();
+    fsInodeBump(fs, inode);
+    fsCountAccess(fs, inode, FS_HOT_WRITES, resolved);
+    RedisModule_ReplyWithSimpleString(ctx, "OK");
+    fsReplicateWrite(ctx, argv, argc, ifversion);
+    fsNotifyWrite(ctx, argv[1], resolved, strlen(resolved));
+    RedisModule_Free(resolved);
+    return REDISMODULE_OK;
+}
+
+/* ===================================================================
+ * FS.UTIMENS key path atime_ms mtime_ms [IFVERSION v]
+ *
+ * Set access and modification times. Value of -1 means "don't change"
+ * (matches POSIX UTIME_OMIT). Does NOT follow symlinks (matches
+ * utimensat with AT_SYMLINK_NOFOLLOW).
+ * =================================================================== */
+static int UTIMENS_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+    RedisModule_AutoMemory(ctx);
+    long long ifversion;
+    if (fsParseIfVersion(ctx, argv, &argc, 5, &ifversion) != REDISMODULE_OK)
+        return REDISMODULE_OK;
+    if (argc != 5) return RedisModule_WrongArity(ctx);
+    if (fsRoute(ctx, argv, argc, 2, 0)) return REDISMODULE_OK;
+
+    RedisModuleKey *key;
+    fsObject *fs = fsGetObject(ctx, argv[1], REDISMODULE_READ|REDISMODULE_WRITE, &key);
+    if (!key) return REDISMODULE_OK;
+
+    size_t pathlen;
+    const char *rawpath = RedisModule_StringPtrLen(argv[2], &pathlen);
+    char *path = fsNormalizeOrReply(ctx, rawpath, pathlen);
+    if (!path) return REDISMODULE_OK;
+
+    fsInode *inode = fsLookup(fs, path, strlen(path));
+    RedisModule_Free(path);
+    if (!fsCheckVersion(ctx, inode, ifversion)) return REDISMODULE_OK;
+    if (!inode) return RedisModule_ReplyWithError(ctx, "ERR no such file or directory");
+
+    long long atime_ms, mtime_ms;
+    if (RedisModule_StringToLongLong(argv[3], &atime_ms) != REDISMODULE_OK)
+        return RedisModule_ReplyWithError(ctx, "ERR atime_ms must be an integer");
+    if (RedisModule_StringToLongLong(argv[4], &mtime_ms) != REDISMODULE_OK)
+        return RedisModule_ReplyWithError(ctx, "ERR mtime_ms must be an integer");
+
+    if (atime_ms != -1) inode->atime = atime_ms;
+    if (mtime_ms != -1) inode->mtime = mtime_ms;
+    fsInodeBump(fs, inode);
+
+    RedisModule_ReplyWithSimpleString(ctx, "OK");
+    fsReplicateWrite(ctx, argv, argc, ifversion);
+    fsNotifyWriteArg(ctx, argv[1], argv[2]);
+    return REDISMODULE_OK;
+}
+
+/* ===================================================================
+ * Path expiry: registry and reclaimer
+ *
+ * fsExpiringKeys maps "<be32 dbid><keyname>" to NULL for every key that
+ * may hold expiring paths. Entries are added eagerly (FS.EXPIRE, RDB load,
+ * RENAME/MOVE/RESTORE notifications) and dropped lazily by the reclaimer
+ * once it finds the key gone or without expiries. SWAPDB and FLUSHDB move
+ * keys between databases wholesale, so those re-key the registry.
+ * =================================================================== */
+static RedisModuleDict *fsExpiringKeys = NULL;
+static char *fsExpireCursor = NULL;     /* Last registry entry visited */
+static size_t fsExpireCursorLen = 0;
+
+static void fsExpireTrack(int dbid, const char *name, size_t namelen) {
+    char *k = RedisModule_Alloc(4 + namelen);
+    k[0] = (char)((uint32_t)dbid >> 24);
+    k[1] = (char)((uint32_t)dbid >> 16);
+    k[2] = (char)((uint32_t)dbid >> 8);
+    k[3] = (char)dbid;
+    memcpy(k + 4, name, namelen);
+    RedisModule_DictReplaceC(fsExpiringKeys, k, 4 + namelen, NULL);
+    RedisModule_Free(k);
+}
+
+static int fsExpireEntryDb(const char *k) {
+    return (int)(((uint32_t)(uint8_t)k[0] << 24) | ((uint32_t)(uint8_t)k[1] << 16) |
+                 ((uint32_t)(uint8_t)k[2] << 8) | (uint32_t)(uint8_t)k[3]);
+}
+
+/* Remember that the key behind argv-style keyname has expiring paths. */
+static void fsExpireTrackKey(RedisModuleCtx *ctx, RedisModuleString *keyname) {
+    size_t namelen;
+    const char *name = RedisModule_StringPtrLen(keyname, &namelen);
+    fsExpireTrack(RedisModule_GetSelectedDb(ctx), name, namelen);
+}
+
+/* fsRemove drops mount entries along with their stub directories. Before
+ * reclaiming path, replicate an FS.UMOUNT for every mount at or below it
+ * so replicas (whose RM would otherwise be redirected) stay in step. */
+static void fsReplicateUmounts(RedisModuleCtx *ctx, RedisModuleString *keyname,
+                               fsObject *fs, const char *path, size_t pathlen) {
+    if (!fsMountsUnder(fs, path, pathlen)) return;
+    RedisModuleDictIter *iter = RedisModule_DictIteratorStartC(
+        fs->mounts, ">=", (void*)path, pathlen);
+    char *k;
+    size_t klen;
+    while ((k = RedisModule_DictNextC(iter, &klen, NULL)) != NULL) {
+        if (klen < pathlen || memcmp(k, path, pathlen) != 0) break;
+        if (!fsIsRoot(path, pathlen) && klen > pathlen && k[pathlen] != '/') continue;
+        RedisModule_Replicate(ctx, "FS.UMOUNT", "sb", keyname, k, klen);
+    }
+    RedisModule_DictIteratorStop(iter);
+}
+
+/* Reclaim the expired subtree rooted at path, spending at most *budget
+ * inode deletions. If the whole subtree fits, it goes in one
+ * FS.RM RECURSIVE. Otherwise we delete descendants leaves-first: walking
+ * the path-ordered dict backwards from the end of the subtree visits every
+ * entry after all of its own descendants, so each one is a leaf (or an
+ * empty directory) by the time we reach it. Each of those is replicated
+ * as a plain FS.RM and the rest waits for the next tick.
+ * Returns 1 if path itself was removed. */
+static int fsExpireReclaim(RedisModuleCtx *ctx, RedisModuleString *keyname,
+                           fsObject *fs, const char *path, size_t pathlen,
+                           long *budget) {
+    // Descendants of path sort between "path/" and "path0" ('0' follows '/').
+    char *end = RedisModule_Alloc(pathlen + 1);
+    memcpy(end, path, pathlen);
+    end[pathlen] = '0';
+
+    char **batch = RedisModule_Alloc(sizeof(char*) * (*budget));
+    size_t *batchlen = RedisModule_Alloc(sizeof(size_t) * (*budget));
+    long n = 0, descendants = 0;
+    RedisModuleDictIter *iter = RedisModule_DictIteratorStartC(
+        fs->inodes, "<", end, pathlen + 1);
+    char *k;
+    size_t klen;
+    while ((k = RedisModule_DictPrevC(iter, &klen, NULL)) != NULL) {
+        if (klen <= pathlen || memcmp(k, path, pathlen) != 0 || k[pathlen] != '/')
+            break;
+        descendants++;
+        if (n < *budget) {
+            batch[n] = RedisModule_Alloc(klen);
+            memcpy(batch[n], k, klen);
+            batchlen[n] = klen;
+            n++;
+        } else if (descendants >= *budget) {
+            break; // Enough to know it won't fit this tick.
+        }
+    }
+    RedisModule_DictIteratorStop(iter);
+    RedisModule_Free(end);
+
+    int whole = descendants < *budget;
+    if (whole) {
+        fsReplicateUmounts(ctx, keyname, fs, path, pathlen);
+        fsDeleteRecursive(fs, path, pathlen);
+        if (descendants > 0)
+            RedisModule_Replicate(ctx, "FS.RM", "sbc", keyname, path, pathlen, "RECURSIVE");
+        else
+            RedisModule_Replicate(ctx, "FS.RM", "sb", keyname, path, pathlen);
+        fsNotifyWrite(ctx, keyname, path, pathlen);
+        *budget -= descendants + 1;
+    } else {
+        for (long i = 0; i < n; i++) {
+            fsReplicateUmounts(ctx, keyname, fs, batch[i], batchlen[i]);
+            fsUnlink(fs, batch[i], batchlen[i]);
+            RedisModule_Replicate(ctx, "FS.RM", "sb", keyname, batch[i], batchlen[i]);
+            fsNotifyWrite(ctx, keyname, batch[i], batchlen[i]);
+        }
+        *budget -= n;
+    }
+    for (long i = 0; i < n; i++) RedisModule_Free(batch[i]);
+    RedisModule_Free(batch);
+    RedisModule_Free(batchlen);
+    return whole;
+}
+
+/* Discard uploads that have been idle past their timeout, replicating
+ * each as FS.ABORT. Returns 1 if any were discarded. */
+static int fsUploadReclaim(RedisModuleCtx *ctx, RedisModuleString *keyname,
+                           fsObject *fs, int64_t now, long *budget) {
+    if (fsUploadCount(fs) == 0) return 0;
+    uint64_t *expired = RedisModule_Alloc(sizeof(uint64_t) * (*budget));
+    long n = 0;
+    RedisModuleDictIter *iter = RedisModule_DictIteratorStartC(fs->uploads, "^", NULL, 0);
+    char *k;
+    fsUpload *up;
+    while (n < *budget && (k = RedisModule_DictNextC(iter, NULL, (void**)&up)) != NULL) {
+        if (up->deadline > now) continue;
+        uint64_t handle = 0;
+        for (int i = 0; i < 8; i++) handle = (handle << 8) | (uint8_t)k[i];
+        expired[n++] = handle;
+    }
+    RedisModule_DictIteratorStop(iter);
+
+    for (long i = 0; i < n; i++) {
+        fsUploadDiscard(fs, expired[i]);
+        RedisModule_Replicate(ctx, "FS.ABORT", "sl", keyname, (long long)expired[i]);
+    }
+    RedisModule_Free(expired);
+    *budget -= n;
+    return n > 0;
+}
+
+/* Reclaim expired paths and idle uploads in one key. Returns 0 if the key
+ * no longer has anything that can expire, so the caller can drop it from
+ * the registry. */
+static int fsExpireKey(RedisModuleCtx *ctx, int dbid, const char *name,
+                       size_t namelen, int64_t now, long *budget) {
+    if (RedisModule_SelectDb(ctx, dbid) != REDISMODULE_OK) return 0;
+    RedisModuleString *keyname = RedisModule_CreateString(ctx, name, namelen);
+    RedisModuleKey *key = RedisModule_OpenKey(ctx, keyname,
+        REDISMODULE_READ|REDISMODULE_WRITE);
+    int alive = 0;
+
+    if (RedisModule_ModuleTypeGetType(key) == FSType) {
+        fsObject *fs = RedisModule_ModuleTypeGetValue(key);
+        int changed = 0;
+        while (*budget > 0 && fs->expires && RedisModule_DictSize(fs->expires) > 0) {
+            RedisModuleDictIter *iter = RedisModule_DictIteratorStartC(
+                fs->expires, "^", NULL, 0);
+            size_t klen;
+            char *k = RedisModule_DictNextC(iter, &klen, NULL);
+            uint64_t when = 0;
+            for (int i = 0; i < 8; i++) when = (when << 8) | (uint8_t)k[i];
+            if ((int64_t)when > now) {
+                RedisModule_DictIteratorStop(iter);
+                break;
+            }
+            size_t pathlen = klen - 8;
+            char *path = RedisModule_Alloc(pathlen);
+            memcpy(path, k + 8, pathlen);
+            RedisModule_DictIteratorStop(iter);
+
+            if (fsLookup(fs, path, pathlen)) {
+                fsExpireReclaim(ctx, keyname, fs, path, pathlen, budget);
+            } else {
+                // Stale entry (shouldn't happen): drop it so we don't spin.
+                fsExpireIndexDel(fs, path, pathlen, (int64_t)when);
+            }
+            RedisModule_Free(path);
+            changed = 1;
+        }
+        if (*budget > 0 && fsUploadReclaim(ctx, keyname, fs, now, budget))
+            changed = 1;
+        alive = (fs->expires && RedisModule_DictSize(fs->expires) > 0) ||
+                fsUploadCount(fs) > 0;
+        // May free fs: the last path going away deletes the key.
+        if (changed) fsMaybeDeleteKey(key, fs);
+    }
+
+    RedisModule_CloseKey(key);
+    RedisModule_FreeString(ctx, keyname);
+    return alive;
+}
+
+/* Timer callback: one reclaim cycle, then re-arm. Only the master expires
+ * paths; replicas receive the resulting FS.RM commands. */
+static void fsExpireCycle(RedisModuleCtx *ctx, void *data) {
+    REDISMODULE_NOT_USED(data);
+    RedisModule_CreateTimer(ctx, FS_EXPIRE_TICK_MS, fsExpireCycle, NULL);
+
+    int flags = RedisModule_GetContextFlags(ctx);
+    if (!(flags & REDISMODULE_CTX_FLAGS_MASTER) || (flags & REDISMODULE_CTX_FLAGS_LOADING))
+        return;
+    if (RedisModule_DictSize(fsExpiringKeys) == 0) return;
+
+    // Snapshot a window of registry entries after the cursor, so every key
+    // gets its turn even when one of them has a long backlog.
+    char *names[FS_EXPIRE_KEYS_PER_TICK];
+    size_t lens[FS_EXPIRE_KEYS_PER_TICK];
+    int n = 0;
+    RedisModuleDictIter *iter = fsExpireCursor ?
+        RedisModule_DictIteratorStartC(fsExpiringKeys, ">", fsExpireCursor, fsExpireCursorLen) :
+        RedisModule_DictIteratorStartC(fsExpiringKeys, "^", NULL, 0);
+    char *k;
+    size_t klen;
+    while (n < FS_EXPIRE_KEYS_PER_TICK &&
+           (k = RedisModule_DictNextC(iter, &klen, NULL)) != NULL) {
+        names[n] = RedisModule_Alloc(klen);
+        memcpy(names[n], k, klen);
+        lens[n] = klen;
+        n++;
+    }
+    RedisModule_DictIteratorStop(iter);
+
+    if (fsExpireCursor) RedisModule_Free(fsExpireCursor);
+    fsExpireCursor = NULL;
+    if (n == FS_EXPIRE_KEYS_PER_TICK) {
+        fsExpireCursor = RedisModule_Alloc(lens[n - 1]);
+        memcpy(fsExpireCursor, names[n - 1], lens[n - 1]);
+        fsExpireCursorLen = lens[n - 1];
+    }
+
+    int64_t now = fsNowMs();
+    long budget = FS_EXPIRE_BUDGET;
+    for (int i = 0; i < n; i++) {
+        if (budget > 0 &&
+            !fsExpireKey(ctx, fsExpireEntryDb(names[i]), names[i] + 4,
+                         lens[i] - 4, now, &budget))
+            RedisModule_DictDelC(fsExpiringKeys, names[i], lens[i], NULL);
+        RedisModule_Free(names[i]);
+    }
+}
+
+/* RENAME, MOVE and RESTORE put an FS key under a name the registry
+ * doesn't know yet; re-register it if it carries expiring paths or open
+ * uploads. */
+static int fsKeyspaceNotify(RedisModuleCtx *ctx, int type, const char *event,
+                            RedisModuleString *keyname) {
+    REDISMODULE_NOT_USED(type);
+    if (strcmp(event, "rename_to") && strcmp(event, "move_to") &&
+        strcmp(event, "restore"))
+        return REDISMODULE_OK;
+
+    RedisModuleKey *key = RedisModule_OpenKey(ctx, keyname, REDISMODULE_READ);
+    if (RedisModule_ModuleTypeGetType(key) == FSType) {
+        fsObject *fs = RedisModule_ModuleTypeGetValue(key);
+        if ((fs->expires && RedisModule_DictSize(fs->expires) > 0) ||
+            fsUploadCount(fs) > 0)
+            fsExpireTrackKey(ctx, keyname);
+    }
+    RedisModule_CloseKey(key);
+    return REDISMODULE_OK;
+}
+
+/* SWAPDB swaps the databases under every key in them, and FLUSHDB or
+ * FLUSHALL empties them: rebuild the registry with the swapped dbids
+ * and without the flushed databases' entries. */
+static void fsExpireDbEvent(RedisModuleCtx *ctx, RedisModuleEvent e,
+                            uint64_t subevent, void *data) {
+    REDISMODULE_NOT_USED(ctx);
+    int first = -1, second = -1, flushed = -2;  /* -1 flushes them all */
+    if (e.id == REDISMODULE_EVENT_SWAPDB) {
+        RedisModuleSwapDbInfo *si = data;
+        first = si->dbnum_first;
+        second = si->dbnum_second;
+    } else {
+        if (subevent != REDISMODULE_SUBEVENT_FLUSHDB_END) return;
+        flushed = ((RedisModuleFlushInfo *)data)->dbnum;
+    }
+
+    RedisModuleDict *remapped = RedisModule_CreateDict(NULL);
+    RedisModuleDictIter *iter = RedisModule_DictIteratorStartC(fsExpiringKeys, "^", NULL, 0);
+    char *k;
+    size_t klen;
+    while ((k = RedisModule_DictNextC(iter, &klen, NULL)) != NULL) {
+        int dbid = fsExpireEntryDb(k);
+        if (flushed == -1 || dbid == flushed) continue;
+        if (dbid == first) dbid = second;
+        else if (dbid == second) dbid = first;
+        // k is the iterator's own buffer, so re-key a copy.
+        char *nk = RedisModule_Alloc(klen);
+        memcpy(nk, k, klen);
+        nk[0] = (char)((uint32_t)dbid >> 24);
+        nk[1] = (char)((uint32_t)dbid >> 16);
+        nk[2] = (char)((uint32_t)dbid >> 8);
+        nk[3] = (char)dbid;
+        RedisModule_DictReplaceC(remapped, nk, klen, NULL);
+        RedisModule_Free(nk);
+    }
+    RedisModule_DictIteratorStop(iter);
+    RedisModule_FreeDict(NULL, fsExpiringKeys);
+    fsExpiringKeys = remapped;
+
+    // The cursor names an entry that may have moved: start over.
+    if (fsExpireCursor) RedisModule_Free(fsExpireCursor);
+    fsExpireCursor = NULL;
+}
+
+/* ===================================================================
+ * FS.EXPIRE key path milliseconds
+ * FS.EXPIREAT key path unix_time_ms
+ *
+ * Set a path to be deleted, together with its subtree, once the given
+ * time has passed. Returns 1 if the expiry was set, 0 if the path does
+ * not exist. FS.EXPIRE is replicated as FS.EXPIREAT so that replicas and
+ * the AOF agree on the absolute deadline. Reclaiming happens in the
+ * background and may trail the deadline by a tick or more under load.
+ * =================================================================== */
+static int fsExpireGeneric(RedisModuleCtx *ctx, RedisModuleString **argv,
+                           int argc, int absolute) {
+    RedisModule_AutoMemory(ctx);
+    if (argc != 4) return RedisModule_WrongArity(ctx);
+    if (fsRoute(ctx, argv, argc, 2, 0)) return REDISMODULE_OK;
+
+    long long t;
+    if (RedisModule_StringToLongLong(argv[3], &t) != REDISMODULE_OK || t <= 0)
+        return RedisModule_ReplyWithError(ctx, "ERR invalid expire time — must be a positive integer");
+    int64_t when = t;
+    if (!absolute) {
+        int64_t now = fsNowMs();
+        if (t > INT64_MAX - now)
+            return RedisModule_ReplyWithError(ctx, "ERR invalid expire time — too large");
+        when = now + t;
+    }
+
+    RedisModuleKey *key = RedisModule_OpenKey(ctx, argv[1],
+        REDISMODULE_READ|REDISMODULE_WRITE);
+    if (RedisModule_KeyType(key) == REDISMODULE_KEYTYPE_EMPTY)
+        return RedisModule_ReplyWithLongLong(ctx, 0);
+    if (RedisModule_ModuleTypeGetType(key) != FSType)
+        return RedisModule_ReplyWithError(ctx, REDISMODULE_ERRORMSG_WRONGTYPE);
+    fsObject *fs = RedisModule_ModuleTypeGetValue(key);
+
+    size_t pathlen;
+    const char *rawpath = RedisModule_StringPtrLen(argv[2], &pathlen);
+    char *path = fsNormalizeOrReply(ctx, rawpath, pathlen);
+    if (!path) return REDISMODULE_OK;
+    size_t npathlen = strlen(path);
+
+    if (fsIsRoot(path, npathlen)) {
+        RedisModule_Free(path);
+        return RedisModule_ReplyWithError(ctx, "ERR cannot expire root directory — use EXPIRE on the key");
+    }
+
+    fsInode *inode = fsLookup(fs, path, npathlen);
+    if (!inode) {
+        RedisModule_Free(path);
+        return RedisModule_ReplyWithLongLong(ctx, 0);
+    }
+
+    fsSetExpire(fs, path, npathlen, inode, when);
+    fsInodeBump(fs, inode);
+    RedisModule_Free(path);
+    fsExpireTrackKey(ctx, argv[1]);
+
+    RedisModule_ReplyWithLongLong(ctx, 1);
+    if (absolute) {
+        RedisModule_ReplicateVerbatim(ctx);
+    } else {
+        RedisModule_Replicate(ctx, "FS.EXPIREAT", "ssl", argv[1], argv[2], (long long)when);
+    }
+    return REDISMODULE_OK;
+}
+
+static int EXPIRE_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+    return fsExpireGeneric(ctx, argv, argc, 0);
+}
+
+static int EXPIREAT_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+    return fsExpireGeneric(ctx, argv, argc, 1);
+}
+
+/* ===================================================================
+ * FS.TTL key path
+ *
+ * Returns the remaining time to live of a path in milliseconds, -1 if the
+ * path exists but has no expiry of its own, -2 if it (or the key) does
+ * not exist. Mirrors PTTL. Expiries set on ancestors are not reported.
+ * =================================================================== */
+static int TTL_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+    RedisModule_AutoMemory(ctx);
+    if (argc != 3) return RedisModule_WrongArity(ctx);
+    if (fsRoute(ctx, argv, argc, 2, 0)) return REDISMODULE_OK;
+
+    // Like PTTL, a missing key is -2 rather than an error.
+    RedisModuleKey *probe = RedisModule_OpenKey(ctx, argv[1], REDISMODULE_READ);
+    if (RedisModule_KeyType(probe) == REDISMODULE_KEYTYPE_EMPTY)
+        return RedisModule_ReplyWithLongLong(ctx, -2);
+
+    RedisModuleKey *key;
+    fsObject *fs = fsGetObject(ctx, argv[1], REDISMODULE_READ, &key);
+    if (!fs) return REDISMODULE_OK;
+
+    size_t pathlen;
+    const char *rawpath = RedisModule_StringPtrLen(argv[2], &pathlen);
+    char *path = fsNormalizeOrReply(ctx, rawpath, pathlen);
+    if (!path) return REDISMODULE_OK;
+
+    fsInode *inode = fsLookup(fs, path, strlen(path));
+    RedisModule_Free(path);
+    if (!inode) return RedisModule_ReplyWithLongLong(ctx, -2);
+    if (!inode->expire_at) return RedisModule_ReplyWithLongLong(ctx, -1);
+
+    int64_t ttl = inode->expire_at - fsNowMs();
+    return RedisModule_ReplyWithLongLong(ctx, ttl > 0 ? ttl : 0);
+}
+
+/* ===================================================================
+ * FS.PERSIST key path
+ *
+ * Remove the expiry of a path. Returns 1 if an expiry was removed,
+ * 0 if the path has none or does not exist.
+ * =================================================================== */
+static int PERSIST_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+    RedisModule_AutoMemory(ctx);
+    if (argc != 3) return RedisModule_WrongArity(ctx);
+    if (fsRoute(ctx, argv, argc, 2, 0)) return REDISMODULE_OK;
+
+    RedisModuleKey *key = RedisModule_OpenKey(ctx, argv[1],
+        REDISMODULE_READ|REDISMODULE_WRITE);
+    if (RedisModule_KeyType(key) == REDISMODULE_KEYTYPE_EMPTY)
+        return RedisModule_ReplyWithLongLong(ctx, 0);
+    if (RedisModule_ModuleTypeGetType(key) != FSType)
+        return RedisModule_ReplyWithError(ctx, REDISMODULE_ERRORMSG_WRONGTYPE);
+    fsObject *fs = RedisModule_ModuleTypeGetValue(key);
+
+    size_t pathlen;
+    const char *rawpath = RedisModule_StringPtrLen(argv[2], &pathlen);
+    char *path = fsNormalizeOrReply(ctx, rawpath, pathlen);
+    if (!path) return REDISMODULE_OK;
+    size_t npathlen = strlen(path);
+
+    fsInode *inode = fsLookup(fs, path, npathlen);
+    if (!inode || !inode->expire_at) {
+        RedisModule_Free(path);
+        return RedisModule_ReplyWithLongLong(ctx, 0);
+    }
+
+    fsSetExpire(fs, path, npathlen, inode, 0);
+    fsInodeBump(fs, inode);
+    RedisModule_Free(path);
+
+    RedisModule_ReplyWithLongLong(ctx, 1);
+    RedisModule_ReplicateVerbatim(ctx);
+    return REDISMODULE_OK;
+}
+
+/* ===================================================================
+ * FS.MOUNT key path target
+ *
+ * Hand the subtree at path to another filesystem key. path must be an
+ * empty directory or missing (it is then created with its parents); it
+ * stays behind as a stub so listings of the parent still show it. From
+ * now on commands on paths at or below it answer
+ * "FSMOVED <target> <path>" and the client retries against target with
+ * the path rebased. Mounts nest: mounting below an existing mount is
+ * forwarded to the key that owns that subtree.
+ * =================================================================== */
+static int MOUNT_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+    RedisModule_AutoMemory(ctx);
+    if (argc != 4) return RedisModule_WrongArity(ctx);
+    if (fsRoute(ctx, argv, argc, 2, 0)) return REDISMODULE_OK;
+
+    size_t targetlen, keylen;
+    const char *target = RedisModule_StringPtrLen(argv[3], &targetlen);
+    const char *keyname = RedisModule_StringPtrLen(argv[1], &keylen);
+    if (targetlen == 0)
+        return RedisModule_ReplyWithError(ctx, "ERR invalid mount target — empty key name");
+    for (size_t i = 0; i < targetlen; i++) {
+        if ((unsigned char)target[i] <= ' ' || target[i] == 0x7f)
+            return RedisModule_ReplyWithError(ctx, "ERR invalid mount target — key name contains whitespace or control characters");
+    }
+    if (targetlen == keylen && memcmp(target, keyname, keylen) == 0)
+        return RedisModule_ReplyWithError(ctx, "ERR invalid mount target — cannot mount a key onto itself");
+
+    RedisModuleKey *key;
+    fsObject *fs = fsGetObject(ctx, argv[1], REDISMODULE_READ|REDISMODULE_WRITE, &key);
+    if (!key) return REDISMODULE_OK;
+
+    size_t pathlen;
+    const char *rawpath = RedisModule_StringPtrLen(argv[2], &pathlen);
+    char *path = fsNormalizeOrReply(ctx, rawpath, pathlen);
+    if (!path) return REDISMODULE_OK;
+    size_t npathlen = strlen(path);
+
+    if (fsIsRoot(path, npathlen)) {
+        RedisModule_Free(path);
+        return RedisModule_ReplyWithError(ctx, "ERR cannot mount over the root directory");
+    }
+    if (fsMountsUnder(fs, path, npathlen)) {
+        RedisModule_Free(path);
+        return RedisModule_ReplyWithError(ctx, "ERR subtree contains a mount point — unmount it first");
+    }
+
+    fsInode *existing = fsLookup(fs, path, npathlen);
+    if (existing) {
+        if (existing->type != FS_INODE_DIR || existing->payload.dir.count != 0) {
+            RedisModule_Free(path);
+            return RedisModule_ReplyWithError(ctx, "ERR mount point must be an empty directory");
+        }
+    } else {
+        if (fsEnsureParents(fs, path, npathlen) != 0) {
+            RedisModule_Free(path);
+            return RedisModule_ReplyWithError(ctx, "ERR parent path conflict — a non-directory exists in the path");
+        }
+        existing = fsInodeCreate(FS_INODE_DIR, 0);
+        fsInsert(fs, path, npathlen, existing);
+
+        char *parent = fsParentPath(path, npathlen);
+        fsInode *pnode = fsLookup(fs, parent, strlen(parent));
+        if (pnode && pnode->type == FS_INODE_DIR) {
+            char *base = fsBaseName(path, npathlen);
+            fsDirAddChild(pnode, base, strlen(base), existing);
+            RedisModule_Free(base);
+            pnode->mtime = fsNowMs();
+            fsInodeBump(fs, pnode);
+        }
+        RedisModule_Free(parent);
+    }
+
+    if (!fs->mounts) fs->mounts = RedisModule_CreateDict(NULL);
+    char *t = RedisModule_Alloc(targetlen + 1);
+    memcpy(t, target, targetlen);
+    t[targetlen] = '\0';
+    RedisModule_DictSetC(fs->mounts, path, npathlen, t);
+    fsInodeBump(fs, existing);
+    RedisModule_Free(path);
+
+    RedisModule_ReplyWithSimpleString(ctx, "OK");
+    RedisModule_ReplicateVerbatim(ctx);
+    fsNotifyWriteArg(ctx, argv[1], argv[2]);
+    return REDISMODULE_OK;
+}
+
+/* ===================================================================
+ * FS.UMOUNT key path
+ *
+ * Remove the mount at path. The stub directory stays; the target key is
+ * left untouched. Returns 1 if a mount was removed, 0 if path is not a
+ * mount point. Paths inside a mounted subtree are redirected as usual,
+ * so nested mounts are removed from the key that owns them.
+ * =================================================================== */
+static int UMOUNT_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+    RedisModule_AutoMemory(ctx);
+    if (argc != 3) return RedisModule_WrongArity(ctx);
+
+    RedisModuleKey *key = RedisModule_OpenKey(ctx, argv[1],
+        REDISMODULE_READ|REDISMODULE_WRITE);
+    if (RedisModule_KeyType(key) == REDISMODULE_KEYTYPE_EMPTY)
+        return RedisModule_ReplyWithLongLong(ctx, 0);
+    if (RedisModule_ModuleTypeGetType(key) != FSType)
+        return RedisModule_ReplyWithError(ctx, REDISMODULE_ERRORMSG_WRONGTYPE);
+    fsObject *fs = RedisModule_ModuleTypeGetValue(key);
 
     size_t pathlen;
     const char *rawpath = RedisModule_StringPtrLen(argv[2], &pathlen);
@@ -3068,99 +6588,403 @@ static int TRUNCATE_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv,
     if (!path) return REDISMODULE_OK;
     size_t npathlen = strlen(path);
 
-    // Resolve symlinks.
-    int err;
-    char *resolved = fsResolvePath(fs, path, npathlen, &err);
+    char *t = NULL;
+    if (!fs->mounts || RedisModule_DictDelC(fs->mounts, path, npathlen, &t) != REDISMODULE_OK) {
+        RedisModule_Free(path);
+        if (fsRoute(ctx, argv, argc, 2, 0)) return REDISMODULE_OK;
+        return RedisModule_ReplyWithLongLong(ctx, 0);
+    }
+    RedisModule_Free(t);
+
+    fsInode *inode = fsLookup(fs, path, npathlen);
+    if (inode) fsInodeBump(fs, inode);
     RedisModule_Free(path);
-    if (err == FS_RESOLVE_ERR_SYMLINK_LOOP)
-        return RedisModule_ReplyWithError(ctx, "ERR too many levels of symbolic links");
-    if (err == FS_RESOLVE_ERR_PATH_DEPTH)
-        return RedisModule_ReplyWithError(ctx, "ERR path depth exceeds limit");
 
-    fsInode *inode = fsLookup(fs, resolved, strlen(resolved));
-    if (!inode) {
-        RedisModule_Free(resolved);
-        return RedisModule_ReplyWithError(ctx, "ERR no such file or directory");
+    RedisModule_ReplyWithLongLong(ctx, 1);
+    RedisModule_ReplicateVerbatim(ctx);
+    fsNotifyWriteArg(ctx, argv[1], argv[2]);
+    return REDISMODULE_OK;
+}
+
+/* ===================================================================
+ * FS.MOUNTS key
+ *
+ * List this key's mount table as [path, target] pairs in path order.
+ * Mounts held by the target keys themselves are not included.
+ * =================================================================== */
+static int MOUNTS_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+    RedisModule_AutoMemory(ctx);
+    if (argc != 2) return RedisModule_WrongArity(ctx);
+
+    RedisModuleKey *key;
+    fsObject *fs = fsGetObject(ctx, argv[1], REDISMODULE_READ, &key);
+    if (!key) return REDISMODULE_OK;
+    if (!fs || !fs->mounts) return RedisModule_ReplyWithArray(ctx, 0);
+
+    RedisModule_ReplyWithArray(ctx, RedisModule_DictSize(fs->mounts));
+    RedisModuleDictIter *iter = RedisModule_DictIteratorStartC(fs->mounts, "^", NULL, 0);
+    size_t klen;
+    char *t;
+    char *k;
+    while ((k = RedisModule_DictNextC(iter, &klen, (void**)&t)) != NULL) {
+        RedisModule_ReplyWithArray(ctx, 2);
+        RedisModule_ReplyWithStringBuffer(ctx, k, klen);
+        RedisModule_ReplyWithCString(ctx, t);
     }
-    if (inode->type != FS_INODE_FILE) {
-        RedisModule_Free(resolved);
-        return RedisModule_ReplyWithError(ctx, "ERR not a file");
+    RedisModule_DictIteratorStop(iter);
+    return REDISMODULE_OK;
+}
+
+/* ===================================================================
+ * Chunked uploads
+ *
+ * A file too large for one bulk string (or one round trip) is written as
+ * FS.OPEN, any number of FS.WRITECHUNK, then FS.COMMIT. The chunks build
+ * up in a detached inode that no path lookup can see, and FS.COMMIT links
+ * it in at once, so readers only ever see the old file or the new one.
+ * Each command is replicated verbatim: handles come from a per-key
+ * counter, so a replica applying the same FS.OPEN hands out the same
+ * handle. Idle uploads are discarded by the expiry timer on the master,
+ * which replicates an FS.ABORT for each.
+ * =================================================================== */
+
+/* Open key for an upload command without auto-creating it. Returns 0
+ * (reply sent) on a type error; *fs is NULL if the key does not exist. */
+static int fsUploadOpenKey(RedisModuleCtx *ctx, RedisModuleString *keyname,
+                           fsObject **fs, RedisModuleKey **key_out) {
+    RedisModuleKey *key = RedisModule_OpenKey(ctx, keyname,
+        REDISMODULE_READ|REDISMODULE_WRITE);
+    *key_out = key;
+    *fs = NULL;
+    if (RedisModule_KeyType(key) == REDISMODULE_KEYTYPE_EMPTY) return 1;
+    if (RedisModule_ModuleTypeGetType(key) != FSType) {
+        RedisModule_ReplyWithError(ctx, REDISMODULE_ERRORMSG_WRONGTYPE);
+        return 0;
     }
+    *fs = RedisModule_ModuleTypeGetValue(key);
+    return 1;
+}
 
-    long long length;
-    if (RedisModule_StringToLongLong(argv[3], &length) != REDISMODULE_OK || length < 0) {
-        RedisModule_Free(resolved);
-        return RedisModule_ReplyWithError(ctx, "ERR length must be a non-negative integer");
+/* Find the upload named by a handle argument, or reply with an error. */
+static fsUpload *fsUploadLookupOrReply(RedisModuleCtx *ctx, fsObject *fs,
+                                       RedisModuleString *arg, uint64_t *handle) {
+    long long h;
+    if (RedisModule_StringToLongLong(arg, &h) != REDISMODULE_OK || h <= 0) {
+        RedisModule_ReplyWithError(ctx, "ERR invalid upload handle");
+        return NULL;
+    }
+    fsUpload *up = fs ? fsUploadGet(fs, (uint64_t)h) : NULL;
+    if (!up) {
+        RedisModule_ReplyWithError(ctx, "ERR no such upload — it was committed, aborted or timed out");
+        return NULL;
     }
+    *handle = (uint64_t)h;
+    return up;
+}
 
-    size_t newlen = (size_t)length;
-    size_t oldlen = inode->payload.file.size;
+/* ===================================================================
+ * FS.OPEN key path [TIMEOUT ms]
+ *
+ * Start a chunked upload to path. Returns the upload handle. The upload
+ * is discarded if no chunk arrives for TIMEOUT ms (default 10 minutes).
+ * The path is only checked here; parents are created at FS.COMMIT.
+ * =================================================================== */
+static int OPEN_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+    RedisModule_AutoMemory(ctx);
+    if (argc != 3 && argc != 5) return RedisModule_WrongArity(ctx);
+    if (fsRoute(ctx, argv, argc, 2, 0)) return REDISMODULE_OK;
 
-    if (newlen == 0) {
-        // Truncate to zero.
-        fs->total_data_size -= oldlen;
-        if (inode->payload.file.data) RedisModule_Free(inode->payload.file.data);
-        inode->payload.file.data = NULL;
-        inode->payload.file.size = 0;
-        memset(inode->payload.file.bloom, 0, FS_BLOOM_BYTES);
-    } else if (newlen < oldlen) {
-        // Shrink.
-        fs->total_data_size -= (oldlen - newlen);
-        inode->payload.file.data = RedisModule_Realloc(inode->payload.file.data, newlen);
-        inode->payload.file.size = newlen;
-        fsBloomBuild(inode);
-    } else if (newlen > oldlen) {
-        // Zero-extend.
-        fs->total_data_size += (newlen - oldlen);
-        inode->payload.file.data = RedisModule_Realloc(inode->payload.file.data, newlen);
-        memset(inode->payload.file.data + oldlen, 0, newlen - oldlen);
-        inode->payload.file.size = newlen;
-        fsBloomBuild(inode);
+    long long timeout = FS_UPLOAD_TIMEOUT_MS;
+    if (argc == 5) {
+        const char *opt = RedisModule_StringPtrLen(argv[3], NULL);
+        if (strcasecmp(opt, "TIMEOUT"))
+            return RedisModule_ReplyWithError(ctx, "ERR syntax error — expected TIMEOUT <ms>");
+        if (RedisModule_StringToLongLong(argv[4], &timeout) != REDISMODULE_OK || timeout <= 0)
+            return RedisModule_ReplyWithError(ctx, "ERR invalid timeout — must be a positive integer");
+    }
+    int64_t now = fsNowMs();
+    if (timeout > INT64_MAX - now)
+        return RedisModule_ReplyWithError(ctx, "ERR invalid timeout — too large");
+
+    size_t pathlen;
+    const char *rawpath = RedisModule_StringPtrLen(argv[2], &pathlen);
+    char *path = fsNormalizeOrReply(ctx, rawpath, pathlen);
+    if (!path) return REDISMODULE_OK;
+    size_t npathlen = strlen(path);
+    if (fsIsRoot(path, npathlen)) {
+        RedisModule_Free(path);
+        return RedisModule_ReplyWithError(ctx, "ERR cannot write to root directory");
+    }
+
+    RedisModuleKey *key;
+    fsObject *fs = fsGetObject(ctx, argv[1], REDISMODULE_READ|REDISMODULE_WRITE, &key);
+    if (!key) {
+        RedisModule_Free(path);
+        return REDISMODULE_OK;
+    }
+
+    fsInode *existing = fsLookup(fs, path, npathlen);
+    if (existing && existing->type != FS_INODE_FILE) {
+        RedisModule_Free(path);
+        return RedisModule_ReplyWithError(ctx, "ERR path exists and is not a file");
+    }
+    if (fsUploadCount(fs) >= FS_UPLOAD_MAX) {
+        RedisModule_Free(path);
+        return RedisModule_ReplyWithError(ctx, "ERR too many open uploads — commit or abort some first");
+    }
+
+    fsUpload *up = RedisModule_Alloc(sizeof(*up));
+    up->path = path;
+    up->inode = fsInodeCreate(FS_INODE_FILE, 0);
+    up->capacity = 0;
+    up->timeout = timeout;
+    up->deadline = now + timeout;
+
+    uint64_t handle = ++fs->upload_clock;
+    char k[8];
+    fsUploadKey(handle, k);
+    if (!fs->uploads) fs->uploads = RedisModule_CreateDict(NULL);
+    RedisModule_DictSetC(fs->uploads, k, 8, up);
+    fsExpireTrackKey(ctx, argv[1]);
+
+    RedisModule_ReplyWithLongLong(ctx, (long long)handle);
+    RedisModule_ReplicateVerbatim(ctx);
+    return REDISMODULE_OK;
+}
+
+/* ===================================================================
+ * FS.WRITECHUNK key handle data [OFFSET n]
+ *
+ * Append a chunk to an open upload and return the bytes received so far.
+ * With OFFSET, the chunk is only accepted if the upload currently holds
+ * exactly n bytes, so a client that lost a reply can resume without
+ * writing a chunk twice.
+ * =================================================================== */
+static int WRITECHUNK_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+    RedisModule_AutoMemory(ctx);
+    if (argc != 4 && argc != 6) return RedisModule_WrongArity(ctx);
+
+    long long offset = -1;
+    if (argc == 6) {
+        const char *opt = RedisModule_StringPtrLen(argv[4], NULL);
+        if (strcasecmp(opt, "OFFSET"))
+            return RedisModule_ReplyWithError(ctx, "ERR syntax error — expected OFFSET <n>");
+        if (RedisModule_StringToLongLong(argv[5], &offset) != REDISMODULE_OK || offset < 0)
+            return RedisModule_ReplyWithError(ctx, "ERR OFFSET must be a non-negative integer");
+    }
+
+    RedisModuleKey *key;
+    fsObject *fs;
+    if (!fsUploadOpenKey(ctx, argv[1], &fs, &key)) return REDISMODULE_OK;
+    uint64_t handle;
+    fsUpload *up = fsUploadLookupOrReply(ctx, fs, argv[2], &handle);
+    if (!up) return REDISMODULE_OK;
+
+    fsInode *inode = up->inode;
+    size_t size = inode->payload.file.size;
+    if (offset >= 0 && (size_t)offset != size) {
+        RedisModuleString *msg = RedisModule_CreateStringPrintf(ctx,
+            "ERR offset mismatch — upload has %zu bytes", size);
+        return RedisModule_ReplyWithError(ctx, RedisModule_StringPtrLen(msg, NULL));
+    }
+
+    size_t len;
+    const char *data = RedisModule_StringPtrLen(argv[3], &len);
+    if (len > 0) {
+        if (size + len > up->capacity) {
+            // Grow by half again, so many small chunks stay amortized O(1)
+            // without doubling the footprint of a multi-GB file.
+            size_t newcap = up->capacity + up->capacity / 2;
+            if (newcap < size + len) newcap = size + len;
+            inode->payload.file.data = RedisModule_Realloc(inode->payload.file.data, newcap);
+            up->capacity = newcap;
+        }
+        memcpy(inode->payload.file.data + size, data, len);
+        inode->payload.file.size = size + len;
+        // Trigrams that straddle the previous chunk start up to 2 bytes back.
+        fsBloomAddRange(inode, size >= 2 ? size - 2 : 0, size + len);
+    }
+    up->deadline = fsNowMs() + up->timeout;
+
+    RedisModule_ReplyWithLongLong(ctx, (long long)inode->payload.file.size);
+    RedisModule_ReplicateVerbatim(ctx);
+    return REDISMODULE_OK;
+}
+
+/* ===================================================================
+ * FS.COMMIT key handle [IFVERSION v]
+ *
+ * Publish an upload: the file at its path is created, or its content
+ * replaced, in one step. Parent directories are created as needed.
+ * Metadata of an existing file is kept. If the commit fails (for example
+ * on a version mismatch) the upload stays open.
+ * =================================================================== */
+static int COMMIT_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+    RedisModule_AutoMemory(ctx);
+    long long ifversion;
+    if (fsParseIfVersion(ctx, argv, &argc, 3, &ifversion) != REDISMODULE_OK)
+        return REDISMODULE_OK;
+    if (argc != 3) return RedisModule_WrongArity(ctx);
+
+    RedisModuleKey *key;
+    fsObject *fs;
+    if (!fsUploadOpenKey(ctx, argv[1], &fs, &key)) return REDISMODULE_OK;
+    uint64_t handle;
+    fsUpload *up = fsUploadLookupOrReply(ctx, fs, argv[2], &handle);
+    if (!up) return REDISMODULE_OK;
+
+    const char *path = up->path;
+    size_t pathlen = strlen(path);
+    const char *target;
+    if (fsMountLookup(fs, path, pathlen, &target))
+        return RedisModule_ReplyWithError(ctx, "ERR cross-key operation — the path is now under a mount");
+
+    fsInode *existing = fsLookup(fs, path, pathlen);
+    if (!fsCheckVersion(ctx, existing, ifversion)) return REDISMODULE_OK;
+    if (existing && existing->type != FS_INODE_FILE)
+        return RedisModule_ReplyWithError(ctx, "ERR path exists and is not a file");
+    if (fsEnsureParents(fs, path, pathlen) != 0)
+        return RedisModule_ReplyWithError(ctx, "ERR parent path conflict — a non-directory exists in the path");
+
+    fsInode *inode = up->inode;
+    size_t size = inode->payload.file.size;
+    if (up->capacity > size && size > 0)
+        inode->payload.file.data = RedisModule_Realloc(inode->payload.file.data, size);
+
+    int64_t now = fsNowMs();
+    if (existing) {
+        fs->total_data_size -= existing->payload.file.size;
+        fsFileMoveData(existing, inode);
+        fs->total_data_size += size;
+        existing->mtime = now;
+        fsInodeBump(fs, existing);
+        fsCountAccess(fs, existing, FS_HOT_WRITES, path);
+    } else {
+        up->inode = NULL;
+        inode->ctime = inode->mtime = inode->atime = now;
+        fsInsert(fs, path, pathlen, inode);
+        fs->total_data_size += size;
+        fsCountAccess(fs, inode, FS_HOT_WRITES, path);
+
+        char *parent = fsParentPath(path, pathlen);
+        fsInode *pnode = fsLookup(fs, parent, strlen(parent));
+        if (pnode && pnode->type == FS_INODE_DIR) {
+            char *base = fsBaseName(path, pathlen);
+            fsDirAddChild(pnode, base, strlen(base), inode);
+            RedisModule_Free(base);
+            pnode->mtime = now;
+            fsInodeBump(fs, pnode);
+        }
+        RedisModule_Free(parent);
     }
-    // newlen == oldlen: no-op.
 
-    inode->mtime = fsNowMs();
-    RedisModule_Free(resolved);
     RedisModule_ReplyWithSimpleString(ctx, "OK");
+    fsReplicateWrite(ctx, argv, argc, ifversion);
+    fsNotifyWrite(ctx, argv[1], path, pathlen);
+    fsUploadDiscard(fs, handle);
+    return REDISMODULE_OK;
+}
+
+/* ===================================================================
+ * FS.ABORT key handle
+ *
+ * Discard an open upload. Returns 1 if it was discarded, 0 if there was
+ * no such upload.
+ * =================================================================== */
+static int ABORT_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+    RedisModule_AutoMemory(ctx);
+    if (argc != 3) return RedisModule_WrongArity(ctx);
+
+    long long handle;
+    if (RedisModule_StringToLongLong(argv[2], &handle) != REDISMODULE_OK || handle <= 0)
+        return RedisModule_ReplyWithError(ctx, "ERR invalid upload handle");
+
+    RedisModuleKey *key;
+    fsObject *fs;
+    if (!fsUploadOpenKey(ctx, argv[1], &fs, &key)) return REDISMODULE_OK;
+    if (!fs || !fsUploadDiscard(fs, (uint64_t)handle))
+        return RedisModule_ReplyWithLongLong(ctx, 0);
+
+    fsMaybeDeleteKey(key, fs);
+    RedisModule_ReplyWithLongLong(ctx, 1);
     RedisModule_ReplicateVerbatim(ctx);
     return REDISMODULE_OK;
 }
 
 /* ===================================================================
- * FS.UTIMENS key path atime_ms mtime_ms
+ * FS.READCHUNK key path offset length [WITHVERSION]
  *
- * Set access and modification times. Value of -1 means "don't change"
- * (matches POSIX UTIME_OMIT). Does NOT follow symlinks (matches
- * utimensat with AT_SYMLINK_NOFOLLOW).
+ * Read up to length bytes of a file starting at offset, for downloading
+ * files in pieces. Follows symlinks. Reading at or past the end returns
+ * an empty string; a missing file returns nil, like FS.CAT. WITHVERSION
+ * replies [data, version], so a client can tell if the file changed
+ * between chunks.
  * =================================================================== */
-static int UTIMENS_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+static int READCHUNK_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
     RedisModule_AutoMemory(ctx);
-    if (argc != 5) return RedisModule_WrongArity(ctx);
+    if (argc < 5 || argc > 6) return RedisModule_WrongArity(ctx);
+    if (fsRoute(ctx, argv, argc, 2, 0)) return REDISMODULE_OK;
+
+    int withversion = 0;
+    if (argc == 6) {
+        const char *opt = RedisModule_StringPtrLen(argv[5], NULL);
+        if (!strcasecmp(opt, "WITHVERSION")) {
+            withversion = 1;
+        } else {
+            return RedisModule_ReplyWithError(ctx, "ERR syntax error — expected WITHVERSION");
+        }
+    }
+
+    long long offset, length;
+    if (RedisModule_StringToLongLong(argv[3], &offset) != REDISMODULE_OK || offset < 0 ||
+        RedisModule_StringToLongLong(argv[4], &length) != REDISMODULE_OK || length < 0)
+        return RedisModule_ReplyWithError(ctx, "ERR offset and length must be non-negative integers");
 
     RedisModuleKey *key;
-    fsObject *fs = fsGetObject(ctx, argv[1], REDISMODULE_READ|REDISMODULE_WRITE, &key);
+    fsObject *fs = fsGetObject(ctx, argv[1], REDISMODULE_READ, &key);
     if (!key) return REDISMODULE_OK;
+    if (!fs) return RedisModule_ReplyWithError(ctx, "ERR no such filesystem key");
 
     size_t pathlen;
     const char *rawpath = RedisModule_StringPtrLen(argv[2], &pathlen);
     char *path = fsNormalizeOrReply(ctx, rawpath, pathlen);
     if (!path) return REDISMODULE_OK;
 
-    fsInode *inode = fsLookup(fs, path, strlen(path));
+    int err;
+    char *resolved = fsResolvePath(fs, path, strlen(path), &err);
     RedisModule_Free(path);
-    if (!inode) return RedisModule_ReplyWithError(ctx, "ERR no such file or directory");
+    if (err == FS_RESOLVE_ERR_SYMLINK_LOOP)
+        return RedisModule_ReplyWithError(ctx, "ERR too many levels of symbolic links");
+    if (err == FS_RESOLVE_ERR_PATH_DEPTH)
+        return RedisModule_ReplyWithError(ctx, "ERR path depth exceeds limit");
 
-    long long atime_ms, mtime_ms;
-    if (RedisModule_StringToLongLong(argv[3], &atime_ms) != REDISMODULE_OK)
-        return RedisModule_ReplyWithError(ctx, "ERR atime_ms must be an integer");
-    if (RedisModule_StringToLongLong(argv[4], &mtime_ms) != REDISMODULE_OK)
-        return RedisModule_ReplyWithError(ctx, "ERR mtime_ms must be an integer");
+    fsInode *inode = fsLookup(fs, resolved, strlen(resolved));
+    fsCountAccess(fs, inode, FS_HOT_READS, resolved);
+    RedisModule_Free(resolved);
+    if (!inode)
+        return RedisModule_ReplyWithNull(ctx);
+    if (inode->type != FS_INODE_FILE)
+        return RedisModule_ReplyWithError(ctx, "ERR not a file");
 
-    if (atime_ms != -1) inode->atime = atime_ms;
-    if (mtime_ms != -1) inode->mtime = mtime_ms;
+    inode->atime = fsNowMs();
+    size_t size = inode->payload.file.size;
+    size_t n = 0;
+    if ((unsigned long long)offset < size) {
+        n = size - (size_t)offset;
+        if ((unsigned long long)length < n) n = (size_t)length;
+    }
 
-    RedisModule_ReplyWithSimpleString(ctx, "OK");
-    RedisModule_ReplicateVerbatim(ctx);
+    if (withversion) RedisModule_ReplyWithArray(ctx, 2);
+    if (n == 0) {
+        RedisModule_ReplyWithStringBuffer(ctx, "", 0);
+    } else if (inode->payload.file.log) {
+        char *buf = RedisModule_PoolAlloc(ctx, n);
+        fsLogRead(inode->payload.file.log, (uint64_t)offset, n, buf);
+        RedisModule_ReplyWithStringBuffer(ctx, buf, n);
+    } else {
+        RedisModule_ReplyWithStringBuffer(ctx, inode->payload.file.data + offset, n);
+    }
+    if (withversion) RedisModule_ReplyWithLongLong(ctx, (long long)inode->version);
     return REDISMODULE_OK;
 }
 
@@ -3190,7 +7014,7 @@ int RedisModule_OnLoad(RedisModuleCtx *ctx, RedisModuleString **argv, int argc)
         .digest = FSDigest,
     };
 
-    FSType = RedisModule_CreateDataType(ctx, "redis-fs0", 0, &tm);
+    FSType = RedisModule_CreateDataType(ctx, "redis-fs0", FS_RDB_ENCVER, &tm);
     if (FSType == NULL) return REDISMODULE_ERR;
 
     // ---- Register commands (Unix names) ----
@@ -3223,6 +7047,10 @@ int RedisModule_OnLoad(RedisModuleCtx *ctx, RedisModuleString **argv, int argc)
         DELETELINES_RedisCommand, "write", 1, 1, 1) == REDISMODULE_ERR)
         return REDISMODULE_ERR;
 
+    if (RedisModule_CreateCommand(ctx, "FS.SPLICE",
+        SPLICE_RedisCommand, "write deny-oom", 1, 1, 1) == REDISMODULE_ERR)
+        return REDISMODULE_ERR;
+
     if (RedisModule_CreateCommand(ctx, "FS.HEAD",
         HEAD_RedisCommand, "readonly", 1, 1, 1) == REDISMODULE_ERR)
         return REDISMODULE_ERR;
@@ -3230,6 +7058,9 @@ int RedisModule_OnLoad(RedisModuleCtx *ctx, RedisModuleString **argv, int argc)
     if (RedisModule_CreateCommand(ctx, "FS.TAIL",
         TAIL_RedisCommand, "readonly", 1, 1, 1) == REDISMODULE_ERR)
         return REDISMODULE_ERR;
+    if (RedisModule_CreateCommand(ctx, "FS.WATCH",
+        WATCH_RedisCommand, "readonly", 1, 1, 1) == REDISMODULE_ERR)
+        return REDISMODULE_ERR;
 
     if (RedisModule_CreateCommand(ctx, "FS.WC",
         WC_RedisCommand, "readonly", 1, 1, 1) == REDISMODULE_ERR)
@@ -3239,6 +7070,10 @@ int RedisModule_OnLoad(RedisModuleCtx *ctx, RedisModuleString **argv, int argc)
         APPEND_RedisCommand, "write deny-oom", 1, 1, 1) == REDISMODULE_ERR)
         return REDISMODULE_ERR;
 
+    if (RedisModule_CreateCommand(ctx, "FS.LOG",
+        LOG_RedisCommand, "write deny-oom", 1, 1, 1) == REDISMODULE_ERR)
+        return REDISMODULE_ERR;
+
     if (RedisModule_CreateCommand(ctx, "FS.RM",
         RM_RedisCommand, "write", 1, 1, 1) == REDISMODULE_ERR)
         return REDISMODULE_ERR;
@@ -3307,5 +7142,78 @@ int RedisModule_OnLoad(RedisModuleCtx *ctx, RedisModuleString **argv, int argc)
         UTIMENS_RedisCommand, "write", 1, 1, 1) == REDISMODULE_ERR)
         return REDISMODULE_ERR;
 
+    if (RedisModule_CreateCommand(ctx, "FS.EXPIRE",
+        EXPIRE_RedisCommand, "write fast", 1, 1, 1) == REDISMODULE_ERR)
+        return REDISMODULE_ERR;
+
+    if (RedisModule_CreateCommand(ctx, "FS.EXPIREAT",
+        EXPIREAT_RedisCommand, "write fast", 1, 1, 1) == REDISMODULE_ERR)
+        return REDISMODULE_ERR;
+
+    if (RedisModule_CreateCommand(ctx, "FS.TTL",
+        TTL_RedisCommand, "readonly fast", 1, 1, 1) == REDISMODULE_ERR)
+        return REDISMODULE_ERR;
+
+    if (RedisModule_CreateCommand(ctx, "FS.PERSIST",
+        PERSIST_RedisCommand, "write fast", 1, 1, 1) == REDISMODULE_ERR)
+        return REDISMODULE_ERR;
+
+    if (RedisModule_CreateCommand(ctx, "FS.SEARCH",
+        SEARCH_RedisCommand, "readonly", 1, 1, 1) == REDISMODULE_ERR)
+        return REDISMODULE_ERR;
+
+    if (RedisModule_CreateCommand(ctx, "FS.HOT",
+        HOT_RedisCommand, "readonly", 1, 1, 1) == REDISMODULE_ERR)
+        return REDISMODULE_ERR;
+
+    if (RedisModule_CreateCommand(ctx, "FS.ANALYZE",
+        ANALYZE_RedisCommand, "readonly", 1, 1, 1) == REDISMODULE_ERR)
+        return REDISMODULE_ERR;
+
+    if (RedisModule_CreateCommand(ctx, "FS.OPEN",
+        OPEN_RedisCommand, "write deny-oom", 1, 1, 1) == REDISMODULE_ERR)
+        return REDISMODULE_ERR;
+
+    if (RedisModule_CreateCommand(ctx, "FS.WRITECHUNK",
+        WRITECHUNK_RedisCommand, "write deny-oom", 1, 1, 1) == REDISMODULE_ERR)
+        return REDISMODULE_ERR;
+
+    if (RedisModule_CreateCommand(ctx, "FS.COMMIT",
+        COMMIT_RedisCommand, "write deny-oom", 1, 1, 1) == REDISMODULE_ERR)
+        return REDISMODULE_ERR;
+
+    if (RedisModule_CreateCommand(ctx, "FS.ABORT",
+        ABORT_RedisCommand, "write", 1, 1, 1) == REDISMODULE_ERR)
+        return REDISMODULE_ERR;
+
+    if (RedisModule_CreateCommand(ctx, "FS.READCHUNK",
+        READCHUNK_RedisCommand, "readonly", 1, 1, 1) == REDISMODULE_ERR)
+        return REDISMODULE_ERR;
+
+    if (RedisModule_CreateCommand(ctx, "FS.MOUNT",
+        MOUNT_RedisCommand, "write deny-oom", 1, 1, 1) == REDISMODULE_ERR)
+        return REDISMODULE_ERR;
+
+    if (RedisModule_CreateCommand(ctx, "FS.UMOUNT",
+        UMOUNT_RedisCommand, "write fast", 1, 1, 1) == REDISMODULE_ERR)
+        return REDISMODULE_ERR;
+
+    if (RedisModule_CreateCommand(ctx, "FS.MOUNTS",
+        MOUNTS_RedisCommand, "readonly fast", 1, 1, 1) == REDISMODULE_ERR)
+        return REDISMODULE_ERR;
+
+    // ---- Path expiry ----
+
+    fsExpiringKeys = RedisModule_CreateDict(NULL);
+    if (RedisModule_SubscribeToKeyspaceEvents(ctx, REDISMODULE_NOTIFY_GENERIC,
+        fsKeyspaceNotify) == REDISMODULE_ERR)
+        return REDISMODULE_ERR;
+    if (RedisModule_SubscribeToServerEvent(ctx, RedisModuleEvent_SwapDB,
+        fsExpireDbEvent) == REDISMODULE_ERR ||
+        RedisModule_SubscribeToServerEvent(ctx, RedisModuleEvent_FlushDB,
+        fsExpireDbEvent) == REDISMODULE_ERR)
+        return REDISMODULE_ERR;
+    RedisModule_CreateTimer(ctx, FS_EXPIRE_TICK_MS, fsExpireCycle, NULL);
+
     return REDISMODULE_OK;
 }
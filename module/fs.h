@@ -35,29 +35,88 @@
 #define FS_MAX_SYMLINK_DEPTH 40
 #define FS_MAX_TREE_DEPTH  64
 
+/* Paths whose resolution went through a symlink are cached per key, up to
+ * this many; a full cache is emptied and starts over. */
+#define FS_RESOLVE_CACHE_MAX 16384
+
 /* Bloom filter for accelerating FS.GREP.
  * Each file inode carries a small bloom filter of content trigrams.
  * 256 bytes = 2048 bits, two hash functions per trigram. */
 #define FS_BLOOM_BYTES 256
 #define FS_BLOOM_BITS  (FS_BLOOM_BYTES * 8)
 
+/* Path expiry. A timer reclaims expired paths every FS_EXPIRE_TICK_MS,
+ * deleting at most FS_EXPIRE_BUDGET inodes per tick across all keys so
+ * that a huge expired subtree never blocks the server for long. */
+#define FS_EXPIRE_TICK_MS        100
+#define FS_EXPIRE_BUDGET         1000
+#define FS_EXPIRE_KEYS_PER_TICK  32
+
+/* Chunked uploads. An upload that receives no chunk for its timeout is
+ * discarded by the expiry timer. Each key holds at most
+ * FS_UPLOAD_MAX open uploads. */
+#define FS_UPLOAD_TIMEOUT_MS     600000
+#define FS_UPLOAD_MAX            1024
+
+/* Paged FIND, GREP and TREE (LIMIT/CURSOR). A page holds at most
+ * FS_PAGE_MAX_LIMIT entries, and also ends once FIND has examined
+ * FS_PAGE_SCAN_INODES inodes or GREP has scanned FS_PAGE_SCAN_BYTES of
+ * file content, so a rare pattern over a huge tree can't stall the
+ * server: the caller gets a short page and a cursor. */
+#define FS_PAGE_MAX_LIMIT    10000
+#define FS_PAGE_SCAN_INODES  100000
+#define FS_PAGE_SCAN_BYTES   (64 * 1024 * 1024)
+
+/* An unpaged FS.GREP over at least this much candidate content runs in a
+ * background thread, on a read view of the files (view.h). */
+#define FS_GREP_BACKGROUND_BYTES  (1024 * 1024)
+
+/* Edits are replicated as byte splices; beyond this many ranges they are
+ * coalesced into a single span so the replicated command stays small. */
+#define FS_SPLICE_MAX_RANGES 64
+
+/* One byte-range edit: at offset off (in the file's pre-edit coordinates),
+ * delete del bytes and insert len bytes from data. */
+typedef struct fsSplice {
+    size_t off;
+    size_t del;
+    const char *data;
+    size_t len;
+} fsSplice;
+
+/* A directory entry: a child's name and its inode, so walking a directory
+ * needs no path join or dict lookup per child. The inode is always the
+ * one the dict holds under the child's path; whatever links, unlinks or
+ * moves an inode updates the entry along with the dict. */
+typedef struct fsDirent {
+    char *name;
+    struct fsInode *inode;
+} fsDirent;
+
 /* A single inode in the filesystem. */
 typedef struct fsInode {
     uint8_t type;           /* FS_INODE_FILE, FS_INODE_DIR, FS_INODE_SYMLINK */
+    uint8_t hot;            /* Hot pools it is in, a bit per FS_HOT_* (see hot.h) */
     uint16_t mode;          /* POSIX permission bits (e.g., 0755) */
     uint32_t uid;           /* User ID */
     uint32_t gid;           /* Group ID */
+    uint32_t slot;          /* Row in the metadata columns, 0 = none */
+    uint8_t heat[2];        /* Logarithmic read and write counters (see hot.h) */
+    uint16_t heat_at[2];    /* Minute each counter was last decayed */
     int64_t ctime;          /* Creation time (milliseconds since epoch) */
     int64_t mtime;          /* Modification time */
     int64_t atime;          /* Access time */
+    uint64_t version;       /* Bumped on every change (see fsInodeBump) */
+    int64_t expire_at;      /* Unix ms when the path is reclaimed, 0 = never */
     union {
         struct {
             char *data;     /* File content (binary-safe) */
             size_t size;    /* Content length */
             uint8_t bloom[FS_BLOOM_BYTES]; /* Trigram bloom filter */
+            struct fsLog *log;  /* Segments of a log file (FS.LOG), else NULL */
         } file;
         struct {
-            char **children;    /* Array of child basenames (not full paths) */
+            fsDirent *children; /* Child entries, in the order added */
             size_t count;       /* Number of children */
             size_t capacity;    /* Allocated capacity */
         } dir;
@@ -67,6 +126,17 @@ typedef struct fsInode {
     } payload;
 } fsInode;
 
+/* An open chunked upload (FS.OPEN .. FS.COMMIT). The bytes accumulate in
+ * a detached file inode, bloom filter included, so committing only has to
+ * link it in. Until then it is invisible to every path lookup. */
+typedef struct fsUpload {
+    char *path;             /* Normalized destination path */
+    fsInode *inode;         /* Detached file inode holding the bytes so far */
+    size_t capacity;        /* Allocated size of inode->payload.file.data */
+    int64_t timeout;        /* Idle timeout in ms */
+    int64_t deadline;       /* Unix ms after which the upload is discarded */
+} fsUpload;
+
 /* The filesystem object — one per Redis key. */
 typedef struct fsObject {
     RedisModuleDict *inodes;    /* path (C string) → fsInode* */
@@ -74,6 +144,17 @@ typedef struct fsObject {
     uint64_t dir_count;         /* Number of directories */
     uint64_t symlink_count;     /* Number of symlinks */
     uint64_t total_data_size;   /* Total bytes of file content */
+    uint64_t version_clock;     /* Last inode version handed out */
+    RedisModuleDict *expires;   /* be64(expire_at)+path → NULL, lazily created */
+    RedisModuleDict *mounts;    /* mount point path → target key (char*), lazily created */
+    struct fsIndex *index;      /* Word index for FS.SEARCH, created by the first search */
+    RedisModuleDict *uploads;   /* be64(handle) → fsUpload*, lazily created */
+    uint64_t upload_clock;      /* Last upload handle handed out */
+    struct fsJournal *journal;  /* Recent changes for FS.WATCH, created by the first watch */
+    struct fsColumns *columns;  /* Metadata columns for predicate FS.FIND, created by the first one */
+    RedisModuleDict *resolved;  /* path → fsResolved*, lazily created */
+    uint64_t symlink_gen;       /* Bumped when a symlink is created, removed or moved */
+    struct fsHot *hot;          /* Hot-file pools for FS.HOT, created by the first access */
 } fsObject;
 
 /* Module type handle (set during OnLoad). */
@@ -97,8 +178,9 @@ void fsObjectFree(fsObject *fs);
 
 /* ---- Inode helpers ---- */
 
-/* Add a child name to a directory inode. */
-void fsDirAddChild(fsInode *dir, const char *name, size_t namelen);
+/* Add a child to a directory inode, or point an existing entry of that
+ * name at child. */
+void fsDirAddChild(fsInode *dir, const char *name, size_t namelen, fsInode *child);
 
 /* Remove a child name from a directory inode. Returns 1 if found, 0 otherwise. */
 int fsDirRemoveChild(fsInode *dir, const char *name, size_t namelen);
@@ -106,28 +188,59 @@ int fsDirRemoveChild(fsInode *dir, const char *name, size_t namelen);
 /* Check if a directory contains a child with the given name. */
 int fsDirHasChild(fsInode *dir, const char *name, size_t namelen);
 
-/* Set file data (copies the data). */
+/* Set file data (copies the data). A log file stays a log. */
 void fsFileSetData(fsInode *inode, const char *data, size_t len);
 
-/* Append data to a file inode. */
+/* Append data to a file inode. Log retention is left to the caller. */
 void fsFileAppendData(fsInode *inode, const char *data, size_t len);
 
+/* Move the content and bloom filter of file inode src into dst, leaving
+ * src empty. Neither inode's metadata changes. A log dst stays a log,
+ * with src's content as its only segment. */
+void fsFileMoveData(fsInode *dst, fsInode *src);
+
+/* Apply n ascending, non-overlapping splices to a file inode, in place
+ * where possible. The bloom filter is extended around the edited ranges
+ * rather than rebuilt. */
+void fsFileSplice(fsInode *inode, const fsSplice *sp, size_t n);
+
+/* A file's content as one buffer. Plain files return their data; log
+ * files are copied into a new buffer that is also stored in *tofree, for
+ * the caller to free. */
+const char *fsFileBytes(const fsInode *inode, char **tofree);
+
 /* ---- Bloom filter helpers ---- */
 
+/* Add the trigrams starting in data bytes [start, end) to a bloom. */
+void fsBloomAddBytes(uint8_t *bloom, const char *data, size_t size,
+                     size_t start, size_t end);
+
+/* Check a glob pattern's literal trigrams against one bloom. */
+int fsBloomMayContain(const uint8_t *bloom, const char *pattern);
+
 /* Rebuild a file inode's bloom filter from its content. */
 void fsBloomBuild(fsInode *inode);
 
+/* Add the trigrams starting in content bytes [start, end) to the bloom. */
+void fsBloomAddRange(fsInode *inode, size_t start, size_t end);
+
 /* Check if a glob pattern's literal substring might match this file's content.
  * Returns 1 if the bloom filter says "maybe", 0 if "definitely not". */
 int fsBloomMayMatch(const fsInode *inode, const char *pattern);
 
+/* ---- Versioning ---- */
+
+/* Stamp an inode with the next version from its filesystem's clock. */
+void fsInodeBump(fsObject *fs, fsInode *inode);
+
 /* ---- Lookup helpers ---- */
 
 /* Look up an inode by path. Returns NULL if not found. */
 fsInode *fsLookup(fsObject *fs, const char *path, size_t pathlen);
 
-/* Resolve symlinks (up to FS_MAX_SYMLINK_DEPTH). Returns the resolved path
- * as a newly allocated string, or NULL on error (sets *err). */
+/* Resolve symlinks in every component of path (up to FS_MAX_SYMLINK_DEPTH
+ * hops in all). Returns the resolved path as a newly allocated string, or
+ * NULL on error (sets *err). */
 char *fsResolvePath(fsObject *fs, const char *path, size_t pathlen, int *err);
 
 /* ---- Time helper ---- */
@@ -139,6 +252,10 @@ static inline int64_t fsNowMs(void) {
 }
 
 /* ---- RDB persistence ---- */
+
+/* Current RDB encoding version. Older encodings remain loadable. */
+#define FS_RDB_ENCVER 6
+
 void FSRdbSave(RedisModuleIO *rdb, void *value);
 void *FSRdbLoad(RedisModuleIO *rdb, int encver);
 void FSFree(void *value);
@@ -0,0 +1,238 @@
+/*
+ * hot.c - Access counters and the hot-file pools behind FS.HOT.
+ *
+ * A pool is a small unordered array. Members are marked in fsInode.hot,
+ * so offering a file that is already in is O(1), and a newcomer is
+ * compared against the coolest member, which is found by a scan only
+ * when the pool has changed or a minute has gone by (decay can reorder
+ * members only at minute boundaries).
+ */
+
+#include "hot.h"
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct fsHotSlot {
+    fsInode *inode;
+    char *path;
+    size_t pathlen;
+} fsHotSlot;
+
+typedef struct fsHotPool {
+    fsHotSlot *slots;
+    size_t count;
+    size_t capacity;
+    size_t min;             /* Slot of the coolest member... */
+    uint8_t minval;         /* ...and its counter... */
+    uint16_t minat;         /* ...as of this minute */
+    int minstale;           /* Members changed since min was found */
+} fsHotPool;
+
+struct fsHot {
+    fsHotPool pools[2];     /* Indexed by FS_HOT_READS / FS_HOT_WRITES */
+    size_t pathbytes;
+};
+
+/* ===================================================================
+ * Counters
+ * =================================================================== */
+
+static uint16_t fsHotMinutes(void) {
+    return (uint16_t)(fsNowMs() / 60000);
+}
+
+/* Minutes since stamp, allowing for one wrap of the 16-bit clock. */
+static unsigned fsHotElapsed(uint16_t now, uint16_t stamp) {
+    return (uint16_t)(now - stamp);
+}
+
+static uint8_t fsHotDecayed(const fsInode *inode, int which, uint16_t now) {
+    unsigned periods = fsHotElapsed(now, inode->heat_at[which]) / FS_HOT_DECAY_MINUTES;
+    uint8_t c = inode->heat[which];
+    return periods >= c ? 0 : (uint8_t)(c - periods);
+}
+
+/* xorshift64*: all the counters need is a cheap coin. */
+static double fsHotRandom(void) {
+    static uint64_t s = 0x9E3779B97F4A7C15ULL;
+    s ^= s >> 12;
+    s ^= s << 25;
+    s ^= s >> 27;
+    return (double)((s * 0x2545F4914F6CDD1DULL) >> 11) / (double)(1ULL << 53);
+}
+
+int fsHotCount(fsInode *inode, int which) {
+    uint16_t now = fsHotMinutes();
+    uint8_t c = fsHotDecayed(inode, which, now);
+    int up = 0;
+    if (c < 255 && fsHotRandom() < 1.0 / ((double)c * FS_HOT_LOG_FACTOR + 1)) {
+        c++;
+        up = 1;
+    }
+    inode->heat[which] = c;
+    inode->heat_at[which] = now;
+    return up;
+}
+
+uint8_t fsHotValue(const fsInode *inode, int which) {
+    return fsHotDecayed(inode, which, fsHotMinutes());
+}
+
+/* ===================================================================
+ * Pools
+ * =================================================================== */
+
+fsHot *fsHotCreate(void) {
+    fsHot *hot = RedisModule_Alloc(sizeof(*hot));
+    memset(hot, 0, sizeof(*hot));
+    return hot;
+}
+
+void fsHotFree(fsHot *hot) {
+    if (!hot) return;
+    for (int w = 0; w < 2; w++) {
+        fsHotPool *pool = &hot->pools[w];
+        for (size_t i = 0; i < pool->count; i++) RedisModule_Free(pool->slots[i].path);
+        if (pool->slots) RedisModule_Free(pool->slots);
+    }
+    RedisModule_Free(hot);
+}
+
+static void fsHotSetPath(fsHot *hot, fsHotSlot *slot, const char *path, size_t pathlen) {
+    if (slot->path) hot->pathbytes -= slot->pathlen + 1;
+    slot->path = RedisModule_Realloc(slot->path, pathlen + 1);
+    memcpy(slot->path, path, pathlen);
+    slot->path[pathlen] = '\0';
+    slot->pathlen = pathlen;
+    hot->pathbytes += pathlen + 1;
+}
+
+static fsHotSlot *fsHotFind(fsHotPool *pool, const fsInode *inode) {
+    for (size_t i = 0; i < pool->count; i++)
+        if (pool->slots[i].inode == inode) return &pool->slots[i];
+    return NULL;
+}
+
+static void fsHotFindMin(fsHotPool *pool, int which, uint16_t now) {
+    pool->min = 0;
+    pool->minval = 255;
+    for (size_t i = 0; i < pool->count; i++) {
+        uint8_t v = fsHotDecayed(pool->slots[i].inode, which, now);
+        if (v < pool->minval || i == 0) {
+            pool->min = i;
+            pool->minval = v;
+        }
+    }
+    pool->minat = now;
+    pool->minstale = 0;
+}
+
+void fsHotOffer(fsHot *hot, int which, fsInode *inode, const char *path, size_t pathlen) {
+    fsHotPool *pool = &hot->pools[which];
+    uint8_t bit = (uint8_t)(1 << which);
+    if (inode->hot & bit) {
+        // It got hotter; if it was the coolest, it may not be any more.
+        if (pool->slots[pool->min].inode == inode) pool->minstale = 1;
+        return;
+    }
+
+    fsHotSlot *slot;
+    if (pool->count < FS_HOT_POOL) {
+        if (pool->count == pool->capacity) {
+            pool->capacity = pool->capacity ? pool->capacity * 2 : 16;
+            pool->slots = RedisModule_Realloc(pool->slots, sizeof(fsHotSlot) * pool->capacity);
+        }
+        slot = &pool->slots[pool->count++];
+        slot->path = NULL;
+    } else {
+        uint16_t now = fsHotMinutes();
+        if (pool->minstale || pool->minat != now) fsHotFindMin(pool, which, now);
+        if (fsHotDecayed(inode, which, now) <= pool->minval) return;
+        slot = &pool->slots[pool->min];
+        slot->inode->hot &= (uint8_t)~bit;
+    }
+    slot->inode = inode;
+    fsHotSetPath(hot, slot, path, pathlen);
+    inode->hot |= bit;
+    pool->minstale = 1;
+}
+
+void fsHotRemove(fsHot *hot, fsInode *inode) {
+    for (int w = 0; w < 2; w++) {
+        if (!(inode->hot & (1 << w))) continue;
+        fsHotPool *pool = &hot->pools[w];
+        fsHotSlot *slot = fsHotFind(pool, inode);
+        if (!slot) continue;
+        hot->pathbytes -= slot->pathlen + 1;
+        RedisModule_Free(slot->path);
+        *slot = pool->slots[--pool->count];
+        pool->minstale = 1;
+    }
+    inode->hot = 0;
+}
+
+void fsHotRename(fsHot *hot, fsInode *inode, const char *path, size_t pathlen) {
+    for (int w = 0; w < 2; w++) {
+        if (!(inode->hot & (1 << w))) continue;
+        fsHotSlot *slot = fsHotFind(&hot->pools[w], inode);
+        if (slot) fsHotSetPath(hot, slot, path, pathlen);
+    }
+}
+
+/* ===================================================================
+ * Queries
+ * =================================================================== */
+
+typedef struct fsHotRanked {
+    fsHotEntry e;
+    unsigned score;
+} fsHotRanked;
+
+static int fsHotCompare(const void *a, const void *b) {
+    const fsHotRanked *x = a, *y = b;
+    if (x->score != y->score) return x->score < y->score ? 1 : -1;
+    return strcmp(x->e.path, y->e.path);
+}
+
+size_t fsHotTop(fsHot *hot, int which, const char *prefix, size_t prefixlen,
+                fsHotEntry *out, size_t limit) {
+    if (!hot) return 0;
+    fsHotRanked *ranked = RedisModule_Alloc(sizeof(*ranked) * 2 * FS_HOT_POOL);
+    size_t n = 0;
+    uint16_t now = fsHotMinutes();
+    for (int w = 0; w < 2; w++) {
+        if (which >= 0 && w != which) continue;
+        const fsHotPool *pool = &hot->pools[w];
+        for (size_t i = 0; i < pool->count; i++) {
+            const fsHotSlot *slot = &pool->slots[i];
+            // Ranking by both: a file in both pools is listed once.
+            if (which < 0 && w == FS_HOT_WRITES &&
+                (slot->inode->hot & (1 << FS_HOT_READS))) continue;
+            if (prefixlen > 1) {
+                if (strncmp(slot->path, prefix, prefixlen) != 0) continue;
+                if (slot->path[prefixlen] != '\0' && slot->path[prefixlen] != '/') continue;
+            }
+            fsHotRanked *r = &ranked[n];
+            r->e.path = slot->path;
+            r->e.pathlen = slot->pathlen;
+            r->e.inode = slot->inode;
+            r->e.reads = fsHotDecayed(slot->inode, FS_HOT_READS, now);
+            r->e.writes = fsHotDecayed(slot->inode, FS_HOT_WRITES, now);
+            r->score = which == FS_HOT_READS ? r->e.reads :
+                       which == FS_HOT_WRITES ? r->e.writes :
+                       (unsigned)r->e.reads + r->e.writes;
+            if (r->score) n++;
+        }
+    }
+    if (n > 1) qsort(ranked, n, sizeof(*ranked), fsHotCompare);
+    if (n > limit) n = limit;
+    for (size_t i = 0; i < n; i++) out[i] = ranked[i].e;
+    RedisModule_Free(ranked);
+    return n;
+}
+
+size_t fsHotMemUsage(const fsHot *hot) {
+    if (!hot) return 0;
+    return sizeof(*hot) + hot->pathbytes +
+           (hot->pools[0].capacity + hot->pools[1].capacity) * sizeof(fsHotSlot);
+}
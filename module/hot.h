@@ -0,0 +1,77 @@
+/*
+ * hot.h - Access counters and the hot-file pools behind FS.HOT.
+ *
+ * Every inode carries two 8-bit logarithmic counters, one for reads and
+ * one for writes, in the style of Redis's LFU: an access bumps a counter
+ * with probability 1 / (counter * FS_HOT_LOG_FACTOR + 1), so a thousand
+ * accesses read as about 16 and a hundred thousand as about 150, up to
+ * 255. A counter loses one for every FS_HOT_DECAY_MINUTES that pass
+ * without an access. Each counter records the minute it was last decayed
+ * in 16 bits, which wraps after 45 days.
+ *
+ * Finding the hottest files must not mean scanning every inode, so each
+ * key keeps a pool per counter of at most FS_HOT_POOL candidates with
+ * their paths. A file is offered to a pool only when its counter goes up
+ * — rarely, once it is warm — and takes the place of the coolest member
+ * if it is hotter. The pools are an approximation: a file that cooled
+ * down lingers until something hotter comes along, and within a small
+ * subtree the hottest files may have lost their place to hotter ones
+ * elsewhere. Counters and pools are not persisted; they start cold after
+ * a restart.
+ */
+
+#ifndef REDIS_FS_HOT_H
+#define REDIS_FS_HOT_H
+
+#include "fs.h"
+
+#define FS_HOT_READS          0
+#define FS_HOT_WRITES         1
+
+#define FS_HOT_LOG_FACTOR     10
+#define FS_HOT_DECAY_MINUTES  1
+#define FS_HOT_POOL           256     /* Candidates kept per counter */
+#define FS_HOT_DEFAULT_LIMIT  10
+
+typedef struct fsHot fsHot;
+
+typedef struct fsHotEntry {
+    const char *path;       /* Owned by the pools; valid until next change */
+    size_t pathlen;
+    fsInode *inode;
+    uint8_t reads, writes;  /* Counters as of now, decayed */
+} fsHotEntry;
+
+/* ---- Counters ---- */
+
+/* Count one access of kind which (FS_HOT_READS or FS_HOT_WRITES). Returns
+ * 1 if the counter went up, which is when the inode should be offered to
+ * its pool. */
+int fsHotCount(fsInode *inode, int which);
+
+/* A counter's value now, with the decay it has not yet been charged. */
+uint8_t fsHotValue(const fsInode *inode, int which);
+
+/* ---- Pools ---- */
+
+fsHot *fsHotCreate(void);
+void fsHotFree(fsHot *hot);
+
+/* Offer inode, at path, to the pool for which. */
+void fsHotOffer(fsHot *hot, int which, fsInode *inode, const char *path, size_t pathlen);
+
+/* An inode left the filesystem. */
+void fsHotRemove(fsHot *hot, fsInode *inode);
+
+/* An inode moved to a new path. */
+void fsHotRename(fsHot *hot, fsInode *inode, const char *path, size_t pathlen);
+
+/* The up to limit hottest pool members at or below prefix, hottest first,
+ * into out. which is FS_HOT_READS or FS_HOT_WRITES to rank by one
+ * counter, or -1 to rank by both together. */
+size_t fsHotTop(fsHot *hot, int which, const char *prefix, size_t prefixlen,
+                fsHotEntry *out, size_t limit);
+
+size_t fsHotMemUsage(const fsHot *hot);
+
+#endif /* REDIS_FS_HOT_H */
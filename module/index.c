@@ -0,0 +1,452 @@
+/*
+ * index.c - Inverted word index for FS.SEARCH.
+ *
+ * Layout: a rax of terms, each holding a posting array of (doc, slot), and
+ * a rax of docs keyed by inode pointer, each holding its (term, tf, pos)
+ * list. The two point at each other — posting.slot indexes the doc's term
+ * list and docterm.pos indexes the term's postings — so a doc is removed
+ * from every posting list in O(terms in doc) by swap-remove, without
+ * scanning long posting lists of common words.
+ */
+
+#include "index.h"
+#include "path.h"
+#include <string.h>
+#include <math.h>
+
+typedef struct fsIndexDoc fsIndexDoc;
+
+typedef struct fsPosting {
+    fsIndexDoc *doc;
+    uint32_t slot;          /* Index into doc->terms */
+} fsPosting;
+
+typedef struct fsIndexTerm {
+    fsPosting *postings;
+    uint32_t count;         /* Document frequency */
+    uint32_t cap;
+    uint16_t len;
+    char word[];
+} fsIndexTerm;
+
+typedef struct fsDocTerm {
+    fsIndexTerm *term;
+    uint32_t tf;
+    uint32_t pos;           /* Index into term->postings */
+} fsDocTerm;
+
+struct fsIndexDoc {
+    fsInode *inode;
+    char *path;
+    fsDocTerm *terms;
+    uint32_t nterms;
+    uint32_t len;           /* Words in the document */
+    long stale;             /* Index into idx->stale, or -1 */
+    uint64_t epoch;         /* Search that last scored this doc */
+    double score;
+};
+
+struct fsIndex {
+    RedisModuleDict *terms;     /* word → fsIndexTerm* */
+    RedisModuleDict *docs;      /* fsInode* bytes → fsIndexDoc* */
+    fsIndexDoc **stale;         /* Docs to re-tokenize */
+    size_t nstale, stalecap;
+    uint64_t ndocs;
+    uint64_t total_len;         /* Sum of document lengths */
+    uint64_t epoch;
+    size_t mem;
+};
+
+/* ===================================================================
+ * Tokenizer
+ * =================================================================== */
+
+static inline int fsIsWordByte(unsigned char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+           (c >= '0' && c <= '9') || c == '_' || c >= 0x80;
+}
+
+/* Copy the next word at or after *pos into buf, lower-cased. Returns its
+ * length, or 0 at the end of s. Overlong runs are skipped. */
+static size_t fsNextWord(const char *s, size_t len, size_t *pos, char *buf) {
+    size_t i = *pos;
+    while (i < len) {
+        while (i < len && !fsIsWordByte((unsigned char)s[i])) i++;
+        size_t start = i;
+        while (i < len && fsIsWordByte((unsigned char)s[i])) i++;
+        size_t wlen = i - start;
+        if (wlen == 0 || wlen > FS_INDEX_MAX_TERM) continue;
+        for (size_t j = 0; j < wlen; j++) {
+            unsigned char c = (unsigned char)s[start + j];
+            buf[j] = (c >= 'A' && c <= 'Z') ? (char)(c + 32) : (char)c;
+        }
+        *pos = i;
+        return wlen;
+    }
+    *pos = len;
+    return 0;
+}
+
+typedef struct fsQuery {
+    char words[FS_INDEX_MAX_QUERY][FS_INDEX_MAX_TERM];
+    size_t lens[FS_INDEX_MAX_QUERY];
+    size_t n;
+} fsQuery;
+
+static int fsQueryHas(const fsQuery *q, const char *w, size_t wlen) {
+    for (size_t i = 0; i < q->n; i++)
+        if (q->lens[i] == wlen && memcmp(q->words[i], w, wlen) == 0) return 1;
+    return 0;
+}
+
+static void fsQueryParse(fsQuery *q, const char *s, size_t len) {
+    char buf[FS_INDEX_MAX_TERM];
+    size_t pos = 0, wlen;
+    q->n = 0;
+    while (q->n < FS_INDEX_MAX_QUERY && (wlen = fsNextWord(s, len, &pos, buf))) {
+        if (fsQueryHas(q, buf, wlen)) continue;
+        memcpy(q->words[q->n], buf, wlen);
+        q->lens[q->n++] = wlen;
+    }
+}
+
+/* ===================================================================
+ * Lifecycle
+ * =================================================================== */
+
+fsIndex *fsIndexCreate(void) {
+    fsIndex *idx = RedisModule_Calloc(1, sizeof(*idx));
+    idx->terms = RedisModule_CreateDict(NULL);
+    idx->docs = RedisModule_CreateDict(NULL);
+    idx->mem = sizeof(*idx);
+    return idx;
+}
+
+void fsIndexFree(fsIndex *idx) {
+    if (!idx) return;
+    RedisModuleDictIter *iter = RedisModule_DictIteratorStartC(idx->terms, "^", NULL, 0);
+    fsIndexTerm *t;
+    while (RedisModule_DictNextC(iter, NULL, (void**)&t)) {
+        RedisModule_Free(t->postings);
+        RedisModule_Free(t);
+    }
+    RedisModule_DictIteratorStop(iter);
+    RedisModule_FreeDict(NULL, idx->terms);
+
+    iter = RedisModule_DictIteratorStartC(idx->docs, "^", NULL, 0);
+    fsIndexDoc *d;
+    while (RedisModule_DictNextC(iter, NULL, (void**)&d)) {
+        RedisModule_Free(d->terms);
+        RedisModule_Free(d->path);
+        RedisModule_Free(d);
+    }
+    RedisModule_DictIteratorStop(iter);
+    RedisModule_FreeDict(NULL, idx->docs);
+    RedisModule_Free(idx->stale);
+    RedisModule_Free(idx);
+}
+
+/* ===================================================================
+ * Maintenance
+ * =================================================================== */
+
+static fsIndexDoc *fsIndexGetDoc(fsIndex *idx, fsInode *inode) {
+    return RedisModule_DictGetC(idx->docs, &inode, sizeof(inode), NULL);
+}
+
+static void fsIndexMarkStale(fsIndex *idx, fsIndexDoc *d) {
+    if (d->stale >= 0) return;
+    if (idx->nstale == idx->stalecap) {
+        size_t oldcap = idx->stalecap;
+        idx->stalecap = oldcap ? oldcap * 2 : 16;
+        idx->stale = RedisModule_Realloc(idx->stale, idx->stalecap * sizeof(*idx->stale));
+        idx->mem += (idx->stalecap - oldcap) * sizeof(*idx->stale);
+    }
+    d->stale = (long)idx->nstale;
+    idx->stale[idx->nstale++] = d;
+}
+
+static void fsIndexUnmarkStale(fsIndex *idx, fsIndexDoc *d) {
+    if (d->stale < 0) return;
+    fsIndexDoc *last = idx->stale[--idx->nstale];
+    idx->stale[d->stale] = last;
+    last->stale = d->stale;
+    d->stale = -1;
+}
+
+/* Drop all of a doc's postings. */
+static void fsIndexUnindex(fsIndex *idx, fsIndexDoc *d) {
+    for (uint32_t i = 0; i < d->nterms; i++) {
+        fsIndexTerm *t = d->terms[i].term;
+        uint32_t pos = d->terms[i].pos;
+        fsPosting last = t->postings[--t->count];
+        if (pos != t->count) {
+            t->postings[pos] = last;
+            last.doc->terms[last.slot].pos = pos;
+        }
+        if (t->count == 0) {
+            RedisModule_DictDelC(idx->terms, t->word, t->len, NULL);
+            idx->mem -= sizeof(*t) + t->len + t->cap * sizeof(fsPosting);
+            RedisModule_Free(t->postings);
+            RedisModule_Free(t);
+        }
+    }
+    idx->mem -= d->nterms * sizeof(fsDocTerm);
+    RedisModule_Free(d->terms);
+    d->terms = NULL;
+    d->nterms = 0;
+    idx->total_len -= d->len;
+    d->len = 0;
+}
+
+/* Tokenize a doc's content and add its postings. */
+static void fsIndexTokenize(fsIndex *idx, fsIndexDoc *d) {
+    char *copy;
+    const char *data = fsFileBytes(d->inode, &copy);
+    size_t size = d->inode->payload.file.size;
+    if (size == 0 || memchr(data, '\0', size)) { // Empty or binary.
+        if (copy) RedisModule_Free(copy);
+        return;
+    }
+
+    // Count term frequencies in a scratch dict; tf is stored in the pointer.
+    RedisModuleDict *tfs = RedisModule_CreateDict(NULL);
+    char buf[FS_INDEX_MAX_TERM];
+    size_t pos = 0, wlen;
+    uint32_t len = 0;
+    while ((wlen = fsNextWord(data, size, &pos, buf))) {
+        int nokey;
+        uintptr_t tf = (uintptr_t)RedisModule_DictGetC(tfs, buf, wlen, &nokey);
+        RedisModule_DictReplaceC(tfs, buf, wlen, (void*)(tf + 1));
+        len++;
+    }
+    if (copy) RedisModule_Free(copy);
+
+    uint64_t nterms = RedisModule_DictSize(tfs);
+    d->terms = nterms ? RedisModule_Alloc(nterms * sizeof(fsDocTerm)) : NULL;
+    d->len = len;
+    idx->total_len += len;
+    idx->mem += nterms * sizeof(fsDocTerm);
+
+    RedisModuleDictIter *iter = RedisModule_DictIteratorStartC(tfs, "^", NULL, 0);
+    char *w;
+    void *tfp;
+    while ((w = RedisModule_DictNextC(iter, &wlen, &tfp)) != NULL) {
+        int nokey;
+        fsIndexTerm *t = RedisModule_DictGetC(idx->terms, w, wlen, &nokey);
+        if (nokey) {
+            t = RedisModule_Alloc(sizeof(*t) + wlen);
+            t->postings = NULL;
+            t->count = t->cap = 0;
+            t->len = (uint16_t)wlen;
+            memcpy(t->word, w, wlen);
+            RedisModule_DictSetC(idx->terms, w, wlen, t);
+            idx->mem += sizeof(*t) + wlen;
+        }
+        if (t->count == t->cap) {
+            uint32_t oldcap = t->cap;
+            t->cap = oldcap ? oldcap * 2 : 4;
+            t->postings = RedisModule_Realloc(t->postings, t->cap * sizeof(fsPosting));
+            idx->mem += (t->cap - oldcap) * sizeof(fsPosting);
+        }
+        t->postings[t->count] = (fsPosting){ d, d->nterms };
+        d->terms[d->nterms++] = (fsDocTerm){ t, (uint32_t)(uintptr_t)tfp, t->count };
+        t->count++;
+    }
+    RedisModule_DictIteratorStop(iter);
+    RedisModule_FreeDict(NULL, tfs);
+}
+
+void fsIndexAdd(fsIndex *idx, fsInode *inode, const char *path, size_t pathlen) {
+    fsIndexDoc *d = fsIndexGetDoc(idx, inode);
+    if (d) {
+        fsIndexRename(idx, inode, path, pathlen);
+        fsIndexMarkStale(idx, d);
+        return;
+    }
+    d = RedisModule_Calloc(1, sizeof(*d));
+    d->inode = inode;
+    d->path = RedisModule_Alloc(pathlen + 1);
+    memcpy(d->path, path, pathlen);
+    d->path[pathlen] = '\0';
+    d->stale = -1;
+    RedisModule_DictSetC(idx->docs, &inode, sizeof(inode), d);
+    idx->ndocs++;
+    idx->mem += sizeof(*d) + pathlen + 1 + sizeof(inode);
+    fsIndexMarkStale(idx, d);
+}
+
+void fsIndexRemove(fsIndex *idx, fsInode *inode) {
+    fsIndexDoc *d = fsIndexGetDoc(idx, inode);
+    if (!d) return;
+    fsIndexUnmarkStale(idx, d);
+    fsIndexUnindex(idx, d);
+    RedisModule_DictDelC(idx->docs, &inode, sizeof(inode), NULL);
+    idx->ndocs--;
+    idx->mem -= sizeof(*d) + strlen(d->path) + 1 + sizeof(inode);
+    RedisModule_Free(d->path);
+    RedisModule_Free(d);
+}
+
+void fsIndexRename(fsIndex *idx, fsInode *inode, const char *path, size_t pathlen) {
+    fsIndexDoc *d = fsIndexGetDoc(idx, inode);
+    if (!d) return;
+    idx->mem -= strlen(d->path);
+    d->path = RedisModule_Realloc(d->path, pathlen + 1);
+    memcpy(d->path, path, pathlen);
+    d->path[pathlen] = '\0';
+    idx->mem += pathlen;
+}
+
+void fsIndexTouch(fsIndex *idx, fsInode *inode) {
+    fsIndexDoc *d = fsIndexGetDoc(idx, inode);
+    if (d) fsIndexMarkStale(idx, d);
+}
+
+void fsIndexRefresh(fsIndex *idx) {
+    while (idx->nstale) {
+        fsIndexDoc *d = idx->stale[idx->nstale - 1];
+        fsIndexUnmarkStale(idx, d);
+        fsIndexUnindex(idx, d);
+        fsIndexTokenize(idx, d);
+    }
+}
+
+/* ===================================================================
+ * Queries
+ * =================================================================== */
+
+/* Min-heap on score, holding the best hits seen so far. */
+static void fsHitSiftDown(fsSearchHit *h, size_t n, size_t i) {
+    for (;;) {
+        size_t l = 2 * i + 1, r = l + 1, m = i;
+        if (l < n && h[l].score < h[m].score) m = l;
+        if (r < n && h[r].score < h[m].score) m = r;
+        if (m == i) return;
+        fsSearchHit tmp = h[i]; h[i] = h[m]; h[m] = tmp;
+        i = m;
+    }
+}
+
+static void fsHitSiftUp(fsSearchHit *h, size_t i) {
+    while (i > 0) {
+        size_t p = (i - 1) / 2;
+        if (h[p].score <= h[i].score) return;
+        fsSearchHit tmp = h[i]; h[i] = h[p]; h[p] = tmp;
+        i = p;
+    }
+}
+
+static int fsIndexDocMatches(const fsIndexDoc *d, const char *prefix,
+                             size_t prefixlen, const char *include) {
+    if (prefixlen > 1) {
+        if (strncmp(d->path, prefix, prefixlen) != 0) return 0;
+        if (d->path[prefixlen] != '\0' && d->path[prefixlen] != '/') return 0;
+    }
+    if (include) {
+        const char *base = strrchr(d->path, '/');
+        if (!fsGlobMatch(include, base ? base + 1 : d->path)) return 0;
+    }
+    return 1;
+}
+
+size_t fsIndexSearch(fsIndex *idx, const char *query, size_t qlen,
+                     const char *prefix, size_t prefixlen, const char *include,
+                     fsSearchHit *hits, size_t limit) {
+    fsQuery q;
+    fsQueryParse(&q, query, qlen);
+    if (q.n == 0 || limit == 0 || idx->ndocs == 0) return 0;
+
+    double N = (double)idx->ndocs;
+    double avgdl = idx->total_len ? (double)idx->total_len / N : 1.0;
+    uint64_t epoch = ++idx->epoch;
+
+    // Accumulate scores on the docs themselves; candidates lists each
+    // matching doc once.
+    fsIndexDoc **cand = NULL;
+    size_t ncand = 0, candcap = 0;
+    for (size_t i = 0; i < q.n; i++) {
+        fsIndexTerm *t = RedisModule_DictGetC(idx->terms, q.words[i], q.lens[i], NULL);
+        if (!t) continue;
+        double df = t->count;
+        double idf = log(1.0 + (N - df + 0.5) / (df + 0.5));
+        for (uint32_t j = 0; j < t->count; j++) {
+            fsIndexDoc *d = t->postings[j].doc;
+            if (d->epoch != epoch) {
+                d->epoch = epoch;
+                if (!fsIndexDocMatches(d, prefix, prefixlen, include)) {
+                    d->score = -1;
+                    continue;
+                }
+                d->score = 0;
+                if (ncand == candcap) {
+                    candcap = candcap ? candcap * 2 : 64;
+                    cand = RedisModule_Realloc(cand, candcap * sizeof(*cand));
+                }
+                cand[ncand++] = d;
+            } else if (d->score < 0) {
+                continue;
+            }
+            double tf = d->terms[t->postings[j].slot].tf;
+            double norm = FS_INDEX_BM25_K1 *
+                (1.0 - FS_INDEX_BM25_B + FS_INDEX_BM25_B * d->len / avgdl);
+            d->score += idf * tf * (FS_INDEX_BM25_K1 + 1.0) / (tf + norm);
+        }
+    }
+
+    size_t n = 0;
+    for (size_t i = 0; i < ncand; i++) {
+        fsSearchHit hit = { cand[i]->path, cand[i]->inode, cand[i]->score };
+        if (n < limit) {
+            hits[n] = hit;
+            fsHitSiftUp(hits, n++);
+        } else if (hit.score > hits[0].score) {
+            hits[0] = hit;
+            fsHitSiftDown(hits, n, 0);
+        }
+    }
+    RedisModule_Free(cand);
+
+    // Heap-sort into descending score order.
+    for (size_t end = n; end > 1; end--) {
+        fsSearchHit tmp = hits[0]; hits[0] = hits[end - 1]; hits[end - 1] = tmp;
+        fsHitSiftDown(hits, end - 1, 0);
+    }
+    return n;
+}
+
+int fsIndexBestLine(const char *data, size_t len, const char *query, size_t qlen,
+                    size_t *lineno, size_t *start, size_t *end) {
+    fsQuery q;
+    fsQueryParse(&q, query, qlen);
+    size_t best = 0, line = 1, ls = 0;
+    char buf[FS_INDEX_MAX_TERM];
+    while (ls <= len) {
+        const char *nl = ls < len ? memchr(data + ls, '\n', len - ls) : NULL;
+        size_t le = nl ? (size_t)(nl - data) : len;
+        size_t pos = 0, wlen, hits = 0;
+        while ((wlen = fsNextWord(data + ls, le - ls, &pos, buf)))
+            if (fsQueryHas(&q, buf, wlen)) hits++;
+        if (hits > best) {
+            best = hits;
+            *lineno = line;
+            *start = ls;
+            *end = le;
+        }
+        if (!nl) break;
+        ls = le + 1;
+        line++;
+    }
+    return best > 0;
+}
+
+uint64_t fsIndexDocCount(const fsIndex *idx) {
+    return idx ? idx->ndocs : 0;
+}
+
+size_t fsIndexMemUsage(const fsIndex *idx) {
+    if (!idx) return 0;
+    // Dict nodes cost roughly their key length plus a pointer or two.
+    return idx->mem + RedisModule_DictSize(idx->terms) * 2 * sizeof(void*) +
+           RedisModule_DictSize(idx->docs) * 2 * sizeof(void*);
+}
@@ -0,0 +1,80 @@
+/*
+ * index.h - Inverted word index for FS.SEARCH.
+ *
+ * An optional per-key index from words to the files containing them, with
+ * term frequencies and document lengths for BM25 ranking. It is created by
+ * the first FS.SEARCH on a key and kept up to date from then on: writes
+ * only mark a file stale, and the next search re-tokenizes the stale files
+ * before scoring, so a file rewritten many times between searches is
+ * indexed once.
+ */
+
+#ifndef REDIS_FS_INDEX_H
+#define REDIS_FS_INDEX_H
+
+#include "fs.h"
+
+/* Words are runs of ASCII letters, digits and '_' (plus any byte >= 0x80,
+ * so UTF-8 words stay whole), folded to lower case. Longer runs are not
+ * indexed. */
+#define FS_INDEX_MAX_TERM     64
+#define FS_INDEX_MAX_QUERY    32    /* Distinct query terms considered */
+
+#define FS_INDEX_SNIPPET_MAX  200   /* Bytes of the best line returned */
+#define FS_SEARCH_DEFAULT_LIMIT 10
+#define FS_SEARCH_MAX_LIMIT   1000
+
+/* BM25 parameters. */
+#define FS_INDEX_BM25_K1      1.2
+#define FS_INDEX_BM25_B       0.75
+
+typedef struct fsIndex fsIndex;
+
+typedef struct fsSearchHit {
+    const char *path;       /* Owned by the index; valid until next change */
+    fsInode *inode;
+    double score;
+} fsSearchHit;
+
+/* ---- Lifecycle ---- */
+
+fsIndex *fsIndexCreate(void);
+void fsIndexFree(fsIndex *idx);
+
+/* ---- Maintenance (called from the fs.c mutation helpers) ---- */
+
+/* A file inode now lives at path. It is indexed on the next refresh. */
+void fsIndexAdd(fsIndex *idx, fsInode *inode, const char *path, size_t pathlen);
+
+/* A file inode left the filesystem. */
+void fsIndexRemove(fsIndex *idx, fsInode *inode);
+
+/* A file inode moved to a new path. */
+void fsIndexRename(fsIndex *idx, fsInode *inode, const char *path, size_t pathlen);
+
+/* A file inode may have changed. O(1): the file is marked stale. */
+void fsIndexTouch(fsIndex *idx, fsInode *inode);
+
+/* Re-tokenize every stale file. */
+void fsIndexRefresh(fsIndex *idx);
+
+/* ---- Queries ---- */
+
+/* Rank files under prefix (whose basename matches include, if given) by
+ * BM25 against the words of query. Fills up to limit hits, best first,
+ * and returns how many. Call fsIndexRefresh first. */
+size_t fsIndexSearch(fsIndex *idx, const char *query, size_t qlen,
+                     const char *prefix, size_t prefixlen, const char *include,
+                     fsSearchHit *hits, size_t limit);
+
+/* Find the line of data containing the most query words. Sets *lineno
+ * (1-based) and the line's [*start, *end) byte range. Returns 0 if no
+ * line contains any query word. */
+int fsIndexBestLine(const char *data, size_t len, const char *query, size_t qlen,
+                    size_t *lineno, size_t *start, size_t *end);
+
+/* Files tracked, and bytes used by the index. */
+uint64_t fsIndexDocCount(const fsIndex *idx);
+size_t fsIndexMemUsage(const fsIndex *idx);
+
+#endif /* REDIS_FS_INDEX_H */
@@ -0,0 +1,284 @@
+/*
+ * log.c - Append-optimized log files (FS.LOG).
+ *
+ * Segments live in one array, oldest first, so dropping from the front is
+ * a memmove of a few hundred bytes per remaining segment and finding the
+ * segment holding an offset is a short walk. Only the open (last) segment
+ * is ever reallocated, and only up to the segment size. Segment buffers
+ * are freed and reallocated through view.c, since a read view may pin
+ * them.
+ */
+
+#include "log.h"
+#include "view.h"
+#include <string.h>
+
+static uint64_t fsLogCountLines(const char *data, size_t len) {
+    uint64_t lines = 0;
+    const char *p = data, *end = data + len;
+    while (p < end && (p = memchr(p, '\n', (size_t)(end - p))) != NULL) {
+        lines++;
+        p++;
+    }
+    return lines;
+}
+
+/* ===================================================================
+ * Lifecycle
+ * =================================================================== */
+
+fsLog *fsLogCreate(void) {
+    fsLog *log = RedisModule_Alloc(sizeof(*log));
+    memset(log, 0, sizeof(*log));
+    log->segment_bytes = FS_LOG_SEGMENT_BYTES;
+    return log;
+}
+
+void fsLogClear(fsLog *log) {
+    for (size_t i = 0; i < log->count; i++)
+        fsBufferFree(log->segments[i].data);
+    log->count = 0;
+    log->dropped += log->size;
+    log->size = 0;
+}
+
+void fsLogFree(fsLog *log) {
+    if (!log) return;
+    fsLogClear(log);
+    if (log->segments) RedisModule_Free(log->segments);
+    RedisModule_Free(log);
+}
+
+fsLog *fsLogCopy(const fsLog *log) {
+    fsLog *copy = RedisModule_Alloc(sizeof(*copy));
+    *copy = *log;
+    copy->segments = NULL;
+    copy->capacity = log->count;
+    if (log->count) {
+        copy->segments = RedisModule_Alloc(sizeof(fsLogSegment) * log->count);
+        memcpy(copy->segments, log->segments, sizeof(fsLogSegment) * log->count);
+        for (size_t i = 0; i < log->count; i++) {
+            fsLogSegment *seg = &copy->segments[i];
+            seg->data = RedisModule_Alloc(seg->size);
+            memcpy(seg->data, log->segments[i].data, seg->size);
+            seg->capacity = seg->size;
+        }
+    }
+    return copy;
+}
+
+/* ===================================================================
+ * Writes
+ * =================================================================== */
+
+static fsLogSegment *fsLogOpenSegment(fsLog *log, int64_t now) {
+    if (log->count == log->capacity) {
+        log->capacity = log->capacity ? log->capacity * 2 : 4;
+        log->segments = RedisModule_Realloc(log->segments,
+                                            sizeof(fsLogSegment) * log->capacity);
+    }
+    fsLogSegment *seg = &log->segments[log->count++];
+    memset(seg, 0, sizeof(*seg));
+    seg->mtime = now;
+    return seg;
+}
+
+/* Give back the slack of a segment that will never grow again, when it is
+ * worth a copy. */
+static void fsLogSeal(fsLogSegment *seg) {
+    if (seg->capacity - seg->size > seg->size / 4) {
+        seg->data = fsBufferRealloc(seg->data, seg->size, seg->size);
+        seg->capacity = seg->size;
+    }
+}
+
+void fsLogAppend(fsLog *log, const char *data, size_t len, int64_t now) {
+    if (len == 0) return;
+    fsLogSegment *seg = log->count ? &log->segments[log->count - 1] : NULL;
+    if (seg && seg->size >= log->segment_bytes) {
+        fsLogSeal(seg);
+        seg = NULL;
+    }
+    if (!seg) seg = fsLogOpenSegment(log, now);
+
+    if (seg->size + len > seg->capacity) {
+        size_t cap = seg->capacity ? seg->capacity : FS_LOG_INITIAL_CAPACITY;
+        while (cap < seg->size + len) cap *= 2;
+        if (cap > log->segment_bytes && seg->size + len <= log->segment_bytes)
+            cap = log->segment_bytes;
+        seg->data = fsBufferRealloc(seg->data, seg->size, cap);
+        seg->capacity = cap;
+    }
+    memcpy(seg->data + seg->size, data, len);
+    // Trigrams that start up to two bytes before the new data now exist.
+    size_t start = seg->size >= 2 ? seg->size - 2 : 0;
+    seg->size += len;
+    fsBloomAddBytes(seg->bloom, seg->data, seg->size, start, seg->size);
+    seg->lines += fsLogCountLines(data, len);
+    seg->mtime = now;
+    log->size += len;
+}
+
+void fsLogAdopt(fsLog *log, char *data, size_t size, const uint8_t *bloom,
+                int64_t now) {
+    fsLogClear(log);
+    if (size == 0) {
+        if (data) fsBufferFree(data);
+        return;
+    }
+    fsLogSegment *seg = fsLogOpenSegment(log, now);
+    seg->data = data;
+    seg->size = size;
+    seg->capacity = size;
+    seg->lines = fsLogCountLines(data, size);
+    memcpy(seg->bloom, bloom, FS_BLOOM_BYTES);
+    log->size = size;
+}
+
+size_t fsLogDrop(fsLog *log, size_t n) {
+    if (log->count == 0) return 0;
+    if (n > log->count - 1) n = log->count - 1;
+    for (size_t i = 0; i < n; i++) {
+        log->size -= log->segments[i].size;
+        log->dropped += log->segments[i].size;
+        fsBufferFree(log->segments[i].data);
+    }
+    if (n) {
+        memmove(log->segments, log->segments + n,
+                sizeof(fsLogSegment) * (log->count - n));
+        log->count -= n;
+    }
+    return n;
+}
+
+size_t fsLogOverSize(const fsLog *log) {
+    if (log->max_size == 0) return 0;
+    uint64_t size = log->size;
+    size_t n = 0;
+    while (size > log->max_size && n + 1 < log->count)
+        size -= log->segments[n++].size;
+    return n;
+}
+
+size_t fsLogExpired(const fsLog *log, int64_t now) {
+    if (log->max_age == 0) return 0;
+    size_t n = 0;
+    while (n + 1 < log->count && log->segments[n].mtime < now - log->max_age)
+        n++;
+    return n;
+}
+
+/* ===================================================================
+ * Reads
+ * =================================================================== */
+
+void fsLogRead(const fsLog *log, uint64_t off, size_t len, char *out) {
+    size_t i = 0;
+    while (i < log->count && off >= log->segments[i].size)
+        off -= log->segments[i++].size;
+    for (; i < log->count && len > 0; i++) {
+        const fsLogSegment *seg = &log->segments[i];
+        size_t n = seg->size - (size_t)off;
+        if (n > len) n = len;
+        memcpy(out, seg->data + off, n);
+        out += n;
+        len -= n;
+        off = 0;
+    }
+}
+
+/* Same line arithmetic as FS.TAIL on a plain file: a final newline does
+ * not start another line, and the last n lines begin just after the n-th
+ * newline counted back from the end. */
+uint64_t fsLogTailOffset(const fsLog *log, long long n) {
+    if (n <= 0) return log->size;
+    uint64_t need = (uint64_t)n;
+    uint64_t base = log->size;
+    for (size_t i = log->count; i-- > 0; ) {
+        const fsLogSegment *seg = &log->segments[i];
+        base -= seg->size;
+        size_t end = seg->size;
+        uint64_t lines = seg->lines;
+        if (i == log->count - 1 && end > 0 && seg->data[end - 1] == '\n') {
+            end--;
+            lines--;
+        }
+        if (lines < need) {
+            need -= lines;
+            continue;
+        }
+        for (size_t j = end; j-- > 0; ) {
+            if (seg->data[j] == '\n' && --need == 0)
+                return base + j + 1;
+        }
+    }
+    return 0;
+}
+
+/* Lines never contain a newline, so when every sealed segment ends with
+ * one, no line spans two segments and the per-segment blooms are exact. */
+int fsLogMayMatch(const fsLog *log, const char *pattern) {
+    for (size_t i = 0; i < log->count; i++) {
+        const fsLogSegment *seg = &log->segments[i];
+        if (seg->size < 3) return 1;
+        if (i + 1 < log->count && seg->data[seg->size - 1] != '\n') return 1;
+        if (fsBloomMayContain(seg->bloom, pattern)) return 1;
+    }
+    return 0;
+}
+
+/* ===================================================================
+ * Persistence
+ * =================================================================== */
+
+void fsLogSave(RedisModuleIO *rdb, const fsLog *log) {
+    RedisModule_SaveUnsigned(rdb, log->segment_bytes);
+    RedisModule_SaveUnsigned(rdb, log->max_size);
+    RedisModule_SaveSigned(rdb, log->max_age);
+    RedisModule_SaveUnsigned(rdb, log->dropped);
+    RedisModule_SaveUnsigned(rdb, log->count);
+    for (size_t i = 0; i < log->count; i++) {
+        const fsLogSegment *seg = &log->segments[i];
+        RedisModule_SaveSigned(rdb, seg->mtime);
+        RedisModule_SaveStringBuffer(rdb, seg->data, seg->size);
+    }
+}
+
+fsLog *fsLogLoad(RedisModuleIO *rdb) {
+    fsLog *log = fsLogCreate();
+    log->segment_bytes = RedisModule_LoadUnsigned(rdb);
+    log->max_size = RedisModule_LoadUnsigned(rdb);
+    log->max_age = RedisModule_LoadSigned(rdb);
+    log->dropped = RedisModule_LoadUnsigned(rdb);
+    uint64_t count = RedisModule_LoadUnsigned(rdb);
+    if (RedisModule_IsIOError(rdb)) goto ioerr;
+    for (uint64_t i = 0; i < count; i++) {
+        int64_t mtime = RedisModule_LoadSigned(rdb);
+        size_t size;
+        char *data = RedisModule_LoadStringBuffer(rdb, &size);
+        if (RedisModule_IsIOError(rdb)) goto ioerr;
+        if (size == 0) {
+            RedisModule_Free(data);
+            continue;
+        }
+        fsLogSegment *seg = fsLogOpenSegment(log, mtime);
+        seg->data = data;
+        seg->size = size;
+        seg->capacity = size;
+        seg->lines = fsLogCountLines(data, size);
+        fsBloomAddBytes(seg->bloom, data, size, 0, size);
+        log->size += size;
+    }
+    return log;
+
+ioerr:
+    fsLogFree(log);
+    return NULL;
+}
+
+size_t fsLogMemUsage(const fsLog *log) {
+    size_t mem = sizeof(*log) + log->capacity * sizeof(fsLogSegment);
+    for (size_t i = 0; i < log->count; i++)
+        mem += log->segments[i].capacity;
+    return mem;
+}
@@ -0,0 +1,96 @@
+/*
+ * log.h - Append-optimized log files (FS.LOG).
+ *
+ * A log file is a file inode whose content is a list of segments rather
+ * than one buffer. Appends go to the open segment at the end; once it
+ * holds the log's segment size it is sealed and never written again.
+ * Each segment carries its own bloom filter and newline count, so an
+ * append touches only the bytes it adds, FS.TAIL reads only the segments
+ * it returns, and FS.GREP skips segments that cannot match. Retention
+ * (MAXSIZE, MAXAGE) drops whole sealed segments from the front.
+ */
+
+#ifndef REDIS_FS_LOG_H
+#define REDIS_FS_LOG_H
+
+#include "fs.h"
+
+/* Segment size bounds. An append is never split, so a segment may end a
+ * little past its size; the open segment grows from
+ * FS_LOG_INITIAL_CAPACITY by doubling. */
+#define FS_LOG_SEGMENT_BYTES     (1024 * 1024)
+#define FS_LOG_MIN_SEGMENT       1024
+#define FS_LOG_MAX_SEGMENT       (64 * 1024 * 1024)
+#define FS_LOG_INITIAL_CAPACITY  4096
+
+typedef struct fsLogSegment {
+    char *data;
+    size_t size;
+    size_t capacity;
+    uint64_t lines;         /* Newlines in data */
+    int64_t mtime;          /* Last append (ms) */
+    uint8_t bloom[FS_BLOOM_BYTES];
+} fsLogSegment;
+
+typedef struct fsLog {
+    fsLogSegment *segments; /* Oldest first; the last one is open */
+    size_t count;
+    size_t capacity;
+    uint64_t size;          /* Bytes in all segments */
+    uint64_t segment_bytes; /* Seal the open segment at this size */
+    uint64_t max_size;      /* Retention by bytes kept, 0 = none */
+    int64_t max_age;        /* Retention by segment age in ms, 0 = none */
+    uint64_t dropped;       /* Bytes ever dropped from the front */
+} fsLog;
+
+/* ---- Lifecycle ---- */
+
+fsLog *fsLogCreate(void);
+void fsLogFree(fsLog *log);
+fsLog *fsLogCopy(const fsLog *log);
+
+/* ---- Writes ---- */
+
+/* Append bytes, sealing the open segment first if it is full. */
+void fsLogAppend(fsLog *log, const char *data, size_t len, int64_t now);
+
+/* Replace the content with a single segment made of data, which must be
+ * RedisModule_Alloc'ed and is taken over, and its prebuilt bloom. */
+void fsLogAdopt(fsLog *log, char *data, size_t size, const uint8_t *bloom,
+                int64_t now);
+
+/* Drop every segment. The bytes count as dropped. */
+void fsLogClear(fsLog *log);
+
+/* Drop the n oldest sealed segments (never the open one). Returns how
+ * many were dropped. */
+size_t fsLogDrop(fsLog *log, size_t n);
+
+/* How many of the oldest sealed segments retention would drop: those
+ * that take the log over MAXSIZE, or were last written before
+ * now - MAXAGE. */
+size_t fsLogOverSize(const fsLog *log);
+size_t fsLogExpired(const fsLog *log, int64_t now);
+
+/* ---- Reads ---- */
+
+/* Copy bytes [off, off + len) of the content into out. */
+void fsLogRead(const fsLog *log, uint64_t off, size_t len, char *out);
+
+/* Offset at which the last n lines begin (0 if there are no more than n),
+ * reading only the segments they span. */
+uint64_t fsLogTailOffset(const fsLog *log, long long n);
+
+/* 1 if any segment's bloom may contain the pattern's literal. */
+int fsLogMayMatch(const fsLog *log, const char *pattern);
+
+/* ---- Persistence ---- */
+
+void fsLogSave(RedisModuleIO *rdb, const fsLog *log);
+
+/* Returns NULL on an I/O error. */
+fsLog *fsLogLoad(RedisModuleIO *rdb);
+
+size_t fsLogMemUsage(const fsLog *log);
+
+#endif /* REDIS_FS_LOG_H */
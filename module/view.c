@@ -0,0 +1,144 @@
+/*
+ * view.c - Pinned read views of file content, for background scans.
+ *
+ * Pin keys are the buffer address itself. A buffer that a writer gives up
+ * while pinned is marked retired rather than freed, so its address can't
+ * be handed out again before the last view lets go of it.
+ */
+
+#include "view.h"
+#include <string.h>
+
+long long fsPinnedCount = 0;
+
+typedef struct fsPin {
+    long long refs;         /* Views holding the buffer */
+    int retired;            /* Its owner has let go; free on last unpin */
+} fsPin;
+
+/* Buffer address → fsPin. Created on first use. */
+static RedisModuleDict *fsPins = NULL;
+
+static fsPin *fsPinLookup(const void *buf) {
+    if (!fsPins || !buf || fsPinnedCount == 0) return NULL;
+    int nokey;
+    fsPin *pin = RedisModule_DictGetC(fsPins, (void*)&buf, sizeof(buf), &nokey);
+    return nokey ? NULL : pin;
+}
+
+static void fsPinBuffer(const void *buf) {
+    if (!buf) return;
+    if (!fsPins) fsPins = RedisModule_CreateDict(NULL);
+    fsPin *pin = fsPinLookup(buf);
+    if (!pin) {
+        pin = RedisModule_Alloc(sizeof(*pin));
+        pin->refs = 0;
+        pin->retired = 0;
+        RedisModule_DictSetC(fsPins, (void*)&buf, sizeof(buf), pin);
+        fsPinnedCount++;
+    }
+    pin->refs++;
+}
+
+static void fsUnpinBuffer(const void *buf) {
+    fsPin *pin = fsPinLookup(buf);
+    if (!pin || --pin->refs > 0) return;
+    RedisModule_DictDelC(fsPins, (void*)&buf, sizeof(buf), NULL);
+    fsPinnedCount--;
+    if (pin->retired) RedisModule_Free((void*)buf);
+    RedisModule_Free(pin);
+}
+
+/* ===================================================================
+ * Buffers
+ * =================================================================== */
+
+void fsBufferFree(void *buf) {
+    if (!buf) return;
+    fsPin *pin = fsPinLookup(buf);
+    if (pin) pin->retired = 1;
+    else RedisModule_Free(buf);
+}
+
+void *fsBufferRealloc(void *buf, size_t oldsize, size_t newsize) {
+    if (!fsPinLookup(buf)) return RedisModule_Realloc(buf, newsize);
+    void *copy = RedisModule_Alloc(newsize);
+    memcpy(copy, buf, oldsize < newsize ? oldsize : newsize);
+    fsBufferFree(buf);
+    return copy;
+}
+
+void *fsBufferUnshare(void *buf, size_t size) {
+    if (!fsPinLookup(buf)) return buf;
+    return fsBufferRealloc(buf, size, size ? size : 1);
+}
+
+/* ===================================================================
+ * Views
+ * =================================================================== */
+
+fsView *fsViewCreate(void) {
+    fsView *view = RedisModule_Alloc(sizeof(*view));
+    memset(view, 0, sizeof(*view));
+    return view;
+}
+
+/* Copy the segment headers of log, pinning each segment's data. */
+static fsLog *fsViewPinLog(const fsLog *log) {
+    fsLog *copy = RedisModule_Alloc(sizeof(*copy));
+    *copy = *log;
+    copy->capacity = log->count;
+    copy->segments = NULL;
+    if (log->count) {
+        copy->segments = RedisModule_Alloc(sizeof(fsLogSegment) * log->count);
+        memcpy(copy->segments, log->segments, sizeof(fsLogSegment) * log->count);
+    }
+    for (size_t i = 0; i < copy->count; i++) fsPinBuffer(copy->segments[i].data);
+    return copy;
+}
+
+void fsViewAddFile(fsView *view, const char *path, size_t pathlen,
+                   const fsInode *inode) {
+    if (view->count == view->capacity) {
+        view->capacity = view->capacity ? view->capacity * 2 : 16;
+        view->files = RedisModule_Realloc(view->files, sizeof(fsViewFile) * view->capacity);
+    }
+    if (view->pathslen + pathlen > view->pathscap) {
+        view->pathscap = (view->pathslen + pathlen) * 2;
+        view->paths = RedisModule_Realloc(view->paths, view->pathscap);
+    }
+    fsViewFile *f = &view->files[view->count++];
+    f->path = view->pathslen;
+    f->pathlen = pathlen;
+    memcpy(view->paths + view->pathslen, path, pathlen);
+    view->pathslen += pathlen;
+
+    f->size = inode->payload.file.size;
+    f->data = NULL;
+    f->log = NULL;
+    if (inode->payload.file.log) {
+        f->log = fsViewPinLog(inode->payload.file.log);
+    } else {
+        f->data = inode->payload.file.data;
+        fsPinBuffer(f->data);
+    }
+    view->bytes += f->size;
+}
+
+void fsViewRelease(fsView *view) {
+    if (!view) return;
+    for (size_t i = 0; i < view->count; i++) {
+        fsViewFile *f = &view->files[i];
+        if (f->log) {
+            for (size_t j = 0; j < f->log->count; j++)
+                fsUnpinBuffer(f->log->segments[j].data);
+            if (f->log->segments) RedisModule_Free(f->log->segments);
+            RedisModule_Free(f->log);
+        } else {
+            fsUnpinBuffer(f->data);
+        }
+    }
+    if (view->files) RedisModule_Free(view->files);
+    if (view->paths) RedisModule_Free(view->paths);
+    RedisModule_Free(view);
+}
@@ -0,0 +1,80 @@
+/*
+ * view.h - Pinned read views of file content, for background scans.
+ *
+ * A view is an immutable copy of what a subtree's files looked like when
+ * it was taken: each file's path and the content buffers it had then.
+ * Taking one copies paths and pointers, never content. While a view pins
+ * a buffer, writers leave it alone: an edit in place, a realloc or a free
+ * of a pinned buffer goes to a private copy instead (or, for a free, is
+ * put off), so a thread can read the view without the module lock while
+ * the main thread keeps writing. Releasing the view frees the buffers
+ * that writers have since replaced.
+ *
+ * Pins are counted in one dict keyed by buffer address. It is only ever
+ * touched on the main thread, when a view is taken or released and when a
+ * writer retires a buffer; the scanning thread only reads the view.
+ * While nothing is pinned, the buffer helpers below are plain
+ * RedisModule_Realloc / RedisModule_Free.
+ *
+ * Log files are pinned segment by segment: the view keeps a copy of the
+ * segment headers, and appends to the open segment only write past the
+ * size the view recorded.
+ */
+
+#ifndef REDIS_FS_VIEW_H
+#define REDIS_FS_VIEW_H
+
+#include "fs.h"
+#include "log.h"
+
+typedef struct fsViewFile {
+    size_t path;            /* Offset of its path in fsView.paths */
+    size_t pathlen;
+    const char *data;       /* Content when taken (plain files) */
+    size_t size;
+    fsLog *log;             /* Segment headers when taken (log files) */
+} fsViewFile;
+
+typedef struct fsView {
+    fsViewFile *files;
+    size_t count;
+    size_t capacity;
+    char *paths;            /* Every file's path, back to back */
+    size_t pathslen;
+    size_t pathscap;
+    uint64_t bytes;         /* Content bytes pinned */
+} fsView;
+
+/* Buffers pinned by any view. While 0, writers skip the pin lookup. */
+extern long long fsPinnedCount;
+
+/* ---- Buffers (main thread only) ---- */
+
+/* Free buf, or once the last view pinning it is released. */
+void fsBufferFree(void *buf);
+
+/* RedisModule_Realloc, except that a pinned buf is left as it is and its
+ * first min(oldsize, newsize) bytes copied to a new buffer. */
+void *fsBufferRealloc(void *buf, size_t oldsize, size_t newsize);
+
+/* buf, or a private copy of its size bytes if a view pins it. Call before
+ * editing a buffer in place. */
+void *fsBufferUnshare(void *buf, size_t size);
+
+/* ---- Views ---- */
+
+fsView *fsViewCreate(void);
+
+/* Add a file inode at path, pinning its current content. */
+void fsViewAddFile(fsView *view, const char *path, size_t pathlen,
+                   const fsInode *inode);
+
+/* The path of a file in the view. */
+static inline const char *fsViewPath(const fsView *view, const fsViewFile *f) {
+    return view->paths + f->path;
+}
+
+/* Unpin everything and free the view. Main thread only. */
+void fsViewRelease(fsView *view);
+
+#endif /* REDIS_FS_VIEW_H */
@@ -0,0 +1,232 @@
+/*
+ * watch.c - Change journal and watcher registry for FS.WATCH.
+ *
+ * Registry keys are be32(db) be32(keylen) key path, so all the watchers
+ * of one key sort together and those below a path form one range.
+ */
+
+#include "watch.h"
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+
+long long fsWatchCount = 0;
+long long fsJournalCount = 0;
+
+/* Registry key → first fsWatcher on that path. Created on first use. */
+static RedisModuleDict *fsWatchers = NULL;
+
+/* ===================================================================
+ * Journal
+ * =================================================================== */
+
+fsJournal *fsJournalCreate(void) {
+    fsJournal *j = RedisModule_Alloc(sizeof(*j));
+    memset(j, 0, sizeof(*j));
+    j->epoch = fsNowMs();
+    fsJournalCount++;
+    return j;
+}
+
+void fsJournalFree(fsJournal *j) {
+    if (!j) return;
+    for (size_t i = 0; i < FS_JOURNAL_SIZE; i++)
+        if (j->ring[i].path) RedisModule_Free(j->ring[i].path);
+    RedisModule_Free(j);
+    fsJournalCount--;
+}
+
+uint64_t fsJournalAppend(fsJournal *j, const char *path, size_t pathlen) {
+    fsJournalEntry *e = &j->ring[++j->seq % FS_JOURNAL_SIZE];
+    if (e->path) RedisModule_Free(e->path);
+    e->seq = j->seq;
+    e->path = RedisModule_Alloc(pathlen + 1);
+    memcpy(e->path, path, pathlen);
+    e->path[pathlen] = '\0';
+    e->pathlen = pathlen;
+    if (j->count < FS_JOURNAL_SIZE) j->count++;
+    return j->seq;
+}
+
+uint64_t fsJournalOldest(const fsJournal *j) {
+    return j->seq - j->count + 1;
+}
+
+const fsJournalEntry *fsJournalGet(const fsJournal *j, uint64_t seq) {
+    return &j->ring[seq % FS_JOURNAL_SIZE];
+}
+
+size_t fsJournalMemUsage(const fsJournal *j) {
+    if (!j) return 0;
+    size_t mem = sizeof(*j);
+    for (size_t i = 0; i < FS_JOURNAL_SIZE; i++)
+        if (j->ring[i].path) mem += j->ring[i].pathlen + 1;
+    return mem;
+}
+
+/* ===================================================================
+ * Tokens and matching
+ * =================================================================== */
+
+int fsWatchParseToken(const char *s, size_t len, int64_t *epoch, uint64_t *seq) {
+    char buf[64];
+    if (len == 0 || len >= sizeof(buf)) return 0;
+    memcpy(buf, s, len);
+    buf[len] = '\0';
+    char *dash = strchr(buf, '-');
+    if (!dash || dash == buf || dash[1] == '\0') return 0;
+    *dash = '\0';
+    char *end;
+    errno = 0;
+    long long e = strtoll(buf, &end, 10);
+    if (errno || *end || e < 0) return 0;
+    unsigned long long n = strtoull(dash + 1, &end, 10);
+    if (errno || *end || dash[1] == '-') return 0;
+    *epoch = e;
+    *seq = n;
+    return 1;
+}
+
+/* Is a a proper ancestor of b? */
+static int fsIsAncestor(const char *a, size_t alen, const char *b, size_t blen) {
+    if (alen >= blen || memcmp(a, b, alen) != 0) return 0;
+    return alen == 1 || b[alen] == '/';
+}
+
+int fsWatchMatches(const char *path, size_t pathlen, int recursive,
+                   const char *changed, size_t changedlen) {
+    if (pathlen == changedlen && memcmp(path, changed, pathlen) == 0) return 1;
+    if (fsIsAncestor(changed, changedlen, path, pathlen)) return 1;
+    if (!fsIsAncestor(path, pathlen, changed, changedlen)) return 0;
+    if (recursive) return 1;
+    size_t rest = pathlen == 1 ? 1 : pathlen + 1;
+    return memchr(changed + rest, '/', changedlen - rest) == NULL;
+}
+
+/* ===================================================================
+ * Registry
+ * =================================================================== */
+
+static void fsPutBE32(char *p, uint32_t v) {
+    p[0] = (char)(v >> 24);
+    p[1] = (char)(v >> 16);
+    p[2] = (char)(v >> 8);
+    p[3] = (char)v;
+}
+
+char *fsWatchKey(int db, const char *key, size_t keylen,
+                 const char *path, size_t pathlen, size_t *outlen,
+                 size_t *pathoff) {
+    size_t off = 8 + keylen;
+    char *buf = RedisModule_Alloc(off + pathlen + 1);
+    fsPutBE32(buf, (uint32_t)db);
+    fsPutBE32(buf + 4, (uint32_t)keylen);
+    memcpy(buf + 8, key, keylen);
+    memcpy(buf + off, path, pathlen);
+    buf[off + pathlen] = '\0';
+    *outlen = off + pathlen;
+    if (pathoff) *pathoff = off;
+    return buf;
+}
+
+void fsWatcherRegister(fsWatcher *w) {
+    if (!fsWatchers) fsWatchers = RedisModule_CreateDict(NULL);
+    int nokey = 0;
+    fsWatcher *head = RedisModule_DictGetC(fsWatchers, w->regkey, w->regkeylen, &nokey);
+    w->prev = NULL;
+    w->next = nokey ? NULL : head;
+    if (w->next) w->next->prev = w;
+    RedisModule_DictReplaceC(fsWatchers, w->regkey, w->regkeylen, w);
+    w->registered = 1;
+    fsWatchCount++;
+}
+
+void fsWatcherUnregister(fsWatcher *w) {
+    if (!w->registered) return;
+    if (w->prev) {
+        w->prev->next = w->next;
+    } else if (w->next) {
+        RedisModule_DictReplaceC(fsWatchers, w->regkey, w->regkeylen, w->next);
+    } else {
+        RedisModule_DictDelC(fsWatchers, w->regkey, w->regkeylen, NULL);
+    }
+    if (w->next) w->next->prev = w->prev;
+    w->prev = w->next = NULL;
+    w->registered = 0;
+    fsWatchCount--;
+}
+
+int fsWatchAnyOnKey(const char *prefix, size_t prefixlen) {
+    if (!fsWatchers || fsWatchCount == 0) return 0;
+    RedisModuleDictIter *iter = RedisModule_DictIteratorStartC(
+        fsWatchers, ">=", (void*)prefix, prefixlen);
+    size_t klen;
+    char *k = RedisModule_DictNextC(iter, &klen, NULL);
+    int found = k && klen >= prefixlen && memcmp(k, prefix, prefixlen) == 0;
+    RedisModule_DictIteratorStop(iter);
+    return found;
+}
+
+/* Watchers picked by one write, woken once the registry walk is done. */
+typedef struct fsWakeList {
+    fsWatcher **items;
+    size_t count, cap;
+} fsWakeList;
+
+static void fsWakeListAdd(fsWakeList *l, fsWatcher *w) {
+    if (l->count == l->cap) {
+        l->cap = l->cap ? l->cap * 2 : 8;
+        l->items = RedisModule_Realloc(l->items, sizeof(fsWatcher*) * l->cap);
+    }
+    l->items[l->count++] = w;
+}
+
+size_t fsWatchWake(const char *prefix, size_t prefixlen,
+                   const char *path, size_t pathlen) {
+    if (!fsWatchers || fsWatchCount == 0) return 0;
+    fsWakeList wake = { NULL, 0, 0 };
+
+    // Ancestors and the path itself: one lookup per component.
+    char *k = RedisModule_Alloc(prefixlen + pathlen + 1);
+    memcpy(k, prefix, prefixlen);
+    memcpy(k + prefixlen, path, pathlen);
+    for (size_t alen = 1; alen <= pathlen; alen++) {
+        if (alen > 1 && alen < pathlen && path[alen] != '/') continue;
+        int nokey = 0;
+        fsWatcher *w = RedisModule_DictGetC(fsWatchers, k, prefixlen + alen, &nokey);
+        for (; !nokey && w; w = w->next)
+            if (fsWatchMatches(path, alen, w->recursive, path, pathlen))
+                fsWakeListAdd(&wake, w);
+    }
+
+    // Everything below the path: one range. Keys in it are longer than
+    // any looked up above, except the root's own, so no watcher is
+    // picked twice.
+    size_t sublen = pathlen == 1 ? 1 : pathlen + 1;
+    k[prefixlen + pathlen] = '/';
+    RedisModuleDictIter *iter = RedisModule_DictIteratorStartC(
+        fsWatchers, ">=", k, prefixlen + sublen);
+    size_t klen;
+    fsWatcher *w;
+    char *rk;
+    while ((rk = RedisModule_DictNextC(iter, &klen, (void**)&w)) != NULL) {
+        if (klen < prefixlen + sublen || memcmp(rk, k, prefixlen + sublen) != 0) break;
+        if (klen == prefixlen + pathlen) continue;
+        for (; w; w = w->next) fsWakeListAdd(&wake, w);
+    }
+    RedisModule_DictIteratorStop(iter);
+    RedisModule_Free(k);
+
+    for (size_t i = 0; i < wake.count; i++) {
+        w = wake.items[i];
+        fsWatcherUnregister(w);
+        w->changed = RedisModule_Alloc(pathlen + 1);
+        memcpy(w->changed, path, pathlen);
+        w->changed[pathlen] = '\0';
+        w->changedlen = pathlen;
+        RedisModule_UnblockClient(w->bc, w);
+    }
+    if (wake.items) RedisModule_Free(wake.items);
+    return wake.count;
+}
@@ -0,0 +1,105 @@
+/*
+ * watch.h - Change journal and watcher registry for FS.WATCH.
+ *
+ * The journal is an optional per-key ring of the paths written most
+ * recently, numbered in order. It is created by the first FS.WATCH on a
+ * key and lets a client resume with SINCE from the number it last saw.
+ * It lives in memory only: a reload starts a new journal under a new
+ * epoch, and tokens from the old one are answered with a rescan.
+ *
+ * The registry holds the clients blocked in FS.WATCH, across all keys, in
+ * one dict keyed by (db, key, watched path). A write looks up the
+ * watchers on each ancestor of the path it changed, plus those below it
+ * with one range scan, so its cost grows with the depth of the path and
+ * the watchers it wakes, not with the number of watchers.
+ */
+
+#ifndef REDIS_FS_WATCH_H
+#define REDIS_FS_WATCH_H
+
+#include "fs.h"
+
+/* Changes kept per key for SINCE. A client that falls further behind is
+ * told to rescan. */
+#define FS_JOURNAL_SIZE 1024
+
+typedef struct fsJournalEntry {
+    uint64_t seq;
+    char *path;
+    size_t pathlen;
+} fsJournalEntry;
+
+typedef struct fsJournal {
+    int64_t epoch;          /* Creation time (ms); names this journal */
+    uint64_t seq;           /* Number of the last change, 0 = none yet */
+    size_t count;           /* Entries held, up to FS_JOURNAL_SIZE */
+    fsJournalEntry ring[FS_JOURNAL_SIZE]; /* seq s lives at s % size */
+} fsJournal;
+
+/* A client blocked in FS.WATCH. */
+typedef struct fsWatcher {
+    RedisModuleBlockedClient *bc;
+    char *regkey;           /* Its registry key: (db, key, path) */
+    size_t regkeylen;
+    size_t pathoff;         /* Where the watched path starts in regkey */
+    int recursive;
+    int registered;
+    struct fsWatcher *prev, *next; /* Others watching the same path */
+    int64_t epoch;          /* Token the client is waiting from */
+    uint64_t seq;
+    char *changed;          /* Path of the write that woke it, if any */
+    size_t changedlen;
+} fsWatcher;
+
+/* Watchers currently blocked, across all keys. While this is 0 and no key
+ * has a journal, writes skip notification entirely. */
+extern long long fsWatchCount;
+extern long long fsJournalCount;
+
+/* ---- Journal ---- */
+
+fsJournal *fsJournalCreate(void);
+void fsJournalFree(fsJournal *j);
+
+/* Record a change to path. Returns its number. */
+uint64_t fsJournalAppend(fsJournal *j, const char *path, size_t pathlen);
+
+/* Number of the oldest change still held (seq + 1 when empty). */
+uint64_t fsJournalOldest(const fsJournal *j);
+
+/* The entry numbered seq, which must be held. */
+const fsJournalEntry *fsJournalGet(const fsJournal *j, uint64_t seq);
+
+size_t fsJournalMemUsage(const fsJournal *j);
+
+/* ---- Tokens ---- */
+
+/* Tokens are "epoch-seq". Returns 0 if s is not one. */
+int fsWatchParseToken(const char *s, size_t len, int64_t *epoch, uint64_t *seq);
+
+/* Does a write to changed concern a watch on path? It does when changed
+ * is path itself, a child of it (any descendant when recursive), or an
+ * ancestor, whose removal or move takes path along. */
+int fsWatchMatches(const char *path, size_t pathlen, int recursive,
+                   const char *changed, size_t changedlen);
+
+/* ---- Registry ---- */
+
+/* The registry key for (db, key, path). Free with RedisModule_Free. */
+char *fsWatchKey(int db, const char *key, size_t keylen,
+                 const char *path, size_t pathlen, size_t *outlen,
+                 size_t *pathoff);
+
+void fsWatcherRegister(fsWatcher *w);
+void fsWatcherUnregister(fsWatcher *w);
+
+/* Is any watcher registered on this key? prefix is fsWatchKey() with an
+ * empty path. */
+int fsWatchAnyOnKey(const char *prefix, size_t prefixlen);
+
+/* Wake the watchers a write to path concerns: each is unregistered, told
+ * the changed path, and unblocked. Returns how many were woken. */
+size_t fsWatchWake(const char *prefix, size_t prefixlen,
+                   const char *path, size_t pathlen);
+
+#endif /* REDIS_FS_WATCH_H */
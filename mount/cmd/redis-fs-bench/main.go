@@ -0,0 +1,267 @@
+// redis-fs-bench measures a FUSE-mounted Redis FS with fio-style workloads.
+//
+// It starts a throwaway redis-server with the fs module loaded (or uses
+// the one given with -redis), mounts the key on a temporary directory in
+// process, and runs each workload through ordinary file system calls, so
+// every layer between an application and the module is in the numbers:
+// the kernel's FUSE driver, the mount's caches and Redis round trips. Each
+// workload reports operations per second and latency percentiles.
+package main
+
+import (
+	"context"
+	"encoding/json"
+	"flag"
+	"fmt"
+	"log"
+	"net"
+	"os"
+	"os/exec"
+	"path/filepath"
+	"regexp"
+	"strconv"
+	"strings"
+	"time"
+
+	"github.com/redis/go-redis/v9"
+	"github.com/redis-fs/mount/internal/client"
+	"github.com/redis-fs/mount/internal/redisfs"
+)
+
+// config holds the workload parameters shared by every workload.
+type config struct {
+	blockSizes []int
+	fileSize   int64
+	duration   time.Duration
+	files      int
+	dirEntries int
+	treeDirs   int
+	treeFiles  int
+	tarFiles   int
+}
+
+func main() {
+	redisAddr := flag.String("redis", "", "Use the Redis server at this address instead of starting one")
+	redisServer := flag.String("redis-server", "redis-server", "redis-server binary to start")
+	modulePath := flag.String("module", "../module/fs.so", "Redis FS module to load into the server")
+	key := flag.String("key", "bench:mount", "Redis key to mount (deleted first)")
+	attrTimeout := flag.Float64("attr-timeout", 1.0, "Attribute cache TTL in seconds")
+	run := flag.String("run", "", "Only run workloads whose name matches this regexp")
+	jsonOut := flag.Bool("json", false, "Print results as JSON")
+	bs := flag.String("bs", "4k,64k,1m", "Block sizes for the read and write workloads")
+	size := flag.String("size", "64m", "File size for the read and write workloads")
+	duration := flag.Duration("time", 5*time.Second, "Time limit for each random I/O and repeated workload")
+	files := flag.Int("files", 2000, "Files created, stat'ed and removed by the metadata workload")
+	dirEntries := flag.Int("dir-entries", 10000, "Entries in the directory the ls -l workload lists")
+	tree := flag.String("tree", "50x40", "Directories x files in the tree the stat walk covers")
+	tarFiles := flag.Int("tar-files", 2000, "Files in the archive the untar workload extracts")
+
+	flag.Usage = func() {
+		fmt.Fprintf(os.Stderr, "Usage: %s [flags]\n\n", os.Args[0])
+		fmt.Fprintf(os.Stderr, "Benchmark a Redis FS FUSE mount with fio-style workloads.\n\n")
+		fmt.Fprintf(os.Stderr, "Flags:\n")
+		flag.PrintDefaults()
+	}
+	flag.Parse()
+
+	cfg := config{
+		duration:   *duration,
+		files:      *files,
+		dirEntries: *dirEntries,
+		tarFiles:   *tarFiles,
+	}
+	for _, s := range strings.Split(*bs, ",") {
+		n, err := parseSize(s)
+		if err != nil || n <= 0 {
+			log.Fatalf("bad block size %q", s)
+		}
+		cfg.blockSizes = append(cfg.blockSizes, int(n))
+	}
+	var err error
+	if cfg.fileSize, err = parseSize(*size); err != nil || cfg.fileSize <= 0 {
+		log.Fatalf("bad file size %q", *size)
+	}
+	if _, err := fmt.Sscanf(*tree, "%dx%d", &cfg.treeDirs, &cfg.treeFiles); err != nil {
+		log.Fatalf("bad tree shape %q, want DIRSxFILES", *tree)
+	}
+	filter, err := regexp.Compile(*run)
+	if err != nil {
+		log.Fatalf("bad -run pattern: %v", err)
+	}
+
+	err = benchmark(cfg, setup{
+		redisAddr:   *redisAddr,
+		redisServer: *redisServer,
+		modulePath:  *modulePath,
+		key:         *key,
+		attrTimeout: time.Duration(*attrTimeout * float64(time.Second)),
+		filter:      filter,
+		json:        *jsonOut,
+	})
+	if err != nil {
+		log.Fatal(err)
+	}
+}
+
+// setup says where to run the workloads and how to report them.
+type setup struct {
+	redisAddr   string
+	redisServer string
+	modulePath  string
+	key         string
+	attrTimeout time.Duration
+	filter      *regexp.Regexp
+	json        bool
+}
+
+// benchmark runs the workloads, tearing down the mount and the server it
+// started however it ends.
+func benchmark(cfg config, s setup) error {
+	addr := s.redisAddr
+	if addr == "" {
+		server, started, err := startRedis(s.redisServer, s.modulePath)
+		if err != nil {
+			return fmt.Errorf("starting redis-server: %w", err)
+		}
+		defer func() {
+			server.Process.Kill()
+			server.Wait()
+		}()
+		addr = started
+	}
+
+	rdb := redis.NewClient(&redis.Options{Addr: addr, PoolSize: 16})
+	defer rdb.Close()
+	ctx := context.Background()
+	if err := waitForRedis(ctx, rdb); err != nil {
+		return fmt.Errorf("cannot connect to Redis at %s: %w", addr, err)
+	}
+	if err := rdb.Del(ctx, s.key).Err(); err != nil {
+		return fmt.Errorf("clearing %s: %w", s.key, err)
+	}
+	if err := rdb.Do(ctx, "FS.MKDIR", s.key, "/bench").Err(); err != nil {
+		return fmt.Errorf("creating %s (is the fs module loaded?): %w", s.key, err)
+	}
+
+	mountpoint, err := os.MkdirTemp("", "redis-fs-bench-")
+	if err != nil {
+		return fmt.Errorf("creating mountpoint: %w", err)
+	}
+	defer os.Remove(mountpoint)
+
+	c := client.New(rdb, s.key)
+	defer c.Close()
+	uid, gid := redisfs.GetOwnership()
+	server, err := redisfs.Mount(mountpoint, c, &redisfs.Options{
+		AttrTimeout: s.attrTimeout,
+		UID:         uid,
+		GID:         gid,
+	})
+	if err != nil {
+		return fmt.Errorf("mount failed: %w", err)
+	}
+	defer server.Unmount()
+
+	root := filepath.Join(mountpoint, "bench")
+	var results []*result
+	if !s.json {
+		printHeader()
+	}
+	for _, w := range workloads(cfg) {
+		if !s.filter.MatchString(w.name) {
+			continue
+		}
+		dir := filepath.Join(root, strings.ReplaceAll(w.name, "/", "-"))
+		if err := os.Mkdir(dir, 0o755); err != nil {
+			return fmt.Errorf("%s: %w", w.name, err)
+		}
+		res, err := w.run(dir)
+		if err != nil {
+			return fmt.Errorf("%s: %w", w.name, err)
+		}
+		for _, r := range res {
+			if !s.json {
+				printResult(r)
+			}
+			results = append(results, r)
+		}
+		// Leave the key empty for the next workload.
+		if err := os.RemoveAll(dir); err != nil {
+			return fmt.Errorf("%s: cleaning up: %w", w.name, err)
+		}
+	}
+	if s.json {
+		enc := json.NewEncoder(os.Stdout)
+		enc.SetIndent("", "  ")
+		return enc.Encode(results)
+	}
+	return nil
+}
+
+// startRedis starts redis-server with the module loaded, without
+// persistence, on a free local port, and returns its address.
+func startRedis(binary, module string) (*exec.Cmd, string, error) {
+	module, err := filepath.Abs(module)
+	if err != nil {
+		return nil, "", err
+	}
+	if _, err := os.Stat(module); err != nil {
+		return nil, "", fmt.Errorf("module: %w (build it with make in module/)", err)
+	}
+	l, err := net.Listen("tcp", "127.0.0.1:0")
+	if err != nil {
+		return nil, "", err
+	}
+	port := strconv.Itoa(l.Addr().(*net.TCPAddr).Port)
+	l.Close()
+
+	cmd := exec.Command(binary,
+		"--port", port, "--bind", "127.0.0.1",
+		"--save", "", "--appendonly", "no",
+		"--loadmodule", module)
+	cmd.Stderr = os.Stderr
+	if err := cmd.Start(); err != nil {
+		return nil, "", err
+	}
+	return cmd, "127.0.0.1:" + port, nil
+}
+
+func waitForRedis(ctx context.Context, rdb *redis.Client) error {
+	deadline := time.Now().Add(5 * time.Second)
+	for {
+		err := rdb.Ping(ctx).Err()
+		if err == nil || time.Now().After(deadline) {
+			return err
+		}
+		time.Sleep(50 * time.Millisecond)
+	}
+}
+
+// parseSize parses a byte count with an optional k, m or g suffix.
+func parseSize(s string) (int64, error) {
+	s = strings.ToLower(strings.TrimSpace(s))
+	mult := int64(1)
+	switch {
+	case strings.HasSuffix(s, "k"):
+		mult = 1 << 10
+	case strings.HasSuffix(s, "m"):
+		mult = 1 << 20
+	case strings.HasSuffix(s, "g"):
+		mult = 1 << 30
+	}
+	if mult > 1 {
+		s = s[:len(s)-1]
+	}
+	n, err := strconv.ParseInt(s, 10, 64)
+	return n * mult, err
+}
+
+func formatSize(n int) string {
+	switch {
+	case n >= 1<<20 && n%(1<<20) == 0:
+		return fmt.Sprintf("%dm", n>>20)
+	case n >= 1<<10 && n%(1<<10) == 0:
+		return fmt.Sprintf("%dk", n>>10)
+	}
+	return strconv.Itoa(n)
+}
@@ -0,0 +1,104 @@
+package main
+
+import (
+	"fmt"
+	"sort"
+	"time"
+)
+
+// result is what one timed phase of a workload measured. An op is one
+// system call for the I/O and metadata workloads, and one whole listing,
+// walk or file for the others; items counts the entries they covered.
+type result struct {
+	Name      string  `json:"name"`
+	Ops       int     `json:"ops"`
+	Items     int64   `json:"items"`
+	Bytes     int64   `json:"bytes"`
+	Seconds   float64 `json:"seconds"`
+	OpsPerSec float64 `json:"ops_per_sec"`
+	P50us     float64 `json:"p50_us"`
+	P90us     float64 `json:"p90_us"`
+	P99us     float64 `json:"p99_us"`
+	MaxUs     float64 `json:"max_us"`
+}
+
+// recorder collects per-op latencies for one phase.
+type recorder struct {
+	name    string
+	start   time.Time
+	latency []time.Duration
+	items   int64
+	bytes   int64
+}
+
+func newRecorder(name string) *recorder {
+	return &recorder{name: name, start: time.Now()}
+}
+
+// time runs and times one op, which returns the bytes it moved.
+func (r *recorder) time(op func() (int, error)) error {
+	t := time.Now()
+	n, err := op()
+	r.latency = append(r.latency, time.Since(t))
+	r.bytes += int64(n)
+	return err
+}
+
+func (r *recorder) result() *result {
+	elapsed := time.Since(r.start).Seconds()
+	lat := r.latency
+	sort.Slice(lat, func(i, j int) bool { return lat[i] < lat[j] })
+	pct := func(p float64) float64 {
+		if len(lat) == 0 {
+			return 0
+		}
+		i := int(p * float64(len(lat)-1))
+		return float64(lat[i]) / float64(time.Microsecond)
+	}
+	res := &result{
+		Name:    r.name,
+		Ops:     len(lat),
+		Items:   r.items,
+		Bytes:   r.bytes,
+		Seconds: elapsed,
+		P50us:   pct(0.50),
+		P90us:   pct(0.90),
+		P99us:   pct(0.99),
+		MaxUs:   pct(1),
+	}
+	if elapsed > 0 {
+		res.OpsPerSec = float64(res.Ops) / elapsed
+	}
+	return res
+}
+
+func printHeader() {
+	fmt.Printf("%-18s %8s %10s %10s %9s %9s %9s %9s %9s\n",
+		"workload", "ops", "ops/s", "items/s", "MB/s", "p50", "p90", "p99", "max")
+}
+
+func printResult(r *result) {
+	perSec := func(n int64) string {
+		if n == 0 || r.Seconds == 0 {
+			return "-"
+		}
+		return fmt.Sprintf("%.1f", float64(n)/r.Seconds)
+	}
+	mbs := "-"
+	if r.Bytes > 0 && r.Seconds > 0 {
+		mbs = fmt.Sprintf("%.1f", float64(r.Bytes)/r.Seconds/(1<<20))
+	}
+	fmt.Printf("%-18s %8d %10.1f %10s %9s %9s %9s %9s %9s\n",
+		r.Name, r.Ops, r.OpsPerSec, perSec(r.Items), mbs,
+		formatMicros(r.P50us), formatMicros(r.P90us), formatMicros(r.P99us), formatMicros(r.MaxUs))
+}
+
+func formatMicros(us float64) string {
+	switch {
+	case us >= 1e6:
+		return fmt.Sprintf("%.2fs", us/1e6)
+	case us >= 1e3:
+		return fmt.Sprintf("%.2fms", us/1e3)
+	}
+	return fmt.Sprintf("%.0fus", us)
+}
@@ -0,0 +1,328 @@
+package main
+
+import (
+	"archive/tar"
+	"bytes"
+	"fmt"
+	"io"
+	"math/rand"
+	"os"
+	"path/filepath"
+	"time"
+)
+
+// A workload runs in its own empty directory on the mount and returns
+// one result per timed phase. Setup it needs (laying out a file or a
+// tree) is done through the mount too, but not timed.
+type workload struct {
+	name string
+	run  func(dir string) ([]*result, error)
+}
+
+func workloads(cfg config) []workload {
+	var ws []workload
+	for _, bs := range cfg.blockSizes {
+		bs := bs
+		ws = append(ws,
+			workload{"seq/" + formatSize(bs), func(dir string) ([]*result, error) {
+				return sequential(cfg, dir, bs)
+			}},
+			workload{"rand/" + formatSize(bs), func(dir string) ([]*result, error) {
+				return random(cfg, dir, bs)
+			}},
+		)
+	}
+	return append(ws,
+		workload{"meta", func(dir string) ([]*result, error) { return metadata(cfg, dir) }},
+		workload{"ls-l", func(dir string) ([]*result, error) { return listing(cfg, dir) }},
+		workload{"stat-walk", func(dir string) ([]*result, error) { return statWalk(cfg, dir) }},
+		workload{"untar", func(dir string) ([]*result, error) { return untar(cfg, dir) }},
+	)
+}
+
+// randomBytes returns n bytes of seeded noise, so runs write the same data.
+func randomBytes(n int, seed int64) []byte {
+	buf := make([]byte, n)
+	rand.New(rand.NewSource(seed)).Read(buf)
+	return buf
+}
+
+// closeOp times Close as an op of its own: the mount buffers writes and
+// sends them to Redis when the file is closed.
+func closeOp(rec *recorder, f *os.File) error {
+	return rec.time(func() (int, error) { return 0, f.Close() })
+}
+
+// sequential writes a file of cfg.fileSize in blocks of bs, then reads it
+// back the same way.
+func sequential(cfg config, dir string, bs int) ([]*result, error) {
+	path := filepath.Join(dir, "seq.dat")
+	buf := randomBytes(bs, 1)
+
+	w := newRecorder("seqwrite/" + formatSize(bs))
+	f, err := os.Create(path)
+	if err != nil {
+		return nil, err
+	}
+	for off := int64(0); off < cfg.fileSize; off += int64(bs) {
+		n := bs
+		if rest := cfg.fileSize - off; rest < int64(n) {
+			n = int(rest)
+		}
+		if err := w.time(func() (int, error) { return f.Write(buf[:n]) }); err != nil {
+			f.Close()
+			return nil, err
+		}
+	}
+	if err := closeOp(w, f); err != nil {
+		return nil, err
+	}
+	wr := w.result()
+
+	r := newRecorder("seqread/" + formatSize(bs))
+	if f, err = os.Open(path); err != nil {
+		return nil, err
+	}
+	defer f.Close()
+	for {
+		n := 0
+		err := r.time(func() (int, error) {
+			var err error
+			n, err = f.Read(buf)
+			return n, err
+		})
+		if err == io.EOF || n == 0 {
+			break
+		}
+		if err != nil {
+			return nil, err
+		}
+	}
+	return []*result{wr, r.result()}, nil
+}
+
+// random reads and then writes blocks of bs at random aligned offsets of
+// a cfg.fileSize file, for cfg.duration each.
+func random(cfg config, dir string, bs int) ([]*result, error) {
+	blocks := cfg.fileSize / int64(bs)
+	if blocks == 0 {
+		return nil, fmt.Errorf("block size %d is larger than the file (-size)", bs)
+	}
+	path := filepath.Join(dir, "rand.dat")
+	if err := os.WriteFile(path, randomBytes(int(blocks)*bs, 2), 0o644); err != nil {
+		return nil, err
+	}
+	buf := randomBytes(bs, 3)
+	rng := rand.New(rand.NewSource(4))
+
+	f, err := os.OpenFile(path, os.O_RDWR, 0)
+	if err != nil {
+		return nil, err
+	}
+	r := newRecorder("randread/" + formatSize(bs))
+	for time.Since(r.start) < cfg.duration {
+		off := rng.Int63n(blocks) * int64(bs)
+		if err := r.time(func() (int, error) { return f.ReadAt(buf, off) }); err != nil {
+			f.Close()
+			return nil, err
+		}
+	}
+	w := newRecorder("randwrite/" + formatSize(bs))
+	for time.Since(w.start) < cfg.duration {
+		off := rng.Int63n(blocks) * int64(bs)
+		if err := w.time(func() (int, error) { return f.WriteAt(buf, off) }); err != nil {
+			f.Close()
+			return nil, err
+		}
+	}
+	if err := closeOp(w, f); err != nil {
+		return nil, err
+	}
+	return []*result{r.result(), w.result()}, nil
+}
+
+// metadata creates cfg.files empty files, stats each, then removes them:
+// the storm of small metadata calls a build or a package install makes.
+func metadata(cfg config, dir string) ([]*result, error) {
+	names := make([]string, cfg.files)
+	for i := range names {
+		names[i] = filepath.Join(dir, fmt.Sprintf("f%06d", i))
+	}
+
+	create := newRecorder("create")
+	for _, name := range names {
+		err := create.time(func() (int, error) {
+			f, err := os.OpenFile(name, os.O_CREATE|os.O_EXCL|os.O_WRONLY, 0o644)
+			if err != nil {
+				return 0, err
+			}
+			return 0, f.Close()
+		})
+		if err != nil {
+			return nil, err
+		}
+	}
+	stat := newRecorder("stat")
+	for _, name := range names {
+		if err := stat.time(func() (int, error) { _, err := os.Lstat(name); return 0, err }); err != nil {
+			return nil, err
+		}
+	}
+	unlink := newRecorder("unlink")
+	for _, name := range names {
+		if err := unlink.time(func() (int, error) { return 0, os.Remove(name) }); err != nil {
+			return nil, err
+		}
+	}
+	create.items = int64(cfg.files)
+	stat.items = int64(cfg.files)
+	unlink.items = int64(cfg.files)
+	return []*result{create.result(), stat.result(), unlink.result()}, nil
+}
+
+// listing does what ls -l does to a directory of cfg.dirEntries files:
+// read the entries, then lstat each one. An op is one whole listing,
+// repeated for cfg.duration (and at least three times).
+func listing(cfg config, dir string) ([]*result, error) {
+	for i := 0; i < cfg.dirEntries; i++ {
+		if err := os.WriteFile(filepath.Join(dir, fmt.Sprintf("entry%06d.txt", i)), nil, 0o644); err != nil {
+			return nil, err
+		}
+	}
+	rec := newRecorder("ls-l")
+	for len(rec.latency) < 3 || time.Since(rec.start) < cfg.duration {
+		err := rec.time(func() (int, error) {
+			d, err := os.Open(dir)
+			if err != nil {
+				return 0, err
+			}
+			names, err := d.Readdirnames(-1)
+			d.Close()
+			if err != nil {
+				return 0, err
+			}
+			for _, name := range names {
+				if _, err := os.Lstat(filepath.Join(dir, name)); err != nil {
+					return 0, err
+				}
+			}
+			rec.items += int64(len(names))
+			return 0, nil
+		})
+		if err != nil {
+			return nil, err
+		}
+	}
+	return []*result{rec.result()}, nil
+}
+
+// statWalk does what git status does to a checkout: walk every directory
+// and lstat every file. The tree is cfg.treeDirs directories two levels
+// deep with cfg.treeFiles small files each. An op is one whole walk.
+func statWalk(cfg config, dir string) ([]*result, error) {
+	body := randomBytes(512, 5)
+	for d := 0; d < cfg.treeDirs; d++ {
+		sub := filepath.Join(dir, fmt.Sprintf("pkg%02d", d%10), fmt.Sprintf("mod%03d", d))
+		if err := os.MkdirAll(sub, 0o755); err != nil {
+			return nil, err
+		}
+		for i := 0; i < cfg.treeFiles; i++ {
+			if err := os.WriteFile(filepath.Join(sub, fmt.Sprintf("src%03d.go", i)), body, 0o644); err != nil {
+				return nil, err
+			}
+		}
+	}
+	rec := newRecorder("stat-walk")
+	for len(rec.latency) < 3 || time.Since(rec.start) < cfg.duration {
+		err := rec.time(func() (int, error) {
+			return 0, filepath.WalkDir(dir, func(path string, d os.DirEntry, err error) error {
+				if err != nil || d.IsDir() {
+					return err
+				}
+				rec.items++
+				_, err = os.Lstat(path)
+				return err
+			})
+		})
+		if err != nil {
+			return nil, err
+		}
+	}
+	return []*result{rec.result()}, nil
+}
+
+// untar extracts an archive of cfg.tarFiles source-sized files (up to
+// 16 KB, in nested directories). An op is one archive entry.
+func untar(cfg config, dir string) ([]*result, error) {
+	archive, err := buildArchive(cfg.tarFiles)
+	if err != nil {
+		return nil, err
+	}
+	tr := tar.NewReader(bytes.NewReader(archive))
+	rec := newRecorder("untar")
+	for {
+		hdr, err := tr.Next()
+		if err == io.EOF {
+			break
+		}
+		if err != nil {
+			return nil, err
+		}
+		target := filepath.Join(dir, hdr.Name)
+		err = rec.time(func() (int, error) {
+			if hdr.Typeflag == tar.TypeDir {
+				return 0, os.Mkdir(target, os.FileMode(hdr.Mode))
+			}
+			f, err := os.OpenFile(target, os.O_CREATE|os.O_EXCL|os.O_WRONLY, os.FileMode(hdr.Mode))
+			if err != nil {
+				return 0, err
+			}
+			n, err := io.Copy(f, tr)
+			if cerr := f.Close(); err == nil {
+				err = cerr
+			}
+			return int(n), err
+		})
+		if err != nil {
+			return nil, err
+		}
+		if hdr.Typeflag != tar.TypeDir {
+			rec.items++
+		}
+	}
+	return []*result{rec.result()}, nil
+}
+
+func buildArchive(files int) ([]byte, error) {
+	rng := rand.New(rand.NewSource(6))
+	noise := randomBytes(16<<10, 7)
+	var out bytes.Buffer
+	tw := tar.NewWriter(&out)
+	dirs := map[string]bool{}
+	for i := 0; i < files; i++ {
+		parent := fmt.Sprintf("src/pkg%02d", i/100)
+		name := fmt.Sprintf("%s/file%04d.c", parent, i)
+		for _, d := range []string{"src", parent} {
+			if dirs[d] {
+				continue
+			}
+			dirs[d] = true
+			hdr := &tar.Header{Name: d + "/", Typeflag: tar.TypeDir, Mode: 0o755}
+			if err := tw.WriteHeader(hdr); err != nil {
+				return nil, err
+			}
+		}
+		size := rng.Intn(len(noise))
+		hdr := &tar.Header{Name: name, Typeflag: tar.TypeReg, Mode: 0o644, Size: int64(size)}
+		if err := tw.WriteHeader(hdr); err != nil {
+			return nil, err
+		}
+		if _, err := tw.Write(noise[:size]); err != nil {
+			return nil, err
+		}
+	}
+	if err := tw.Close(); err != nil {
+		return nil, err
+	}
+	return out.Bytes(), nil
+}
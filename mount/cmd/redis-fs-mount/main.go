@@ -27,6 +27,8 @@ func main() {
 	allowOther := flag.Bool("allow-other", false, "Allow other users to access mount")
 	foreground := flag.Bool("foreground", true, "Run in foreground")
 	debug := flag.Bool("debug", false, "Enable FUSE debug logging")
+	replicaAddrs := flag.String("replicas", "", "Comma-separated replica addresses to serve reads from")
+	maxStaleness := flag.Float64("max-staleness", 1.0, "Max age in seconds of data read from a replica")
 
 	flag.Usage = func() {
 		fmt.Fprintf(os.Stderr, "Usage: %s [flags] <redis-key> <mountpoint>\n\n", os.Args[0])
@@ -103,6 +105,23 @@ func main() {
 
 	c := client.New(rdb, redisKey)
 
+	var replicas []*redis.Client
+	for _, addr := range strings.Split(*replicaAddrs, ",") {
+		if addr = strings.TrimSpace(addr); addr == "" {
+			continue
+		}
+		replicas = append(replicas, redis.NewClient(&redis.Options{
+			Addr:     addr,
+			Password: *redisPassword,
+			DB:       *redisDB,
+			PoolSize: 16,
+		}))
+	}
+	c.EnableReplicaReads(client.ReadOptions{
+		Replicas:     replicas,
+		MaxStaleness: time.Duration(*maxStaleness * float64(time.Second)),
+	})
+
 	uid, gid := redisfs.GetOwnership()
 
 	opts := &redisfs.Options{
@@ -116,6 +135,9 @@ func main() {
 
 	log.Printf("Mounting Redis FS key %q at %s", redisKey, mountpoint)
 	log.Printf("Redis: %s (db %d)", *redisAddr, *redisDB)
+	if len(replicas) > 0 {
+		log.Printf("Reads: %d replica(s), max staleness %.3gs", len(replicas), *maxStaleness)
+	}
 
 	server, err := redisfs.Mount(mountpoint, c, opts)
 	if err != nil {
@@ -139,5 +161,9 @@ func main() {
 	server.Wait()
 	log.Printf("Unmounted.")
 
+	c.Close()
+	for _, r := range replicas {
+		r.Close()
+	}
 	rdb.Close()
 }
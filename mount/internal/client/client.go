@@ -11,8 +11,9 @@ import (
 
 // Client wraps a go-redis client with FS.* command methods.
 type Client struct {
-	rdb *redis.Client
-	key string // Redis key holding the filesystem
+	rdb   *redis.Client
+	key   string      // Redis key holding the filesystem
+	reads *readRouter // nil: all reads go to rdb
 }
 
 // New creates a new FS client for the given Redis key.
@@ -20,9 +21,49 @@ func New(rdb *redis.Client, key string) *Client {
 	return &Client{rdb: rdb, key: key}
 }
 
+// EnableReplicaReads routes read commands to replicas that are within
+// opts.MaxStaleness of the primary and have seen this client's writes.
+// Call before the client is shared; Close stops the offset poller.
+func (c *Client) EnableReplicaReads(opts ReadOptions) {
+	if len(opts.Replicas) > 0 {
+		c.reads = newReadRouter(c.rdb, opts)
+	}
+}
+
+// Close stops background replica polling. It does not close the
+// underlying go-redis clients.
+func (c *Client) Close() {
+	if c.reads != nil {
+		c.reads.close()
+	}
+}
+
+// do runs a write command on the primary.
+func (c *Client) do(ctx context.Context, cmd string, pathArgs []int, args ...interface{}) *redis.Cmd {
+	if c.reads != nil {
+		defer c.reads.noteWrite()
+	}
+	return c.exec(ctx, c.rdb, cmd, pathArgs, args...)
+}
+
+// read runs a read command on a fresh replica if there is one, falling
+// back to the primary when the replica cannot be reached.
+func (c *Client) read(ctx context.Context, cmd string, pathArgs []int, args ...interface{}) *redis.Cmd {
+	if c.reads == nil {
+		return c.exec(ctx, c.rdb, cmd, pathArgs, args...)
+	}
+	rdb := c.reads.pick()
+	res := c.exec(ctx, rdb, cmd, pathArgs, append([]interface{}(nil), args...)...)
+	var rerr redis.Error
+	if rdb != c.rdb && res.Err() != nil && !errors.As(res.Err(), &rerr) {
+		return c.exec(ctx, c.rdb, cmd, pathArgs, args...)
+	}
+	return res
+}
+
 // Stat returns metadata for a path. Returns nil, nil if path does not exist.
 func (c *Client) Stat(ctx context.Context, path string) (*StatResult, error) {
-	res, err := c.rdb.Do(ctx, "FS.STAT", c.key, path).Slice()
+	res, err := c.read(ctx, "FS.STAT", pathFirst, path).Slice()
 	if err != nil {
 		if errors.Is(err, redis.Nil) {
 			return nil, nil // path does not exist
@@ -34,7 +75,7 @@ func (c *Client) Stat(ctx context.Context, path string) (*StatResult, error) {
 
 // Cat returns the file content at path.
 func (c *Client) Cat(ctx context.Context, path string) ([]byte, error) {
-	val, err := c.rdb.Do(ctx, "FS.CAT", c.key, path).Result()
+	val, err := c.read(ctx, "FS.CAT", pathFirst, path).Result()
 	if err != nil {
 		return nil, err
 	}
@@ -50,82 +91,109 @@ func (c *Client) Cat(ctx context.Context, path string) ([]byte, error) {
 
 // Echo writes content to a file (creates or overwrites).
 func (c *Client) Echo(ctx context.Context, path string, data []byte) error {
-	return c.rdb.Do(ctx, "FS.ECHO", c.key, path, data).Err()
+	return c.do(ctx, "FS.ECHO", pathFirst, path, data).Err()
 }
 
 // EchoAppend appends content to a file.
 func (c *Client) EchoAppend(ctx context.Context, path string, data []byte) error {
-	return c.rdb.Do(ctx, "FS.ECHO", c.key, path, data, "APPEND").Err()
+	return c.do(ctx, "FS.ECHO", pathFirst, path, data, "APPEND").Err()
 }
 
 // Touch creates an empty file.
 func (c *Client) Touch(ctx context.Context, path string) error {
-	return c.rdb.Do(ctx, "FS.TOUCH", c.key, path).Err()
+	return c.do(ctx, "FS.TOUCH", pathFirst, path).Err()
 }
 
 // Mkdir creates a directory (with PARENTS to auto-create ancestors).
 func (c *Client) Mkdir(ctx context.Context, path string) error {
-	return c.rdb.Do(ctx, "FS.MKDIR", c.key, path, "PARENTS").Err()
+	return c.do(ctx, "FS.MKDIR", pathFirst, path, "PARENTS").Err()
 }
 
 // Rm removes a file, directory, or symlink.
 func (c *Client) Rm(ctx context.Context, path string) error {
-	return c.rdb.Do(ctx, "FS.RM", c.key, path).Err()
+	return c.do(ctx, "FS.RM", pathFirst, path).Err()
 }
 
 // Ls returns the children of a directory.
 func (c *Client) Ls(ctx context.Context, path string) ([]string, error) {
-	return c.rdb.Do(ctx, "FS.LS", c.key, path).StringSlice()
+	return c.read(ctx, "FS.LS", pathFirst, path).StringSlice()
 }
 
 // LsLong returns detailed directory listing.
 func (c *Client) LsLong(ctx context.Context, path string) ([]LsEntry, error) {
-	res, err := c.rdb.Do(ctx, "FS.LS", c.key, path, "LONG").Slice()
+	res, err := c.read(ctx, "FS.LS", pathFirst, path, "LONG").Slice()
 	if err != nil {
 		return nil, err
 	}
 	return parseLsLong(res)
 }
 
+// LsLongPage returns up to count entries of a detailed listing, in name
+// order, starting at cursor ("" for the first page). The returned cursor
+// is "" after the last page.
+func (c *Client) LsLongPage(ctx context.Context, path, cursor string, count int) ([]LsEntry, string, error) {
+	args := []interface{}{path, "LONG", "COUNT", count}
+	if cursor != "" {
+		args = append(args, "CURSOR", cursor)
+	}
+	res, err := c.read(ctx, "FS.LS", pathFirst, args...).Slice()
+	if err != nil {
+		return nil, "", err
+	}
+	if len(res) != 2 {
+		return nil, "", fmt.Errorf("unexpected LS page length: %d", len(res))
+	}
+	items, _ := res[0].([]interface{})
+	entries, err := parseLsLong(items)
+	if err != nil {
+		return nil, "", err
+	}
+	next := toString(res[1])
+	if next == "0" {
+		next = ""
+	}
+	return entries, next, nil
+}
+
 // Mv renames/moves a path.
 func (c *Client) Mv(ctx context.Context, src, dst string) error {
-	return c.rdb.Do(ctx, "FS.MV", c.key, src, dst).Err()
+	return c.do(ctx, "FS.MV", pathBoth, src, dst).Err()
 }
 
 // Ln creates a symbolic link.
 func (c *Client) Ln(ctx context.Context, target, linkpath string) error {
-	return c.rdb.Do(ctx, "FS.LN", c.key, target, linkpath).Err()
+	return c.do(ctx, "FS.LN", pathLink, target, linkpath).Err()
 }
 
 // Readlink returns the target of a symbolic link.
 func (c *Client) Readlink(ctx context.Context, path string) (string, error) {
-	return c.rdb.Do(ctx, "FS.READLINK", c.key, path).Text()
+	return c.read(ctx, "FS.READLINK", pathFirst, path).Text()
 }
 
 // Chmod changes file permissions.
 func (c *Client) Chmod(ctx context.Context, path string, mode uint32) error {
 	modeStr := fmt.Sprintf("%04o", mode)
-	return c.rdb.Do(ctx, "FS.CHMOD", c.key, path, modeStr).Err()
+	return c.do(ctx, "FS.CHMOD", pathFirst, path, modeStr).Err()
 }
 
 // Chown changes file owner and group.
 func (c *Client) Chown(ctx context.Context, path string, uid, gid uint32) error {
-	return c.rdb.Do(ctx, "FS.CHOWN", c.key, path, uid, gid).Err()
+	return c.do(ctx, "FS.CHOWN", pathFirst, path, uid, gid).Err()
 }
 
 // Truncate truncates or extends a file to the given length.
 func (c *Client) Truncate(ctx context.Context, path string, size int64) error {
-	return c.rdb.Do(ctx, "FS.TRUNCATE", c.key, path, size).Err()
+	return c.do(ctx, "FS.TRUNCATE", pathFirst, path, size).Err()
 }
 
 // Utimens sets access and modification times (milliseconds). -1 means don't change.
 func (c *Client) Utimens(ctx context.Context, path string, atimeMs, mtimeMs int64) error {
-	return c.rdb.Do(ctx, "FS.UTIMENS", c.key, path, atimeMs, mtimeMs).Err()
+	return c.do(ctx, "FS.UTIMENS", pathFirst, path, atimeMs, mtimeMs).Err()
 }
 
 // Info returns filesystem-level statistics.
 func (c *Client) Info(ctx context.Context) (*InfoResult, error) {
-	res, err := c.rdb.Do(ctx, "FS.INFO", c.key).Slice()
+	res, err := c.read(ctx, "FS.INFO", nil).Slice()
 	if err != nil {
 		return nil, err
 	}
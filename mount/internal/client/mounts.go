@@ -0,0 +1,64 @@
+package client
+
+import (
+	"context"
+	"path"
+	"strings"
+
+	"github.com/redis/go-redis/v9"
+)
+
+// maxRedirects bounds how many FSMOVED hops a single call may follow.
+const maxRedirects = 8
+
+// Positions of path arguments (after the key) for do. Most commands take
+// one path first; MV takes two; LN's first argument is the link target,
+// which is stored verbatim and must not be rebased.
+var (
+	pathFirst = []int{0}
+	pathBoth  = []int{0, 1}
+	pathLink  = []int{1}
+)
+
+// exec runs an FS.* command on rdb against the key that owns its paths.
+// When a path lies under a mount the server answers "FSMOVED <key>
+// <mount>"; exec retries on that key with the path arguments rebased
+// onto its root.
+func (c *Client) exec(ctx context.Context, rdb *redis.Client, cmd string, pathArgs []int, args ...interface{}) *redis.Cmd {
+	key := c.key
+	for hop := 0; ; hop++ {
+		res := rdb.Do(ctx, append([]interface{}{cmd, key}, args...)...)
+		target, mount, ok := parseMoved(res.Err())
+		if !ok || hop == maxRedirects {
+			return res
+		}
+		key = target
+		for _, i := range pathArgs {
+			if p, isStr := args[i].(string); isStr {
+				args[i] = rebase(p, mount)
+			}
+		}
+	}
+}
+
+// parseMoved extracts the target key and mount point from an FSMOVED error.
+func parseMoved(err error) (target, mount string, ok bool) {
+	if err == nil {
+		return "", "", false
+	}
+	fields := strings.SplitN(err.Error(), " ", 3)
+	if len(fields) != 3 || fields[0] != "FSMOVED" {
+		return "", "", false
+	}
+	return fields[1], fields[2], true
+}
+
+// rebase rewrites p, which lies at or under mount, relative to the
+// mounted key's root.
+func rebase(p, mount string) string {
+	rel := strings.TrimPrefix(path.Clean("/"+p), mount)
+	if rel == "" {
+		return "/"
+	}
+	return rel
+}
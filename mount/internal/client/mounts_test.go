@@ -0,0 +1,37 @@
+package client
+
+import (
+	"errors"
+	"testing"
+)
+
+func TestParseMoved(t *testing.T) {
+	target, mount, ok := parseMoved(errors.New("FSMOVED ws:shard1 /src/lib"))
+	if !ok || target != "ws:shard1" || mount != "/src/lib" {
+		t.Fatalf("parseMoved = %q, %q, %v", target, mount, ok)
+	}
+	for _, msg := range []string{"ERR not a file", "FSMOVED onlykey", "MOVED 1 host:6379"} {
+		if _, _, ok := parseMoved(errors.New(msg)); ok {
+			t.Fatalf("parseMoved(%q) matched", msg)
+		}
+	}
+	if _, _, ok := parseMoved(nil); ok {
+		t.Fatal("parseMoved(nil) matched")
+	}
+}
+
+func TestRebase(t *testing.T) {
+	cases := []struct {
+		path, mount, want string
+	}{
+		{"/src/lib", "/src/lib", "/"},
+		{"/src/lib/", "/src/lib", "/"},
+		{"/src/lib/a/b.go", "/src/lib", "/a/b.go"},
+		{"src//lib/./a", "/src/lib", "/a"},
+	}
+	for _, tc := range cases {
+		if got := rebase(tc.path, tc.mount); got != tc.want {
+			t.Fatalf("rebase(%q, %q) = %q, want %q", tc.path, tc.mount, got, tc.want)
+		}
+	}
+}
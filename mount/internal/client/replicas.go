@@ -0,0 +1,197 @@
+package client
+
+import (
+	"context"
+	"strconv"
+	"strings"
+	"sync"
+	"time"
+
+	"github.com/redis/go-redis/v9"
+)
+
+// maxOffsetSamples bounds the history of primary replication offsets
+// used to work out how far behind each replica is.
+const maxOffsetSamples = 64
+
+// ReadOptions configures replica read routing.
+type ReadOptions struct {
+	// Replicas serve FS.STAT, FS.CAT, FS.LS, FS.READLINK and FS.INFO
+	// when they are fresh enough. Writes always go to the primary.
+	Replicas []*redis.Client
+	// MaxStaleness bounds how old data served by a replica may be: a
+	// replica is used only if it has applied everything the primary had
+	// at some point within this window.
+	MaxStaleness time.Duration
+	// PollInterval is how often replication offsets are sampled.
+	// Defaults to a quarter of MaxStaleness.
+	PollInterval time.Duration
+}
+
+type offsetSample struct {
+	offset int64
+	at     time.Time
+}
+
+type replicaState struct {
+	rdb        *redis.Client
+	up         bool
+	offset     int64
+	caughtUpAt time.Time // time of the newest primary sample this replica has reached
+}
+
+// readRouter picks the connection for read commands. Freshness comes
+// from replication offsets: the primary's master_repl_offset is sampled
+// on every poll, and a replica that has reached the offset sampled at
+// time t holds every write made before t.
+//
+// Read-your-writes: every write bumps writeSeq. The next primary sample
+// taken after it becomes the fence, and until a replica has reached the
+// fence all reads go to the primary.
+type readRouter struct {
+	primary  *redis.Client
+	replicas []*replicaState
+	opts     ReadOptions
+
+	mu        sync.Mutex
+	samples   []offsetSample
+	writeSeq  uint64
+	fencedSeq uint64
+	fence     int64
+	next      int
+
+	stop chan struct{}
+	done chan struct{}
+}
+
+func newReadRouter(primary *redis.Client, opts ReadOptions) *readRouter {
+	if opts.PollInterval <= 0 {
+		opts.PollInterval = opts.MaxStaleness / 4
+	}
+	if opts.PollInterval < 10*time.Millisecond {
+		opts.PollInterval = 10 * time.Millisecond
+	}
+	r := &readRouter{
+		primary: primary,
+		opts:    opts,
+		stop:    make(chan struct{}),
+		done:    make(chan struct{}),
+	}
+	for _, rdb := range opts.Replicas {
+		r.replicas = append(r.replicas, &replicaState{rdb: rdb})
+	}
+	go r.run()
+	return r
+}
+
+func (r *readRouter) run() {
+	defer close(r.done)
+	t := time.NewTicker(r.opts.PollInterval)
+	defer t.Stop()
+	for {
+		r.poll(context.Background())
+		select {
+		case <-r.stop:
+			return
+		case <-t.C:
+		}
+	}
+}
+
+func (r *readRouter) close() {
+	close(r.stop)
+	<-r.done
+}
+
+// noteWrite records that this session wrote to the primary.
+func (r *readRouter) noteWrite() {
+	r.mu.Lock()
+	r.writeSeq++
+	r.mu.Unlock()
+}
+
+// poll samples the primary's offset, then each replica's.
+func (r *readRouter) poll(ctx context.Context) {
+	ctx, cancel := context.WithTimeout(ctx, r.opts.PollInterval)
+	defer cancel()
+
+	r.mu.Lock()
+	seq := r.writeSeq
+	r.mu.Unlock()
+
+	info, err := r.primary.Info(ctx, "replication").Result()
+	if err != nil {
+		return
+	}
+	poff, ok := infoInt(info, "master_repl_offset")
+	if !ok {
+		return
+	}
+	now := time.Now()
+
+	r.mu.Lock()
+	if seq > r.fencedSeq {
+		r.fence, r.fencedSeq = poff, seq
+	}
+	r.samples = append(r.samples, offsetSample{poff, now})
+	if len(r.samples) > maxOffsetSamples {
+		r.samples = r.samples[len(r.samples)-maxOffsetSamples:]
+	}
+	r.mu.Unlock()
+
+	for _, rs := range r.replicas {
+		info, err := rs.rdb.Info(ctx, "replication").Result()
+		off, ok := infoInt(info, "slave_repl_offset")
+		up := err == nil && ok && infoField(info, "master_link_status") == "up"
+		r.mu.Lock()
+		rs.up, rs.offset = up, off
+		if up {
+			rs.caughtUpAt = caughtUpAt(r.samples, off)
+		}
+		r.mu.Unlock()
+	}
+}
+
+// pick returns a fresh replica, round-robin, or the primary.
+func (r *readRouter) pick() *redis.Client {
+	r.mu.Lock()
+	defer r.mu.Unlock()
+	if r.fencedSeq != r.writeSeq {
+		return r.primary // a write is not fenced yet
+	}
+	now := time.Now()
+	for i := range r.replicas {
+		rs := r.replicas[(r.next+i)%len(r.replicas)]
+		if rs.up && rs.offset >= r.fence && !rs.caughtUpAt.IsZero() &&
+			now.Sub(rs.caughtUpAt) <= r.opts.MaxStaleness {
+			r.next = (r.next + i + 1) % len(r.replicas)
+			return rs.rdb
+		}
+	}
+	return r.primary
+}
+
+// caughtUpAt returns the time of the newest sample at or below offset.
+func caughtUpAt(samples []offsetSample, offset int64) time.Time {
+	for i := len(samples) - 1; i >= 0; i-- {
+		if samples[i].offset <= offset {
+			return samples[i].at
+		}
+	}
+	return time.Time{}
+}
+
+// infoField returns the value of field in an INFO reply.
+func infoField(info, field string) string {
+	for _, line := range strings.Split(info, "\n") {
+		if v, ok := strings.CutPrefix(strings.TrimRight(line, "\r"), field+":"); ok {
+			return v
+		}
+	}
+	return ""
+}
+
+func infoInt(info, field string) (int64, bool) {
+	n, err := strconv.ParseInt(infoField(info, field), 10, 64)
+	return n, err == nil
+}
@@ -0,0 +1,80 @@
+package client
+
+import (
+	"testing"
+	"time"
+
+	"github.com/redis/go-redis/v9"
+)
+
+func TestInfoField(t *testing.T) {
+	info := "# Replication\r\nrole:slave\r\nmaster_link_status:up\r\nslave_repl_offset:4242\r\n"
+	if got := infoField(info, "master_link_status"); got != "up" {
+		t.Fatalf("master_link_status = %q", got)
+	}
+	if n, ok := infoInt(info, "slave_repl_offset"); !ok || n != 4242 {
+		t.Fatalf("slave_repl_offset = %d, %v", n, ok)
+	}
+	if _, ok := infoInt(info, "master_repl_offset"); ok {
+		t.Fatal("missing field parsed")
+	}
+}
+
+func TestCaughtUpAt(t *testing.T) {
+	t0 := time.Unix(1000, 0)
+	samples := []offsetSample{
+		{100, t0},
+		{200, t0.Add(time.Second)},
+		{300, t0.Add(2 * time.Second)},
+	}
+	if got := caughtUpAt(samples, 250); !got.Equal(t0.Add(time.Second)) {
+		t.Fatalf("caughtUpAt(250) = %v", got)
+	}
+	if got := caughtUpAt(samples, 300); !got.Equal(t0.Add(2 * time.Second)) {
+		t.Fatalf("caughtUpAt(300) = %v", got)
+	}
+	if got := caughtUpAt(samples, 50); !got.IsZero() {
+		t.Fatalf("caughtUpAt(50) = %v", got)
+	}
+}
+
+func TestPick(t *testing.T) {
+	primary := redis.NewClient(&redis.Options{Addr: "primary:6379"})
+	replica := redis.NewClient(&redis.Options{Addr: "replica:6379"})
+	rs := &replicaState{rdb: replica, up: true, offset: 500, caughtUpAt: time.Now()}
+	r := &readRouter{
+		primary:  primary,
+		replicas: []*replicaState{rs},
+		opts:     ReadOptions{MaxStaleness: time.Second},
+	}
+
+	if r.pick() != replica {
+		t.Fatal("fresh replica not used")
+	}
+
+	// A write is not fenced until the next primary sample.
+	r.noteWrite()
+	if r.pick() != primary {
+		t.Fatal("unfenced write read from replica")
+	}
+
+	// Fenced beyond the replica's offset: still the primary.
+	r.fence, r.fencedSeq = 600, r.writeSeq
+	if r.pick() != primary {
+		t.Fatal("replica behind fence used")
+	}
+	rs.offset = 600
+	if r.pick() != replica {
+		t.Fatal("caught-up replica not used")
+	}
+
+	// Too stale, or link down: the primary.
+	rs.caughtUpAt = time.Now().Add(-2 * time.Second)
+	if r.pick() != primary {
+		t.Fatal("stale replica used")
+	}
+	rs.caughtUpAt, rs.up = time.Now(), false
+	if r.pick() != primary {
+		t.Fatal("disconnected replica used")
+	}
+}
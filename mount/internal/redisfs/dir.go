@@ -41,6 +41,9 @@ func (n *FSNode) Lookup(ctx context.Context, name string, out *fuse.EntryOut) (*
 	return node, 0
 }
 
+// readdirPageSize is how many entries Readdir fetches per FS.LS call.
+const readdirPageSize = 1000
+
 // Readdir implements fs.NodeReaddirer.
 func (n *FSNode) Readdir(ctx context.Context) (fs.DirStream, syscall.Errno) {
 	// Check dir cache.
@@ -48,12 +51,33 @@ func (n *FSNode) Readdir(ctx context.Context) (fs.DirStream, syscall.Errno) {
 		return fs.NewListDirStream(cached.([]fuse.DirEntry)), 0
 	}
 
-	entries, err := n.client.LsLong(ctx, n.fsPath)
-	if err != nil {
-		return nil, mapError(err)
+	s := &dirStream{node: n}
+	if errno := s.fetch(ctx); errno != 0 {
+		return nil, errno
 	}
+	return s, 0
+}
 
-	result := make([]fuse.DirEntry, 0, len(entries))
+// dirStream lists a directory one FS.LS page at a time, so a huge
+// directory is neither fetched nor held in one piece before the kernel
+// sees its first entries. A listing read to the end is cached.
+type dirStream struct {
+	node   *FSNode
+	page   []fuse.DirEntry
+	seen   []fuse.DirEntry // everything returned so far, for the dir cache
+	cursor string
+	done   bool
+	errno  syscall.Errno
+}
+
+// fetch reads the next page into s.page.
+func (s *dirStream) fetch(ctx context.Context) syscall.Errno {
+	n := s.node
+	entries, next, err := n.client.LsLongPage(ctx, n.fsPath, s.cursor, readdirPageSize)
+	if err != nil {
+		return mapError(err)
+	}
+	s.page = make([]fuse.DirEntry, 0, len(entries))
 	for _, e := range entries {
 		var mode uint32
 		switch e.Type {
@@ -64,7 +88,7 @@ func (n *FSNode) Readdir(ctx context.Context) (fs.DirStream, syscall.Errno) {
 		case "symlink":
 			mode = syscall.S_IFLNK
 		}
-		result = append(result, fuse.DirEntry{
+		s.page = append(s.page, fuse.DirEntry{
 			Name: e.Name,
 			Mode: mode,
 		})
@@ -76,11 +100,36 @@ func (n *FSNode) Readdir(ctx context.Context) (fs.DirStream, syscall.Errno) {
 		}
 		n.attrCache.Set(childPath, lsEntryToAttr(&e, n.opts.UID, n.opts.GID))
 	}
+	s.seen = append(s.seen, s.page...)
+	s.cursor = next
+	if next == "" {
+		s.done = true
+		n.dirCache.Set(n.fsPath, s.seen)
+	}
+	return 0
+}
+
+// HasNext implements fs.DirStream.
+func (s *dirStream) HasNext() bool {
+	for len(s.page) == 0 && !s.done && s.errno == 0 {
+		s.errno = s.fetch(context.Background())
+	}
+	return len(s.page) > 0 || s.errno != 0
+}
 
-	n.dirCache.Set(n.fsPath, result)
-	return fs.NewListDirStream(result), 0
+// Next implements fs.DirStream.
+func (s *dirStream) Next() (fuse.DirEntry, syscall.Errno) {
+	if s.errno != 0 {
+		return fuse.DirEntry{}, s.errno
+	}
+	e := s.page[0]
+	s.page = s.page[1:]
+	return e, 0
 }
 
+// Close implements fs.DirStream.
+func (s *dirStream) Close() {}
+
 // lsEntryToAttr converts an LsEntry to fuse.Attr (partial — only has mtime, mode, size).
 func lsEntryToAttr(e *client.LsEntry, uid, gid uint32) fuse.Attr {
 	var mode uint32
@@ -184,6 +233,7 @@ func (n *FSNode) Rename(ctx context.Context, name string, newParent fs.InodeEmbe
 // Ensure interfaces are satisfied.
 var _ fs.NodeLookuper = (*FSNode)(nil)
 var _ fs.NodeReaddirer = (*FSNode)(nil)
+var _ fs.DirStream = (*dirStream)(nil)
 var _ fs.NodeMkdirer = (*FSNode)(nil)
 var _ fs.NodeRmdirer = (*FSNode)(nil)
 var _ fs.NodeRenamer = (*FSNode)(nil)
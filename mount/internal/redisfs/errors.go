@@ -29,6 +29,11 @@ func mapError(err error) syscall.Errno {
 		return syscall.ENOTEMPTY
 	case strings.Contains(msg, "too many levels of symbolic links"):
 		return syscall.ELOOP
+	case strings.Contains(msg, "cross-key operation"):
+		return syscall.EXDEV
+	case strings.Contains(msg, "contains a mount point"),
+		strings.Contains(msg, "FSMOVED"):
+		return syscall.EBUSY
 	case strings.Contains(msg, "path depth exceeds limit"),
 		strings.Contains(msg, "mode must be"),
 		strings.Contains(msg, "uid out of range"),
@@ -21,6 +21,8 @@ func TestMapError(t *testing.T) {
 		{"ERR mode must be an octal value between 0000 and 07777", syscall.EINVAL},
 		{"ERR uid out of range", syscall.EINVAL},
 		{"ERR cannot move a directory into its own subtree", syscall.EINVAL},
+		{"ERR cross-key operation — paths are on different mounts", syscall.EXDEV},
+		{"ERR subtree contains a mount point — unmount it first", syscall.EBUSY},
 	}
 
 	for _, tc := range cases {
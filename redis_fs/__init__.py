@@ -1,21 +1,30 @@
 """Redis-FS: Filesystem storage in Redis for agents."""
 
-from redis_fs.client import RedisFS
+from redis_fs.client import Batch, BatchResult, RedisFS
+from redis_fs.async_client import AsyncBatch, AsyncRedisFS
 from redis_fs.exceptions import (
     RedisFSError,
     NotAFileError,
     NotADirectoryError,
     PathNotFoundError,
     SymlinkLoopError,
+    VersionMismatchError,
+    CrossKeyError,
 )
 
 __version__ = "0.1.0"
 __all__ = [
     "RedisFS",
+    "Batch",
+    "BatchResult",
+    "AsyncRedisFS",
+    "AsyncBatch",
     "RedisFSError",
     "NotAFileError",
     "NotADirectoryError",
     "PathNotFoundError",
     "SymlinkLoopError",
+    "VersionMismatchError",
+    "CrossKeyError",
 ]
 
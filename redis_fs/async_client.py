@@ -0,0 +1,352 @@
+"""asyncio Redis-FS client."""
+
+from typing import IO, Any, Callable, Dict, List, Optional, Tuple, Union
+
+from redis.asyncio import Redis
+from redis.exceptions import ConnectionError, RedisError, ResponseError, TimeoutError
+
+from redis_fs.client import Batch, RedisFS
+from redis_fs.exceptions import RedisFSError
+from redis_fs.replicas import AsyncReadRouter
+
+
+class AsyncRedisFS(RedisFS):
+    """RedisFS for asyncio, on a ``redis.asyncio.Redis`` connection pool.
+
+    Same methods, arguments, results and exceptions as RedisFS, but every
+    call is a coroutine. One instance can be shared by any number of
+    tasks; each command borrows a connection from the pool for the
+    duration of its round trip.
+
+    Args:
+        redis: redis.asyncio.Redis client (its pool bounds concurrency).
+        key: Redis key name for this filesystem volume.
+        replicas: Optional redis.asyncio replica connections for reads.
+        max_staleness: Max age in seconds of data read from a replica.
+
+    Example:
+        >>> from redis.asyncio import Redis
+        >>> fs = AsyncRedisFS(Redis(max_connections=64), "myproject")
+        >>> await fs.write("/notes/todo.md", "# TODO")
+        >>> await fs.read("/notes/todo.md")
+        '# TODO'
+    """
+
+    def __init__(
+        self,
+        redis: Redis,
+        key: str,
+        replicas: Optional[List[Redis]] = None,
+        max_staleness: float = 1.0,
+    ):
+        self._redis = redis
+        self._key = key
+        self._reads = AsyncReadRouter(redis, replicas, max_staleness) if replicas else None
+
+    def batch(self) -> "AsyncBatch":
+        """Queue calls and send them in one pipeline: ``async with fs.batch() as b:``."""
+        return AsyncBatch(self)
+
+    # The public methods are inherited: each returns self._run(...) or
+    # self._gather(...), which here are coroutines.
+
+    async def _call(self, cmd: str, *args) -> Any:
+        if self._reads is None:
+            return await self._redis.execute_command(f"FS.{cmd}", *args)
+        if cmd not in self._READ_COMMANDS:
+            try:
+                return await self._redis.execute_command(f"FS.{cmd}", *args)
+            finally:
+                self._reads.note_write()
+        conn = await self._reads.pick()
+        try:
+            return await conn.execute_command(f"FS.{cmd}", *args)
+        except (ConnectionError, TimeoutError):
+            if conn is self._redis:
+                raise
+            return await self._redis.execute_command(f"FS.{cmd}", *args)
+
+    async def _send(
+        self, cmd: str, *args, key: Optional[str] = None, prefix: str = ""
+    ) -> Tuple[str, str, list, Any]:
+        key = key or self._key
+        args = list(args)
+        for _ in range(self.MAX_REDIRECTS + 1):
+            try:
+                return key, prefix, args, await self._call(cmd, key, *args)
+            except ResponseError as e:
+                if not str(e).startswith("FSMOVED "):
+                    raise
+                key, mount = self._redirect(cmd, args, e)
+                prefix += mount
+        raise RedisFSError(f"too many FSMOVED redirects for FS.{cmd}")
+
+    async def _pipe(self, calls: List[Tuple[str, str, tuple]]) -> List[Any]:
+        reads = all(cmd in self._READ_COMMANDS for cmd, _, _ in calls)
+        conn = await self._reads.pick() if self._reads is not None and reads else self._redis
+        try:
+            return await self._pipeline(conn, calls)
+        except (ConnectionError, TimeoutError):
+            if conn is self._redis:
+                raise
+            return await self._pipeline(self._redis, calls)
+        finally:
+            if self._reads is not None and not reads:
+                self._reads.note_write()
+
+    @staticmethod
+    async def _pipeline(conn: Redis, calls: List[Tuple[str, str, tuple]]) -> List[Any]:
+        pipe = conn.pipeline(transaction=False)
+        for cmd, key, args in calls:
+            pipe.execute_command(f"FS.{cmd}", key, *args)
+        return await pipe.execute(raise_on_error=False)
+
+    async def _fan_out(self, cmd: str, path: str, *args) -> List[Tuple[str, Any]]:
+        replies = []
+        pending = [(self._key, "", path)]
+        while pending:
+            step = await self._fan_out_step(cmd, *pending.pop(), args)
+            if step is None:
+                continue
+            key, prefix, p, result, below = step
+            replies.append((prefix, result))
+            for mount, target in below:
+                pending.append((target, prefix + mount, "/"))
+        return replies
+
+    async def _fan_out_step(
+        self, cmd: str, key: str, prefix: str, path: str, args: tuple
+    ) -> Optional[Tuple[str, str, str, Any, List[Tuple[str, str]]]]:
+        result, table = await self._pipe([(cmd, key, (path, *args)), ("MOUNTS", key, ())])
+        sent = [path]
+        if self._moved(result):
+            key, mount = self._redirect(cmd, sent, result)
+            try:
+                key, prefix, sent, result = await self._send(
+                    cmd, sent[0], *args, key=key, prefix=prefix + mount
+                )
+            except ResponseError as e:
+                self._translate(e)
+                return None
+            table = await self._call("MOUNTS", key)
+        elif isinstance(result, ResponseError):
+            self._translate(result)
+            return None
+        return key, prefix, sent[0], result, self._mounted_below(sent[0], self._pairs(table))
+
+    async def _fan_out_page(
+        self, cmd: str, path: str, *args, limit: int, cursor: Optional[str]
+    ) -> Tuple[List[Tuple[str, Any]], Optional[str]]:
+        start, _, resume = (cursor or "0:").partition(":")
+        try:
+            start = int(start)
+        except ValueError:
+            raise RedisFSError(f"invalid cursor: {cursor!r}") from None
+        replies = []
+        pending = [(self._key, "", path)]
+        index = -1
+        while pending:
+            index += 1
+            page_args: list = [*args, "LIMIT", limit]
+            if index == start and resume:
+                page_args.extend(["CURSOR", resume])
+            query = ("TEST", ()) if index < start else (cmd, tuple(page_args))
+            step = await self._fan_out_step(query[0], *pending.pop(), query[1])
+            if step is None:
+                continue
+            key, prefix, p, result, below = step
+            for mount, target in sorted(below, reverse=True):
+                pending.append((target, prefix + mount, "/"))
+            if index < start:
+                continue
+            results, token = result
+            replies.append((prefix, results))
+            limit -= len(results)
+            token = self._text(token)
+            if token != "0":
+                return replies, f"{index}:{token}"
+            if limit <= 0:
+                return replies, f"{index + 1}:" if pending else None
+        return replies, None
+
+    async def _execute(self, cmd: str, *args) -> Any:
+        try:
+            return (await self._send(cmd, *args))[3]
+        except ResponseError as e:
+            return self._translate(e)
+
+    async def _run(self, cmd: str, *args, parse: Optional[Callable[[Any], Any]] = None) -> Any:
+        result = await self._execute(cmd, *args)
+        return parse(result) if parse else result
+
+    async def _gather(self, cmd: str, path: str, *args, parse: Callable[[Any], Any]) -> Any:
+        return parse(await self._fan_out(cmd, path, *args))
+
+    async def _paged(
+        self, cmd: str, path: str, *args, limit: int, cursor: Optional[str],
+        parse: Callable[[Any], Any],
+    ) -> Tuple[Any, Optional[str]]:
+        replies, token = await self._fan_out_page(cmd, path, *args, limit=limit, cursor=cursor)
+        return parse(replies), token
+
+    # === Large files ===
+
+    async def upload(
+        self,
+        path: str,
+        source: Union[bytes, str, IO[bytes]],
+        chunk_size: Optional[int] = None,
+        if_version: Optional[int] = None,
+        timeout_ms: Optional[int] = None,
+    ) -> int:
+        """Write a file of any size, one chunk at a time (see RedisFS.upload)."""
+        chunk_size = chunk_size or self.CHUNK_SIZE
+        args: list = [path]
+        if timeout_ms is not None:
+            args.extend(["TIMEOUT", timeout_ms])
+        try:
+            key, _, _, handle = await self._send("OPEN", *args)
+        except ResponseError as e:
+            self._translate(e)
+            raise
+        size = 0
+        try:
+            for chunk in self._chunks(source, chunk_size):
+                size = await self._call("WRITECHUNK", key, handle, chunk, "OFFSET", size)
+            await self._call("COMMIT", key, handle, *self._if_version([], if_version))
+        except BaseException as e:
+            try:
+                await self._call("ABORT", key, handle)
+            except RedisError:
+                pass  # the server times it out
+            if isinstance(e, ResponseError):
+                self._translate(e)
+            raise
+        return size
+
+    async def download(
+        self,
+        path: str,
+        dest: Optional[IO[bytes]] = None,
+        chunk_size: Optional[int] = None,
+    ) -> Union[bytes, int, None]:
+        """Read a file of any size, one chunk at a time (see RedisFS.download)."""
+        chunk_size = chunk_size or self.CHUNK_SIZE
+        start = dest.tell() if dest is not None and dest.seekable() else None
+        for attempt in range(self.DOWNLOAD_RETRIES + 1):
+            if attempt and dest is not None:
+                if start is None:
+                    break
+                dest.seek(start)
+                dest.truncate()
+            try:
+                key, _, sent, reply = await self._send(
+                    "READCHUNK", path, 0, chunk_size, "WITHVERSION"
+                )
+            except ResponseError as e:
+                return self._translate(e)
+            if reply is None:
+                return None
+            chunk, version = reply
+            parts: List[bytes] = []
+            offset = 0
+            while True:
+                if dest is None:
+                    parts.append(chunk)
+                else:
+                    dest.write(chunk)
+                offset += len(chunk)
+                if len(chunk) < chunk_size:
+                    return b"".join(parts) if dest is None else offset
+                reply = await self._call(
+                    "READCHUNK", key, sent[0], offset, chunk_size, "WITHVERSION"
+                )
+                if reply is None or reply[1] != version:
+                    break  # changed underneath us: start over
+                chunk = reply[0]
+        raise RedisFSError(f"{path} changed during download")
+
+    async def analyze(self, path: str = "/", count: Optional[int] = None) -> Optional[Dict[str, Any]]:
+        """Data-shape and memory statistics for a subtree (see RedisFS.analyze)."""
+        page = ["COUNT", count] if count else []
+        try:
+            key, _, sent, reply = await self._send("ANALYZE", path, *page)
+        except ResponseError as e:
+            return self._translate(e)
+        merged: Dict[str, Any] = {}
+        while True:
+            stats, cursor = reply
+            self._merge_analysis(merged, stats)
+            cursor = self._text(cursor)
+            if cursor == "0":
+                return self._finish_analysis(merged)
+            reply = await self._call("ANALYZE", key, sent[0], *page, "CURSOR", cursor)
+
+
+    def open(self, *args, **kwargs):
+        raise TypeError(
+            "open() returns a blocking stream; use upload() and download() "
+            "with AsyncRedisFS"
+        )
+
+
+class AsyncBatch(Batch, AsyncRedisFS):
+    """Batch for AsyncRedisFS: ``async with fs.batch() as b:``.
+
+    Calls queue exactly as in Batch; execute() is a coroutine.
+    """
+
+    async def __aenter__(self) -> "AsyncBatch":
+        return self
+
+    async def __aexit__(self, exc_type, exc, tb) -> None:
+        if exc_type is None:
+            await self.execute()
+        else:
+            self._queued = []
+
+    def __enter__(self):
+        raise TypeError("use 'async with' with an AsyncRedisFS batch")
+
+    async def execute(self) -> List[Any]:
+        """Send the queued calls and return their values in order."""
+        queued, self._queued = self._queued, []
+        if not queued:
+            return []
+        calls = [(cmd, self._key, args) for cmd, args, _, _, _ in queued]
+        fan_out = any(f for _, _, _, f, _ in queued)
+        if fan_out:
+            calls.append(("MOUNTS", self._key, ()))
+        replies = await self._pipe(calls)
+        mounts = self._pairs(replies.pop()) if fan_out else []
+
+        first_error = None
+        for (cmd, args, parse, fan_out, result), reply in zip(queued, replies):
+            try:
+                result._value = await self._settle(cmd, args, parse, fan_out, reply, mounts)
+            except Exception as e:
+                result._error = e
+                first_error = first_error or e
+            result._done = True
+        if first_error is not None:
+            raise first_error
+        return [result._value for _, _, _, _, result in queued]
+
+    async def _settle(self, cmd, args, parse, fan_out, reply, mounts) -> Any:
+        if fan_out:
+            if self._moved(reply) or self._mounted_below(args[0], mounts):
+                return parse(await self._fan_out(cmd, *args))
+            if isinstance(reply, ResponseError):
+                self._translate(reply)
+                return parse([])
+            return parse([("", reply)])
+        if self._moved(reply):
+            args = list(args)
+            key, _ = self._redirect(cmd, args, reply)
+            try:
+                reply = (await self._send(cmd, *args, key=key))[3]
+            except ResponseError as e:
+                reply = self._translate(e)
+        elif isinstance(reply, ResponseError):
+            reply = self._translate(reply)
+        return parse(reply) if parse else reply
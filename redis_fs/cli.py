@@ -175,8 +175,11 @@ def ls(ctx, key, path, long):
 def tree(ctx, key, path, depth):
     """Show directory tree."""
     fs = get_fs(ctx, key)
-    result = fs.tree(path, depth=depth)
-    click.echo(result)
+    suffix = {"dir": "/", "symlink": "@"}
+    for level, type_, name in fs.tree_flat(path, depth=depth) or []:
+        if name != "/":
+            name += suffix.get(type_, "")
+        click.echo("  " * level + name)
 
 
 @cli.command()
@@ -184,11 +187,17 @@ def tree(ctx, key, path, depth):
 @click.argument("path")
 @click.argument("pattern")
 @click.option("-t", "--type", "type_", type=click.Choice(["file", "dir", "link"]))
+@click.option("--min-size", type=int, help="At least this many bytes")
+@click.option("--max-size", type=int, help="At most this many bytes")
+@click.option("--newer", type=int, help="Modified after this time (ms since epoch)")
+@click.option("--older", type=int, help="Modified before this time (ms since epoch)")
+@click.option("--uid", type=int, help="Owned by this uid")
 @click.pass_context
-def find(ctx, key, path, pattern, type_):
+def find(ctx, key, path, pattern, type_, min_size, max_size, newer, older, uid):
     """Find files matching glob pattern."""
     fs = get_fs(ctx, key)
-    results = fs.find(path, pattern, type=type_)
+    results = fs.find(path, pattern, type=type_, min_size=min_size, max_size=max_size,
+                      newer=newer, older=older, uid=uid)
     for result in results:
         click.echo(result)
 
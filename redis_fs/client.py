@@ -1,15 +1,22 @@
 """Redis-FS client implementation."""
 
-from typing import Optional, List, Dict, Any, Union
+import io
+import posixpath
+from typing import IO, Any, Callable, Dict, Iterator, List, Optional, Tuple, Union
 from redis import Redis
-from redis.exceptions import ResponseError
+from redis.exceptions import ConnectionError, RedisError, ResponseError, TimeoutError
 
 from redis_fs.exceptions import (
+    RedisFSError,
+    CrossKeyError,
     NotAFileError,
     NotADirectoryError,
     PathNotFoundError,
     SymlinkLoopError,
+    VersionMismatchError,
 )
+from redis_fs.files import FileWriter, RawFileReader, RawFileWriter, TextFileWriter
+from redis_fs.replicas import ReadRouter
 
 
 class RedisFS:
@@ -18,6 +25,10 @@ class RedisFS:
     Args:
         redis: Redis client instance.
         key: Redis key name for this filesystem volume.
+        replicas: Optional replica connections to serve reads from.
+            Writes always go to ``redis``, and reads made after a write
+            see it.
+        max_staleness: Max age in seconds of data read from a replica.
     
     Example:
         >>> import redis
@@ -29,25 +40,332 @@ class RedisFS:
         '# TODO\\n- Item 1'
     """
 
-    def __init__(self, redis: Redis, key: str):
+    # Mounted subtrees answer "FSMOVED <key> <mount point>"; follow at most
+    # this many hops. Path arguments by position, for commands where the
+    # path is not simply the first argument.
+    MAX_REDIRECTS = 8
+    _PATH_ARGS = {"CP": (0, 1), "MV": (0, 1), "LN": (1,)}
+
+    # Commands that may be served by a replica.
+    _READ_COMMANDS = frozenset({
+        "CAT", "LINES", "HEAD", "TAIL", "LS", "TREE", "FIND", "GREP", "SEARCH",
+        "STAT", "TEST", "READLINK", "WC", "TTL", "INFO", "MOUNTS", "READCHUNK",
+        "ANALYZE",
+    })
+    # FS.ANALYZE fields that are {bucket: count} histograms.
+    _ANALYZE_HISTOGRAMS = ("file_sizes", "dir_fanout", "path_lengths", "depths", "bloom_fill")
+
+    # Chunk size for upload() and download(), well under proto-max-bulk-len.
+    CHUNK_SIZE = 4 * 1024 * 1024
+    # download() restarts at most this many times if the file keeps changing.
+    DOWNLOAD_RETRIES = 3
+
+    def __init__(
+        self,
+        redis: Redis,
+        key: str,
+        replicas: Optional[List[Redis]] = None,
+        max_staleness: float = 1.0,
+    ):
         self._redis = redis
         self._key = key
+        self._reads = ReadRouter(redis, replicas, max_staleness) if replicas else None
+
+    def batch(self) -> "Batch":
+        """Queue calls and send them in one pipeline.
+
+        Inside ``with fs.batch() as b:`` every method of ``b`` returns a
+        BatchResult instead of sending a command; leaving the block sends
+        them all in one round trip and fills in each result's ``value``.
+        Errors are mapped to the same exceptions (and missing paths to the
+        same None) as an unbatched call.
+
+        Example:
+            >>> with fs.batch() as b:
+            ...     a, c = b.read("/a.md"), b.stat("/c.md")
+            >>> a.value, c.value
+        """
+        return Batch(self)
+
+    def _call(self, cmd: str, *args) -> Any:
+        """Send one FS.<cmd>, on a replica when it is a read and one is fresh."""
+        if self._reads is None:
+            return self._redis.execute_command(f"FS.{cmd}", *args)
+        if cmd not in self._READ_COMMANDS:
+            try:
+                return self._redis.execute_command(f"FS.{cmd}", *args)
+            finally:
+                self._reads.note_write()
+        conn = self._reads.pick()
+        try:
+            return conn.execute_command(f"FS.{cmd}", *args)
+        except (ConnectionError, TimeoutError):
+            if conn is self._redis:
+                raise
+            return self._redis.execute_command(f"FS.{cmd}", *args)
+
+    @staticmethod
+    def _rebase(path: str, mount: str) -> str:
+        """Rewrite path, which lies under mount, relative to the mounted key."""
+        path = "/" + posixpath.normpath("/" + path).lstrip("/")
+        return path[len(mount):] or "/"
+
+    def _send(
+        self, cmd: str, *args, key: Optional[str] = None, prefix: str = ""
+    ) -> Tuple[str, str, list, Any]:
+        """Run FS.<cmd>, following FSMOVED redirects across mounted keys.
+
+        Returns the key that answered, the mount prefix of that key within
+        the logical tree, the (rebased) arguments, and the reply.
+        """
+        key = key or self._key
+        args = list(args)
+        for _ in range(self.MAX_REDIRECTS + 1):
+            try:
+                return key, prefix, args, self._call(cmd, key, *args)
+            except ResponseError as e:
+                if not str(e).startswith("FSMOVED "):
+                    raise
+                key, mount = self._redirect(cmd, args, e)
+                prefix += mount
+        raise RedisFSError(f"too many FSMOVED redirects for FS.{cmd}")
+
+    def _redirect(self, cmd: str, args: list, e: ResponseError) -> Tuple[str, str]:
+        """Rebase args in place for an FSMOVED error; returns (target key, mount)."""
+        _, key, mount = str(e).split(" ", 2)
+        for i in self._PATH_ARGS.get(cmd, (0,)):
+            args[i] = self._rebase(args[i], mount)
+        return key, mount
+
+    def _pipe(self, calls: List[Tuple[str, str, tuple]]) -> List[Any]:
+        """Send (cmd, key, args) calls in one pipeline.
+
+        Routed like _call: all reads may go to a fresh replica, anything
+        else goes to the primary. Server errors are returned in place of
+        their replies rather than raised.
+        """
+        reads = all(cmd in self._READ_COMMANDS for cmd, _, _ in calls)
+        conn = self._reads.pick() if self._reads is not None and reads else self._redis
+        try:
+            return self._pipeline(conn, calls)
+        except (ConnectionError, TimeoutError):
+            if conn is self._redis:
+                raise
+            return self._pipeline(self._redis, calls)
+        finally:
+            if self._reads is not None and not reads:
+                self._reads.note_write()
+
+    @staticmethod
+    def _pipeline(conn: Redis, calls: List[Tuple[str, str, tuple]]) -> List[Any]:
+        pipe = conn.pipeline(transaction=False)
+        for cmd, key, args in calls:
+            pipe.execute_command(f"FS.{cmd}", key, *args)
+        return pipe.execute(raise_on_error=False)
+
+    @staticmethod
+    def _moved(reply: Any) -> bool:
+        return isinstance(reply, ResponseError) and str(reply).startswith("FSMOVED ")
+
+    @staticmethod
+    def _mounted_below(path: str, mounts: List[Tuple[str, str]]) -> List[Tuple[str, str]]:
+        """The (mount point, target) pairs strictly below path."""
+        root = "/" + posixpath.normpath("/" + path).lstrip("/")
+        under = root.rstrip("/") + "/"
+        return [(m, t) for m, t in mounts if m.startswith(under)]
+
+    def _fan_out(self, cmd: str, path: str, *args) -> List[Tuple[str, Any]]:
+        """Run a subtree query on path and on every mount below it.
+
+        Returns (mount prefix, reply) pairs so FIND and GREP results can be
+        stitched into one logical tree. Each key's query and its mount
+        table are fetched in one round trip.
+        """
+        replies = []
+        pending = [(self._key, "", path)]
+        while pending:
+            step = self._fan_out_step(cmd, *pending.pop(), args)
+            if step is None:
+                continue
+            key, prefix, p, result, below = step
+            replies.append((prefix, result))
+            for mount, target in below:
+                pending.append((target, prefix + mount, "/"))
+        return replies
+
+    def _fan_out_step(
+        self, cmd: str, key: str, prefix: str, path: str, args: tuple
+    ) -> Optional[Tuple[str, str, str, Any, List[Tuple[str, str]]]]:
+        """Query one key of a fan-out, following a redirect if path is mounted.
+
+        Returns the key that answered, its mount prefix, the rebased path,
+        the reply and the mounts below the path; None if the path is missing.
+        """
+        result, table = self._pipe([(cmd, key, (path, *args)), ("MOUNTS", key, ())])
+        sent = [path]
+        if self._moved(result):
+            key, mount = self._redirect(cmd, sent, result)
+            try:
+                key, prefix, sent, result = self._send(
+                    cmd, sent[0], *args, key=key, prefix=prefix + mount
+                )
+            except ResponseError as e:
+                self._translate(e)
+                return None
+            table = self._call("MOUNTS", key)
+        elif isinstance(result, ResponseError):
+            self._translate(result)
+            return None
+        return key, prefix, sent[0], result, self._mounted_below(sent[0], self._pairs(table))
+
+    def _fan_out_page(
+        self, cmd: str, path: str, *args, limit: int, cursor: Optional[str]
+    ) -> Tuple[List[Tuple[str, Any]], Optional[str]]:
+        """Run one LIMIT/CURSOR page of a subtree query across mounts.
+
+        Keys are visited in a fixed order, path's own key first and then the
+        mounts below it depth first by mount point, so the continuation
+        token "<key number>:<module cursor>" says where the next page
+        starts. Keys finished by earlier pages are only resolved, not
+        queried. Returns (mount prefix, results) pairs and the token, or
+        None after the last page.
+        """
+        start, _, resume = (cursor or "0:").partition(":")
+        try:
+            start = int(start)
+        except ValueError:
+            raise RedisFSError(f"invalid cursor: {cursor!r}") from None
+        replies = []
+        pending = [(self._key, "", path)]
+        index = -1
+        while pending:
+            index += 1
+            page_args: list = [*args, "LIMIT", limit]
+            if index == start and resume:
+                page_args.extend(["CURSOR", resume])
+            query = ("TEST", ()) if index < start else (cmd, tuple(page_args))
+            step = self._fan_out_step(query[0], *pending.pop(), query[1])
+            if step is None:
+                continue
+            key, prefix, p, result, below = step
+            for mount, target in sorted(below, reverse=True):
+                pending.append((target, prefix + mount, "/"))
+            if index < start:
+                continue
+            results, token = result
+            replies.append((prefix, results))
+            limit -= len(results)
+            token = self._text(token)
+            if token != "0":
+                return replies, f"{index}:{token}"
+            if limit <= 0:
+                return replies, f"{index + 1}:" if pending else None
+        return replies, None
+
+    @staticmethod
+    def _join(prefix: str, path: str) -> str:
+        """Place a path from a mounted key back into the logical tree."""
+        if not prefix:
+            return path
+        return prefix if path == "/" else prefix + path
 
     def _execute(self, cmd: str, *args) -> Any:
         """Execute a FS.* command."""
         try:
-            return self._redis.execute_command(f"FS.{cmd}", self._key, *args)
+            return self._send(cmd, *args)[3]
         except ResponseError as e:
-            err_msg = str(e).lower()
-            if "no such filesystem" in err_msg or "not found" in err_msg:
-                return None
-            if "not a file" in err_msg:
-                raise NotAFileError(str(e))
-            if "not a directory" in err_msg:
-                raise NotADirectoryError(str(e))
-            if "symbolic links" in err_msg:
-                raise SymlinkLoopError(str(e))
-            raise
+            return self._translate(e)
+
+    def _run(self, cmd: str, *args, parse: Optional[Callable[[Any], Any]] = None) -> Any:
+        """Execute FS.<cmd> and shape its reply (None for a missing path) with parse.
+
+        Every single-command method goes through here, so Batch can queue
+        the same call instead of sending it.
+        """
+        result = self._execute(cmd, *args)
+        return parse(result) if parse else result
+
+    def _gather(self, cmd: str, path: str, *args, parse: Callable[[Any], Any]) -> Any:
+        """Run a subtree query across mounts and shape the (prefix, reply) pairs."""
+        return parse(self._fan_out(cmd, path, *args))
+
+    def _paged(
+        self, cmd: str, path: str, *args, limit: int, cursor: Optional[str],
+        parse: Callable[[Any], Any],
+    ) -> Tuple[Any, Optional[str]]:
+        """Like _gather, for one page: returns the shaped results and next cursor."""
+        replies, token = self._fan_out_page(cmd, path, *args, limit=limit, cursor=cursor)
+        return parse(replies), token
+
+    # Reply shapes.
+
+    @staticmethod
+    def _text(result: Any) -> Any:
+        return result.decode("utf-8") if isinstance(result, bytes) else result
+
+    @classmethod
+    def _triples(cls, result: Any) -> List[Tuple[int, str, str]]:
+        """Turn a flat FS.TREE reply into (depth, type, name) tuples."""
+        if not result:
+            return []
+        return [
+            (int(result[i]), cls._text(result[i + 1]), cls._text(result[i + 2]))
+            for i in range(0, len(result), 3)
+        ]
+
+    @staticmethod
+    def _ok(result: Any) -> bool:
+        return result == b"OK" or result == "OK"
+
+    @staticmethod
+    def _one(result: Any) -> bool:
+        return result == 1
+
+    @staticmethod
+    def _map(result: Any) -> Optional[Dict[str, Any]]:
+        """Turn a flat [key, value, ...] reply into a dict."""
+        if not isinstance(result, list):
+            return None
+        it = iter(result)
+        return {
+            (k.decode("utf-8") if isinstance(k, bytes) else k): v
+            for k, v in zip(it, it)
+        }
+
+    @staticmethod
+    def _pairs(result: Any) -> List[Tuple[str, str]]:
+        """Decode a MOUNTS reply into (mount point, target) pairs."""
+        if not isinstance(result, list):
+            return []
+        return [
+            tuple(e.decode("utf-8") if isinstance(e, bytes) else e for e in pair)
+            for pair in result
+        ]
+
+    @staticmethod
+    def _translate(e: ResponseError) -> None:
+        """Map a server error to the client's exceptions; None for missing paths."""
+        err_msg = str(e).lower()
+        if "no such filesystem" in err_msg or "not found" in err_msg:
+            return None
+        if "not a file" in err_msg:
+            raise NotAFileError(str(e))
+        if "not a directory" in err_msg:
+            raise NotADirectoryError(str(e))
+        if "symbolic links" in err_msg:
+            raise SymlinkLoopError(str(e))
+        if "version mismatch" in err_msg:
+            raise VersionMismatchError(str(e))
+        if "cross-key" in err_msg:
+            raise CrossKeyError(str(e))
+        raise e
+
+    @staticmethod
+    def _if_version(args: list, if_version: Optional[int]) -> list:
+        """Append an IFVERSION precondition to a write command's args."""
+        if if_version is not None:
+            args.extend(["IFVERSION", if_version])
+        return args
 
     def _handle_error(self, result: Any) -> None:
         """Check for error responses and raise appropriate exceptions."""
@@ -67,55 +385,319 @@ class RedisFS:
         
         Returns None if file doesn't exist.
         """
-        result = self._execute("CAT", path)
-        if result is None:
-            return None
-        return result.decode("utf-8") if isinstance(result, bytes) else result
+        return self._run("CAT", path, parse=self._text)
+
+    def read_bytes(self, path: str) -> Optional[bytes]:
+        """Read entire file content as bytes, without decoding.
+
+        Returns None if file doesn't exist.
+        """
+        return self._run("CAT", path)
+
+    def read_versioned(self, path: str) -> Optional[Tuple[str, int]]:
+        """Read a file together with its version.
+
+        Pass the version as ``if_version`` to a later write to make it
+        conditional on nobody else having changed the file in between.
+        Returns None if file doesn't exist.
+        """
+        def parse(result):
+            if result is None:
+                return None
+            content, version = result
+            return self._text(content), int(version)
+        return self._run("CAT", path, "WITHVERSION", parse=parse)
 
     def lines(self, path: str, start: int = 1, end: int = -1) -> Optional[str]:
         """Read specific line range (1-indexed, end=-1 means to EOF)."""
-        result = self._execute("LINES", path, start, end)
-        if result is None:
-            return None
-        return result.decode("utf-8") if isinstance(result, bytes) else result
+        return self._run("LINES", path, start, end, parse=self._text)
 
     def head(self, path: str, n: int = 10) -> Optional[str]:
         """Read first N lines."""
-        result = self._execute("HEAD", path, n)
-        if result is None:
-            return None
-        return result.decode("utf-8") if isinstance(result, bytes) else result
+        return self._run("HEAD", path, n, parse=self._text)
 
     def tail(self, path: str, n: int = 10) -> Optional[str]:
         """Read last N lines."""
-        result = self._execute("TAIL", path, n)
-        if result is None:
-            return None
-        return result.decode("utf-8") if isinstance(result, bytes) else result
+        return self._run("TAIL", path, n, parse=self._text)
+
+    def follow(
+        self,
+        path: str,
+        offset: int = 0,
+        block_ms: Optional[int] = None,
+        count: Optional[int] = None,
+    ) -> Optional[Tuple[bytes, int]]:
+        """Read what a file holds from a byte offset on, like ``tail -f``.
+
+        Returns the new bytes and the offset to pass next time, or None if
+        there is nothing new. With ``block_ms``, waits up to that many
+        milliseconds (0 = forever) for a write instead of returning None
+        at once. ``count`` caps the bytes returned per call (default 1MB).
+
+        Example:
+            >>> offset = 0
+            >>> while True:
+            ...     got = fs.follow("/logs/build.log", offset, block_ms=5000)
+            ...     if got:
+            ...         data, offset = got
+        """
+        args = [path, "FOLLOW", offset]
+        if block_ms is not None:
+            args.extend(["BLOCK", block_ms])
+        if count is not None:
+            args.extend(["COUNT", count])
+
+        def parse(result):
+            if result is None:
+                return None
+            next_offset, data = result
+            return data, int(next_offset)
+        return self._run("TAIL", *args, parse=parse)
+
+    def watch(
+        self,
+        path: str,
+        recursive: bool = False,
+        since: Optional[str] = None,
+        timeout_ms: Optional[int] = None,
+    ) -> Tuple[List[str], str]:
+        """Wait for a write under a path, like ``inotifywait``.
+
+        Returns the paths that changed and a token. Pass the token as
+        ``since`` next time to also get changes made between calls. An
+        empty list means ``timeout_ms`` passed first (0 or None = wait
+        forever). If the path itself is returned for a ``since`` token
+        the server no longer has changes for, rescan it.
+
+        Example:
+            >>> token = None
+            >>> while True:
+            ...     changed, token = fs.watch("/src", recursive=True, since=token)
+        """
+        args = [path]
+        if recursive:
+            args.append("RECURSIVE")
+        if since is not None:
+            args.extend(["SINCE", since])
+        if timeout_ms is not None:
+            args.extend(["TIMEOUT", timeout_ms])
+
+        def parse(result):
+            token, changed = result
+            return [self._text(p) for p in changed], self._text(token)
+        return self._run("WATCH", *args, parse=parse)
 
     # === Writing ===
 
-    def write(self, path: str, content: str) -> int:
+    def write(
+        self, path: str, content: str, if_version: Optional[int] = None
+    ) -> int:
         """Write content to file (creates parents, overwrites existing).
-        
+
+        With ``if_version``, the write only happens if the file's current
+        version matches (0 = file must not exist); otherwise
+        VersionMismatchError is raised.
+
         Returns the file size in bytes.
         """
-        return self._execute("ECHO", path, content)
+        return self._run("ECHO", *self._if_version([path, content], if_version))
 
-    def append(self, path: str, content: str) -> int:
+    def append(
+        self, path: str, content: str, if_version: Optional[int] = None
+    ) -> int:
         """Append content to file.
         
         Returns the new file size in bytes.
         """
-        return self._execute("APPEND", path, content)
+        return self._run("APPEND", *self._if_version([path, content], if_version))
+
+    def make_log(
+        self,
+        path: str,
+        max_size: Optional[int] = None,
+        max_age_ms: Optional[int] = None,
+        segment_size: Optional[int] = None,
+    ) -> bool:
+        """Make path an append-optimized log file (creates it if missing).
+
+        Appends are stored in segments of ``segment_size`` bytes (1 MiB by
+        default); the oldest whole segments are dropped to keep the log
+        within ``max_size`` bytes and ``max_age_ms``. A plain file keeps
+        its content. Options left as None keep their current value; 0
+        turns a limit off.
+        """
+        args: list = [path]
+        for name, value in (
+            ("SEGMENT", segment_size), ("MAXSIZE", max_size), ("MAXAGE", max_age_ms)
+        ):
+            if value is not None:
+                args.extend([name, value])
+        return self._run("LOG", *args, parse=self._ok)
 
-    def insert(self, path: str, after_line: int, content: str) -> bool:
+    def insert(
+        self,
+        path: str,
+        after_line: int,
+        content: str,
+        if_version: Optional[int] = None,
+    ) -> bool:
         """Insert content after line N (0=beginning, -1=end).
         
         Returns True on success.
         """
-        result = self._execute("INSERT", path, after_line, content)
-        return result == b"OK" or result == "OK"
+        args = self._if_version([path, after_line, content], if_version)
+        return self._run("INSERT", *args, parse=self._ok)
+
+    # === Large files ===
+
+    @staticmethod
+    def _chunks(source: Union[bytes, str, IO[bytes]], size: int) -> Iterator[bytes]:
+        """Split bytes, str or a binary file object into chunks of size."""
+        if isinstance(source, str):
+            source = source.encode("utf-8")
+        if isinstance(source, (bytes, bytearray, memoryview)):
+            view = memoryview(source)
+            for i in range(0, len(view), size):
+                yield view[i:i + size].tobytes()
+            return
+        while True:
+            chunk = source.read(size)
+            if not chunk:
+                return
+            yield chunk
+
+    def upload(
+        self,
+        path: str,
+        source: Union[bytes, str, IO[bytes]],
+        chunk_size: Optional[int] = None,
+        if_version: Optional[int] = None,
+        timeout_ms: Optional[int] = None,
+    ) -> int:
+        """Write a file of any size, one chunk at a time.
+
+        ``source`` is bytes, a str, or a binary file object that is read
+        incrementally. Readers keep seeing the previous content until the
+        last chunk is in, then the new file appears at once. If anything
+        fails the partial upload is discarded; one that is abandoned is
+        reclaimed by the server after ``timeout_ms`` (default 10 minutes)
+        without a chunk.
+
+        Returns the file size in bytes.
+        """
+        chunk_size = chunk_size or self.CHUNK_SIZE
+        args: list = [path]
+        if timeout_ms is not None:
+            args.extend(["TIMEOUT", timeout_ms])
+        try:
+            key, _, _, handle = self._send("OPEN", *args)
+        except ResponseError as e:
+            self._translate(e)
+            raise
+        size = 0
+        try:
+            for chunk in self._chunks(source, chunk_size):
+                size = self._call("WRITECHUNK", key, handle, chunk, "OFFSET", size)
+            self._call("COMMIT", key, handle, *self._if_version([], if_version))
+        except BaseException as e:
+            try:
+                self._call("ABORT", key, handle)
+            except RedisError:
+                pass  # the server times it out
+            if isinstance(e, ResponseError):
+                self._translate(e)
+            raise
+        return size
+
+    def download(
+        self,
+        path: str,
+        dest: Optional[IO[bytes]] = None,
+        chunk_size: Optional[int] = None,
+    ) -> Union[bytes, int, None]:
+        """Read a file of any size, one chunk at a time.
+
+        Returns the content as bytes, or, when ``dest`` is a binary file
+        object, writes it there and returns the number of bytes. If the
+        file changes mid-download the download starts over (``dest`` must
+        then be seekable), so the result is always one version of the
+        file. Returns None if it doesn't exist.
+        """
+        chunk_size = chunk_size or self.CHUNK_SIZE
+        start = dest.tell() if dest is not None and dest.seekable() else None
+        for attempt in range(self.DOWNLOAD_RETRIES + 1):
+            if attempt and dest is not None:
+                if start is None:
+                    break
+                dest.seek(start)
+                dest.truncate()
+            try:
+                key, _, sent, reply = self._send(
+                    "READCHUNK", path, 0, chunk_size, "WITHVERSION"
+                )
+            except ResponseError as e:
+                return self._translate(e)
+            if reply is None:
+                return None
+            chunk, version = reply
+            parts: List[bytes] = []
+            offset = 0
+            while True:
+                if dest is None:
+                    parts.append(chunk)
+                else:
+                    dest.write(chunk)
+                offset += len(chunk)
+                if len(chunk) < chunk_size:
+                    return b"".join(parts) if dest is None else offset
+                reply = self._call(
+                    "READCHUNK", key, sent[0], offset, chunk_size, "WITHVERSION"
+                )
+                if reply is None or reply[1] != version:
+                    break  # changed underneath us: start over
+                chunk = reply[0]
+        raise RedisFSError(f"{path} changed during download")
+
+    def open(
+        self,
+        path: str,
+        mode: str = "rb",
+        chunk_size: Optional[int] = None,
+        encoding: str = "utf-8",
+        errors: Optional[str] = None,
+        newline: Optional[str] = None,
+        if_version: Optional[int] = None,
+        timeout_ms: Optional[int] = None,
+    ) -> IO:
+        """Open a file as a stream, like the built-in open().
+
+        Modes are "rb", "wb", "ab" and their text forms "r", "w", "a".
+        Memory use is bounded by ``chunk_size`` (default CHUNK_SIZE)
+        whatever the file size:
+
+        - Reads fetch byte ranges of one chunk at a time, so small reads
+          are served from the readahead buffer. The file's version is
+          pinned at open; a concurrent change makes the next read raise
+          VersionMismatchError. Opening a missing file raises
+          PathNotFoundError.
+        - "w" writes go to an upload session in chunks. The file is
+          replaced atomically when the stream is closed (checked against
+          ``if_version``), and left untouched if a ``with`` block raises.
+        - "a" writes are appended a chunk at a time.
+        """
+        chunk_size = chunk_size or self.CHUNK_SIZE
+        kind = mode.replace("b", "").replace("t", "")
+        if kind not in ("r", "w", "a") or ("b" in mode and "t" in mode):
+            raise ValueError(f"invalid mode: {mode!r}")
+        if kind == "r":
+            stream = io.BufferedReader(RawFileReader(self, path, chunk_size), chunk_size)
+        else:
+            raw = RawFileWriter(self, path, kind == "a", if_version, timeout_ms)
+            stream = FileWriter(raw, chunk_size)
+        if "b" in mode:
+            return stream
+        text = TextFileWriter if kind != "r" else io.TextIOWrapper
+        return text(stream, encoding=encoding, errors=errors, newline=newline)
 
     # === Editing ===
 
@@ -127,6 +709,7 @@ class RedisFS:
         all: bool = False,
         line_start: Optional[int] = None,
         line_end: Optional[int] = None,
+        if_version: Optional[int] = None,
     ) -> int:
         """Replace text in file.
         
@@ -137,6 +720,7 @@ class RedisFS:
             all: Replace all occurrences (default: first only).
             line_start: Constrain to lines >= this (1-indexed).
             line_end: Constrain to lines <= this.
+            if_version: Only edit if the file is still at this version.
         
         Returns:
             Number of replacements made.
@@ -146,23 +730,45 @@ class RedisFS:
             args.extend(["LINE", line_start, line_end])
         if all:
             args.append("ALL")
-        return self._execute("REPLACE", *args)
+        return self._run("REPLACE", *self._if_version(args, if_version))
+
+    def splice(
+        self,
+        path: str,
+        edits: List[Tuple[int, int, str]],
+        if_version: Optional[int] = None,
+    ) -> int:
+        """Apply byte-range edits atomically.
+
+        Each edit is ``(offset, delete_len, data)`` in the file's pre-edit
+        coordinates; edits must be ascending and non-overlapping.
+
+        Returns the new file size in bytes.
+        """
+        args: list = [path]
+        for offset, delete_len, data in edits:
+            args.extend([offset, delete_len, data])
+        return self._run("SPLICE", *self._if_version(args, if_version))
 
-    def delete_lines(self, path: str, start: int, end: int) -> int:
+    def delete_lines(
+        self, path: str, start: int, end: int, if_version: Optional[int] = None
+    ) -> int:
         """Delete line range (inclusive, 1-indexed).
 
         Returns number of lines deleted.
         """
-        return self._execute("DELETELINES", path, start, end)
+        args = self._if_version([path, start, end], if_version)
+        return self._run("DELETELINES", *args)
 
     # === Navigation ===
 
-    def ls(self, path: str = "/", long: bool = False) -> List[str]:
+    def ls(self, path: str = "/", long: bool = False, sorted: bool = False) -> List[str]:
         """List directory contents.
 
         Args:
             path: Directory path.
             long: Include detailed info (mode, size, etc.).
+            sorted: Return entries by name rather than in the order added.
 
         Returns:
             List of entries (or detailed info if long=True).
@@ -170,23 +776,103 @@ class RedisFS:
         args = [path]
         if long:
             args.append("LONG")
-        result = self._execute("LS", *args)
-        if result is None:
+        if sorted:
+            args.append("SORTED")
+        def parse(result):
+            if isinstance(result, list):
+                return [self._text(e) for e in result]
             return []
-        if isinstance(result, list):
-            return [e.decode("utf-8") if isinstance(e, bytes) else e for e in result]
-        return []
+        return self._run("LS", *args, parse=parse)
+
+    def ls_page(
+        self,
+        path: str = "/",
+        long: bool = False,
+        count: int = 1000,
+        cursor: Optional[str] = None,
+    ) -> Tuple[List[Any], Optional[str]]:
+        """Like ls(), but at most count entries, and a cursor for the rest.
+
+        Entries come in name order. Pass the returned cursor back to get the
+        next page; it is None after the last one. Entries added or removed
+        between pages don't shift the ones still to come.
+        """
+        args = [path]
+        if long:
+            args.append("LONG")
+        args.extend(["COUNT", count])
+        if cursor:
+            args.extend(["CURSOR", cursor])
+        def parse(result):
+            if not result:
+                return [], None
+            token = self._text(result[1])
+            return [self._text(e) for e in result[0]], None if token == "0" else token
+        return self._run("LS", *args, parse=parse)
 
     def tree(self, path: str = "/", depth: Optional[int] = None) -> str:
         """Get directory tree representation."""
         args = [path]
         if depth is not None:
             args.extend(["DEPTH", depth])
-        result = self._execute("TREE", *args)
-        return result.decode("utf-8") if isinstance(result, bytes) else result or ""
+        return self._run("TREE", *args, parse=lambda r: self._text(r) or "")
+
+    def tree_flat(
+        self, path: str = "/", depth: Optional[int] = None
+    ) -> List[Tuple[int, str, str]]:
+        """Get the tree as (depth, type, name) tuples in pre-order.
+
+        depth is 0 for path itself; a node's parent is the closest node
+        before it with a smaller depth. Cheaper to build and parse than
+        the nested reply of tree() on large trees.
+        """
+        args = [path]
+        if depth is not None:
+            args.extend(["DEPTH", depth])
+        args.append("FLAT")
+        return self._run("TREE", *args, parse=self._triples)
+
+    def tree_page(
+        self,
+        path: str = "/",
+        depth: Optional[int] = None,
+        limit: int = 100,
+        cursor: Optional[str] = None,
+        flat: bool = False,
+    ) -> Tuple[Any, Optional[str]]:
+        """Get at most limit nodes of the tree, and a cursor for the rest.
+
+        Pass the returned cursor back to get the next page; it is None after
+        the last one. Each page repeats the directories leading to its first
+        node, so every page nests like a piece of tree(). With flat, a page
+        is a list of tree_flat() tuples instead.
+        """
+        args = [path]
+        if depth is not None:
+            args.extend(["DEPTH", depth])
+        if flat:
+            args.append("FLAT")
+        args.extend(["LIMIT", limit])
+        if cursor:
+            args.extend(["CURSOR", cursor])
+        def parse(result):
+            if not result:
+                return [] if flat else "", None
+            token = self._text(result[1])
+            page = self._triples(result[0]) if flat else result[0]
+            return page, None if token == "0" else token
+        return self._run("TREE", *args, parse=parse)
 
     def find(
-        self, path: str, pattern: str, type: Optional[str] = None
+        self,
+        path: str,
+        pattern: str,
+        type: Optional[str] = None,
+        min_size: Optional[int] = None,
+        max_size: Optional[int] = None,
+        newer: Optional[int] = None,
+        older: Optional[int] = None,
+        uid: Optional[int] = None,
     ) -> List[str]:
         """Find files/directories matching glob pattern.
 
@@ -194,38 +880,65 @@ class RedisFS:
             path: Starting path.
             pattern: Glob pattern (e.g., "*.md").
             type: Filter by type ("file", "dir", "link").
+            min_size, max_size: Inclusive size bounds in bytes (entries
+                for a directory).
+            newer, older: Only entries modified after / before this time,
+                in ms since the epoch.
+            uid: Only entries owned by this uid.
 
         Returns:
             List of matching paths.
         """
-        args = [path, pattern]
+        args = self._find_args(pattern, type, min_size, max_size, newer, older, uid)
+        return self._gather("FIND", path, *args, parse=self._found)
+
+    def find_page(
+        self,
+        path: str,
+        pattern: str,
+        type: Optional[str] = None,
+        limit: int = 100,
+        cursor: Optional[str] = None,
+        min_size: Optional[int] = None,
+        max_size: Optional[int] = None,
+        newer: Optional[int] = None,
+        older: Optional[int] = None,
+        uid: Optional[int] = None,
+    ) -> Tuple[List[str], Optional[str]]:
+        """Like find(), but at most limit paths, and a cursor for the rest.
+
+        Paths come in path order. Pass the returned cursor back to get the
+        next page; it is None after the last one. A page can be short (even
+        empty) when the server stops scanning early on a large tree, so
+        page until the cursor is None rather than until a page is short.
+        """
+        args = self._find_args(pattern, type, min_size, max_size, newer, older, uid)
+        return self._paged("FIND", path, *args, limit=limit, cursor=cursor, parse=self._found)
+
+    @staticmethod
+    def _find_args(pattern, type, min_size, max_size, newer, older, uid) -> List[Any]:
+        args: List[Any] = [pattern]
         if type:
             args.extend(["TYPE", type])
-        result = self._execute("FIND", *args)
-        if result is None:
-            return []
-        if isinstance(result, list):
-            return [e.decode("utf-8") if isinstance(e, bytes) else e for e in result]
-        return []
+        for opt, value in (("MINSIZE", min_size), ("MAXSIZE", max_size),
+                           ("NEWER", newer), ("OLDER", older), ("UID", uid)):
+            if value is not None:
+                args.extend([opt, value])
+        return args
+
+    def _found(self, replies: List[Tuple[str, Any]]) -> List[str]:
+        return [
+            self._join(prefix, self._text(e))
+            for prefix, result in replies for e in result
+        ]
 
     def stat(self, path: str) -> Optional[Dict[str, Any]]:
         """Get file/directory metadata."""
-        result = self._execute("STAT", path)
-        if result is None:
-            return None
-        if isinstance(result, list):
-            # Convert alternating key-value list to dict
-            it = iter(result)
-            return {
-                (k.decode("utf-8") if isinstance(k, bytes) else k): v
-                for k, v in zip(it, it)
-            }
-        return None
+        return self._run("STAT", path, parse=self._map)
 
     def exists(self, path: str) -> bool:
         """Check if path exists."""
-        result = self._execute("TEST", path)
-        return result == 1
+        return self._run("TEST", path, parse=self._one)
 
     # === Search ===
 
@@ -236,22 +949,171 @@ class RedisFS:
 
         Returns list of matches with file path and matching lines.
         """
-        args = [path, pattern]
+        args = [pattern]
         if nocase:
             args.append("NOCASE")
-        result = self._execute("GREP", *args)
-        if result is None:
-            return []
-        # Parse grep results - they come as [path, match, path, match, ...]
-        if isinstance(result, list):
-            matches = []
+        return self._gather("GREP", path, *args, parse=self._matches)
+
+    def grep_page(
+        self,
+        path: str,
+        pattern: str,
+        nocase: bool = False,
+        limit: int = 100,
+        cursor: Optional[str] = None,
+    ) -> Tuple[List[Any], Optional[str]]:
+        """Like grep(), but at most limit matching lines, and a cursor for the rest.
+
+        Pass the returned cursor back to get the next page; it is None after
+        the last one. Pages can be short, as with find_page().
+        """
+        args = [pattern]
+        if nocase:
+            args.append("NOCASE")
+        return self._paged("GREP", path, *args, limit=limit, cursor=cursor, parse=self._matches)
+
+    def _matches(self, replies: List[Tuple[str, Any]]) -> List[Any]:
+        matches = []
+        for prefix, result in replies:
             for item in result:
                 if isinstance(item, bytes):
                     matches.append(item.decode("utf-8"))
+                elif isinstance(item, list) and prefix:
+                    name = self._text(item[0])
+                    matches.append([self._join(prefix, name)] + item[1:])
                 else:
                     matches.append(item)
-            return matches
-        return []
+        return matches
+
+    def search(
+        self,
+        path: str,
+        query: str,
+        limit: int = 10,
+        include: Optional[str] = None,
+    ) -> List[Dict[str, Any]]:
+        """Rank files under path by BM25 relevance to the words of query.
+
+        Returns up to limit dicts with the file's path, its score, and the
+        line containing the most query words (line number and text). The
+        first search on a key builds its word index.
+        """
+        args = [query, "LIMIT", limit]
+        if include:
+            args.extend(["INCLUDE", include])
+        def parse(replies):
+            hits = []
+            for prefix, result in replies:
+                for p, score, line, text in result:
+                    hits.append({
+                        "path": self._join(prefix, self._text(p)),
+                        "score": float(score),
+                        "line": line,
+                        "text": text.decode("utf-8", errors="replace")
+                        if isinstance(text, bytes) else text,
+                    })
+            hits.sort(key=lambda h: h["score"], reverse=True)
+            return hits[:limit]
+        return self._gather("SEARCH", path, *args, parse=parse)
+
+    def hot(
+        self,
+        path: str = "/",
+        limit: int = 10,
+        by: Optional[str] = None,
+    ) -> List[Dict[str, Any]]:
+        """The most read and written files at or below path, hottest first.
+
+        Returns up to limit dicts with the file's path and its read and
+        write counters (logarithmic, 0-255, decaying while idle). by is
+        "reads" or "writes" to rank by one counter, else both count. The
+        ranking is approximate: it comes from a sample of hot files the
+        module keeps, not a scan.
+        """
+        args = ["LIMIT", limit]
+        if by:
+            args.append(by.upper())
+        def score(h):
+            return h["reads"] + h["writes"] if not by else h[by.lower()]
+        def parse(replies):
+            hits = []
+            for prefix, result in replies:
+                for p, reads, writes in result:
+                    hits.append({
+                        "path": self._join(prefix, self._text(p)),
+                        "reads": reads,
+                        "writes": writes,
+                    })
+            hits.sort(key=score, reverse=True)
+            return hits[:limit]
+        return self._gather("HOT", path, *args, parse=parse)
+
+    def analyze(self, path: str = "/", count: Optional[int] = None) -> Optional[Dict[str, Any]]:
+        """Data-shape and memory statistics for the subtree at path.
+
+        Walks the subtree a page of count inodes at a time (FS.ANALYZE with
+        CURSOR) and merges the pages: counts and byte totals, histograms as
+        {bucket: count} dicts, bytes and files per extension, and memory by
+        kind. duplicate_files and duplicate_bytes are not summed, since each
+        page only counts copies within itself: they are estimated from the
+        merged content hashes of one file in 16. Returns None if the
+        filesystem doesn't exist.
+        """
+        page = ["COUNT", count] if count else []
+        try:
+            key, _, sent, reply = self._send("ANALYZE", path, *page)
+        except ResponseError as e:
+            return self._translate(e)
+        merged: Dict[str, Any] = {}
+        while True:
+            stats, cursor = reply
+            self._merge_analysis(merged, stats)
+            cursor = self._text(cursor)
+            if cursor == "0":
+                return self._finish_analysis(merged)
+            reply = self._call("ANALYZE", key, sent[0], *page, "CURSOR", cursor)
+
+    @classmethod
+    def _merge_analysis(cls, merged: Dict[str, Any], stats: list) -> None:
+        """Add one FS.ANALYZE page into merged."""
+        for name, value in zip(stats[::2], stats[1::2]):
+            name = cls._text(name)
+            if name in cls._ANALYZE_HISTOGRAMS:
+                hist = merged.setdefault(name, {})
+                for bucket, n in zip(value[::2], value[1::2]):
+                    hist[bucket] = hist.get(bucket, 0) + n
+            elif name == "extensions":
+                exts = merged.setdefault(name, {})
+                for i in range(0, len(value), 3):
+                    e = exts.setdefault(cls._text(value[i]), {"files": 0, "bytes": 0})
+                    e["files"] += value[i + 1]
+                    e["bytes"] += value[i + 2]
+            elif name == "samples":
+                merged.setdefault(name, []).extend(
+                    (cls._text(h), size) for h, size in zip(value[::2], value[1::2])
+                )
+            elif name == "memory":
+                mem = merged.setdefault(name, {})
+                for kind, n in zip(value[::2], value[1::2]):
+                    kind = cls._text(kind)
+                    mem[kind] = mem.get(kind, 0) + n
+            elif name not in ("duplicate_files", "duplicate_bytes"):
+                merged[name] = merged.get(name, 0) + value
+
+    @staticmethod
+    def _finish_analysis(merged: Dict[str, Any]) -> Dict[str, Any]:
+        """Estimate duplicates across all pages from the merged samples."""
+        samples = merged.pop("samples", [])
+        seen = set()
+        files = size = 0
+        for sample in samples:
+            if sample in seen:
+                files += 1
+                size += sample[1]
+            seen.add(sample)
+        merged["duplicate_files"] = files * 16
+        merged["duplicate_bytes"] = size * 16
+        return merged
 
     # === Organization ===
 
@@ -265,41 +1127,69 @@ class RedisFS:
         args = [path]
         if parents:
             args.append("PARENTS")
-        result = self._execute("MKDIR", *args)
-        return result == b"OK" or result == "OK"
+        return self._run("MKDIR", *args, parse=self._ok)
 
     def rm(self, path: str, recursive: bool = False) -> bool:
         """Remove file or directory."""
         args = [path]
         if recursive:
             args.append("RECURSIVE")
-        result = self._execute("RM", *args)
-        return result == 1
+        return self._run("RM", *args, parse=self._one)
 
     def cp(self, src: str, dst: str, recursive: bool = False) -> bool:
         """Copy file or directory."""
         args = [src, dst]
         if recursive:
             args.append("RECURSIVE")
-        result = self._execute("CP", *args)
-        return result == b"OK" or result == "OK"
+        return self._run("CP", *args, parse=self._ok)
 
     def mv(self, src: str, dst: str) -> bool:
         """Move/rename file or directory."""
-        result = self._execute("MV", src, dst)
-        return result == b"OK" or result == "OK"
+        return self._run("MV", src, dst, parse=self._ok)
 
     def ln(self, target: str, link: str) -> bool:
         """Create symbolic link."""
-        result = self._execute("LN", target, link)
-        return result == b"OK" or result == "OK"
+        return self._run("LN", target, link, parse=self._ok)
 
     def readlink(self, path: str) -> Optional[str]:
         """Read symlink target."""
-        result = self._execute("READLINK", path)
-        if result is None:
-            return None
-        return result.decode("utf-8") if isinstance(result, bytes) else result
+        return self._run("READLINK", path, parse=self._text)
+
+    # === Expiry ===
+
+    def expire(self, path: str, ms: int) -> bool:
+        """Delete path (and its subtree) after ``ms`` milliseconds.
+
+        Returns False if the path doesn't exist.
+        """
+        return self._run("EXPIRE", path, ms, parse=self._one)
+
+    def ttl(self, path: str) -> int:
+        """Remaining time to live in ms (-1 = no expiry, -2 = missing)."""
+        return self._run("TTL", path)
+
+    def persist(self, path: str) -> bool:
+        """Remove a path's expiry. Returns True if one was removed."""
+        return self._run("PERSIST", path, parse=self._one)
+
+    # === Mounts ===
+
+    def mount(self, path: str, target: str) -> bool:
+        """Hand the subtree at path to another filesystem key.
+
+        Later calls on paths under the mount point are transparently
+        redirected to target, so one logical tree can span several keys
+        (and cluster slots).
+        """
+        return self._run("MOUNT", path, target, parse=self._ok)
+
+    def umount(self, path: str) -> bool:
+        """Remove a mount. Returns True if path was a mount point."""
+        return self._run("UMOUNT", path, parse=self._one)
+
+    def mounts(self) -> List[Tuple[str, str]]:
+        """List this key's own (mount point, target key) pairs."""
+        return self._run("MOUNTS", parse=self._pairs)
 
     # === Stats ===
 
@@ -308,25 +1198,138 @@ class RedisFS:
 
         Returns dict with 'lines', 'words', 'chars' keys.
         """
-        result = self._execute("WC", path)
-        if result is None:
-            return None
-        if isinstance(result, list):
-            it = iter(result)
-            return {
-                (k.decode("utf-8") if isinstance(k, bytes) else k): v
-                for k, v in zip(it, it)
-            }
-        return None
+        return self._run("WC", path, parse=self._map)
 
     def info(self) -> Dict[str, Any]:
-        """Get filesystem statistics."""
-        result = self._redis.execute_command("FS.INFO", self._key)
-        if isinstance(result, list):
-            it = iter(result)
-            return {
-                (k.decode("utf-8") if isinstance(k, bytes) else k): v
-                for k, v in zip(it, it)
-            }
-        return {}
+        """Get filesystem statistics (empty if the key doesn't exist)."""
+        return self._run("INFO", parse=lambda r: self._map(r) or {})
+
+
+
+class BatchResult:
+    """The result of one batched call, available once the batch has run."""
+
+    __slots__ = ("_value", "_error", "_done")
+
+    def __init__(self):
+        self._value: Any = None
+        self._error: Optional[Exception] = None
+        self._done = False
+
+    @property
+    def value(self) -> Any:
+        """The call's return value; raises the call's exception if it failed."""
+        if not self._done:
+            raise RedisFSError("batch has not been executed yet")
+        if self._error is not None:
+            raise self._error
+        return self._value
+
+
+class Batch(RedisFS):
+    """A RedisFS whose calls are queued and sent in one pipeline.
+
+    Created by ``RedisFS.batch()``. Each call returns a BatchResult;
+    ``execute()`` (or leaving the ``with`` block) sends every queued
+    command in one round trip and fills them in. The batch is not a
+    transaction: commands run in order, but other clients' commands may
+    interleave, and one failing does not stop the rest.
+
+    Calls that hit a mount are finished one by one after the pipeline:
+    a path under a mount is resent to the mounted key, and FIND, GREP and
+    SEARCH on a path with mounts below it fan out as usual.
+    """
+
+    def __init__(self, fs: RedisFS):
+        self._redis = fs._redis
+        self._key = fs._key
+        self._reads = fs._reads
+        self._queued: List[Tuple[str, tuple, Optional[Callable], bool, BatchResult]] = []
+
+    def __enter__(self) -> "Batch":
+        return self
+
+    def __exit__(self, exc_type, exc, tb) -> None:
+        if exc_type is None:
+            self.execute()
+        else:
+            self._queued = []
+
+    def __len__(self) -> int:
+        return len(self._queued)
+
+    def _run(self, cmd: str, *args, parse: Optional[Callable[[Any], Any]] = None) -> BatchResult:
+        return self._queue(cmd, args, parse, False)
+
+    def _gather(self, cmd: str, path: str, *args, parse: Callable[[Any], Any]) -> BatchResult:
+        return self._queue(cmd, (path, *args), parse, True)
+
+    def _queue(self, cmd: str, args: tuple, parse: Optional[Callable], fan_out: bool) -> BatchResult:
+        result = BatchResult()
+        self._queued.append((cmd, args, parse, fan_out, result))
+        return result
+
+    def _paged(self, cmd: str, path: str, *args, limit, cursor, parse):
+        raise TypeError(
+            f"{cmd.lower()}_page() may take several round trips and can't be batched"
+        )
+
+    def upload(self, *args, **kwargs):
+        raise TypeError("upload() takes several round trips and can't be batched")
+
+    def download(self, *args, **kwargs):
+        raise TypeError("download() takes several round trips and can't be batched")
+
+    def analyze(self, *args, **kwargs):
+        raise TypeError("analyze() takes several round trips and can't be batched")
+
+    def open(self, *args, **kwargs):
+        raise TypeError("open() streams over several round trips and can't be batched")
+
+    def execute(self) -> List[Any]:
+        """Send the queued calls and return their values in order.
+
+        Every BatchResult is filled in first; then the first failure, if
+        any, is raised.
+        """
+        queued, self._queued = self._queued, []
+        if not queued:
+            return []
+        calls = [(cmd, self._key, args) for cmd, args, _, _, _ in queued]
+        fan_out = any(f for _, _, _, f, _ in queued)
+        if fan_out:
+            calls.append(("MOUNTS", self._key, ()))
+        replies = self._pipe(calls)
+        mounts = self._pairs(replies.pop()) if fan_out else []
+
+        first_error = None
+        for (cmd, args, parse, fan_out, result), reply in zip(queued, replies):
+            try:
+                result._value = self._settle(cmd, args, parse, fan_out, reply, mounts)
+            except Exception as e:
+                result._error = e
+                first_error = first_error or e
+            result._done = True
+        if first_error is not None:
+            raise first_error
+        return [result._value for _, _, _, _, result in queued]
 
+    def _settle(self, cmd, args, parse, fan_out, reply, mounts) -> Any:
+        """Turn one pipelined reply into what the unbatched call returns."""
+        if fan_out:
+            if self._moved(reply) or self._mounted_below(args[0], mounts):
+                return parse(self._fan_out(cmd, *args))
+            if isinstance(reply, ResponseError):
+                self._translate(reply)
+                return parse([])
+            return parse([("", reply)])
+        if self._moved(reply):
+            args = list(args)
+            key, _ = self._redirect(cmd, args, reply)
+            try:
+                reply = self._send(cmd, *args, key=key)[3]
+            except ResponseError as e:
+                reply = self._translate(e)
+        elif isinstance(reply, ResponseError):
+            reply = self._translate(reply)
+        return parse(reply) if parse else reply
@@ -25,3 +25,12 @@ class SymlinkLoopError(RedisFSError):
     """Raised when too many levels of symbolic links are encountered."""
     pass
 
+
+class VersionMismatchError(RedisFSError):
+    """Raised when an IFVERSION precondition fails because the path changed."""
+    pass
+
+
+class CrossKeyError(RedisFSError):
+    """Raised when a two-path command spans different mounted keys."""
+    pass
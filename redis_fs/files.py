@@ -0,0 +1,191 @@
+"""File objects for streaming Redis-FS files (RedisFS.open)."""
+
+import io
+from typing import TYPE_CHECKING, Optional
+
+from redis.exceptions import RedisError, ResponseError
+
+from redis_fs.exceptions import PathNotFoundError, VersionMismatchError
+
+if TYPE_CHECKING:
+    from redis_fs.client import RedisFS
+
+
+class RawFileReader(io.RawIOBase):
+    """Unbuffered reads of one version of a file, by byte range (FS.READCHUNK).
+
+    The file's version is pinned at open; if the file changes while it is
+    open, the next read raises VersionMismatchError rather than mixing two
+    versions.
+    """
+
+    def __init__(self, fs: "RedisFS", path: str, chunk_size: int):
+        super().__init__()
+        self._fs = fs
+        self._path = path
+        self._chunk_size = chunk_size
+        self._pos = 0
+        try:
+            key, _, sent, reply = fs._send("READCHUNK", path, 0, 0, "WITHVERSION")
+        except ResponseError as e:
+            fs._translate(e)
+            raise
+        if reply is None:
+            raise PathNotFoundError(f"no such file: {path}")
+        self._key, self._rpath, self._version = key, sent[0], reply[1]
+
+    def readable(self) -> bool:
+        return True
+
+    def seekable(self) -> bool:
+        return True
+
+    def tell(self) -> int:
+        return self._pos
+
+    def seek(self, offset: int, whence: int = io.SEEK_SET) -> int:
+        if whence == io.SEEK_CUR:
+            offset += self._pos
+        elif whence == io.SEEK_END:
+            offset += self._size()
+        elif whence != io.SEEK_SET:
+            raise ValueError(f"invalid whence: {whence}")
+        if offset < 0:
+            raise ValueError("negative seek position")
+        self._pos = offset
+        return offset
+
+    def _size(self) -> int:
+        stat = self._fs._map(self._fs._call("STAT", self._key, self._rpath)) or {}
+        return int(stat.get("size", 0))
+
+    def _read(self, n: int) -> bytes:
+        reply = self._fs._call(
+            "READCHUNK", self._key, self._rpath, self._pos, n, "WITHVERSION"
+        )
+        if reply is None or reply[1] != self._version:
+            raise VersionMismatchError(f"{self._path} changed while open")
+        self._pos += len(reply[0])
+        return reply[0]
+
+    def readinto(self, b) -> int:
+        data = self._read(len(b)) if len(b) else b""
+        b[:len(data)] = data
+        return len(data)
+
+    def readall(self) -> bytes:
+        parts = []
+        while True:
+            chunk = self._read(self._chunk_size)
+            parts.append(chunk)
+            if len(chunk) < self._chunk_size:
+                return b"".join(parts)
+
+
+class RawFileWriter(io.RawIOBase):
+    """Unbuffered writes to a file.
+
+    In "w" mode the data goes to an upload session (FS.OPEN) and the file
+    is replaced atomically on close; abort() discards it instead. In "a"
+    mode each write is an FS.APPEND.
+    """
+
+    def __init__(
+        self,
+        fs: "RedisFS",
+        path: str,
+        append: bool,
+        if_version: Optional[int] = None,
+        timeout_ms: Optional[int] = None,
+    ):
+        super().__init__()
+        self._fs = fs
+        self._append = append
+        self._if_version = if_version
+        self._size = 0
+        self._handle = None
+        try:
+            if append:
+                # Creates a missing file, like open(path, "a"), and resolves
+                # mounts. An existing file is left alone: the module treats
+                # an empty append as a no-op.
+                self._key, _, sent, _ = fs._send(
+                    "APPEND", *fs._if_version([path, b""], if_version)
+                )
+                self._rpath = sent[0]
+            else:
+                args: list = [path]
+                if timeout_ms is not None:
+                    args.extend(["TIMEOUT", timeout_ms])
+                self._key, _, _, self._handle = fs._send("OPEN", *args)
+        except ResponseError as e:
+            fs._translate(e)
+            raise
+
+    def writable(self) -> bool:
+        return True
+
+    def write(self, b) -> int:
+        data = bytes(b)
+        try:
+            if self._append:
+                self._fs._call("APPEND", self._key, self._rpath, data)
+            else:
+                self._size = self._fs._call(
+                    "WRITECHUNK", self._key, self._handle, data, "OFFSET", self._size
+                )
+        except ResponseError as e:
+            self._fs._translate(e)
+            raise
+        return len(data)
+
+    def abort(self) -> None:
+        """Discard a "w" upload; the file keeps its previous content.
+
+        A no-op in "a" mode, where earlier writes are already visible.
+        """
+        if self._handle is None:
+            return
+        handle, self._handle = self._handle, None
+        try:
+            self._fs._call("ABORT", self._key, handle)
+        except RedisError:
+            pass  # the server times it out
+        super().close()
+
+    def close(self) -> None:
+        if self.closed:
+            return
+        if self._handle is not None:
+            try:
+                self._fs._call(
+                    "COMMIT", self._key, self._handle,
+                    *self._fs._if_version([], self._if_version),
+                )
+            except ResponseError as e:
+                self.abort()
+                self._fs._translate(e)
+                raise
+            except BaseException:
+                self.abort()
+                raise
+            self._handle = None
+        super().close()
+
+
+class FileWriter(io.BufferedWriter):
+    """Buffered writer that discards the upload if its ``with`` block fails."""
+
+    def __exit__(self, exc_type, exc, tb):
+        if exc_type is not None:
+            self.raw.abort()
+        return super().__exit__(exc_type, exc, tb)
+
+
+class TextFileWriter(io.TextIOWrapper):
+    """Text-mode FileWriter: also discards the upload if its block fails."""
+
+    def __exit__(self, exc_type, exc, tb):
+        if exc_type is not None:
+            self.buffer.raw.abort()
+        return super().__exit__(exc_type, exc, tb)
@@ -0,0 +1,166 @@
+"""Replica read routing for the Redis-FS client."""
+
+import asyncio
+import threading
+import time
+from typing import List, Optional, Tuple
+
+from redis import Redis
+
+
+class ReadRouter:
+    """Pick a connection for read commands.
+
+    Freshness comes from replication offsets. The primary's
+    master_repl_offset is sampled on each poll; a replica that has reached
+    the offset sampled at time t holds every write made before t, so its
+    data is at most ``now - t`` old. Replicas older than ``max_staleness``
+    seconds are skipped.
+
+    Read-your-writes: every write bumps a sequence number. The next primary
+    sample taken after it becomes the fence, and reads stay on the primary
+    until a replica has reached the fence.
+
+    Polling is lazy: offsets are refreshed on a read when the last poll is
+    older than ``poll_interval`` (default: a quarter of max_staleness).
+    """
+
+    MAX_SAMPLES = 64
+
+    def __init__(
+        self,
+        primary: Redis,
+        replicas: List[Redis],
+        max_staleness: float = 1.0,
+        poll_interval: Optional[float] = None,
+    ):
+        self.primary = primary
+        self.replicas = list(replicas)
+        self.max_staleness = max_staleness
+        self.poll_interval = max(
+            poll_interval if poll_interval is not None else max_staleness / 4,
+            0.01,
+        )
+        self._lock = threading.Lock()
+        self._samples: List[Tuple[int, float]] = []
+        self._state = [(False, 0, 0.0) for _ in self.replicas]  # up, offset, caught up at
+        self._write_seq = 0
+        self._fenced_seq = 0
+        self._fence = 0
+        self._next = 0
+        self._polled_at = 0.0
+
+    def note_write(self) -> None:
+        """Record that this session wrote to the primary."""
+        with self._lock:
+            self._write_seq += 1
+
+    def poll(self) -> None:
+        """Sample the primary's offset, then each replica's."""
+        seq = self._start_poll()
+        try:
+            offset = int(self.primary.info("replication")["master_repl_offset"])
+        except Exception:
+            return
+        self._record_primary(seq, offset)
+        for i, replica in enumerate(self.replicas):
+            try:
+                info = replica.info("replication")
+            except Exception:
+                info = None
+            self._record_replica(i, info)
+
+    def pick(self) -> Redis:
+        """Return a fresh replica, round-robin, or the primary."""
+        if self._poll_due():
+            self.poll()
+        return self._choose()
+
+    # Bookkeeping shared with AsyncReadRouter; only the I/O differs.
+
+    def _poll_due(self) -> bool:
+        return time.monotonic() - self._polled_at >= self.poll_interval
+
+    def _start_poll(self) -> int:
+        with self._lock:
+            self._polled_at = time.monotonic()
+            return self._write_seq
+
+    def _record_primary(self, seq: int, offset: int) -> None:
+        now = time.monotonic()
+        with self._lock:
+            if seq > self._fenced_seq:
+                self._fence, self._fenced_seq = offset, seq
+            self._samples.append((offset, now))
+            del self._samples[: -self.MAX_SAMPLES]
+
+    def _record_replica(self, i: int, info: Optional[dict]) -> None:
+        try:
+            up = info is not None and info.get("master_link_status") == "up"
+            roff = int(info.get("slave_repl_offset", -1)) if up else 0
+        except (TypeError, ValueError):
+            up, roff = False, 0
+        with self._lock:
+            caught_up = self._caught_up_at(roff) if up else 0.0
+            self._state[i] = (up, roff, caught_up)
+
+    def _caught_up_at(self, offset: int) -> float:
+        for sample_offset, at in reversed(self._samples):
+            if sample_offset <= offset:
+                return at
+        return 0.0
+
+    def _choose(self):
+        with self._lock:
+            if self._fenced_seq != self._write_seq:
+                return self.primary  # a write is not fenced yet
+            now = time.monotonic()
+            n = len(self.replicas)
+            for i in range(n):
+                j = (self._next + i) % n
+                up, offset, caught_up = self._state[j]
+                if (up and offset >= self._fence and caught_up
+                        and now - caught_up <= self.max_staleness):
+                    self._next = (j + 1) % n
+                    return self.replicas[j]
+            return self.primary
+
+
+class AsyncReadRouter(ReadRouter):
+    """ReadRouter for redis.asyncio connections.
+
+    Same policy; poll() and pick() are coroutines. Concurrent reads that
+    find the samples stale share one poll instead of each starting one.
+    """
+
+    def __init__(self, *args, **kwargs):
+        super().__init__(*args, **kwargs)
+        self._polling: Optional[asyncio.Task] = None
+
+    async def poll(self) -> None:
+        """Sample the primary's offset, then each replica's."""
+        seq = self._start_poll()
+        try:
+            info = await self.primary.info("replication")
+            offset = int(info["master_repl_offset"])
+        except Exception:
+            return
+        self._record_primary(seq, offset)
+        results = await asyncio.gather(
+            *(replica.info("replication") for replica in self.replicas),
+            return_exceptions=True,
+        )
+        for i, info in enumerate(results):
+            self._record_replica(i, None if isinstance(info, BaseException) else info)
+
+    async def pick(self):
+        """Return a fresh replica, round-robin, or the primary."""
+        if self._poll_due() and self._polling is None:
+            self._polling = asyncio.ensure_future(self.poll())
+            try:
+                await self._polling
+            finally:
+                self._polling = None
+        elif self._polling is not None:
+            await asyncio.shield(self._polling)
+        return self._choose()
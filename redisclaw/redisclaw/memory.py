@@ -139,6 +139,10 @@ Periodic checks to run (not yet implemented in RedisClaw).
 - [ ] Summarize recent activity
 """
 
+# FS.READCHUNK from offset 0 with this length reads a whole file, along
+# with its version, in one atomic reply.
+WHOLE_FILE = 1 << 62
+
 DEFAULTS = {
     "memory": DEFAULT_MEMORY,
     "soul": DEFAULT_SOUL,
@@ -155,6 +159,7 @@ class MemoryManager:
 
     redis_client: redis.Redis
     redis_key: str = "sandbox"
+    # path -> (version, content) of memory files read by load_memories.
     _cache: dict = field(default_factory=dict)
 
     def _fs_cmd(self, *args) -> Any:
@@ -186,6 +191,7 @@ class MemoryManager:
 
     def write_file(self, path: str, content: str) -> bool:
         """Write content to a file in Redis-FS."""
+        self._cache.pop(path, None)
         try:
             self._ensure_memory_dir()
             self._fs_cmd("FS.ECHO", self.redis_key, path, content)
@@ -199,16 +205,78 @@ class MemoryManager:
         if name not in MEMORY_FILES:
             raise ValueError(f"Unknown memory file: {name}")
 
-        path = MEMORY_FILES[name]
-        content = self.read_file(path)
-
-        if content is None:
-            # Create with default content
-            default = DEFAULTS.get(name, "")
-            self.write_file(path, default)
-            return default
-
-        return content
+        return self.load_memories((name,))[name]
+
+    def load_memories(self, names) -> dict[str, str]:
+        """Get several memory files by name in one round trip.
+
+        Files are cached with their versions. Each call checks the cached
+        versions and reads whole only the files not yet cached, all in one
+        pipeline; files that changed since are re-read in a second. Missing
+        files are created with their defaults, like get_memory, in another.
+        """
+        names = list(names)
+        for name in names:
+            if name not in MEMORY_FILES:
+                raise ValueError(f"Unknown memory file: {name}")
+
+        replies = self._read_versioned(names, validate=True)
+        changed = [n for n in names if n not in replies and MEMORY_FILES[n] not in self._cache]
+        replies.update(self._read_versioned(changed, validate=False))
+
+        contents, missing = {}, {}
+        for name in names:
+            if name not in replies:
+                contents[name] = self._cache[MEMORY_FILES[name]][1]
+            elif replies[name] is None:
+                missing[name] = DEFAULTS.get(name, "")
+            else:
+                contents[name] = replies[name]
+
+        if missing:
+            pipe = self.redis_client.pipeline(transaction=False)
+            pipe.execute_command("FS.MKDIR", self.redis_key, MEMORY_DIR)
+            for name, content in missing.items():
+                pipe.execute_command("FS.ECHO", self.redis_key, MEMORY_FILES[name], content)
+            for name, reply in zip(missing, pipe.execute(raise_on_error=False)[1:]):
+                if isinstance(reply, Exception):
+                    print(f"Error writing {MEMORY_FILES[name]}: {reply}")
+            contents.update(missing)
+        return {name: contents[name] for name in names}
+
+    def _read_versioned(self, names: list[str], validate: bool) -> dict[str, str | None]:
+        """Read memory files with their versions in one pipeline, caching them.
+
+        With validate, cached files only have their version checked (a
+        zero-length read); those still current are left out of the result,
+        and those that changed are left out and dropped from the cache.
+        Returns content, or None for a missing file, for each file read.
+        """
+        if not names:
+            return {}
+        pipe = self.redis_client.pipeline(transaction=False)
+        for name in names:
+            path = MEMORY_FILES[name]
+            length = 0 if validate and path in self._cache else WHOLE_FILE
+            pipe.execute_command("FS.READCHUNK", self.redis_key, path, 0, length, "WITHVERSION")
+        replies = pipe.execute(raise_on_error=False)
+
+        result = {}
+        for name, reply in zip(names, replies):
+            path = MEMORY_FILES[name]
+            cached = self._cache.get(path) if validate else None
+            if reply is None or isinstance(reply, Exception):
+                self._cache.pop(path, None)
+                result[name] = None
+            elif cached is not None:
+                if reply[1] != cached[0]:
+                    del self._cache[path]  # changed: re-read it
+            else:
+                data, version = reply
+                content = data.decode() if isinstance(data, bytes) else data
+                self._cache[path] = (version, content)
+                result[name] = content
+        return result
 
     def set_memory(self, name: str, content: str) -> bool:
         """Set a memory file by name."""
@@ -257,24 +325,25 @@ class MemoryManager:
     def get_context_prompt(self) -> str:
         """Build system prompt context from memory files."""
         sections = []
+        files = self.load_memories(("memory", "soul", "user", "identity"))
 
         # Always include MEMORY.md (core memories)
-        memory = self.get_memory("memory")
+        memory = files["memory"]
         if memory and memory.strip():
             sections.append(f"<memory>\n{memory}\n</memory>")
 
         # Include SOUL.md (personality)
-        soul = self.get_memory("soul")
+        soul = files["soul"]
         if soul and soul.strip():
             sections.append(f"<soul>\n{soul}\n</soul>")
 
         # Include USER.md (user info)
-        user = self.get_memory("user")
+        user = files["user"]
         if user and user.strip():
             sections.append(f"<user_profile>\n{user}\n</user_profile>")
 
         # Include IDENTITY.md (AI identity)
-        identity = self.get_memory("identity")
+        identity = files["identity"]
         if identity and identity.strip():
             sections.append(f"<identity>\n{identity}\n</identity>")
 
@@ -283,6 +352,28 @@ class MemoryManager:
 
         return "\n\n".join(sections)
 
+    def search(self, query: str, limit: int = 5) -> list[dict]:
+        """Find the memory files most relevant to query, best first.
+
+        Ranking happens server-side (FS.SEARCH), so only the matching
+        paths and their best lines cross the network.
+        """
+        try:
+            result = self._fs_cmd(
+                "FS.SEARCH", self.redis_key, MEMORY_DIR, query, "LIMIT", limit
+            )
+        except redis.ResponseError:
+            return []
+        return [
+            {
+                "path": path.decode() if isinstance(path, bytes) else path,
+                "score": float(score),
+                "line": line,
+                "text": text.decode(errors="replace") if isinstance(text, bytes) else text,
+            }
+            for path, score, line, text in result
+        ]
+
     def list_memory_files(self) -> list[str]:
         """List all memory files."""
         try:
@@ -295,7 +386,5 @@ class MemoryManager:
 
     def initialize_defaults(self) -> None:
         """Initialize all default memory files if they don't exist."""
-        self._ensure_memory_dir()
-        for name in MEMORY_FILES:
-            self.get_memory(name)  # Creates with defaults if missing
+        self.load_memories(MEMORY_FILES)  # Creates with defaults if missing
 
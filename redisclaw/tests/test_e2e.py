@@ -438,6 +438,21 @@ class TestMemorySystem:
         assert "<soul>" in context
         assert "<identity>" in context
 
+    def test_memory_cache(self, redis_client):
+        """Cached memory files are revalidated by version, not re-read."""
+        from redisclaw.memory import MemoryManager, MEMORY_FILES
+
+        manager = MemoryManager(redis_client, redis_key=FS_KEY)
+        manager.initialize_defaults()
+        first = manager.load_memories(("memory", "soul"))
+        assert set(manager._cache) >= {MEMORY_FILES["memory"], MEMORY_FILES["soul"]}
+        assert manager.load_memories(("memory", "soul")) == first
+
+        # A write from elsewhere is picked up on the next turn.
+        redis_client.execute_command("FS.ECHO", FS_KEY, MEMORY_FILES["soul"], "# Soul\nnew")
+        again = manager.load_memories(("memory", "soul"))
+        assert again["soul"] == "# Soul\nnew" and again["memory"] == first["memory"]
+
     def test_daily_log(self, redis_client):
         """MemoryManager can write daily logs."""
         from redisclaw.memory import MemoryManager
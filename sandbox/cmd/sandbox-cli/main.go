@@ -58,7 +58,7 @@ Usage:
 
 Commands:
   launch <command>     Launch a process (use -w to wait)
-  read <id>            Read process output
+  read <id> [out err]  Read process output (from stdout/stderr offsets)
   write <id> <input>   Write to process stdin
   kill <id>            Kill a process
   list                 List all processes
@@ -74,6 +74,7 @@ func cmdLaunch(args []string) error {
 	cwd := fs.String("d", "", "Working directory")
 	timeout := fs.Int("t", 0, "Timeout in seconds")
 	keepStdin := fs.Bool("i", false, "Keep stdin open")
+	logPath := fs.String("log", "", "Redis-FS file to stream output to")
 	fs.Parse(args)
 
 	if fs.NArg() < 1 {
@@ -86,6 +87,7 @@ func cmdLaunch(args []string) error {
 		"timeout_secs":    *timeout,
 		"wait":            *wait,
 		"keep_stdin_open": *keepStdin,
+		"log_path":        *logPath,
 	})
 
 	resp, err := http.Post(baseURL+"/processes", "application/json", bytes.NewReader(body))
@@ -101,7 +103,11 @@ func cmdRead(args []string) error {
 	if len(args) < 1 {
 		return fmt.Errorf("process ID required")
 	}
-	resp, err := http.Get(baseURL + "/processes/" + args[0])
+	url := baseURL + "/processes/" + args[0]
+	if len(args) >= 3 {
+		url += "?stdout_offset=" + args[1] + "&stderr_offset=" + args[2]
+	}
+	resp, err := http.Get(url)
 	if err != nil {
 		return err
 	}
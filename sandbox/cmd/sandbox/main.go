@@ -10,19 +10,34 @@ import (
 	"os"
 	"os/signal"
 	"syscall"
+	"time"
 
 	"github.com/redis-fs/sandbox/internal/api"
 	"github.com/redis-fs/sandbox/internal/executor"
+	"github.com/redis-fs/sandbox/internal/logstream"
+	"github.com/redis/go-redis/v9"
 )
 
 func main() {
 	port := flag.Int("port", 8090, "HTTP server port")
 	workspace := flag.String("workspace", "/workspace", "Workspace directory")
 	transport := flag.String("transport", "http", "Transport: http or stdio (MCP)")
+	outputLimit := flag.Int("output-limit", executor.DefaultOutputLimit, "Bytes of stdout and of stderr kept per process")
+	redisAddr := flag.String("redis", "", "Redis server address, to stream output to log_path files (disabled if empty)")
+	redisPassword := flag.String("password", "", "Redis password")
+	redisKey := flag.String("key", "sandbox", "Redis-FS key that log_path files are written to")
+	logInterval := flag.Duration("log-interval", 250*time.Millisecond, "How often streamed output is sent to Redis")
 
 	flag.Parse()
 
 	manager := executor.NewManager(*workspace)
+	manager.SetOutputLimit(*outputLimit)
+	if *redisAddr != "" {
+		rdb := redis.NewClient(&redis.Options{Addr: *redisAddr, Password: *redisPassword})
+		streamer := logstream.New(rdb, *redisKey, logstream.Options{Interval: *logInterval})
+		defer streamer.Stop()
+		manager.SetOutputSink(streamer)
+	}
 
 	if *transport == "stdio" {
 		// Run MCP server over stdio
@@ -56,7 +71,7 @@ func main() {
 	log.Printf("Endpoints:")
 	log.Printf("  POST   /processes       - Launch process")
 	log.Printf("  GET    /processes       - List processes")
-	log.Printf("  GET    /processes/{id}  - Read process output")
+	log.Printf("  GET    /processes/{id}  - Read process output (?stdout_offset=N&stderr_offset=M)")
 	log.Printf("  POST   /processes/{id}/write - Write to stdin")
 	log.Printf("  POST   /processes/{id}/wait  - Wait for completion")
 	log.Printf("  DELETE /processes/{id}  - Kill process")
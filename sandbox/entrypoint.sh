@@ -60,5 +60,6 @@ trap cleanup SIGTERM SIGINT
 
 # Run the sandbox server
 echo "Starting sandbox server on port ${SANDBOX_PORT}..."
-exec sandbox --port "${SANDBOX_PORT}" --workspace "${MOUNT_POINT}"
+exec sandbox --port "${SANDBOX_PORT}" --workspace "${MOUNT_POINT}" \
+    --redis "${REDIS_ADDR}" --key "${REDIS_KEY}"
 
@@ -106,17 +106,22 @@ func (s *MCPServer) getTools() []map[string]interface{} {
 					"timeout_secs":    map[string]string{"type": "integer", "description": "Timeout"},
 					"wait":            map[string]string{"type": "boolean", "description": "Wait for completion"},
 					"keep_stdin_open": map[string]string{"type": "boolean", "description": "Keep stdin open"},
+					"log_path":        map[string]string{"type": "string", "description": "Redis-FS file to stream output to (follow it with FS.TAIL)"},
 				},
 				"required": []string{"command"},
 			},
 		},
 		{
 			"name":        "sandbox_read",
-			"description": "Read output from a sandbox process",
+			"description": "Read output from a sandbox process; pass back the returned offsets to get only new output",
 			"inputSchema": map[string]interface{}{
-				"type":       "object",
-				"properties": map[string]interface{}{"id": map[string]string{"type": "string"}},
-				"required":   []string{"id"},
+				"type": "object",
+				"properties": map[string]interface{}{
+					"id":            map[string]string{"type": "string"},
+					"stdout_offset": map[string]string{"type": "integer", "description": "Return stdout from this offset on"},
+					"stderr_offset": map[string]string{"type": "integer", "description": "Return stderr from this offset on"},
+				},
+				"required": []string{"id"},
 			},
 		},
 		{
@@ -46,6 +46,9 @@ func (s *MCPServer) toolLaunch(ctx context.Context, args map[string]interface{})
 	if keepStdin, ok := args["keep_stdin_open"].(bool); ok {
 		opts.KeepStdinOpen = keepStdin
 	}
+	if logPath, ok := args["log_path"].(string); ok {
+		opts.LogPath = logPath
+	}
 
 	result, err := s.manager.Launch(ctx, opts)
 	if err != nil {
@@ -62,7 +65,9 @@ func (s *MCPServer) toolRead(args map[string]interface{}) (string, error) {
 		return "", fmt.Errorf("id is required")
 	}
 
-	result, err := s.manager.Read(id)
+	stdoutOffset, _ := args["stdout_offset"].(float64)
+	stderrOffset, _ := args["stderr_offset"].(float64)
+	result, err := s.manager.ReadSince(id, int64(stdoutOffset), int64(stderrOffset))
 	if err != nil {
 		return "", err
 	}
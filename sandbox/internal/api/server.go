@@ -4,6 +4,7 @@ package api
 import (
 	"encoding/json"
 	"net/http"
+	"strconv"
 	"time"
 
 	"github.com/gorilla/mux"
@@ -49,6 +50,7 @@ type LaunchRequest struct {
 	TimeoutSecs   int    `json:"timeout_secs,omitempty"`
 	Wait          bool   `json:"wait"`
 	KeepStdinOpen bool   `json:"keep_stdin_open,omitempty"`
+	LogPath       string `json:"log_path,omitempty"`
 }
 
 func (s *Server) handleLaunch(w http.ResponseWriter, r *http.Request) {
@@ -63,6 +65,7 @@ func (s *Server) handleLaunch(w http.ResponseWriter, r *http.Request) {
 		Cwd:           req.Cwd,
 		Wait:          req.Wait,
 		KeepStdinOpen: req.KeepStdinOpen,
+		LogPath:       req.LogPath,
 	}
 	if req.TimeoutSecs > 0 {
 		opts.Timeout = time.Duration(req.TimeoutSecs) * time.Second
@@ -86,7 +89,18 @@ func (s *Server) handleList(w http.ResponseWriter, r *http.Request) {
 
 func (s *Server) handleRead(w http.ResponseWriter, r *http.Request) {
 	id := mux.Vars(r)["id"]
-	result, err := s.manager.Read(id)
+	var offsets [2]int64
+	for i, name := range []string{"stdout_offset", "stderr_offset"} {
+		if v := r.URL.Query().Get(name); v != "" {
+			n, err := strconv.ParseInt(v, 10, 64)
+			if err != nil || n < 0 {
+				http.Error(w, "invalid "+name, http.StatusBadRequest)
+				return
+			}
+			offsets[i] = n
+		}
+	}
+	result, err := s.manager.ReadSince(id, offsets[0], offsets[1])
 	if err != nil {
 		http.Error(w, err.Error(), http.StatusNotFound)
 		return
@@ -9,8 +9,13 @@ import (
 )
 
 // monitor watches a process and updates its state when it exits.
-func (m *Manager) monitor(proc *Process, timeout time.Duration) {
+func (m *Manager) monitor(proc *Process, timeout time.Duration, sink OutputSink) {
 	defer close(proc.done)
+	if proc.LogPath != "" {
+		// Deferred calls run last-in first-out: the log is flushed
+		// before waiters see the process as done.
+		defer sink.Close(proc.LogPath)
+	}
 
 	var timeoutCh <-chan time.Time
 	if timeout > 0 {
@@ -57,10 +62,22 @@ type ReadResult struct {
 	ExitCode int          `json:"exit_code"`
 	Stdout   string       `json:"stdout"`
 	Stderr   string       `json:"stderr"`
+	// Offsets just past the returned output: pass them to ReadSince to
+	// get only what is new.
+	StdoutOffset int64 `json:"stdout_offset"`
+	StderrOffset int64 `json:"stderr_offset"`
+	// Bytes of the requested output no longer buffered (see SetOutputLimit).
+	Dropped int64 `json:"dropped,omitempty"`
 }
 
-// Read returns the current output of a process.
+// Read returns all the buffered output of a process.
 func (m *Manager) Read(id string) (*ReadResult, error) {
+	return m.ReadSince(id, 0, 0)
+}
+
+// ReadSince returns the output of a process from the given stdout and
+// stderr offsets on, so polling costs only the new output.
+func (m *Manager) ReadSince(id string, stdoutOffset, stderrOffset int64) (*ReadResult, error) {
 	m.mu.RLock()
 	proc, ok := m.processes[id]
 	m.mu.RUnlock()
@@ -69,16 +86,22 @@ func (m *Manager) Read(id string) (*ReadResult, error) {
 		return nil, fmt.Errorf("process %s not found", id)
 	}
 
+	// Read the state first: output read after it is at least as new.
 	proc.mu.RLock()
-	defer proc.mu.RUnlock()
-
-	return &ReadResult{
-		ID:       proc.ID,
-		State:    proc.State,
-		ExitCode: proc.ExitCode,
-		Stdout:   proc.stdout.String(),
-		Stderr:   proc.stderr.String(),
-	}, nil
+	result := &ReadResult{ID: proc.ID, State: proc.State, ExitCode: proc.ExitCode}
+	proc.mu.RUnlock()
+
+	stdout, outStart, outEnd := proc.stdout.Since(stdoutOffset)
+	stderr, errStart, errEnd := proc.stderr.Since(stderrOffset)
+	result.Stdout, result.StdoutOffset = string(stdout), outEnd
+	result.Stderr, result.StderrOffset = string(stderr), errEnd
+	if outStart > stdoutOffset {
+		result.Dropped += outStart - stdoutOffset
+	}
+	if errStart > stderrOffset {
+		result.Dropped += errStart - stderrOffset
+	}
+	return result, nil
 }
 
 // Write sends input to a process's stdin.
@@ -138,6 +161,7 @@ type ProcessInfo struct {
 	PID       int          `json:"pid"`
 	StartedAt time.Time    `json:"started_at"`
 	EndedAt   *time.Time   `json:"ended_at,omitempty"`
+	LogPath   string       `json:"log_path,omitempty"`
 }
 
 // List returns all processes.
@@ -157,6 +181,7 @@ func (m *Manager) List() []*ProcessInfo {
 			PID:       proc.PID,
 			StartedAt: proc.StartedAt,
 			EndedAt:   proc.EndedAt,
+			LogPath:   proc.LogPath,
 		})
 		proc.mu.RUnlock()
 	}
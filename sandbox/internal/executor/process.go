@@ -2,7 +2,6 @@
 package executor
 
 import (
-	"bytes"
 	"context"
 	"fmt"
 	"io"
@@ -34,30 +33,60 @@ type Process struct {
 	StartedAt time.Time    `json:"started_at"`
 	EndedAt   *time.Time   `json:"ended_at,omitempty"`
 	PID       int          `json:"pid,omitempty"`
+	LogPath   string       `json:"log_path,omitempty"`
 
 	cmd    *exec.Cmd
-	stdout *bytes.Buffer
-	stderr *bytes.Buffer
+	stdout *ringBuffer
+	stderr *ringBuffer
 	stdin  io.WriteCloser
 	mu     sync.RWMutex
 	done   chan struct{}
 }
 
+// OutputSink receives a copy of process output as it is produced, for
+// processes launched with a LogPath.
+type OutputSink interface {
+	// Write queues p to be appended to the file at path. It must not block
+	// on I/O: it is called from the goroutine copying the process's output.
+	Write(path string, p []byte)
+	// Close is called once the process has exited and all its output has
+	// been written, so anything still queued for path can be sent now.
+	Close(path string)
+}
+
 // Manager handles process creation and lifecycle.
 type Manager struct {
-	processes map[string]*Process
-	workspace string
-	mu        sync.RWMutex
+	processes   map[string]*Process
+	workspace   string
+	outputLimit int
+	sink        OutputSink
+	mu          sync.RWMutex
 }
 
 // NewManager creates a new process manager.
 func NewManager(workspace string) *Manager {
 	return &Manager{
-		processes: make(map[string]*Process),
-		workspace: workspace,
+		processes:   make(map[string]*Process),
+		workspace:   workspace,
+		outputLimit: DefaultOutputLimit,
 	}
 }
 
+// SetOutputLimit sets how many bytes of stdout, and of stderr, processes
+// launched from now on keep for Read.
+func (m *Manager) SetOutputLimit(n int) {
+	m.mu.Lock()
+	m.outputLimit = n
+	m.mu.Unlock()
+}
+
+// SetOutputSink enables LaunchOptions.LogPath, streaming output to sink.
+func (m *Manager) SetOutputSink(sink OutputSink) {
+	m.mu.Lock()
+	m.sink = sink
+	m.mu.Unlock()
+}
+
 // LaunchOptions configures process launch behavior.
 type LaunchOptions struct {
 	Command       string        `json:"command"`
@@ -65,6 +94,9 @@ type LaunchOptions struct {
 	Timeout       time.Duration `json:"timeout,omitempty"`
 	Wait          bool          `json:"wait"`
 	KeepStdinOpen bool          `json:"keep_stdin_open,omitempty"`
+	// LogPath, if set, is a Redis-FS path that stdout and stderr are
+	// appended to as they are produced (requires an output sink).
+	LogPath string `json:"log_path,omitempty"`
 }
 
 // LaunchResult contains the result of launching a process.
@@ -88,12 +120,25 @@ func (m *Manager) Launch(ctx context.Context, opts LaunchOptions) (*LaunchResult
 		cwd = m.workspace + "/" + cwd
 	}
 
+	m.mu.RLock()
+	limit, sink := m.outputLimit, m.sink
+	m.mu.RUnlock()
+
+	var tee func([]byte)
+	if opts.LogPath != "" {
+		if sink == nil {
+			return nil, fmt.Errorf("log_path needs output streaming, which is not configured")
+		}
+		path := opts.LogPath
+		tee = func(p []byte) { sink.Write(path, p) }
+	}
+
 	cmd := exec.CommandContext(ctx, "sh", "-c", opts.Command)
 	cmd.Dir = cwd
 	cmd.SysProcAttr = &syscall.SysProcAttr{Setpgid: true}
 
-	stdout := &bytes.Buffer{}
-	stderr := &bytes.Buffer{}
+	stdout := newRingBuffer(limit, tee)
+	stderr := newRingBuffer(limit, tee)
 	cmd.Stdout = stdout
 	cmd.Stderr = stderr
 
@@ -112,6 +157,7 @@ func (m *Manager) Launch(ctx context.Context, opts LaunchOptions) (*LaunchResult
 		Cwd:       cwd,
 		State:     StateRunning,
 		StartedAt: time.Now(),
+		LogPath:   opts.LogPath,
 		cmd:       cmd,
 		stdout:    stdout,
 		stderr:    stderr,
@@ -128,7 +174,7 @@ func (m *Manager) Launch(ctx context.Context, opts LaunchOptions) (*LaunchResult
 	m.processes[id] = proc
 	m.mu.Unlock()
 
-	go m.monitor(proc, opts.Timeout)
+	go m.monitor(proc, opts.Timeout, sink)
 
 	result := &LaunchResult{ID: id, PID: proc.PID, State: StateRunning}
 
@@ -0,0 +1,81 @@
+package executor
+
+import "sync"
+
+// DefaultOutputLimit is how many bytes of stdout, and of stderr, each
+// process keeps for Read. Older output is dropped as new output arrives.
+const DefaultOutputLimit = 1 << 20
+
+// ringBuffer keeps the last size bytes written to it. Offsets count every
+// byte ever written, so a reader can ask for the output since an offset
+// and tell whether part of it has already been dropped.
+type ringBuffer struct {
+	mu      sync.Mutex
+	buf     []byte // grows up to size, then wraps; offset o lives at o % size
+	size    int
+	written int64 // total bytes ever written
+	tee     func([]byte)
+}
+
+func newRingBuffer(size int, tee func([]byte)) *ringBuffer {
+	if size <= 0 {
+		size = DefaultOutputLimit
+	}
+	return &ringBuffer{size: size, tee: tee}
+}
+
+// Write implements io.Writer; it never fails.
+func (r *ringBuffer) Write(p []byte) (int, error) {
+	n := len(p)
+	if r.tee != nil {
+		r.tee(p)
+	}
+
+	r.mu.Lock()
+	defer r.mu.Unlock()
+	if len(p) > r.size {
+		r.written += int64(len(p) - r.size)
+		p = p[len(p)-r.size:]
+	}
+	if end := r.written + int64(len(p)); len(r.buf) < r.size && int64(len(r.buf)) < end {
+		grow := r.size
+		if end < int64(r.size) {
+			grow = int(end)
+		}
+		r.buf = append(r.buf, make([]byte, grow-len(r.buf))...)
+	}
+	for len(p) > 0 {
+		k := copy(r.buf[r.written%int64(r.size):], p)
+		r.written += int64(k)
+		p = p[k:]
+	}
+	return n, nil
+}
+
+// Since returns the buffered output from offset on, and the offsets it
+// actually starts and ends at. start is past offset if the output in
+// between was dropped; end is the offset to pass next time.
+func (r *ringBuffer) Since(offset int64) (data []byte, start, end int64) {
+	r.mu.Lock()
+	defer r.mu.Unlock()
+
+	end = r.written
+	start = offset
+	if oldest := end - int64(len(r.buf)); start < oldest {
+		start = oldest
+	}
+	if start > end {
+		start = end
+	}
+	data = make([]byte, end-start)
+	pos := int(start % int64(r.size))
+	k := copy(data, r.buf[pos:])
+	copy(data[k:], r.buf)
+	return data, start, end
+}
+
+// String returns all the buffered output.
+func (r *ringBuffer) String() string {
+	data, _, _ := r.Since(0)
+	return string(data)
+}
@@ -0,0 +1,42 @@
+package executor
+
+import "testing"
+
+func TestRingBuffer(t *testing.T) {
+	r := newRingBuffer(8, nil)
+	r.Write([]byte("abc"))
+	if data, start, end := r.Since(0); string(data) != "abc" || start != 0 || end != 3 {
+		t.Fatalf("got %q [%d, %d)", data, start, end)
+	}
+
+	// Wraps, dropping the oldest bytes.
+	r.Write([]byte("defghij"))
+	if data, start, end := r.Since(0); string(data) != "cdefghij" || start != 2 || end != 10 {
+		t.Fatalf("got %q [%d, %d)", data, start, end)
+	}
+	if data, start, _ := r.Since(7); string(data) != "hij" || start != 7 {
+		t.Fatalf("got %q from %d", data, start)
+	}
+	if data, start, end := r.Since(10); len(data) != 0 || start != 10 || end != 10 {
+		t.Fatalf("got %q [%d, %d)", data, start, end)
+	}
+
+	// A write larger than the buffer keeps only its tail.
+	r.Write([]byte("0123456789xyz"))
+	if data, start, end := r.Since(0); string(data) != "56789xyz" || start != 15 || end != 23 {
+		t.Fatalf("got %q [%d, %d)", data, start, end)
+	}
+}
+
+func TestRingBufferLargeFirstWrite(t *testing.T) {
+	var teed []byte
+	r := newRingBuffer(4, func(p []byte) { teed = append(teed, p...) })
+	r.Write([]byte("abcdef"))
+	r.Write([]byte("g"))
+	if data, start, _ := r.Since(0); string(data) != "defg" || start != 3 {
+		t.Fatalf("got %q from %d", data, start)
+	}
+	if string(teed) != "abcdefg" {
+		t.Fatalf("tee got %q", teed)
+	}
+}
@@ -0,0 +1,181 @@
+// Package logstream streams process output into Redis-FS files.
+//
+// Output is not sent as it arrives: it is buffered per file and sent every
+// Interval (or sooner, once FlushBytes have built up), with the appends
+// for every file sent in one pipeline of FS.APPEND commands. A chatty
+// build costs a few round trips a second, however many lines it prints,
+// and agents can FS.TAIL the file while the job runs.
+package logstream
+
+import (
+	"context"
+	"fmt"
+	"log"
+	"sync"
+	"time"
+
+	"github.com/redis/go-redis/v9"
+)
+
+// Options tunes a Streamer. Zero values take the defaults.
+type Options struct {
+	Interval   time.Duration // how often buffered output is sent (250ms)
+	FlushBytes int           // send early once a file has this much (64 KiB)
+	MaxPending int           // per-file cap while a send is in flight (4 MiB)
+}
+
+// Streamer appends output to files in one Redis-FS key. It implements
+// executor.OutputSink.
+type Streamer struct {
+	rdb  *redis.Client
+	key  string
+	opts Options
+
+	mu      sync.Mutex
+	pending map[string]*pendingLog
+
+	flushMu sync.Mutex // one flush at a time, so appends stay in order
+	wake    chan struct{}
+	stop    chan struct{}
+	stopped chan struct{}
+}
+
+type pendingLog struct {
+	data    []byte
+	dropped int64 // bytes discarded because data hit MaxPending
+	closed  bool
+}
+
+// New starts a Streamer appending to files in the Redis-FS key.
+func New(rdb *redis.Client, key string, opts Options) *Streamer {
+	if opts.Interval <= 0 {
+		opts.Interval = 250 * time.Millisecond
+	}
+	if opts.FlushBytes <= 0 {
+		opts.FlushBytes = 64 << 10
+	}
+	if opts.MaxPending <= 0 {
+		opts.MaxPending = 4 << 20
+	}
+	s := &Streamer{
+		rdb:     rdb,
+		key:     key,
+		opts:    opts,
+		pending: make(map[string]*pendingLog),
+		wake:    make(chan struct{}, 1),
+		stop:    make(chan struct{}),
+		stopped: make(chan struct{}),
+	}
+	go s.run()
+	return s
+}
+
+// Write queues p to be appended to path. It never blocks on Redis.
+func (s *Streamer) Write(path string, p []byte) {
+	s.mu.Lock()
+	pl := s.pending[path]
+	if pl == nil {
+		pl = &pendingLog{}
+		s.pending[path] = pl
+	}
+	if room := s.opts.MaxPending - len(pl.data); len(p) > room {
+		pl.dropped += int64(len(p) - room)
+		p = p[:room]
+	}
+	pl.data = append(pl.data, p...)
+	full := len(pl.data) >= s.opts.FlushBytes
+	s.mu.Unlock()
+
+	if full {
+		select {
+		case s.wake <- struct{}{}:
+		default:
+		}
+	}
+}
+
+// Close sends whatever is still queued for path and returns once it has
+// been appended (or failed), so the file is complete when a process is
+// reported done.
+func (s *Streamer) Close(path string) {
+	s.mu.Lock()
+	if pl := s.pending[path]; pl != nil {
+		pl.closed = true
+	}
+	s.mu.Unlock()
+	s.flush()
+}
+
+// Stop sends all queued output and stops the background flusher.
+func (s *Streamer) Stop() {
+	close(s.stop)
+	<-s.stopped
+	s.flush()
+}
+
+func (s *Streamer) run() {
+	defer close(s.stopped)
+	ticker := time.NewTicker(s.opts.Interval)
+	defer ticker.Stop()
+	for {
+		select {
+		case <-ticker.C:
+		case <-s.wake:
+		case <-s.stop:
+			return
+		}
+		s.flush()
+	}
+}
+
+type appendCall struct {
+	path string
+	data []byte
+}
+
+// flush sends every file's queued output in one pipeline.
+func (s *Streamer) flush() {
+	s.flushMu.Lock()
+	defer s.flushMu.Unlock()
+
+	s.mu.Lock()
+	var calls []appendCall
+	for path, pl := range s.pending {
+		data := pl.data
+		if pl.dropped > 0 {
+			note := fmt.Sprintf("\n[... %d bytes of output dropped ...]\n", pl.dropped)
+			data = append([]byte(note), data...)
+		}
+		if len(data) > 0 {
+			calls = append(calls, appendCall{path, data})
+		}
+		if pl.closed {
+			delete(s.pending, path)
+		} else {
+			pl.data, pl.dropped = nil, 0
+		}
+	}
+	s.mu.Unlock()
+	if len(calls) == 0 {
+		return
+	}
+
+	ctx, cancel := context.WithTimeout(context.Background(), 10*time.Second)
+	defer cancel()
+	cmds, err := s.rdb.Pipelined(ctx, func(pipe redis.Pipeliner) error {
+		for _, c := range calls {
+			pipe.Do(ctx, "FS.APPEND", s.key, c.path, c.data)
+		}
+		return nil
+	})
+	if err == nil {
+		return
+	}
+	// Output that failed to send is not retried: the process's own
+	// buffers still have the recent part of it.
+	for i, cmd := range cmds {
+		if cmd.Err() != nil {
+			log.Printf("logstream: appending to %s: %v", calls[i].path, cmd.Err())
+		}
+	}
+}
@@ -13,7 +13,10 @@ Usage:
     # Start Redis with the module loaded first:
     #   redis-server --loadmodule ./module/fs.so --enable-debug-command yes
     #
-    python3 test.py [--port 6379]
+    python3 test.py [--port 6379] [--replica-port 6380]
+
+    Tests that check replication need a replica of that server, also with
+    the module loaded, and are skipped without --replica-port.
 """
 
 import argparse
@@ -73,9 +76,12 @@ def check_module_loaded(r):
 class TestCase:
     """Base class for all Redis-FS tests."""
 
+    replica_port = None     # Set from --replica-port
+
     def __init__(self, port):
         self.port = port
         self.redis = None
+        self.replica = None
         self.test_key = f"test:{self.__class__.__name__.lower()}"
 
     def getname(self):
@@ -89,6 +95,8 @@ class TestCase:
     def setup(self):
         """Called before each test — clean slate."""
         self.redis = redis.Redis(host="127.0.0.1", port=self.port, db=9)
+        if self.replica_port:
+            self.replica = redis.Redis(host="127.0.0.1", port=self.replica_port, db=9)
         # Delete the test key if it exists from a prior failed run.
         self.redis.delete(self.test_key)
 
@@ -97,6 +105,8 @@ class TestCase:
         if self.redis:
             self.redis.delete(self.test_key)
             self.redis.close()
+        if self.replica:
+            self.replica.close()
 
     def test(self):
         """Override this method with actual test logic."""
@@ -184,6 +194,8 @@ def main():
     parser = argparse.ArgumentParser(description="Redis-FS test runner")
     parser.add_argument("--port", type=int, default=6379,
                         help="Redis port (default 6379)")
+    parser.add_argument("--replica-port", type=int, default=None,
+                        help="Port of a replica of that server, for replication tests")
     args = parser.parse_args()
 
     print("=" * 56)
@@ -202,6 +214,7 @@ def main():
     check_module_loaded(r)
     r.close()
 
+    TestCase.replica_port = args.replica_port
     tests = find_test_classes(args.port)
     if not tests:
         print(colored("No tests found in tests/ directory.", "yellow"))
@@ -0,0 +1,92 @@
+from test import TestCase
+
+
+def as_map(flat):
+    return {flat[i]: flat[i + 1] for i in range(0, len(flat), 2)}
+
+
+class Analyze(TestCase):
+    def getname(self):
+        return "FS.ANALYZE — data-shape statistics"
+
+    def test(self):
+        r = self.redis
+        k = self.test_key
+
+        r.execute_command("FS.ECHO", k, "/src/a.c", "int a;")
+        r.execute_command("FS.ECHO", k, "/src/b.c", "int b;")
+        r.execute_command("FS.ECHO", k, "/docs/readme.md", "# hi\n")
+        r.execute_command("FS.LN", k, "/src/a.c", "/link")
+
+        stats, cursor = r.execute_command("FS.ANALYZE", k)
+        assert cursor == b"0", cursor
+        s = as_map(stats)
+        assert (s[b"inodes"], s[b"files"], s[b"directories"], s[b"symlinks"]) == (7, 3, 3, 1), s
+        assert s[b"file_bytes"] == 17, s
+        assert s[b"file_sizes"] == [8, 3], s           # 5 and 6 bytes: the 5..8 bucket
+        assert s[b"dir_fanout"] == [1, 1, 2, 1, 4, 1], s   # /docs, /src, /
+        assert s[b"depths"] == [0, 1, 1, 3, 2, 3], s
+        assert s[b"extensions"] == [b"c", 2, 12, b"md", 1, 5], s
+        mem = as_map(s[b"memory"])
+        assert mem[b"content"] >= 17 and mem[b"metadata"] > 0 and mem[b"paths"] > 0, mem
+
+        # A subtree.
+        s = as_map(r.execute_command("FS.ANALYZE", k, "/src")[0])
+        assert (s[b"inodes"], s[b"files"]) == (3, 2), s
+
+        # Paging: the pages add up to the whole walk.
+        totals = {}
+        cursor = None
+        pages = 0
+        while cursor != b"0":
+            args = ["COUNT", 2] + (["CURSOR", cursor] if cursor else [])
+            stats, cursor = r.execute_command("FS.ANALYZE", k, *args)
+            for name, value in as_map(stats).items():
+                if isinstance(value, int):
+                    totals[name] = totals.get(name, 0) + value
+            pages += 1
+        assert pages == 4, pages
+        assert totals[b"inodes"] == 7 and totals[b"file_bytes"] == 17, totals
+
+        # Duplicates: every copy of a sampled file is sampled too.
+        for i in range(64):
+            body = f"content {i}\n" * 3
+            r.execute_command("FS.ECHO", k, f"/dup/{i}.txt", body)
+            r.execute_command("FS.ECHO", k, f"/dup/{i}.copy", body)
+        s = as_map(r.execute_command("FS.ANALYZE", k, "/dup")[0])
+        assert s[b"sampled_files"] % 2 == 0, s
+        assert s[b"duplicate_files"] == s[b"sampled_files"] // 2 * 16, s
+
+        # Per-page duplicate figures miss copies split across pages; the
+        # merged samples recover the whole-walk estimate.
+        seen, paged_dups, cursor = {}, 0, None
+        while cursor != b"0":
+            args = ["COUNT", 3] + (["CURSOR", cursor] if cursor else [])
+            stats, cursor = r.execute_command("FS.ANALYZE", k, "/dup", *args)
+            page = as_map(stats)
+            paged_dups += page[b"duplicate_files"]
+            samples = page[b"samples"]
+            for h, size in zip(samples[0::2], samples[1::2]):
+                seen[(h, size)] = seen.get((h, size), 0) + 1
+        merged = sum(n - 1 for n in seen.values()) * 16
+        assert merged == s[b"duplicate_files"], (merged, s)
+        assert paged_dups <= merged
+
+        # Errors.
+        for args in (["COUNT", 0], ["COUNT", 100001], ["/", "BOGUS"]):
+            try:
+                r.execute_command("FS.ANALYZE", k, *args)
+                assert False, args
+            except Exception as e:
+                assert "COUNT" in str(e) or "syntax" in str(e), e
+        for args in (["/nothing"], ["/src", "CURSOR", "/docs"]):
+            try:
+                r.execute_command("FS.ANALYZE", k, *args)
+                assert False, args
+            except Exception as e:
+                assert "no such path" in str(e) or "invalid cursor" in str(e), e
+        try:
+            r.execute_command("FS.ANALYZE", k + ":missing")
+            assert False
+        except Exception as e:
+            assert "no such filesystem key" in str(e)
@@ -20,6 +20,11 @@ class Append(TestCase):
         content = r.execute_command("FS.CAT", k, "/log.txt")
         assert content == b"line1\nline2\n"
 
+        # An empty append to an existing file changes nothing.
+        before = r.execute_command("FS.STAT", k, "/log.txt")
+        assert r.execute_command("FS.APPEND", k, "/log.txt", "") == 12
+        assert r.execute_command("FS.STAT", k, "/log.txt") == before
+
         # Append auto-creates parents.
         r.execute_command("FS.APPEND", k, "/a/b/c.txt", "data")
         assert r.execute_command("FS.CAT", k, "/a/b/c.txt") == b"data"
@@ -0,0 +1,78 @@
+import time
+
+import redis
+
+from test import TestCase
+
+
+class Expire(TestCase):
+    def getname(self):
+        return "FS.EXPIRE / FS.TTL — path expiry"
+
+    def test(self):
+        r = self.redis
+        k = self.test_key
+
+        r.execute_command("FS.ECHO", k, "/keep.txt", "stay")
+        r.execute_command("FS.ECHO", k, "/tmp/a/b.txt", "scratch")
+        r.execute_command("FS.ECHO", k, "/tmp/c.txt", "scratch")
+
+        # No expiry yet; missing paths report -2.
+        assert r.execute_command("FS.TTL", k, "/tmp") == -1
+        assert r.execute_command("FS.TTL", k, "/nope") == -2
+        assert r.execute_command("FS.TTL", k + ":missing", "/keep.txt") == -2
+        assert r.execute_command("FS.EXPIRE", k, "/nope", 1000) == 0
+
+        # TTL counts down from the requested value.
+        assert r.execute_command("FS.EXPIRE", k, "/tmp", 100000) == 1
+        ttl = r.execute_command("FS.TTL", k, "/tmp")
+        assert 0 < ttl <= 100000
+
+        # PERSIST clears it.
+        assert r.execute_command("FS.PERSIST", k, "/tmp") == 1
+        assert r.execute_command("FS.TTL", k, "/tmp") == -1
+        assert r.execute_command("FS.PERSIST", k, "/tmp") == 0
+
+        # The expiry follows the path through a rename.
+        r.execute_command("FS.EXPIRE", k, "/tmp", 100000)
+        r.execute_command("FS.MV", k, "/tmp", "/scratch")
+        assert r.execute_command("FS.TTL", k, "/scratch") > 0
+
+        # Once expired, the whole subtree is reclaimed in the background.
+        r.execute_command("FS.EXPIRE", k, "/scratch", 50)
+        deadline = time.time() + 5
+        while time.time() < deadline:
+            if r.execute_command("FS.TEST", k, "/scratch") == 0:
+                break
+            time.sleep(0.05)
+        assert r.execute_command("FS.TEST", k, "/scratch") == 0
+        assert r.execute_command("FS.TEST", k, "/scratch/a/b.txt") == 0
+        assert r.execute_command("FS.CAT", k, "/keep.txt") == b"stay"
+        info = r.execute_command("FS.INFO", k)
+        d = dict(zip(info[0::2], info[1::2]))
+        assert d[b"files"] == 1
+
+        # The expiry follows the key into another database with SWAPDB.
+        r.execute_command("FS.ECHO", k, "/swapped.txt", "scratch")
+        r.execute_command("FS.EXPIRE", k, "/swapped.txt", 300)
+        other = redis.Redis(host="127.0.0.1", port=self.port, db=10)
+        r.swapdb(9, 10)
+        try:
+            deadline = time.time() + 5
+            while time.time() < deadline:
+                if other.execute_command("FS.TEST", k, "/swapped.txt") == 0:
+                    break
+                time.sleep(0.05)
+            assert other.execute_command("FS.TEST", k, "/swapped.txt") == 0
+            assert other.execute_command("FS.CAT", k, "/keep.txt") == b"stay"
+        finally:
+            r.swapdb(9, 10)
+            other.close()
+
+        # The root can't expire, and times must be positive.
+        for args in (("/", 1000), ("/keep.txt", 0), ("/keep.txt", "abc")):
+            try:
+                r.execute_command("FS.EXPIRE", k, *args)
+                assert False, "invalid EXPIRE should fail"
+            except Exception as e:
+                assert "expire" in str(e)
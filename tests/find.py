@@ -1,3 +1,5 @@
+import redis
+
 from test import TestCase
 
 
@@ -42,3 +44,46 @@ class Find(TestCase):
         # No matches.
         results = r.execute_command("FS.FIND", k, "/", "*.xyz")
         assert results == [] or results is None
+
+        # Metadata predicates: size, mtime and owner.
+        r.execute_command("FS.ECHO", k, "/big.txt", "x" * 100)
+        r.execute_command("FS.CHOWN", k, "/sub/c.txt", 1000)
+        r.execute_command("FS.UTIMENS", k, "/sub/d.log", 0, 5000)
+        results = r.execute_command("FS.FIND", k, "/", "*", "TYPE", "file", "MINSIZE", 2)
+        assert results == [b"/big.txt"], f"Got {results}"
+        results = r.execute_command("FS.FIND", k, "/", "*.txt", "MAXSIZE", 1)
+        assert results == [b"/a.txt", b"/sub/c.txt", b"/sub/deep/e.txt"], f"Got {results}"
+        results = r.execute_command("FS.FIND", k, "/", "*", "OLDER", 5001)
+        assert results == [b"/sub/d.log"], f"Got {results}"
+        results = r.execute_command("FS.FIND", k, "/sub", "*", "NEWER", 5000, "TYPE", "file")
+        assert results == [b"/sub/c.txt", b"/sub/deep/e.txt"], f"Got {results}"
+        assert r.execute_command("FS.FIND", k, "/", "*", "UID", 1000) == [b"/sub/c.txt"]
+
+        # A directory's size is its entry count.
+        results = r.execute_command("FS.FIND", k, "/", "*", "TYPE", "dir", "MINSIZE", 3)
+        assert results == [b"/", b"/sub"], f"Got {results}"
+
+        # Writes after the first predicate find are seen by the next one,
+        # including renames of whole directories.
+        r.execute_command("FS.ECHO", k, "/sub/deep/e.txt", "y" * 50)
+        r.execute_command("FS.MV", k, "/sub", "/moved")
+        results = r.execute_command("FS.FIND", k, "/moved", "*", "MINSIZE", 50)
+        assert results == [b"/moved/deep/e.txt"], f"Got {results}"
+        r.execute_command("FS.RM", k, "/big.txt")
+        assert r.execute_command("FS.FIND", k, "/", "big.txt", "MINSIZE", 0) == []
+
+        # Paged like any FIND: path order, cursor "0" at the end.
+        page, cursor = r.execute_command("FS.FIND", k, "/", "*", "TYPE", "file",
+                                         "MAXSIZE", 1, "LIMIT", 2)
+        assert page == [b"/a.txt", b"/b.log"] and cursor == b"/moved/c.txt"
+        page, cursor = r.execute_command("FS.FIND", k, "/", "*", "TYPE", "file",
+                                         "MAXSIZE", 1, "LIMIT", 2, "CURSOR", cursor)
+        assert page == [b"/moved/c.txt", b"/moved/d.log"] and cursor == b"0"
+
+        # Errors.
+        for args in (["MINSIZE", -1], ["UID", "x"], ["NEWER"]):
+            try:
+                r.execute_command("FS.FIND", k, "/", "*", *args)
+                assert False, f"expected error for {args}"
+            except redis.ResponseError:
+                pass
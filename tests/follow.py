@@ -0,0 +1,70 @@
+import threading
+import time
+
+import redis
+
+from test import TestCase
+
+
+class Follow(TestCase):
+    def getname(self):
+        return "FS.TAIL FOLLOW — blocking reads of appended bytes"
+
+    def test(self):
+        r = self.redis
+        k = self.test_key
+
+        # Nothing to read yet: nil at once, or after BLOCK times out.
+        assert r.execute_command("FS.TAIL", k, "/out.log", "FOLLOW", 0) is None
+        start = time.time()
+        result = r.execute_command("FS.TAIL", k, "/out.log", "FOLLOW", 0, "BLOCK", 100)
+        assert result is None, f"Expected nil on timeout, got {result}"
+        assert time.time() - start >= 0.09, "BLOCK returned before its timeout"
+
+        # New bytes come back with the offset to pass next time.
+        r.execute_command("FS.APPEND", k, "/out.log", "hello\n")
+        result = r.execute_command("FS.TAIL", k, "/out.log", "FOLLOW", 0)
+        assert result == [6, b"hello\n"], f"Got {result}"
+        result = r.execute_command("FS.TAIL", k, "/out.log", "FOLLOW", 0, "COUNT", 2)
+        assert result == [2, b"he"], f"Got {result}"
+        assert r.execute_command("FS.TAIL", k, "/out.log", "FOLLOW", 6) is None
+
+        # A blocked follower wakes on the append, not on its timeout.
+        writer = redis.Redis(host="127.0.0.1", port=self.port, db=9)
+        def append_later():
+            time.sleep(0.1)
+            writer.execute_command("FS.ECHO", k, "/other.txt", "unrelated")
+            writer.execute_command("FS.APPEND", k, "/out.log", "world\n")
+        t = threading.Thread(target=append_later)
+        t.start()
+        start = time.time()
+        result = r.execute_command("FS.TAIL", k, "/out.log", "FOLLOW", 6, "BLOCK", 5000)
+        t.join()
+        writer.close()
+        assert result == [12, b"world\n"], f"Got {result}"
+        assert time.time() - start < 4, "Follower was not woken by the append"
+
+        # Truncation restarts the follower at the beginning.
+        r.execute_command("FS.TRUNCATE", k, "/out.log", 3)
+        result = r.execute_command("FS.TAIL", k, "/out.log", "FOLLOW", 12)
+        assert result == [3, b"hel"], f"Got {result}"
+
+        # Log offsets count dropped bytes, so retention does not move them.
+        r.execute_command("FS.LOG", k, "/app.log", "SEGMENT", 1024, "MAXSIZE", 1024)
+        for i in range(300):
+            r.execute_command("FS.APPEND", k, "/app.log", f"{i:08d}\n")
+        result = r.execute_command("FS.TAIL", k, "/app.log", "FOLLOW", 2691)
+        assert result == [2700, b"00000299\n"], f"Got {result}"
+        next_offset, data = r.execute_command("FS.TAIL", k, "/app.log", "FOLLOW", 0, "COUNT", 9)
+        assert next_offset > 9 and len(data) == 9, "Expected a read from the oldest kept byte"
+
+        # Errors.
+        r.execute_command("FS.MKDIR", k, "/dir")
+        for args in (("/dir", "FOLLOW", 0), ("/out.log", "FOLLOW", -1),
+                     ("/out.log", "FOLLOW", 0, "COUNT", 0),
+                     ("/out.log", "FOLLOW", 0, "BOGUS", 1)):
+            try:
+                r.execute_command("FS.TAIL", k, *args)
+                assert False, f"Expected an error for {args}"
+            except redis.ResponseError:
+                pass
@@ -1,3 +1,7 @@
+import time
+
+import redis
+
 from test import TestCase
 
 
@@ -46,3 +50,32 @@ class Grep(TestCase):
         if bin_entries:
             assert b"Binary file" in bin_entries[0][2], \
                 f"Expected binary notice, got {bin_entries[0][2]}"
+
+        # A large unpaged grep runs in the background on a read view of the
+        # files: it returns the same matches as the paged (inline) walk, and
+        # writes made while it is blocked don't show up in its reply. The
+        # files are big enough (32 MB, scanned NOCASE) that the scan
+        # outlasts the writes by orders of magnitude.
+        filler = "".join(f"filler line {i} of the big file\n" for i in range(120000))
+        for i in range(4):
+            r.execute_command("FS.ECHO", k, f"/big/f{i}.txt",
+                              filler + f"needle {i}\n" + filler)
+        paged, cursor = r.execute_command("FS.GREP", k, "/big", "*needle*",
+                                          "NOCASE", "LIMIT", 10000)
+        assert cursor == b"0" and len(paged) == 4
+
+        grepper = redis.Redis(host="127.0.0.1", port=self.port, db=9)
+        conn = grepper.connection_pool.get_connection("FS.GREP")
+        conn.send_command("FS.GREP", k, "/big", "*needle*", "NOCASE")
+        deadline = time.time() + 5
+        while r.info("clients")["blocked_clients"] == 0:
+            assert not conn.can_read(), "grep replied before it was seen blocked"
+            assert time.time() < deadline, "grep never blocked"
+        for i in range(4):
+            r.execute_command("FS.ECHO", k, f"/big/f{i}.txt", "gone")
+        assert not conn.can_read(), "grep finished before the writes landed"
+        results = conn.read_response()
+        grepper.connection_pool.release(conn)
+        grepper.close()
+        assert results == paged, f"Got {results}"
+        assert r.execute_command("FS.GREP", k, "/big", "*needle*") == []
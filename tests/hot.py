@@ -0,0 +1,61 @@
+from test import TestCase
+
+
+class Hot(TestCase):
+    def getname(self):
+        return "FS.HOT — hot-file tracking"
+
+    def test(self):
+        r = self.redis
+        k = self.test_key
+
+        r.execute_command("FS.ECHO", k, "/src/main.c", "int main;")
+        r.execute_command("FS.ECHO", k, "/src/util.c", "int util;")
+        r.execute_command("FS.ECHO", k, "/docs/readme.md", "# docs")
+
+        # Every write counts once for a cold file, so all three are in.
+        hot = r.execute_command("FS.HOT", k, "WRITES")
+        assert sorted(h[0] for h in hot) == [b"/docs/readme.md", b"/src/main.c", b"/src/util.c"], hot
+        assert all(h[1] == 0 and h[2] == 1 for h in hot), hot
+
+        # Reads push a file up the read ranking.
+        for _ in range(300):
+            r.execute_command("FS.CAT", k, "/src/util.c")
+        for _ in range(20):
+            r.execute_command("FS.HEAD", k, "/docs/readme.md", 1)
+        hot = r.execute_command("FS.HOT", k, "READS")
+        assert [h[0] for h in hot] == [b"/src/util.c", b"/docs/readme.md"], hot
+        assert hot[0][1] > hot[1][1] > 0
+
+        # Path scope and LIMIT.
+        hot = r.execute_command("FS.HOT", k, "/src", "READS")
+        assert [h[0] for h in hot] == [b"/src/util.c"], hot
+        assert len(r.execute_command("FS.HOT", k, "LIMIT", 1)) == 1
+        assert r.execute_command("FS.HOT", k, "/nothing") == []
+
+        # Counters and pool entries follow moves and go with deletes.
+        r.execute_command("FS.MV", k, "/src", "/lib")
+        hot = r.execute_command("FS.HOT", k, "/lib", "READS")
+        assert [h[0] for h in hot] == [b"/lib/util.c"], hot
+        r.execute_command("FS.RM", k, "/lib/util.c")
+        hot = r.execute_command("FS.HOT", k, "READS")
+        assert [h[0] for h in hot] == [b"/docs/readme.md"], hot
+
+        # Metadata commands don't count as writes.
+        before = r.execute_command("FS.HOT", k, "/docs", "WRITES")[0][2]
+        for _ in range(50):
+            r.execute_command("FS.CHMOD", k, "/docs/readme.md", "0600")
+        assert r.execute_command("FS.HOT", k, "/docs", "WRITES")[0][2] == before
+
+        # Errors.
+        for args in (["LIMIT", 0], ["LIMIT", 257], ["/", "BOGUS"]):
+            try:
+                r.execute_command("FS.HOT", k, *args)
+                assert False, args
+            except Exception as e:
+                assert "LIMIT" in str(e) or "syntax" in str(e), e
+        try:
+            r.execute_command("FS.HOT", k + ":missing")
+            assert False
+        except Exception as e:
+            assert "no such filesystem key" in str(e)
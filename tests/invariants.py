@@ -18,6 +18,20 @@ def assert_tree_consistent(r, key):
                 child = d + ("" if d == "/" else "/") + name
             assert r.execute_command("FS.TEST", key, child) == 1, f"Missing listed child {child!r}"
 
+        # LONG reads metadata through the entry, not the path: both must agree.
+        for entry in r.execute_command("FS.LS", key, d, "LONG") or []:
+            name, ftype, _, size, mtime = entry
+            if isinstance(d, bytes):
+                child = d + (b"" if d == b"/" else b"/") + name
+            else:
+                child = d + ("" if d == "/" else "/") + name
+            stat = r.execute_command("FS.STAT", key, child)
+            st = dict(zip(stat[0::2], stat[1::2]))
+            assert st[b"type"] == ftype, f"LS LONG type of {child!r} is stale"
+            assert int(st[b"mtime"]) == mtime, f"LS LONG mtime of {child!r} is stale"
+            if ftype == b"file":
+                assert int(st[b"size"]) == size, f"LS LONG size of {child!r} is stale"
+
     for p in all_paths:
         if p == b"/" or p == "/":
             continue
@@ -0,0 +1,83 @@
+import time
+
+from test import TestCase
+
+
+class LogFile(TestCase):
+    def getname(self):
+        return "FS.LOG — segmented log files and retention"
+
+    def stat(self, path):
+        reply = self.redis.execute_command("FS.STAT", self.test_key, path)
+        return {reply[i].decode(): reply[i + 1] for i in range(0, len(reply), 2)}
+
+    def test(self):
+        r = self.redis
+        k = self.test_key
+
+        assert r.execute_command("FS.LOG", k, "/app.log", "SEGMENT", 1024) == b"OK"
+        lines = [f"line {i:03d} {'needle' if i == 7 else 'hay'}\n" for i in range(1, 201)]
+        for line in lines:
+            r.execute_command("FS.APPEND", k, "/app.log", line)
+        content = "".join(lines).encode()
+
+        # Still a file to every reader.
+        st = self.stat("/app.log")
+        assert st["type"] == b"file" and st["size"] == len(content)
+        assert st["segments"] == 3 and st["segment_size"] == 1024
+        assert r.execute_command("FS.CAT", k, "/app.log") == content
+        assert r.execute_command("FS.TAIL", k, "/app.log", 2) == b"line 199 hay\nline 200 hay\n"
+        assert r.execute_command("FS.READCHUNK", k, "/app.log", 1020, 20) == content[1020:1040]
+        assert r.execute_command("FS.GREP", k, "/", "*needle*") == [
+            [b"/app.log", 7, b"line 007 needle"]]
+
+        # Edits in the middle are refused; rewriting keeps it a log.
+        for cmd in (["FS.REPLACE", k, "/app.log", "hay", "x"],
+                    ["FS.TRUNCATE", k, "/app.log", 5]):
+            try:
+                r.execute_command(*cmd)
+                assert False, f"expected {cmd[0]} to fail"
+            except Exception as e:
+                assert "append-only" in str(e)
+
+        # Retention drops whole segments from the front.
+        r.execute_command("FS.LOG", k, "/app.log", "MAXSIZE", 1500)
+        st = self.stat("/app.log")
+        assert st["segments"] == 1 and st["size"] <= 1500
+        assert st["dropped"] == len(content) - st["size"]
+        assert content.endswith(r.execute_command("FS.CAT", k, "/app.log"))
+
+        # A plain file converts with its content.
+        r.execute_command("FS.ECHO", k, "/plain.txt", "a\nb\n")
+        r.execute_command("FS.LOG", k, "/plain.txt")
+        r.execute_command("FS.APPEND", k, "/plain.txt", "c\n")
+        assert r.execute_command("FS.CAT", k, "/plain.txt") == b"a\nb\nc\n"
+
+        # Age retention on the master replicates as FS.LOG ... DROP; the
+        # replica must end up at the same version.
+        if self.replica:
+            r.execute_command("FS.LOG", k, "/aged.log", "SEGMENT", 1024, "MAXAGE", 50)
+            r.execute_command("FS.APPEND", k, "/aged.log", "x" * 1100)
+            r.execute_command("FS.APPEND", k, "/aged.log", "y" * 1100)
+            time.sleep(0.1)
+            r.execute_command("FS.APPEND", k, "/aged.log", "z\n")
+            assert r.execute_command("WAIT", 1, 2000) >= 1
+            on_master = self.stat("/aged.log")
+            reply = self.replica.execute_command("FS.STAT", k, "/aged.log")
+            on_replica = {reply[i].decode(): reply[i + 1] for i in range(0, len(reply), 2)}
+            assert on_master["dropped"] > 0
+            assert on_replica["dropped"] == on_master["dropped"]
+            assert on_replica["version"] == on_master["version"]
+        else:
+            print("         (skipped replica check — no --replica-port)")
+
+        try:
+            r.execute_command("DEBUG", "RELOAD")
+        except Exception as e:
+            if "DEBUG" in str(e).upper():
+                print("         (skipped — DEBUG command not enabled)")
+                return
+            raise
+        st = self.stat("/app.log")
+        assert st["max_size"] == 1500 and st["segments"] == 1
+        assert r.execute_command("FS.CAT", k, "/plain.txt") == b"a\nb\nc\n"
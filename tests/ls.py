@@ -1,3 +1,5 @@
+import redis
+
 from test import TestCase
 
 
@@ -47,3 +49,35 @@ class Ls(TestCase):
         r.execute_command("FS.MKDIR", k, "/empty")
         entries4 = r.execute_command("FS.LS", k, "/empty")
         assert entries4 == [] or entries4 is None
+
+        # SORTED returns names in byte order, not insertion order.
+        r.execute_command("FS.ECHO", k, "/big/zeta", "z")
+        r.execute_command("FS.ECHO", k, "/big/alpha/deep/x", "x")
+        r.execute_command("FS.ECHO", k, "/big/alpha.txt", "a")
+        r.execute_command("FS.ECHO", k, "/big/mid", "m")
+        assert r.execute_command("FS.LS", k, "/big", "SORTED") == [
+            b"alpha", b"alpha.txt", b"mid", b"zeta"]
+
+        # Paged: [entries, cursor], name order, cursor "0" after the last page.
+        page, cursor = r.execute_command("FS.LS", k, "/big", "COUNT", 2)
+        assert page == [b"alpha", b"alpha.txt"], f"Got {page}"
+        assert cursor == b"/big/mid", f"Got {cursor}"
+
+        # The cursor survives writes: removing its entry or adding one
+        # behind it doesn't shift the rest.
+        r.execute_command("FS.RM", k, "/big/mid")
+        r.execute_command("FS.ECHO", k, "/big/aardvark", "a")
+        page, cursor = r.execute_command("FS.LS", k, "/big", "LONG", "COUNT", 2,
+                                         "CURSOR", cursor)
+        assert [e[0] for e in page] == [b"zeta"], f"Got {page}"
+        assert page[0][1] == b"file" and page[0][3] == 1
+        assert cursor == b"0"
+
+        # Errors.
+        for args in (["COUNT", 0], ["COUNT", 10001], ["CURSOR", "/elsewhere/x"],
+                     ["CURSOR", "/big/alpha/deep"], ["BOGUS"]):
+            try:
+                r.execute_command("FS.LS", k, "/big", *args)
+                assert False, f"expected error for {args}"
+            except redis.ResponseError:
+                pass
@@ -0,0 +1,80 @@
+from test import TestCase
+
+
+class Mount(TestCase):
+    def getname(self):
+        return "FS.MOUNT — subtrees on other keys"
+
+    def teardown(self):
+        if self.redis:
+            self.redis.delete(self.test_key + ":lib")
+        super().teardown()
+
+    def test(self):
+        r = self.redis
+        k = self.test_key
+        lib = k + ":lib"
+
+        r.execute_command("FS.ECHO", k, "/README.md", "top")
+        r.execute_command("FS.ECHO", lib, "/a.txt", "shard")
+
+        # Mounting creates the stub directory; it shows up in its parent.
+        assert r.execute_command("FS.MOUNT", k, "/src/lib", lib) == b"OK"
+        assert b"lib" in r.execute_command("FS.LS", k, "/src")
+        assert r.execute_command("FS.MOUNTS", k) == [[b"/src/lib", lib.encode()]]
+        info = r.execute_command("FS.INFO", k)
+        assert dict(zip(info[0::2], info[1::2]))[b"mounts"] == 1
+
+        # Paths at or below the mount point redirect to the owning key.
+        for path in ("/src/lib", "/src/lib/a.txt", "/src//lib/./x/../a.txt"):
+            try:
+                r.execute_command("FS.CAT", k, path)
+                assert False, "expected FSMOVED"
+            except Exception as e:
+                assert str(e) == f"FSMOVED {lib} /src/lib", str(e)
+
+        # Paths outside it are served locally.
+        assert r.execute_command("FS.CAT", k, "/README.md") == b"top"
+
+        # Two-path commands must stay on one key.
+        try:
+            r.execute_command("FS.MV", k, "/README.md", "/src/lib/README.md")
+            assert False, "expected cross-key error"
+        except Exception as e:
+            assert "cross-key operation" in str(e)
+
+        # Subtrees holding a mount cannot be removed, moved or copied.
+        for cmd in (("FS.RM", k, "/src", "RECURSIVE"),
+                    ("FS.MV", k, "/src", "/source"),
+                    ("FS.CP", k, "/src", "/copy", "RECURSIVE")):
+            try:
+                r.execute_command(*cmd)
+                assert False, f"expected {cmd[0]} to fail"
+            except Exception as e:
+                assert "contains a mount point" in str(e)
+
+        # Mount points must be empty directories, never the root or self.
+        r.execute_command("FS.MKDIR", k, "/full")
+        r.execute_command("FS.ECHO", k, "/full/x", "1")
+        for path, target, msg in (("/full", lib, "must be an empty directory"),
+                                  ("/README.md", lib, "must be an empty directory"),
+                                  ("/", lib, "root directory"),
+                                  ("/self", k, "onto itself"),
+                                  ("/bad", "a b", "whitespace")):
+            try:
+                r.execute_command("FS.MOUNT", k, path, target)
+                assert False, f"expected MOUNT {path} to fail"
+            except Exception as e:
+                assert msg in str(e), str(e)
+
+        # UMOUNT leaves the stub behind and the target untouched.
+        assert r.execute_command("FS.UMOUNT", k, "/src/lib") == 1
+        assert r.execute_command("FS.UMOUNT", k, "/src/lib") == 0
+        assert r.execute_command("FS.MOUNTS", k) == []
+        assert r.execute_command("FS.LS", k, "/src/lib") == []
+        assert r.execute_command("FS.CAT", lib, "/a.txt") == b"shard"
+
+        # Mount table survives DEBUG RELOAD.
+        r.execute_command("FS.MOUNT", k, "/src/lib", lib)
+        r.execute_command("DEBUG", "RELOAD")
+        assert r.execute_command("FS.MOUNTS", k) == [[b"/src/lib", lib.encode()]]
@@ -0,0 +1,53 @@
+from test import TestCase
+
+
+class Paging(TestCase):
+    def getname(self):
+        return "FS.FIND/GREP/TREE — LIMIT and CURSOR"
+
+    def test(self):
+        r = self.redis
+        k = self.test_key
+
+        for i in range(5):
+            r.execute_command("FS.ECHO", k, f"/d/f{i}.md", f"hit {i}\nmiss\nhit again\n")
+        r.execute_command("FS.ECHO", k, "/d/other.txt", "hit\n")
+
+        # FIND pages through the same results as an unpaged call.
+        everything = r.execute_command("FS.FIND", k, "/", "*.md")
+        assert everything == sorted(everything) and len(everything) == 5
+        found, cursor = [], None
+        while cursor != b"0":
+            args = ["CURSOR", cursor] if cursor else []
+            page, cursor = r.execute_command("FS.FIND", k, "/", "*.md", "LIMIT", 2, *args)
+            assert len(page) <= 2
+            found += page
+        assert found == everything
+
+        # A GREP page can end partway through a file.
+        page, cursor = r.execute_command("FS.GREP", k, "/d", "hit*", "LIMIT", 3)
+        assert [(p, n) for p, n, _ in page] == [
+            (b"/d/f0.md", 1), (b"/d/f0.md", 3), (b"/d/f1.md", 1)]
+        assert cursor == b"2:/d/f1.md"
+        page, cursor = r.execute_command("FS.GREP", k, "/d", "hit*", "LIMIT", 1,
+                                         "CURSOR", cursor)
+        assert [(p, n) for p, n, _ in page] == [(b"/d/f1.md", 3)]
+        rest, cursor = r.execute_command("FS.GREP", k, "/d", "hit*", "CURSOR", cursor)
+        assert cursor == b"0" and len(rest) == 7
+
+        # TREE repeats the cursor's parent directories so pages nest alike.
+        tree, cursor = r.execute_command("FS.TREE", k, "/", "LIMIT", 3)
+        assert tree == [b"/", [[b"d/", [b"f0.md"]]]]
+        assert cursor == b"/d/f1.md"
+        tree, cursor = r.execute_command("FS.TREE", k, "/", "LIMIT", 10, "CURSOR", cursor)
+        assert tree == [b"/", [[b"d/", [b"f1.md", b"f2.md", b"f3.md", b"f4.md",
+                                        b"other.txt"]]]]
+        assert cursor == b"0"
+
+        # Errors.
+        for args in (["LIMIT", 0], ["LIMIT", 10001], ["CURSOR", "/elsewhere"]):
+            try:
+                r.execute_command("FS.FIND", k, "/d", "*", *args)
+                assert False, f"expected error for {args}"
+            except Exception as e:
+                assert "LIMIT" in str(e) or "cursor" in str(e)
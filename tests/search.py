@@ -0,0 +1,65 @@
+from test import TestCase
+
+
+class Search(TestCase):
+    def getname(self):
+        return "FS.SEARCH — BM25 ranked search"
+
+    def test(self):
+        r = self.redis
+        k = self.test_key
+
+        r.execute_command("FS.ECHO", k, "/notes/redis.md",
+                          "# Redis\nA Redis module extends Redis.\nUnrelated line")
+        r.execute_command("FS.ECHO", k, "/notes/fox.md",
+                          "The quick brown fox\njumps over the lazy dog")
+        r.execute_command("FS.ECHO", k, "/src/mod.c", "/* a module */")
+        r.execute_command("FS.ECHO", k, "/bin.dat", b"redis\x00redis")
+
+        # Index does not exist until the first search.
+        info = r.execute_command("FS.INFO", k)
+        assert dict(zip(info[0::2], info[1::2]))[b"index_bytes"] == 0
+
+        hits = r.execute_command("FS.SEARCH", k, "/", "redis module")
+        paths = [h[0] for h in hits]
+        assert paths == [b"/notes/redis.md", b"/src/mod.c"], paths
+        assert float(hits[0][1]) > float(hits[1][1]) > 0
+        # Best line is the one with the most query words; binary files skipped.
+        assert hits[0][2] == 2 and hits[0][3] == b"A Redis module extends Redis."
+
+        info = r.execute_command("FS.INFO", k)
+        assert dict(zip(info[0::2], info[1::2]))[b"index_bytes"] > 0
+
+        # Path scope, INCLUDE and LIMIT.
+        hits = r.execute_command("FS.SEARCH", k, "/src", "module")
+        assert [h[0] for h in hits] == [b"/src/mod.c"]
+        hits = r.execute_command("FS.SEARCH", k, "/", "module", "INCLUDE", "*.c")
+        assert [h[0] for h in hits] == [b"/src/mod.c"]
+        hits = r.execute_command("FS.SEARCH", k, "/", "redis", "LIMIT", 1)
+        assert len(hits) == 1
+        assert r.execute_command("FS.SEARCH", k, "/", "nothing matches") == []
+
+        # The index follows writes, moves and deletes.
+        r.execute_command("FS.ECHO", k, "/notes/fox.md", "the fox read about a redis module")
+        r.execute_command("FS.MV", k, "/src/mod.c", "/src/module.c")
+        r.execute_command("FS.RM", k, "/notes/redis.md")
+        hits = r.execute_command("FS.SEARCH", k, "/", "module")
+        assert sorted(h[0] for h in hits) == [b"/notes/fox.md", b"/src/module.c"]
+        r.execute_command("FS.REPLACE", k, "/notes/fox.md", "redis", "valkey")
+        hits = r.execute_command("FS.SEARCH", k, "/", "valkey")
+        assert [h[0] for h in hits] == [b"/notes/fox.md"]
+
+        # The index is rebuilt after a reload.
+        r.execute_command("DEBUG", "RELOAD")
+        info = r.execute_command("FS.INFO", k)
+        assert dict(zip(info[0::2], info[1::2]))[b"index_bytes"] > 0
+        hits = r.execute_command("FS.SEARCH", k, "/", "valkey")
+        assert [h[0] for h in hits] == [b"/notes/fox.md"]
+
+        for args, msg in ((("LIMIT", 0), "LIMIT must be"),
+                          (("BOGUS", 1), "syntax error")):
+            try:
+                r.execute_command("FS.SEARCH", k, "/", "redis", *args)
+                assert False, "expected error"
+            except Exception as e:
+                assert msg in str(e)
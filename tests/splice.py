@@ -0,0 +1,64 @@
+from test import TestCase
+
+
+class Splice(TestCase):
+    def getname(self):
+        return "FS.SPLICE — byte-range edits"
+
+    def test(self):
+        r = self.redis
+        k = self.test_key
+
+        r.execute_command("FS.ECHO", k, "/f.txt", "hello world")
+
+        # Single range: replace "world" with "there".
+        assert r.execute_command("FS.SPLICE", k, "/f.txt", 6, 5, "there") == 11
+        assert r.execute_command("FS.CAT", k, "/f.txt") == b"hello there"
+
+        # Several ranges, in pre-edit coordinates: grow, shrink, insert.
+        size = r.execute_command("FS.SPLICE", k, "/f.txt",
+                                 0, 5, "HELLO!!", 5, 1, "", 11, 0, ".")
+        content = r.execute_command("FS.CAT", k, "/f.txt")
+        assert content == b"HELLO!!there.", f"Got {content}"
+        assert size == len(content)
+
+        # Pure deletion down to an empty file.
+        assert r.execute_command("FS.SPLICE", k, "/f.txt", 0, 13, "") == 0
+        assert r.execute_command("FS.CAT", k, "/f.txt") == b""
+
+        # A missing file is created along with its parents.
+        assert r.execute_command("FS.SPLICE", k, "/new/g.txt", 0, 0, "abc") == 3
+        assert r.execute_command("FS.CAT", k, "/new/g.txt") == b"abc"
+
+        # Data that looks like an option is still data.
+        r.execute_command("FS.SPLICE", k, "/new/g.txt", 3, 0, "IFVERSION")
+        assert r.execute_command("FS.CAT", k, "/new/g.txt") == b"abcIFVERSION"
+
+        # IFVERSION works as a trailing pair.
+        stat = r.execute_command("FS.STAT", k, "/new/g.txt")
+        v = dict(zip(stat[0::2], stat[1::2]))[b"version"]
+        r.execute_command("FS.SPLICE", k, "/new/g.txt", 0, 3, "", "IFVERSION", v)
+        assert r.execute_command("FS.CAT", k, "/new/g.txt") == b"IFVERSION"
+
+        # Invalid ranges are rejected without touching the file.
+        for args, msg in (((5, 100, "x"), "beyond end"),
+                          ((4, 2, "a", 3, 0, "b"), "ascending"),
+                          ((-1, 0, "x"), "non-negative")):
+            try:
+                r.execute_command("FS.SPLICE", k, "/new/g.txt", *args)
+                assert False, f"SPLICE {args} should fail"
+            except Exception as e:
+                assert msg in str(e), f"Got {e}"
+        assert r.execute_command("FS.CAT", k, "/new/g.txt") == b"IFVERSION"
+
+        # Edit commands still behave the same now that they splice.
+        r.execute_command("FS.ECHO", k, "/e.txt", "a b a b a\nline 2\nline 3\n")
+        assert r.execute_command("FS.REPLACE", k, "/e.txt", "a", "xyz", "ALL") == 3
+        r.execute_command("FS.INSERT", k, "/e.txt", 1, "ins")
+        assert r.execute_command("FS.DELETELINES", k, "/e.txt", 3, 3) == 1
+        assert r.execute_command("FS.CAT", k, "/e.txt") == b"xyz b xyz b xyz\nins\nline 3\n"
+
+        # GREP still finds content introduced by an edit.
+        r.execute_command("FS.REPLACE", k, "/e.txt", "ins", "needle")
+        matches = r.execute_command("FS.GREP", k, "/", "*needle*")
+        assert len(matches) > 0
@@ -1,3 +1,5 @@
+import redis
+
 from test import TestCase
 
 
@@ -98,3 +100,29 @@ class Symlinks(TestCase):
             assert False, "Expected error on symlink chain exceeding 40 levels"
         except Exception:
             pass  # Any error is acceptable
+
+        # Symlinks in the middle of a path are followed too, the way a
+        # pnpm node_modules tree links packages.
+        r.execute_command("FS.ECHO", k, "/store/pkg@1/index.js", "module.exports = 1")
+        r.execute_command("FS.LN", k, "../store/pkg@1", "/node_modules/pkg")
+        r.execute_command("FS.LN", k, "/node_modules", "/app/node_modules")
+        assert r.execute_command("FS.CAT", k, "/app/node_modules/pkg/index.js") == b"module.exports = 1"
+        assert r.execute_command("FS.LS", k, "/app/node_modules/pkg") == [b"index.js"]
+        assert r.execute_command("FS.CAT", k, "/app/node_modules/pkg/missing.js") is None
+
+        # Repointing a link is seen at once, cached resolutions included.
+        r.execute_command("FS.ECHO", k, "/store/pkg@2/index.js", "module.exports = 2")
+        r.execute_command("FS.RM", k, "/node_modules/pkg")
+        assert r.execute_command("FS.CAT", k, "/app/node_modules/pkg/index.js") is None
+        r.execute_command("FS.LN", k, "/store/pkg@2", "/node_modules/pkg")
+        assert r.execute_command("FS.CAT", k, "/app/node_modules/pkg/index.js") == b"module.exports = 2"
+        r.execute_command("FS.MV", k, "/app/node_modules", "/app/nm")
+        assert r.execute_command("FS.CAT", k, "/app/nm/pkg/index.js") == b"module.exports = 2"
+        assert r.execute_command("FS.CAT", k, "/app/node_modules/pkg/index.js") is None
+
+        # Hops through directories count towards the same limit.
+        try:
+            r.execute_command("FS.CAT", k, "/loopA/x")
+            assert False, "Expected error on a loop in the middle of a path"
+        except redis.ResponseError:
+            pass
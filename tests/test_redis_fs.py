@@ -48,6 +48,16 @@ class TestBasicIO:
         content = fs.read("/log.txt")
         assert content == "Line 1\nLine 2\n"
 
+    def test_make_log(self, fs):
+        """Test a log file: appends, tail, and size retention."""
+        assert fs.make_log("/logs/app.log", max_size=2048, segment_size=1024)
+        for i in range(200):
+            fs.append("/logs/app.log", f"event {i}\n")
+        assert fs.tail("/logs/app.log", 1) == "event 199\n"
+        stat = fs.stat("/logs/app.log")
+        assert stat["size"] <= 2048
+        assert stat["dropped"] > 0
+
     def test_write_creates_parents(self, fs):
         """Test that write creates parent directories."""
         fs.write("/a/b/c/file.txt", "nested")
@@ -91,6 +101,31 @@ class TestLineOperations:
         assert "Line 18" in result
         assert "Line 17" not in result
 
+    def test_follow(self, fs):
+        """Test reading appended bytes from an offset."""
+        fs.write("/follow.log", "first\n")
+        data, offset = fs.follow("/follow.log")
+        assert data == b"first\n"
+        assert offset == 6
+        assert fs.follow("/follow.log", offset) is None
+        fs.append("/follow.log", "second\n")
+        data, offset = fs.follow("/follow.log", offset, block_ms=1000)
+        assert data == b"second\n"
+        assert offset == 13
+
+    def test_watch(self, fs):
+        """Test waiting for changes under a directory."""
+        fs.mkdir("/watched")
+        changed, token = fs.watch("/watched", timeout_ms=10)
+        assert changed == []
+        fs.write("/watched/a.txt", "a")
+        fs.write("/watched/sub/b.txt", "b")
+        changed, token = fs.watch("/watched", since=token, timeout_ms=10)
+        assert changed == ["/watched/a.txt"]
+        fs.write("/watched/sub/c.txt", "c")
+        changed, token = fs.watch("/watched", recursive=True, since=token)
+        assert changed == ["/watched/sub/c.txt"]
+
     def test_insert(self, fs):
         """Test inserting content after a line."""
         fs.write("/insert.txt", "Line 1\nLine 2\nLine 3\n")
@@ -146,6 +181,17 @@ class TestNavigation:
         assert "file2.txt" in entries
         assert "subdir" in entries
 
+    def test_ls_page(self, fs):
+        """Test paging through a directory in name order."""
+        for name in ("c.txt", "a.txt", "b.txt"):
+            fs.write(f"/paged/{name}", name)
+        assert fs.ls("/paged", sorted=True) == ["a.txt", "b.txt", "c.txt"]
+        page, cursor = fs.ls_page("/paged", count=2)
+        assert page == ["a.txt", "b.txt"]
+        page, cursor = fs.ls_page("/paged", count=2, cursor=cursor)
+        assert page == ["c.txt"]
+        assert cursor is None
+
     def test_exists(self, fs):
         """Test existence check."""
         fs.write("/exists.txt", "content")
@@ -162,6 +208,14 @@ class TestNavigation:
         assert any("readme.md" in r for r in results)
         assert any("guide.md" in r for r in results)
 
+    def test_find_predicates(self, fs):
+        """Test finding files by size and mtime."""
+        fs.write("/data/small.bin", "x")
+        fs.write("/data/large.bin", "x" * 4096)
+        assert fs.find("/data", "*", type="file", min_size=1024) == ["/data/large.bin"]
+        assert fs.find("/data", "*.bin", max_size=1) == ["/data/small.bin"]
+        assert fs.find("/data", "*", newer=2**62) == []
+
     def test_stat(self, fs):
         """Test getting file metadata."""
         fs.write("/stat-test.txt", "content")
@@ -232,6 +286,185 @@ class TestSearch:
         results = fs.grep("/search", "*foo*")
         assert len(results) > 0
 
+    def test_grep_page(self, fs):
+        """Test paging through grep matches."""
+        fs.write("/search/file1.txt", "foo 1\nfoo 2\nbar")
+        fs.write("/search/file2.txt", "foo 3")
+        page, cursor = fs.grep_page("/search", "foo*", limit=2)
+        assert [m[1] for m in page] == [1, 2] and cursor is not None
+        page, cursor = fs.grep_page("/search", "foo*", limit=2, cursor=cursor)
+        assert len(page) == 1 and cursor is None
+
+    def test_tree_page(self, fs):
+        """Test paging through the tree."""
+        for i in range(3):
+            fs.write(f"/t/f{i}.txt", "x")
+        tree, cursor = fs.tree_page("/t", limit=2)
+        assert tree == [b"t/", [b"f0.txt"]] and cursor == "/t/f1.txt"
+        tree, cursor = fs.tree_page("/t", limit=2, cursor=cursor)
+        assert tree == [b"t/", [b"f1.txt", b"f2.txt"]] and cursor is None
+
+    def test_tree_flat(self, fs):
+        """Test the flat tree encoding."""
+        fs.write("/t/b.txt", "x")
+        fs.write("/t/a/c.txt", "x")
+        assert fs.tree_flat("/t") == [
+            (0, "dir", "t"), (1, "dir", "a"), (2, "file", "c.txt"), (1, "file", "b.txt")]
+        assert fs.tree_flat("/t", depth=0) == [(0, "dir", "t")]
+        page, cursor = fs.tree_page("/t", limit=2, flat=True)
+        assert page == [(0, "dir", "t"), (1, "dir", "a")] and cursor == "/t/a/c.txt"
+
+    def test_search(self, fs):
+        """Test ranked search."""
+        fs.write("/search/a.md", "redis module notes\nredis redis")
+        fs.write("/search/b.md", "a note that mentions redis once among many other words")
+        hits = fs.search("/search", "redis")
+        assert [h["path"] for h in hits] == ["/search/a.md", "/search/b.md"]
+        assert hits[0]["line"] == 2
+
+    def test_hot(self, fs):
+        """Test hot-file reporting."""
+        fs.write("/hot/a.txt", "a")
+        fs.write("/hot/b.txt", "b")
+        for _ in range(200):
+            fs.read("/hot/a.txt")
+        hits = fs.hot("/hot", by="reads")
+        assert hits[0]["path"] == "/hot/a.txt" and hits[0]["reads"] > 1
+        assert fs.hot("/hot", limit=1, by="writes")[0]["writes"] >= 1
+
+    def test_analyze(self, fs):
+        """Test data-shape statistics, merged across pages."""
+        fs.write("/an/a.py", "x = 1\n")
+        fs.write("/an/b.py", "y = 22\n")
+        fs.write("/an/notes.md", "# notes\n")
+        full = fs.analyze("/an")
+        assert (full["inodes"], full["files"], full["directories"]) == (4, 3, 1)
+        assert full["extensions"]["py"] == {"files": 2, "bytes": 13}
+        assert sum(full["file_sizes"].values()) == 3
+        paged = fs.analyze("/an", count=1)
+        assert paged["inodes"] == 4 and paged["file_sizes"] == full["file_sizes"]
+
+
+class TestLargeFiles:
+    """Test chunked upload and download."""
+
+    def test_upload_download(self, fs):
+        """A file written in chunks reads back whole."""
+        import io
+        data = bytes(range(256)) * 1000
+        assert fs.upload("/big.bin", io.BytesIO(data), chunk_size=4096) == len(data)
+        assert fs.download("/big.bin", chunk_size=5000) == data
+        out = io.BytesIO()
+        assert fs.download("/big.bin", out, chunk_size=5000) == len(data)
+        assert out.getvalue() == data
+        assert fs.download("/missing.bin") is None
+
+    def test_upload_replaces_atomically(self, fs, redis_client):
+        """Readers see the old content until the commit."""
+        fs.write("/a.txt", "old")
+        handle = redis_client.execute_command("FS.OPEN", "test-vol", "/a.txt")
+        redis_client.execute_command("FS.WRITECHUNK", "test-vol", handle, "new")
+        assert fs.read("/a.txt") == "old"
+        redis_client.execute_command("FS.COMMIT", "test-vol", handle)
+        assert fs.read("/a.txt") == "new"
+
+
+    def test_open(self, fs):
+        """Streams read and write in chunks; "w" replaces on close."""
+        data = bytes(range(256)) * 100
+        with fs.open("/stream.bin", "wb", chunk_size=1000) as f:
+            for i in range(0, len(data), 333):
+                f.write(data[i:i + 333])
+            assert not fs.exists("/stream.bin")
+        with fs.open("/stream.bin", chunk_size=1000) as f:
+            assert f.read(10) == data[:10]
+            f.seek(-4, 2)
+            assert f.read() == data[-4:]
+        with pytest.raises(KeyError):
+            with fs.open("/stream.bin", "wb") as f:
+                f.write(b"partial")
+                raise KeyError
+        assert fs.read_bytes("/stream.bin") == data
+        with fs.open("/log.txt", "a") as f:
+            f.write("one\n")
+        with fs.open("/log.txt", "a") as f:
+            f.write("two\n")
+        with fs.open("/log.txt", "r") as f:
+            assert f.readlines() == ["one\n", "two\n"]
+
+
+class TestBatch:
+    """Test pipelined batches."""
+
+    def test_batch(self, fs):
+        """Queued calls run on exit and return the unbatched results."""
+        with fs.batch() as b:
+            writes = [b.write(f"/batch/{i}.md", f"file {i}") for i in range(50)]
+            assert len(b) == 50
+        assert writes[7].value == len("file 7")
+        with fs.batch() as b:
+            read, stat, missing, found = (
+                b.read("/batch/3.md"), b.stat("/batch/4.md"),
+                b.read("/batch/nope.md"), b.find("/batch", "1*.md"),
+            )
+        assert read.value == "file 3"
+        assert stat.value["type"] in ("file", b"file")
+        assert missing.value is None
+        assert len(found.value) == 11
+
+    def test_batch_errors(self, fs):
+        """One failure doesn't stop the rest; it is raised from its result."""
+        from redis_fs import NotAFileError
+        fs.mkdir("/dir")
+        fs.write("/ok.md", "ok")
+        b = fs.batch()
+        bad, good = b.read("/dir"), b.read("/ok.md")
+        with pytest.raises(NotAFileError):
+            b.execute()
+        assert good.value == "ok"
+        with pytest.raises(NotAFileError):
+            bad.value
+
+    def test_batch_across_mounts(self, fs, redis_client):
+        """Paths under a mount are followed like unbatched calls."""
+        redis_client.delete("test-vol-lib")
+        fs.mount("/lib", "test-vol-lib")
+        with fs.batch() as b:
+            b.write("/lib/a.py", "a")
+            b.write("/main.py", "m")
+            found = b.find("/", "*.py")
+        assert sorted(found.value) == ["/lib/a.py", "/main.py"]
+
+
+class TestAsync:
+    """Test the asyncio client."""
+
+    def test_async(self, redis_client):
+        """Same API and results as RedisFS, awaited; calls run concurrently."""
+        import asyncio
+        from redis.asyncio import Redis
+        from redis_fs import AsyncRedisFS, NotAFileError
+
+        async def main():
+            r = Redis(host="localhost", port=6399, db=0, max_connections=8)
+            fs = AsyncRedisFS(r, "test-vol")
+            sizes = await asyncio.gather(
+                *(fs.write(f"/async/{i}.md", f"file {i}") for i in range(32))
+            )
+            assert sizes == [len(f"file {i}") for i in range(32)]
+            assert await fs.read("/async/5.md") == "file 5"
+            assert await fs.read("/async/nope.md") is None
+            assert len(await fs.find("/async", "*.md")) == 32
+            with pytest.raises(NotAFileError):
+                await fs.read("/async")
+            async with fs.batch() as b:
+                first, stat = b.read("/async/0.md"), b.stat("/async/1.md")
+            assert first.value == "file 0"
+            assert stat.value is not None
+            await r.aclose() if hasattr(r, "aclose") else await r.close()
+
+        asyncio.run(main())
+
 
 class TestStats:
     """Test stats operations."""
@@ -252,3 +485,56 @@ class TestStats:
         # Should have file_count or similar
         assert len(info) > 0
 
+
+
+class TestMounts:
+    """Test subtrees mounted from other keys."""
+
+    def test_redirect(self, fs, redis_client):
+        """Paths under a mount are served by the target key."""
+        redis_client.delete("test-vol-lib")
+        assert fs.mount("/src/lib", "test-vol-lib")
+        fs.write("/src/lib/util.py", "def helper(): pass")
+        assert fs.read("/src/lib/util.py") == "def helper(): pass"
+        lib = RedisFS(redis_client, "test-vol-lib")
+        assert lib.read("/util.py") == "def helper(): pass"
+        assert fs.mounts() == [("/src/lib", "test-vol-lib")]
+
+    def test_fan_out(self, fs, redis_client):
+        """FIND and GREP cover mounted subtrees."""
+        redis_client.delete("test-vol-lib")
+        fs.write("/src/main.py", "import helper")
+        fs.mount("/src/lib", "test-vol-lib")
+        fs.write("/src/lib/helper.py", "def helper(): pass")
+        assert sorted(fs.find("/", "*.py")) == ["/src/lib/helper.py", "/src/main.py"]
+        files = {m[0].decode() if isinstance(m[0], bytes) else m[0]
+                 for m in fs.grep("/src", "*helper*")}
+        assert files == {"/src/lib/helper.py", "/src/main.py"}
+
+    def test_paged_fan_out(self, fs, redis_client):
+        """find_page pages across mounted subtrees too."""
+        redis_client.delete("test-vol-lib")
+        fs.mount("/src/lib", "test-vol-lib")
+        for name in ("a", "b", "c"):
+            fs.write(f"/src/{name}.py", "x")
+            fs.write(f"/src/lib/{name}.py", "x")
+        found, cursor = [], None
+        while True:
+            page, cursor = fs.find_page("/", "*.py", limit=2, cursor=cursor)
+            assert len(page) <= 2
+            found += page
+            if cursor is None:
+                break
+        assert found == ["/src/a.py", "/src/b.py", "/src/c.py",
+                         "/src/lib/a.py", "/src/lib/b.py", "/src/lib/c.py"]
+
+    def test_cross_key(self, fs, redis_client):
+        """Moves across a mount boundary are refused."""
+        from redis_fs import CrossKeyError
+        redis_client.delete("test-vol-lib")
+        fs.mount("/lib", "test-vol-lib")
+        fs.write("/a.txt", "x")
+        with pytest.raises(CrossKeyError):
+            fs.mv("/a.txt", "/lib/a.txt")
+        assert fs.umount("/lib")
+        assert fs.mounts() == []
@@ -36,3 +36,22 @@ class Tree(TestCase):
         # Flatten result and look for symlink marker.
         flat = str(result)
         assert "sym" in flat
+
+        # FLAT: the same nodes as (depth, type, name) triples, in pre-order.
+        result = r.execute_command("FS.TREE", k, "/sub", "FLAT")
+        assert result == [0, b"dir", b"sub",
+                          1, b"file", b"b.txt",
+                          1, b"dir", b"deep",
+                          2, b"file", b"c.txt"], f"Got {result}"
+        result = r.execute_command("FS.TREE", k, "/", "DEPTH", 1, "FLAT")
+        assert result[:3] == [0, b"dir", b"/"]
+        assert result[3::3] == [1, 1, 1]
+        assert result[5::3] == [b"a.txt", b"sub", b"sym"]
+        assert result[4::3] == [b"file", b"dir", b"symlink"]
+
+        # Paged FLAT repeats the cursor's ancestors, like the nested form.
+        page, cursor = r.execute_command("FS.TREE", k, "/sub", "FLAT", "LIMIT", 2)
+        assert page == [0, b"dir", b"sub", 1, b"file", b"b.txt"], f"Got {page}"
+        page, cursor = r.execute_command("FS.TREE", k, "/sub", "FLAT", "CURSOR", cursor)
+        assert page == [0, b"dir", b"sub", 1, b"dir", b"deep", 2, b"file", b"c.txt"]
+        assert cursor == b"0"
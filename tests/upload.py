@@ -0,0 +1,78 @@
+import time
+
+from test import TestCase
+
+
+class Upload(TestCase):
+    def getname(self):
+        return "FS.OPEN — chunked uploads and downloads"
+
+    def test(self):
+        r = self.redis
+        k = self.test_key
+
+        h = r.execute_command("FS.OPEN", k, "/dir/big.bin")
+        assert h == 1
+        assert r.execute_command("FS.WRITECHUNK", k, h, b"hello ") == 6
+        assert r.execute_command("FS.WRITECHUNK", k, h, b"world", "OFFSET", 6) == 11
+
+        # A replayed chunk is refused instead of written twice.
+        try:
+            r.execute_command("FS.WRITECHUNK", k, h, b"world", "OFFSET", 6)
+            assert False, "expected error"
+        except Exception as e:
+            assert "offset mismatch" in str(e)
+
+        # Nothing is visible before the commit, not even the parent.
+        assert r.execute_command("FS.CAT", k, "/dir/big.bin") is None
+        assert r.execute_command("FS.TEST", k, "/dir") == 0
+        info = r.execute_command("FS.INFO", k)
+        assert dict(zip(info[0::2], info[1::2]))[b"uploads"] == 1
+
+        # Open uploads survive a restart.
+        r.execute_command("DEBUG", "RELOAD")
+        assert r.execute_command("FS.COMMIT", k, h, "IFVERSION", 0) == b"OK"
+        assert r.execute_command("FS.CAT", k, "/dir/big.bin") == b"hello world"
+        try:
+            r.execute_command("FS.COMMIT", k, h)
+            assert False, "expected error"
+        except Exception as e:
+            assert "no such upload" in str(e)
+
+        # Ranged reads.
+        assert r.execute_command("FS.READCHUNK", k, "/dir/big.bin", 6, 100) == b"world"
+        assert r.execute_command("FS.READCHUNK", k, "/dir/big.bin", 11, 5) == b""
+        data, version = r.execute_command(
+            "FS.READCHUNK", k, "/dir/big.bin", 0, 5, "WITHVERSION")
+        assert data == b"hello" and version > 0
+        assert r.execute_command("FS.READCHUNK", k, "/nope", 0, 5) is None
+
+        # Overwriting keeps the file's metadata.
+        r.execute_command("FS.CHMOD", k, "/dir/big.bin", "0600")
+        h = r.execute_command("FS.OPEN", k, "/dir/big.bin")
+        r.execute_command("FS.WRITECHUNK", k, h, b"v2")
+        assert r.execute_command("FS.CAT", k, "/dir/big.bin") == b"hello world"
+        r.execute_command("FS.COMMIT", k, h)
+        assert r.execute_command("FS.CAT", k, "/dir/big.bin") == b"v2"
+        st = r.execute_command("FS.STAT", k, "/dir/big.bin")
+        assert dict(zip(st[0::2], st[1::2]))[b"mode"] == b"0600"
+
+        # Aborted and idle uploads are discarded.
+        h = r.execute_command("FS.OPEN", k, "/gone")
+        assert r.execute_command("FS.ABORT", k, h) == 1
+        assert r.execute_command("FS.ABORT", k, h) == 0
+        h = r.execute_command("FS.OPEN", k, "/idle", "TIMEOUT", 50)
+        r.execute_command("FS.WRITECHUNK", k, h, b"x")
+        for _ in range(50):
+            info = r.execute_command("FS.INFO", k)
+            if dict(zip(info[0::2], info[1::2]))[b"uploads"] == 0:
+                break
+            time.sleep(0.05)
+        assert dict(zip(info[0::2], info[1::2]))[b"uploads"] == 0
+        assert r.execute_command("FS.TEST", k, "/idle") == 0
+
+        try:
+            r.execute_command("FS.OPEN", k, "/dir")
+            assert False, "expected error"
+        except Exception as e:
+            assert "not a file" in str(e)
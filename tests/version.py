@@ -0,0 +1,106 @@
+from test import TestCase
+
+
+class Version(TestCase):
+    def getname(self):
+        return "FS.STAT / IFVERSION — optimistic concurrency"
+
+    def test(self):
+        r = self.redis
+        k = self.test_key
+
+        def version(path):
+            stat = r.execute_command("FS.STAT", k, path)
+            d = dict(zip(stat[0::2], stat[1::2]))
+            return int(d[b"version"])
+
+        # IFVERSION 0 means "create only".
+        r.execute_command("FS.ECHO", k, "/f.txt", "one", "IFVERSION", 0)
+        v1 = version("/f.txt")
+        assert v1 > 0
+        try:
+            r.execute_command("FS.ECHO", k, "/f.txt", "two", "IFVERSION", 0)
+            assert False, "create-only write over existing file should fail"
+        except Exception as e:
+            assert "version mismatch" in str(e)
+
+        # CAT WITHVERSION returns content and version together.
+        content, v = r.execute_command("FS.CAT", k, "/f.txt", "WITHVERSION")
+        assert content == b"one"
+        assert int(v) == v1
+
+        # A write at the current version succeeds and bumps it.
+        r.execute_command("FS.APPEND", k, "/f.txt", "!", "IFVERSION", v1)
+        v2 = version("/f.txt")
+        assert v2 > v1
+
+        # A stale version is rejected and leaves the file untouched.
+        try:
+            r.execute_command("FS.REPLACE", k, "/f.txt", "one", "ONE", "IFVERSION", v1)
+            assert False, "stale IFVERSION should fail"
+        except Exception as e:
+            assert "version mismatch" in str(e)
+        assert r.execute_command("FS.CAT", k, "/f.txt") == b"one!"
+        assert version("/f.txt") == v2
+
+        # Metadata changes bump the version too, and the parent directory
+        # changes when an entry is added.
+        dv = version("/")
+        r.execute_command("FS.CHMOD", k, "/f.txt", "0600", "IFVERSION", v2)
+        assert version("/f.txt") > v2
+        r.execute_command("FS.ECHO", k, "/g.txt", "x")
+        assert version("/") > dv
+
+        # RM honours IFVERSION.
+        try:
+            r.execute_command("FS.RM", k, "/f.txt", "IFVERSION", v1)
+            assert False, "stale RM should fail"
+        except Exception as e:
+            assert "version mismatch" in str(e)
+        r.execute_command("FS.RM", k, "/f.txt", "IFVERSION", version("/f.txt"))
+        assert r.execute_command("FS.CAT", k, "/f.txt") is None
+
+        def mismatch(*cmd):
+            try:
+                r.execute_command(*cmd)
+                assert False, f"expected {cmd[0]} to fail"
+            except Exception as e:
+                assert "version mismatch" in str(e), e
+
+        # MKDIR, LN and CP check the version of the path they create.
+        r.execute_command("FS.MKDIR", k, "/d", "IFVERSION", 0)
+        mismatch("FS.MKDIR", k, "/d", "PARENTS", "IFVERSION", 0)
+        assert r.execute_command("FS.MKDIR", k, "/d", "PARENTS", "IFVERSION", version("/d")) == b"OK"
+        r.execute_command("FS.LN", k, "/g.txt", "/link", "IFVERSION", 0)
+        assert r.execute_command("FS.READLINK", k, "/link") == b"/g.txt"
+        mismatch("FS.LN", k, "/g.txt", "/link", "IFVERSION", 0)
+        r.execute_command("FS.CP", k, "/g.txt", "/copy.txt", "IFVERSION", 0)
+        assert r.execute_command("FS.CAT", k, "/copy.txt") == b"x"
+        mismatch("FS.CP", k, "/g.txt", "/copy.txt", "IFVERSION", 0)
+        mismatch("FS.CP", k, "/d", "/d2", "RECURSIVE", "IFVERSION", version("/d"))
+        r.execute_command("FS.CP", k, "/d", "/d2", "RECURSIVE", "IFVERSION", 0)
+        assert r.execute_command("FS.TEST", k, "/d2") == 1
+
+        # CHMOD, CHOWN and UTIMENS check the version before the path: a
+        # missing path is a mismatch unless IFVERSION is 0.
+        for cmd in (["FS.CHMOD", k, "/gone", "0600"],
+                    ["FS.CHOWN", k, "/gone", 1000],
+                    ["FS.UTIMENS", k, "/gone", 1, 1]):
+            mismatch(*cmd, "IFVERSION", 5)
+            try:
+                r.execute_command(*cmd, "IFVERSION", 0)
+                assert False, f"expected {cmd[0]} on a missing path to fail"
+            except Exception as e:
+                assert "no such file" in str(e), e
+            mismatch(*cmd[:2], "/g.txt", *cmd[3:], "IFVERSION", 0)
+
+        # A file containing the literal word IFVERSION is still writable.
+        r.execute_command("FS.ECHO", k, "/w.txt", "IFVERSION")
+        assert r.execute_command("FS.CAT", k, "/w.txt") == b"IFVERSION"
+
+        # Bad version arguments are rejected.
+        try:
+            r.execute_command("FS.ECHO", k, "/g.txt", "y", "IFVERSION", "-1")
+            assert False, "negative IFVERSION should fail"
+        except Exception as e:
+            assert "IFVERSION" in str(e)
@@ -0,0 +1,64 @@
+import threading
+import time
+
+import redis
+
+from test import TestCase
+
+
+class Watch(TestCase):
+    def getname(self):
+        return "FS.WATCH — waiting for changes under a path"
+
+    def test(self):
+        r = self.redis
+        k = self.test_key
+
+        # Nothing written yet: TIMEOUT ends the wait with no changes.
+        start = time.time()
+        token, changed = r.execute_command("FS.WATCH", k, "/src", "TIMEOUT", 100)
+        assert changed == [], f"Expected no changes, got {changed}"
+        assert time.time() - start >= 0.09, "TIMEOUT returned early"
+
+        # A blocked watcher wakes on a write below it, not on others.
+        writer = redis.Redis(host="127.0.0.1", port=self.port, db=9)
+        def write_later():
+            time.sleep(0.1)
+            writer.execute_command("FS.ECHO", k, "/other.txt", "unrelated")
+            writer.execute_command("FS.ECHO", k, "/src/a/deep.c", "x")
+            writer.execute_command("FS.ECHO", k, "/src/main.c", "y")
+        t = threading.Thread(target=write_later)
+        t.start()
+        start = time.time()
+        token, changed = r.execute_command("FS.WATCH", k, "/src", "TIMEOUT", 5000)
+        t.join()
+        assert changed == [b"/src/main.c"], f"Got {changed}"
+        assert time.time() - start < 4, "Watcher was not woken by the write"
+
+        # SINCE returns what changed between calls, deduplicated.
+        r.execute_command("FS.APPEND", k, "/src/main.c", "z")
+        r.execute_command("FS.CHMOD", k, "/src/main.c", "0600")
+        r.execute_command("FS.ECHO", k, "/src/a/b/c.c", "w")
+        r.execute_command("FS.ECHO", k, "/elsewhere.txt", "v")
+        token2, changed = r.execute_command("FS.WATCH", k, "/src", "RECURSIVE", "SINCE", token)
+        assert changed == [b"/src/main.c", b"/src/a/b/c.c"], f"Got {changed}"
+        _, changed = r.execute_command("FS.WATCH", k, "/src", "SINCE", token2, "TIMEOUT", 10)
+        assert changed == [], f"Expected no changes since {token2}, got {changed}"
+
+        # Removing or moving an ancestor concerns the watched path too.
+        r.execute_command("FS.MV", k, "/src", "/lib")
+        _, changed = r.execute_command("FS.WATCH", k, "/src/main.c", "SINCE", token2)
+        assert changed == [b"/src"], f"Got {changed}"
+
+        # A token this journal no longer covers asks for a rescan.
+        _, changed = r.execute_command("FS.WATCH", k, "/lib", "SINCE", "1-1")
+        assert changed == [b"/lib"], f"Got {changed}"
+
+        # Errors.
+        for args in (("/", "SINCE", "bogus"), ("/", "TIMEOUT", -1), ("/", "BOGUS")):
+            try:
+                r.execute_command("FS.WATCH", k, *args)
+                assert False, f"Expected an error for {args}"
+            except redis.ResponseError:
+                pass
+        writer.close()